@@ -0,0 +1,29 @@
+#include <stdio.h>
+#include "pico/time.h"
+#include "bench.h"
+
+/**
+ * @brief Imprime o cabeçalho CSV dos resultados
+ */
+void bench_header(void) {
+    printf("bench,iterations,total_us,ns_per_op\n");
+}
+
+/**
+ * @brief Executa uma operação repetidamente e imprime o tempo médio em CSV
+ * @param name Nome do benchmark
+ * @param fn Operação medida
+ * @param ctx Contexto repassado à operação
+ * @param iterations Número de repetições
+ * @return Tempo total em microssegundos
+ */
+uint64_t bench_run(const char *name, bench_fn_t fn, void *ctx, uint32_t iterations) {
+    fn(ctx); // Aquecimento
+    uint64_t start = time_us_64();
+    for (uint32_t i = 0; i < iterations; ++i)
+        fn(ctx);
+    uint64_t total = time_us_64() - start;
+    printf("%s,%lu,%llu,%.1f\n", name, (unsigned long)iterations, (unsigned long long)total,
+           iterations ? (double)total * 1000.0 / iterations : 0.0);
+    return total;
+}
@@ -0,0 +1,11 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+
+typedef void (*bench_fn_t)(void *ctx); // Operação medida pelo benchmark
+
+void bench_header(void); // Imprime o cabeçalho CSV dos resultados
+uint64_t bench_run(const char *name, bench_fn_t fn, void *ctx, uint32_t iterations); // Executa e imprime uma linha CSV
+
+#endif // BENCH_H
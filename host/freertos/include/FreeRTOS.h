@@ -0,0 +1,26 @@
+#ifndef FREERTOS_H
+#define FREERTOS_H
+
+// Subconjunto da API do FreeRTOS para o Template_host: cada tarefa é uma
+// thread POSIX e um tick corresponde a 1 ms (configTICK_RATE_HZ = 1000).
+// Prioridades são aceitas e ignoradas.
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uint32_t StackType_t;
+
+#include "FreeRTOSConfig.h"
+
+#define pdFALSE ((BaseType_t)0)
+#define pdTRUE ((BaseType_t)1)
+#define pdFAIL pdFALSE
+#define pdPASS pdTRUE
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+#define portTICK_PERIOD_MS ((TickType_t)1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(((TickType_t)(ms) * (TickType_t)configTICK_RATE_HZ) / (TickType_t)1000U))
+
+#endif // FREERTOS_H
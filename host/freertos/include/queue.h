@@ -0,0 +1,16 @@
+#ifndef QUEUE_H
+#define QUEUE_H
+
+#include "FreeRTOS.h"
+
+typedef struct QueueDefinition *QueueHandle_t;
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size); // Fila de itens de tamanho fixo
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks_to_wait); // Insere no fim
+BaseType_t xQueueReceive(QueueHandle_t queue, void *buffer, TickType_t ticks_to_wait); // Retira do início
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue); // Itens na fila
+void vQueueDelete(QueueHandle_t queue); // Libera a fila
+
+#define xQueueSendToBack xQueueSend
+
+#endif // QUEUE_H
@@ -0,0 +1,17 @@
+#ifndef SEMPHR_H
+#define SEMPHR_H
+
+#include "queue.h"
+
+// Semáforos são filas de itens vazios, como no FreeRTOS
+typedef QueueHandle_t SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void); // Semáforo binário, criado vazio
+SemaphoreHandle_t xSemaphoreCreateMutex(void); // Mutex, criado livre (sem herança de prioridade)
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max_count, UBaseType_t initial_count);
+
+#define xSemaphoreTake(sem, ticks) xQueueReceive((sem), NULL, (ticks))
+#define xSemaphoreGive(sem) xQueueSend((sem), NULL, 0)
+#define vSemaphoreDelete(sem) vQueueDelete(sem)
+
+#endif // SEMPHR_H
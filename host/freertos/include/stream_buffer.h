@@ -0,0 +1,17 @@
+#ifndef STREAM_BUFFER_H
+#define STREAM_BUFFER_H
+
+#include "FreeRTOS.h"
+
+typedef struct StreamBufferDef_t *StreamBufferHandle_t;
+
+StreamBufferHandle_t xStreamBufferCreate(size_t size, size_t trigger_level); // Buffer circular de bytes
+size_t xStreamBufferSend(StreamBufferHandle_t sb, const void *data, size_t len,
+                         TickType_t ticks_to_wait); // Espera caber tudo; grava o que couber
+size_t xStreamBufferReceive(StreamBufferHandle_t sb, void *buffer, size_t len,
+                            TickType_t ticks_to_wait); // Espera trigger_level bytes; lê o disponível
+size_t xStreamBufferBytesAvailable(StreamBufferHandle_t sb); // Bytes para leitura
+size_t xStreamBufferSpacesAvailable(StreamBufferHandle_t sb); // Bytes livres
+void vStreamBufferDelete(StreamBufferHandle_t sb); // Libera o buffer
+
+#endif // STREAM_BUFFER_H
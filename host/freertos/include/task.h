@@ -0,0 +1,22 @@
+#ifndef TASK_H
+#define TASK_H
+
+#include "FreeRTOS.h"
+
+typedef struct tskTaskControlBlock *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+#define tskIDLE_PRIORITY ((UBaseType_t)0U)
+
+BaseType_t xTaskCreate(TaskFunction_t task, const char *name, configSTACK_DEPTH_TYPE stack_depth, void *params,
+                       UBaseType_t priority, TaskHandle_t *created); // Cria e inicia a thread da tarefa
+void vTaskDelete(TaskHandle_t task); // Somente vTaskDelete(NULL) (encerra a tarefa atual)
+void vTaskDelay(TickType_t ticks); // Suspende a tarefa atual
+TickType_t xTaskGetTickCount(void); // Ticks desde o início do programa
+void vTaskEnterCritical(void); // Seção crítica global (mutex recursivo)
+void vTaskExitCritical(void);
+
+#define taskENTER_CRITICAL() vTaskEnterCritical()
+#define taskEXIT_CRITICAL() vTaskExitCritical()
+
+#endif // TASK_H
@@ -0,0 +1,8 @@
+#ifndef TIMERS_H
+#define TIMERS_H
+
+#include "FreeRTOS.h"
+
+typedef struct tmrTimerControl *TimerHandle_t;
+
+#endif // TIMERS_H
@@ -0,0 +1,264 @@
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "stream_buffer.h"
+#include "pico/time.h"
+
+struct tskTaskControlBlock {
+    pthread_t thread;
+    TaskFunction_t task;
+    void *params;
+};
+
+struct QueueDefinition {
+    pthread_mutex_t mtx;
+    pthread_cond_t cond; // Sinalizado a cada inserção ou remoção
+    uint8_t *storage;
+    UBaseType_t length, item_size, head, count;
+};
+
+struct StreamBufferDef_t {
+    pthread_mutex_t mtx;
+    pthread_cond_t cond;
+    uint8_t *storage;
+    size_t size, trigger_level, head, count;
+};
+
+/**
+ * @brief Converte ticks de espera em um instante absoluto de CLOCK_REALTIME
+ * @param ticks Tempo limite em ticks (1 ms)
+ * @param ts Estrutura de saída
+ */
+static void deadline_from_ticks(TickType_t ticks, struct timespec *ts) {
+    clock_gettime(CLOCK_REALTIME, ts);
+    ts->tv_sec += ticks / 1000u;
+    ts->tv_nsec += (long)(ticks % 1000u) * 1000000L;
+    if (ts->tv_nsec >= 1000000000L) {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+
+/**
+ * @brief Espera na condição até o prazo; portMAX_DELAY espera indefinidamente
+ * @return false se o prazo expirou
+ */
+static bool wait_until(pthread_cond_t *cond, pthread_mutex_t *mtx, TickType_t ticks, const struct timespec *ts) {
+    if (portMAX_DELAY == ticks)
+        return 0 == pthread_cond_wait(cond, mtx);
+    return ETIMEDOUT != pthread_cond_timedwait(cond, mtx, ts);
+}
+
+static void *task_entry(void *arg) {
+    struct tskTaskControlBlock *tcb = arg;
+    tcb->task(tcb->params);
+    return NULL;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t task, const char *name, configSTACK_DEPTH_TYPE stack_depth, void *params,
+                       UBaseType_t priority, TaskHandle_t *created) {
+    (void)name;
+    (void)stack_depth;
+    (void)priority;
+    struct tskTaskControlBlock *tcb = calloc(1, sizeof *tcb);
+    if (!tcb)
+        return pdFAIL;
+    tcb->task = task;
+    tcb->params = params;
+    if (pthread_create(&tcb->thread, NULL, task_entry, tcb)) {
+        free(tcb);
+        return pdFAIL;
+    }
+    pthread_detach(tcb->thread);
+    if (created)
+        *created = tcb;
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    configASSERT(NULL == task);
+    pthread_exit(NULL);
+}
+
+void vTaskDelay(TickType_t ticks) {
+    sleep_ms(ticks);
+}
+
+TickType_t xTaskGetTickCount(void) {
+    return (TickType_t)(time_us_64() / 1000u);
+}
+
+static pthread_mutex_t critical_mtx = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+
+void vTaskEnterCritical(void) {
+    pthread_mutex_lock(&critical_mtx);
+}
+
+void vTaskExitCritical(void) {
+    pthread_mutex_unlock(&critical_mtx);
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size) {
+    struct QueueDefinition *q = calloc(1, sizeof *q);
+    if (!q)
+        return NULL;
+    q->storage = item_size ? calloc(length, item_size) : NULL;
+    if (item_size && !q->storage) {
+        free(q);
+        return NULL;
+    }
+    pthread_mutex_init(&q->mtx, NULL);
+    pthread_cond_init(&q->cond, NULL);
+    q->length = length;
+    q->item_size = item_size;
+    return q;
+}
+
+BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t ticks_to_wait) {
+    struct timespec ts;
+    deadline_from_ticks(ticks_to_wait, &ts);
+    pthread_mutex_lock(&q->mtx);
+    while (q->count == q->length)
+        if (!ticks_to_wait || !wait_until(&q->cond, &q->mtx, ticks_to_wait, &ts)) {
+            pthread_mutex_unlock(&q->mtx);
+            return pdFAIL;
+        }
+    if (q->item_size)
+        memcpy(q->storage + (q->head + q->count) % q->length * q->item_size, item, q->item_size);
+    q->count++;
+    pthread_cond_broadcast(&q->cond);
+    pthread_mutex_unlock(&q->mtx);
+    return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t q, void *buffer, TickType_t ticks_to_wait) {
+    struct timespec ts;
+    deadline_from_ticks(ticks_to_wait, &ts);
+    pthread_mutex_lock(&q->mtx);
+    while (!q->count)
+        if (!ticks_to_wait || !wait_until(&q->cond, &q->mtx, ticks_to_wait, &ts)) {
+            pthread_mutex_unlock(&q->mtx);
+            return pdFAIL;
+        }
+    if (q->item_size)
+        memcpy(buffer, q->storage + q->head * q->item_size, q->item_size);
+    q->head = (q->head + 1) % q->length;
+    q->count--;
+    pthread_cond_broadcast(&q->cond);
+    pthread_mutex_unlock(&q->mtx);
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q) {
+    pthread_mutex_lock(&q->mtx);
+    UBaseType_t count = q->count;
+    pthread_mutex_unlock(&q->mtx);
+    return count;
+}
+
+void vQueueDelete(QueueHandle_t q) {
+    pthread_cond_destroy(&q->cond);
+    pthread_mutex_destroy(&q->mtx);
+    free(q->storage);
+    free(q);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void) {
+    return xQueueCreate(1, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+    SemaphoreHandle_t sem = xQueueCreate(1, 0);
+    if (sem)
+        xSemaphoreGive(sem);
+    return sem;
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max_count, UBaseType_t initial_count) {
+    SemaphoreHandle_t sem = xQueueCreate(max_count, 0);
+    if (sem)
+        sem->count = initial_count;
+    return sem;
+}
+
+StreamBufferHandle_t xStreamBufferCreate(size_t size, size_t trigger_level) {
+    struct StreamBufferDef_t *sb = calloc(1, sizeof *sb);
+    if (!sb)
+        return NULL;
+    sb->storage = malloc(size);
+    if (!sb->storage) {
+        free(sb);
+        return NULL;
+    }
+    pthread_mutex_init(&sb->mtx, NULL);
+    pthread_cond_init(&sb->cond, NULL);
+    sb->size = size;
+    sb->trigger_level = trigger_level ? trigger_level : 1;
+    return sb;
+}
+
+size_t xStreamBufferSend(StreamBufferHandle_t sb, const void *data, size_t len, TickType_t ticks_to_wait) {
+    struct timespec ts;
+    deadline_from_ticks(ticks_to_wait, &ts);
+    pthread_mutex_lock(&sb->mtx);
+    while (sb->size - sb->count < len && ticks_to_wait && wait_until(&sb->cond, &sb->mtx, ticks_to_wait, &ts))
+        ;
+    size_t n = sb->size - sb->count;
+    if (n > len)
+        n = len;
+    const uint8_t *p = data;
+    for (size_t i = 0; i < n; ++i)
+        sb->storage[(sb->head + sb->count + i) % sb->size] = p[i];
+    sb->count += n;
+    if (n)
+        pthread_cond_broadcast(&sb->cond);
+    pthread_mutex_unlock(&sb->mtx);
+    return n;
+}
+
+size_t xStreamBufferReceive(StreamBufferHandle_t sb, void *buffer, size_t len, TickType_t ticks_to_wait) {
+    struct timespec ts;
+    deadline_from_ticks(ticks_to_wait, &ts);
+    pthread_mutex_lock(&sb->mtx);
+    // Como no FreeRTOS: só bloqueia se estiver vazio; acorda ao atingir trigger_level
+    if (!sb->count)
+        while (sb->count < sb->trigger_level && ticks_to_wait && wait_until(&sb->cond, &sb->mtx, ticks_to_wait, &ts))
+            ;
+    size_t n = sb->count < len ? sb->count : len;
+    uint8_t *p = buffer;
+    for (size_t i = 0; i < n; ++i)
+        p[i] = sb->storage[(sb->head + i) % sb->size];
+    sb->head = (sb->head + n) % sb->size;
+    sb->count -= n;
+    if (n)
+        pthread_cond_broadcast(&sb->cond);
+    pthread_mutex_unlock(&sb->mtx);
+    return n;
+}
+
+size_t xStreamBufferBytesAvailable(StreamBufferHandle_t sb) {
+    pthread_mutex_lock(&sb->mtx);
+    size_t n = sb->count;
+    pthread_mutex_unlock(&sb->mtx);
+    return n;
+}
+
+size_t xStreamBufferSpacesAvailable(StreamBufferHandle_t sb) {
+    pthread_mutex_lock(&sb->mtx);
+    size_t n = sb->size - sb->count;
+    pthread_mutex_unlock(&sb->mtx);
+    return n;
+}
+
+void vStreamBufferDelete(StreamBufferHandle_t sb) {
+    pthread_cond_destroy(&sb->cond);
+    pthread_mutex_destroy(&sb->mtx);
+    free(sb->storage);
+    free(sb);
+}
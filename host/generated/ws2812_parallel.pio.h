@@ -0,0 +1,71 @@
+// ----------------------------------------------------------- //
+// Equivalente ao cabeçalho gerado pelo pioasm a partir de       //
+// src/drivers/ws2812_parallel.pio, para o alvo Template_host   //
+// ----------------------------------------------------------- //
+
+#pragma once
+
+#include "hardware/pio.h"
+#include "hardware/clocks.h"
+
+// ------------------- //
+// pio_matrix_parallel //
+// ------------------- //
+
+#define pio_matrix_parallel_wrap_target 0
+#define pio_matrix_parallel_wrap 3
+
+#define pio_matrix_parallel_T1 2
+#define pio_matrix_parallel_T2 5
+#define pio_matrix_parallel_T3 3
+
+static const uint16_t pio_matrix_parallel_program_instructions[] = {
+            //     .wrap_target
+    0x6028, //  0: out    x, 8
+    0xa10b, //  1: mov    pins, !null            [1]
+    0xa401, //  2: mov    pins, x                [4]
+    0xa103, //  3: mov    pins, null             [1]
+            //     .wrap
+};
+
+static const struct pio_program pio_matrix_parallel_program = {
+    .instructions = pio_matrix_parallel_program_instructions,
+    .length = 4,
+    .origin = -1,
+};
+
+static inline pio_sm_config pio_matrix_parallel_program_get_default_config(uint offset) {
+    pio_sm_config c = pio_get_default_sm_config();
+    sm_config_set_wrap(&c, offset + pio_matrix_parallel_wrap_target, offset + pio_matrix_parallel_wrap);
+    return c;
+}
+
+static inline void pio_matrix_parallel_program_init(PIO pio, uint sm, uint offset, uint pin_base, uint pin_count)
+{
+    pio_sm_config c = pio_matrix_parallel_program_get_default_config(offset);
+
+    // The chains are the OUT/MOV pin group
+    sm_config_set_out_pins(&c, pin_base, pin_count);
+
+    // Attach pio to the GPIOs and set them as outputs
+    for (uint i = 0; i < pin_count; i++) {
+        pio_gpio_init(pio, pin_base + i);
+    }
+    pio_sm_set_consecutive_pindirs(pio, sm, pin_base, pin_count, true);
+
+    // Set pio clock to 8MHz, giving T1 + T2 + T3 = 10 cycles per LED binary digit
+    float div = clock_get_hz(clk_sys) / 8000000.0;
+    sm_config_set_clkdiv(&c, div);
+
+    // Give all the FIFO space to TX (not using RX)
+    sm_config_set_fifo_join(&c, PIO_FIFO_JOIN_TX);
+
+    // Shift to the right, use autopull: four bit-planes per word, lowest byte first
+    sm_config_set_out_shift(&c, true, true, 32);
+
+    // Load configuration, and jump to the start of the program
+    pio_sm_init(pio, sm, offset, &c);
+
+    // enable this pio state machine
+    pio_sm_set_enabled(pio, sm, true);
+}
@@ -0,0 +1,13 @@
+#ifndef HAL_HARDWARE_ADC_H
+#define HAL_HARDWARE_ADC_H
+
+#include "pico.h"
+
+void adc_init(void); // Inicializa o ADC
+void adc_gpio_init(uint gpio); // Prepara o pino para uso analógico
+void adc_select_input(uint input); // Seleciona o canal
+uint adc_get_selected_input(void); // Canal selecionado
+uint16_t adc_read(void); // Conversão única de 12 bits
+void adc_set_temp_sensor_enabled(bool enable); // Habilita o sensor de temperatura
+
+#endif // HAL_HARDWARE_ADC_H
@@ -0,0 +1,108 @@
+#ifndef HAL_HARDWARE_DMA_H
+#define HAL_HARDWARE_DMA_H
+
+#include "pico.h"
+
+#define NUM_DMA_CHANNELS 12
+
+enum dma_channel_transfer_size {
+    DMA_SIZE_8 = 0,
+    DMA_SIZE_16 = 1,
+    DMA_SIZE_32 = 2
+};
+
+// Valores de DREQ do RP2040
+enum dreq_num_rp2040 {
+    DREQ_PIO0_TX0 = 0,
+    DREQ_PIO0_RX0 = 4,
+    DREQ_PIO1_TX0 = 8,
+    DREQ_PIO1_RX0 = 12,
+    DREQ_SPI0_TX = 16,
+    DREQ_SPI0_RX = 17,
+    DREQ_SPI1_TX = 18,
+    DREQ_SPI1_RX = 19,
+    DREQ_UART0_TX = 20,
+    DREQ_UART0_RX = 21,
+    DREQ_UART1_TX = 22,
+    DREQ_UART1_RX = 23,
+    DREQ_PWM_WRAP0 = 24,
+    DREQ_I2C0_TX = 32,
+    DREQ_I2C0_RX = 33,
+    DREQ_I2C1_TX = 34,
+    DREQ_I2C1_RX = 35,
+    DREQ_ADC = 36,
+    DREQ_DMA_TIMER0 = 0x3b,
+    DREQ_FORCE = 0x3f
+};
+
+// Modos de cálculo do sniffer (SNIFF_CTRL.CALC); a simulação implementa CRC16
+#define DMA_SNIFF_CTRL_CALC_VALUE_CRC32 0x0
+#define DMA_SNIFF_CTRL_CALC_VALUE_CRC32R 0x1
+#define DMA_SNIFF_CTRL_CALC_VALUE_CRC16 0x2
+#define DMA_SNIFF_CTRL_CALC_VALUE_CRC16R 0x3
+#define DMA_SNIFF_CTRL_CALC_VALUE_EVEN 0xe
+#define DMA_SNIFF_CTRL_CALC_VALUE_SUM 0xf
+
+// Configuração de canal (no RP2040 é o registrador CTRL; aqui, campos explícitos)
+typedef struct {
+    bool read_increment;
+    bool write_increment;
+    uint dreq;
+    enum dma_channel_transfer_size size;
+    uint chain_to;
+    bool irq_quiet;
+    bool enable;
+    bool bswap;
+    bool sniff_enable;
+} dma_channel_config;
+
+// Registradores globais do DMA usados pelos tratadores de interrupção
+typedef struct {
+    io_rw_32 ints0;
+    io_rw_32 ints1;
+    io_rw_32 sniff_ctrl;
+    io_rw_32 sniff_data;
+} dma_hw_t;
+
+extern dma_hw_t hal_dma_hw;
+#define dma_hw (&hal_dma_hw)
+
+int dma_claim_unused_channel(bool required); // Reserva um canal livre
+void dma_channel_claim(uint channel); // Reserva um canal específico
+void dma_channel_unclaim(uint channel); // Libera o canal
+bool dma_channel_is_claimed(uint channel); // Verifica se o canal está reservado
+dma_channel_config dma_channel_get_default_config(uint channel); // Configuração padrão
+dma_channel_config dma_get_channel_config(uint channel); // Configuração atual do canal
+void channel_config_set_read_increment(dma_channel_config *c, bool incr); // Incremento do endereço de leitura
+void channel_config_set_write_increment(dma_channel_config *c, bool incr); // Incremento do endereço de escrita
+void channel_config_set_dreq(dma_channel_config *c, uint dreq); // Sinal de cadência da transferência
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size); // Tamanho do elemento
+void channel_config_set_chain_to(dma_channel_config *c, uint chain_to); // Canal disparado ao terminar
+void channel_config_set_irq_quiet(dma_channel_config *c, bool irq_quiet); // Suprime a interrupção
+void channel_config_set_enable(dma_channel_config *c, bool enable); // Habilita o canal
+void channel_config_set_bswap(dma_channel_config *c, bool bswap); // Inverte os bytes
+void channel_config_set_sniff_enable(dma_channel_config *c, bool sniff_enable); // Habilita o sniffer
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger); // Configura o canal
+void dma_channel_set_config(uint channel, const dma_channel_config *config, bool trigger); // Altera só a configuração
+void dma_channel_set_read_addr(uint channel, const volatile void *read_addr, bool trigger); // Altera o endereço de leitura
+void dma_channel_set_write_addr(uint channel, volatile void *write_addr, bool trigger); // Altera o endereço de escrita
+void dma_channel_set_trans_count(uint channel, uint32_t trans_count, bool trigger); // Altera a contagem
+void dma_channel_transfer_from_buffer_now(uint channel, const volatile void *read_addr, uint32_t transfer_count); // Dispara a partir de um buffer
+void dma_channel_start(uint channel); // Dispara o canal
+void dma_start_channel_mask(uint32_t chan_mask); // Dispara vários canais ao mesmo tempo
+void dma_channel_abort(uint channel); // Aborta o canal
+bool dma_channel_is_busy(uint channel); // Verifica se o canal está ocupado
+void dma_channel_wait_for_finish_blocking(uint channel); // Aguarda o término
+void dma_channel_set_irq0_enabled(uint channel, bool enabled); // Interrupção na linha 0
+void dma_channel_set_irq1_enabled(uint channel, bool enabled); // Interrupção na linha 1
+bool dma_channel_get_irq0_status(uint channel); // Interrupção pendente na linha 0
+bool dma_channel_get_irq1_status(uint channel); // Interrupção pendente na linha 1
+void dma_channel_acknowledge_irq0(uint channel); // Reconhece a interrupção na linha 0
+void dma_channel_acknowledge_irq1(uint channel); // Reconhece a interrupção na linha 1
+void dma_sniffer_enable(uint channel, uint mode, bool force_channel_enable); // Conecta o sniffer a um canal
+void dma_sniffer_disable(void); // Desliga o sniffer
+void dma_sniffer_set_data_accumulator(uint32_t seed_value); // Valor inicial do acumulador
+uint32_t dma_sniffer_get_data_accumulator(void); // Resultado acumulado
+
+#endif // HAL_HARDWARE_DMA_H
@@ -0,0 +1,53 @@
+#ifndef HAL_HARDWARE_GPIO_H
+#define HAL_HARDWARE_GPIO_H
+
+#include "pico.h"
+
+#define NUM_BANK0_GPIOS 30
+
+#define GPIO_OUT 1
+#define GPIO_IN 0
+
+enum gpio_function {
+    GPIO_FUNC_XIP = 0,
+    GPIO_FUNC_SPI = 1,
+    GPIO_FUNC_UART = 2,
+    GPIO_FUNC_I2C = 3,
+    GPIO_FUNC_PWM = 4,
+    GPIO_FUNC_SIO = 5,
+    GPIO_FUNC_PIO0 = 6,
+    GPIO_FUNC_PIO1 = 7,
+    GPIO_FUNC_GPCK = 8,
+    GPIO_FUNC_USB = 9,
+    GPIO_FUNC_NULL = 0x1f,
+};
+
+enum gpio_drive_strength {
+    GPIO_DRIVE_STRENGTH_2MA = 0,
+    GPIO_DRIVE_STRENGTH_4MA = 1,
+    GPIO_DRIVE_STRENGTH_8MA = 2,
+    GPIO_DRIVE_STRENGTH_12MA = 3
+};
+
+enum gpio_irq_level {
+    GPIO_IRQ_LEVEL_LOW = 0x1u,
+    GPIO_IRQ_LEVEL_HIGH = 0x2u,
+    GPIO_IRQ_EDGE_FALL = 0x4u,
+    GPIO_IRQ_EDGE_RISE = 0x8u,
+};
+
+typedef void (*gpio_irq_callback_t)(uint gpio, uint32_t event_mask);
+
+void gpio_init(uint gpio); // Inicializa o pino como SIO
+void gpio_set_dir(uint gpio, bool out); // Define a direção do pino
+void gpio_put(uint gpio, bool value); // Escreve no pino
+bool gpio_get(uint gpio); // Lê o pino
+void gpio_pull_up(uint gpio); // Habilita pull-up
+void gpio_pull_down(uint gpio); // Habilita pull-down
+void gpio_set_function(uint gpio, enum gpio_function fn); // Seleciona a função do pino
+enum gpio_function gpio_get_function(uint gpio); // Função selecionada para o pino
+bool gpio_is_dir_out(uint gpio); // O pino é saída
+void gpio_set_drive_strength(uint gpio, enum gpio_drive_strength drive); // Define a corrente de saída
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t event_mask, bool enabled, gpio_irq_callback_t callback); // Registra a interrupção do pino
+
+#endif // HAL_HARDWARE_GPIO_H
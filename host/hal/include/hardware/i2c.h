@@ -0,0 +1,45 @@
+#ifndef HAL_HARDWARE_I2C_H
+#define HAL_HARDWARE_I2C_H
+
+#include "pico.h"
+#include "pico/time.h"
+#include "hardware/gpio.h"
+
+typedef struct i2c_inst i2c_inst_t;
+
+// Registradores do DW_apb_i2c usados pelos drivers (FIFO de transmissão para o DMA)
+typedef struct {
+    io_rw_32 con;
+    io_rw_32 tar;
+    io_rw_32 data_cmd;
+    io_rw_32 enable;
+    io_ro_32 txflr;
+    io_rw_32 dma_cr;
+    io_ro_32 status;
+} i2c_hw_t;
+
+#define I2C_IC_TAR_IC_TAR_BITS 0x000003ffu // Endereço do escravo em IC_TAR
+#define I2C_IC_STATUS_TFE_BITS 0x00000004u // FIFO de transmissão vazia
+#define I2C_IC_STATUS_MST_ACTIVITY_BITS 0x00000020u // Mestre em uma transação
+
+// Campos de IC_DATA_CMD: além do byte, encerram ou reiniciam a transação
+#define I2C_IC_DATA_CMD_STOP_BITS 0x00000200u
+#define I2C_IC_DATA_CMD_RESTART_BITS 0x00000400u
+
+extern i2c_inst_t hal_i2c0_inst;
+extern i2c_inst_t hal_i2c1_inst;
+#define i2c0 (&hal_i2c0_inst)
+#define i2c1 (&hal_i2c1_inst)
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate); // Inicializa o barramento, retorna a frequência
+void i2c_deinit(i2c_inst_t *i2c); // Desabilita o barramento
+uint i2c_set_baudrate(i2c_inst_t *i2c, uint baudrate); // Altera a frequência
+uint i2c_hw_index(i2c_inst_t *i2c); // Índice do barramento (0 ou 1)
+i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c); // Registradores do barramento
+uint i2c_get_dreq(i2c_inst_t *i2c, bool is_tx); // DREQ de transmissão ou recepção
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop); // Escrita bloqueante
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop); // Leitura bloqueante
+int i2c_write_timeout_us(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop, uint timeout_us); // Escrita com tempo limite
+int i2c_read_timeout_us(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop, uint timeout_us); // Leitura com tempo limite
+
+#endif // HAL_HARDWARE_I2C_H
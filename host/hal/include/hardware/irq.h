@@ -0,0 +1,28 @@
+#ifndef HAL_HARDWARE_IRQ_H
+#define HAL_HARDWARE_IRQ_H
+
+#include "pico.h"
+
+typedef void (*irq_handler_t)(void);
+
+enum irq_num_rp2040 {
+    TIMER_IRQ_0 = 0,
+    TIMER_IRQ_1 = 1,
+    TIMER_IRQ_2 = 2,
+    TIMER_IRQ_3 = 3,
+    DMA_IRQ_0 = 11,
+    DMA_IRQ_1 = 12,
+    I2C0_IRQ = 23,
+    I2C1_IRQ = 24,
+    NUM_IRQS = 32
+};
+
+#define PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY 0x80
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler); // Registra o tratador exclusivo
+void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority); // Registra um tratador compartilhado
+void irq_remove_handler(uint num, irq_handler_t handler); // Remove um tratador
+void irq_set_enabled(uint num, bool enabled); // Habilita a interrupção
+bool irq_is_enabled(uint num); // Verifica se a interrupção está habilitada
+
+#endif // HAL_HARDWARE_IRQ_H
@@ -0,0 +1,83 @@
+#ifndef HAL_HARDWARE_PIO_H
+#define HAL_HARDWARE_PIO_H
+
+#include "pico.h"
+#include "hardware/gpio.h"
+
+#define NUM_PIO_STATE_MACHINES 4
+
+// Registradores do PIO usados pelos drivers (FIFO de transmissão para o DMA)
+typedef struct {
+    io_rw_32 ctrl;
+    io_ro_32 fstat;
+    io_wo_32 txf[NUM_PIO_STATE_MACHINES];
+    io_ro_32 rxf[NUM_PIO_STATE_MACHINES];
+} pio_hw_t;
+
+typedef pio_hw_t *PIO;
+
+extern pio_hw_t hal_pio0_hw;
+extern pio_hw_t hal_pio1_hw;
+#define pio0 (&hal_pio0_hw)
+#define pio1 (&hal_pio1_hw)
+
+typedef struct pio_program {
+    const uint16_t *instructions;
+    uint8_t length;
+    int8_t origin;
+} pio_program_t;
+
+enum pio_fifo_join {
+    PIO_FIFO_JOIN_NONE = 0,
+    PIO_FIFO_JOIN_TX = 1,
+    PIO_FIFO_JOIN_RX = 2,
+};
+
+// Configuração da máquina de estados
+typedef struct {
+    uint wrap_target;
+    uint wrap;
+    uint set_base;
+    uint set_count;
+    uint out_base;
+    uint out_count;
+    uint sideset_base;
+    uint sideset_bits;
+    float clkdiv;
+    enum pio_fifo_join join;
+    bool out_shift_right;
+    bool autopull;
+    uint pull_threshold;
+    bool out_sticky;
+} pio_sm_config;
+
+uint pio_get_index(PIO pio); // Índice do bloco PIO (0 ou 1)
+uint pio_get_dreq(PIO pio, uint sm, bool is_tx); // DREQ da FIFO da máquina de estados
+uint pio_add_program(PIO pio, const pio_program_t *program); // Carrega o programa, retorna o offset
+bool pio_can_add_program(PIO pio, const pio_program_t *program); // Verifica se há espaço para o programa
+void pio_remove_program(PIO pio, const pio_program_t *program, uint loaded_offset); // Descarrega o programa
+int pio_claim_unused_sm(PIO pio, bool required); // Reserva uma máquina de estados livre
+void pio_sm_claim(PIO pio, uint sm); // Reserva uma máquina de estados específica
+void pio_sm_unclaim(PIO pio, uint sm); // Libera a máquina de estados
+void pio_gpio_init(PIO pio, uint pin); // Conecta o pino ao PIO
+int pio_sm_set_consecutive_pindirs(PIO pio, uint sm, uint pin_base, uint pin_count, bool is_out); // Direção dos pinos
+int pio_sm_init(PIO pio, uint sm, uint initial_pc, const pio_sm_config *config); // Aplica a configuração
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled); // Habilita a máquina de estados
+void pio_sm_put(PIO pio, uint sm, uint32_t data); // Escreve na FIFO de transmissão
+void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data); // Escreve na FIFO, bloqueando se cheia
+bool pio_sm_is_tx_fifo_full(PIO pio, uint sm); // FIFO de transmissão cheia
+bool pio_sm_is_tx_fifo_empty(PIO pio, uint sm); // FIFO de transmissão vazia
+void pio_sm_clear_fifos(PIO pio, uint sm); // Esvazia as FIFOs
+
+pio_sm_config pio_get_default_sm_config(void); // Configuração padrão
+void sm_config_set_wrap(pio_sm_config *c, uint wrap_target, uint wrap); // Laço do programa
+void sm_config_set_set_pins(pio_sm_config *c, uint set_base, uint set_count); // Pinos da instrução SET
+void sm_config_set_out_pins(pio_sm_config *c, uint out_base, uint out_count); // Pinos da instrução OUT
+void sm_config_set_sideset_pins(pio_sm_config *c, uint sideset_base); // Pinos de side-set
+void sm_config_set_sideset(pio_sm_config *c, uint bit_count, bool optional, bool pindirs); // Formato do side-set
+void sm_config_set_clkdiv(pio_sm_config *c, float div); // Divisor de clock
+void sm_config_set_fifo_join(pio_sm_config *c, enum pio_fifo_join join); // Junção das FIFOs
+void sm_config_set_out_shift(pio_sm_config *c, bool shift_right, bool autopull, uint pull_threshold); // Deslocamento de saída
+void sm_config_set_out_special(pio_sm_config *c, bool sticky, bool has_enable_pin, uint enable_pin_index); // Opções especiais de saída
+
+#endif // HAL_HARDWARE_PIO_H
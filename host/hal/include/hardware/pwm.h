@@ -0,0 +1,23 @@
+#ifndef HAL_HARDWARE_PWM_H
+#define HAL_HARDWARE_PWM_H
+
+#include "pico.h"
+
+typedef struct {
+    float clkdiv;
+    uint16_t wrap;
+    bool phase_correct;
+} pwm_config;
+
+uint pwm_gpio_to_slice_num(uint gpio); // Slice associado ao pino
+uint pwm_gpio_to_channel(uint gpio); // Canal (A/B) associado ao pino
+pwm_config pwm_get_default_config(void); // Configuração padrão
+void pwm_config_set_clkdiv(pwm_config *c, float div); // Divisor de clock
+void pwm_config_set_wrap(pwm_config *c, uint16_t wrap); // Valor de topo
+void pwm_init(uint slice_num, pwm_config *c, bool start); // Aplica a configuração
+void pwm_set_wrap(uint slice_num, uint16_t wrap); // Altera o valor de topo
+void pwm_set_clkdiv(uint slice_num, float divider); // Altera o divisor
+void pwm_set_gpio_level(uint gpio, uint16_t level); // Nível do canal do pino
+void pwm_set_enabled(uint slice_num, bool enabled); // Habilita o slice
+
+#endif // HAL_HARDWARE_PWM_H
@@ -0,0 +1,11 @@
+#ifndef HAL_HARDWARE_RTC_H
+#define HAL_HARDWARE_RTC_H
+
+#include "pico/types.h"
+
+void rtc_init(void); // Inicializa o RTC a partir do relógio do host
+bool rtc_set_datetime(datetime_t *t); // Ajusta data e hora
+bool rtc_get_datetime(datetime_t *t); // Lê data e hora
+bool rtc_running(void); // Verifica se o RTC está em execução
+
+#endif // HAL_HARDWARE_RTC_H
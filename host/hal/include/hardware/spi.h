@@ -0,0 +1,44 @@
+#ifndef HAL_HARDWARE_SPI_H
+#define HAL_HARDWARE_SPI_H
+
+#include "pico.h"
+#include "hardware/gpio.h"
+
+typedef struct spi_inst spi_inst_t;
+
+// Registradores do PL022 usados pelos drivers (endereço de dados para o DMA)
+typedef struct {
+    io_rw_32 cr0;
+    io_rw_32 cr1;
+    io_rw_32 dr;
+    io_ro_32 sr;
+    io_rw_32 cpsr;
+    io_rw_32 imsc;
+    io_ro_32 ris;
+    io_ro_32 mis;
+    io_wo_32 icr;
+    io_rw_32 dmacr;
+} spi_hw_t;
+
+extern spi_inst_t hal_spi0_inst;
+extern spi_inst_t hal_spi1_inst;
+#define spi0 (&hal_spi0_inst)
+#define spi1 (&hal_spi1_inst)
+
+typedef enum { SPI_CPHA_0 = 0, SPI_CPHA_1 = 1 } spi_cpha_t;
+typedef enum { SPI_CPOL_0 = 0, SPI_CPOL_1 = 1 } spi_cpol_t;
+typedef enum { SPI_LSB_FIRST = 0, SPI_MSB_FIRST = 1 } spi_order_t;
+
+uint spi_init(spi_inst_t *spi, uint baudrate); // Inicializa o SPI, retorna a frequência
+void spi_deinit(spi_inst_t *spi); // Desabilita o SPI
+uint spi_set_baudrate(spi_inst_t *spi, uint baudrate); // Altera a frequência
+uint spi_get_baudrate(const spi_inst_t *spi); // Frequência atual
+uint spi_get_index(const spi_inst_t *spi); // Índice do SPI (0 ou 1)
+spi_hw_t *spi_get_hw(spi_inst_t *spi); // Registradores do SPI
+void spi_set_format(spi_inst_t *spi, uint data_bits, spi_cpol_t cpol, spi_cpha_t cpha, spi_order_t order); // Formato do quadro
+bool spi_is_busy(const spi_inst_t *spi); // Verifica se há transferência em curso
+int spi_write_read_blocking(spi_inst_t *spi, const uint8_t *src, uint8_t *dst, size_t len); // Escrita e leitura simultâneas
+int spi_write_blocking(spi_inst_t *spi, const uint8_t *src, size_t len); // Escrita descartando a leitura
+int spi_read_blocking(spi_inst_t *spi, uint8_t repeated_tx_data, uint8_t *dst, size_t len); // Leitura enviando um byte fixo
+
+#endif // HAL_HARDWARE_SPI_H
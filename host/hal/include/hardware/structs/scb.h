@@ -0,0 +1,17 @@
+#ifndef HAL_HARDWARE_STRUCTS_SCB_H
+#define HAL_HARDWARE_STRUCTS_SCB_H
+
+#include "pico.h"
+
+typedef struct {
+    io_rw_32 cpuid;
+    io_rw_32 icsr;
+    io_rw_32 vtor;
+    io_rw_32 aircr;
+    io_rw_32 scr;
+} armv6m_scb_hw_t;
+
+extern armv6m_scb_hw_t hal_scb;
+#define scb_hw (&hal_scb)
+
+#endif // HAL_HARDWARE_STRUCTS_SCB_H
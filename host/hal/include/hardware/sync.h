@@ -0,0 +1,12 @@
+#ifndef HAL_HARDWARE_SYNC_H
+#define HAL_HARDWARE_SYNC_H
+
+#include "pico.h"
+
+static inline uint32_t save_and_disable_interrupts(void) { return 0; }
+static inline void restore_interrupts(uint32_t status) { (void)status; }
+static inline void __dmb(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void __sev(void) {}
+static inline void __wfe(void) {}
+
+#endif // HAL_HARDWARE_SYNC_H
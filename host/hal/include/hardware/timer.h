@@ -0,0 +1,12 @@
+#ifndef HAL_HARDWARE_TIMER_H
+#define HAL_HARDWARE_TIMER_H
+
+#include "pico.h"
+
+uint64_t time_us_64(void); // Microssegundos desde o boot
+uint32_t time_us_32(void); // Microssegundos desde o boot (32 bits)
+void busy_wait_us(uint64_t delay_us); // Espera ativa em microssegundos
+void busy_wait_us_32(uint32_t delay_us); // Espera ativa em microssegundos (32 bits)
+void busy_wait_ms(uint32_t delay_ms); // Espera ativa em milissegundos
+
+#endif // HAL_HARDWARE_TIMER_H
@@ -0,0 +1,6 @@
+#ifndef HAL_HARDWARE_UART_H
+#define HAL_HARDWARE_UART_H
+
+#include "pico.h"
+
+#endif // HAL_HARDWARE_UART_H
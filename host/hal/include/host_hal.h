@@ -0,0 +1,70 @@
+#ifndef HOST_HAL_H
+#define HOST_HAL_H
+
+// Interface de extensão da HAL de simulação: permite conectar modelos de
+// dispositivos em memória aos barramentos usados pelos drivers do projeto.
+
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "hardware/spi.h"
+#include "hardware/pio.h"
+
+// Contadores de tráfego de um barramento simulado
+typedef struct {
+    uint64_t transactions; // Transações (ou transferências) executadas
+    uint64_t bytes_tx; // Bytes enviados pelo mestre
+    uint64_t bytes_rx; // Bytes recebidos pelo mestre
+    uint64_t bytes_flushed; // Bytes descartados da FIFO de transmissão ao desabilitar o controlador
+} hal_bus_stats_t;
+
+// Contadores do controlador de DMA simulado
+typedef struct {
+    uint64_t configures; // Canais configurados (dma_channel_configure/dma_channel_set_config)
+    uint64_t starts;     // Disparos (cada dma_start_channel_mask conta uma vez)
+    uint64_t irqs;       // Linhas de interrupção acionadas
+} hal_dma_stats_t;
+
+// Dispositivo I2C simulado: retorna o número de bytes transferidos ou PICO_ERROR_GENERIC (NACK)
+typedef struct {
+    int (*write)(void *ctx, const uint8_t *src, size_t len, bool nostop);
+    int (*read)(void *ctx, uint8_t *dst, size_t len, bool nostop);
+    void *ctx;
+} hal_i2c_device_t;
+
+// Dispositivo SPI simulado: troca um byte por ciclo (MOSI -> MISO)
+typedef struct {
+    uint8_t (*exchange)(void *ctx, uint8_t out);
+    void *ctx;
+} hal_spi_device_t;
+
+// Consumidor das palavras escritas na FIFO de transmissão de um PIO
+typedef void (*hal_pio_sink_t)(void *ctx, uint sm, uint32_t word);
+
+// Dispositivo I2C genérico de registradores com ponteiro de auto-incremento
+typedef struct {
+    uint8_t regs[256];
+    uint8_t pointer;
+} hal_i2c_mem_t;
+
+void hal_i2c_attach(i2c_inst_t *i2c, uint8_t addr, const hal_i2c_device_t *dev); // Conecta um dispositivo ao endereço
+void hal_i2c_detach(i2c_inst_t *i2c, uint8_t addr); // Desconecta o dispositivo do endereço
+void hal_i2c_mem_attach(i2c_inst_t *i2c, uint8_t addr, hal_i2c_mem_t *mem); // Conecta um banco de registradores
+hal_bus_stats_t *hal_i2c_stats(i2c_inst_t *i2c); // Contadores do barramento I2C
+
+void hal_spi_attach(spi_inst_t *spi, const hal_spi_device_t *dev); // Conecta um dispositivo ao SPI (NULL desconecta)
+hal_bus_stats_t *hal_spi_stats(spi_inst_t *spi); // Contadores do barramento SPI
+
+void hal_gpio_set_input(uint gpio, bool value); // Define o nível lido em um pino de entrada
+bool hal_gpio_get_output(uint gpio); // Nível escrito em um pino de saída
+uint16_t hal_pwm_get_level(uint gpio); // Nível PWM configurado para o pino
+
+void hal_adc_set(uint input, uint16_t value); // Define o valor convertido por um canal do ADC
+
+void hal_pio_set_sink(PIO pio, hal_pio_sink_t sink, void *ctx); // Conecta um consumidor às FIFOs do PIO
+hal_bus_stats_t *hal_pio_stats(PIO pio); // Contadores de palavras escritas no PIO
+
+hal_dma_stats_t *hal_dma_stats(void); // Contadores do DMA
+
+void hal_stats_reset(hal_bus_stats_t *stats); // Zera os contadores
+
+#endif // HOST_HAL_H
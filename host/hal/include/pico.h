@@ -0,0 +1,49 @@
+#ifndef HAL_PICO_H
+#define HAL_PICO_H
+
+// Base da HAL de simulação: tipos e macros que o pico-sdk expõe em "pico.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef unsigned int uint;
+
+typedef volatile uint32_t io_rw_32;
+typedef const volatile uint32_t io_ro_32;
+typedef volatile uint32_t io_wo_32;
+
+#define _u(x) x ## u
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+
+#define __not_in_flash(group)
+#define __not_in_flash_func(func_name) func_name
+#define __time_critical_func(func_name) func_name
+#define __no_inline_not_in_flash_func(func_name) func_name
+#define __scratch_x(group)
+#define __scratch_y(group)
+#define __aligned(x) __attribute__((aligned(x)))
+#ifndef __unused
+#define __unused __attribute__((unused))
+#endif
+
+#define PICO_OK 0
+#define PICO_ERROR_NONE 0
+#define PICO_ERROR_TIMEOUT -1
+#define PICO_ERROR_GENERIC -2
+#define PICO_ERROR_NO_DATA -3
+
+#define hard_assert(x) ((void)0)
+
+void hal_timer_poll(void); // Executa os alarmes vencidos (a simulação não tem interrupção de timer)
+void hal_i2c_poll(void); // Transmite as FIFOs I2C (a simulação não tem o relógio do barramento)
+
+// Laços de espera ativa são os pontos em que os barramentos e os alarmes da simulação avançam
+static inline void tight_loop_contents(void) {
+    hal_i2c_poll();
+    hal_timer_poll();
+}
+
+void panic(const char *fmt, ...) __attribute__((noreturn, format(__printf__, 1, 2)));
+
+#endif // HAL_PICO_H
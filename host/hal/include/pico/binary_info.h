@@ -0,0 +1,11 @@
+#ifndef HAL_PICO_BINARY_INFO_H
+#define HAL_PICO_BINARY_INFO_H
+
+// Metadados de binário não existem no host
+#define bi_decl(_decl)
+#define bi_decl_if_func_used(_decl)
+#define bi_2pins_with_func(p0, p1, func)
+#define bi_1pin_with_name(p0, name)
+#define bi_program_description(desc)
+
+#endif // HAL_PICO_BINARY_INFO_H
@@ -0,0 +1,8 @@
+#ifndef HAL_PICO_BOOTROM_H
+#define HAL_PICO_BOOTROM_H
+
+#include "pico.h"
+
+void reset_usb_boot(uint32_t usb_activity_gpio_pin_mask, uint32_t disable_interface_mask); // Encerra o processo no host
+
+#endif // HAL_PICO_BOOTROM_H
@@ -0,0 +1,24 @@
+#ifndef HAL_PICO_MUTEX_H
+#define HAL_PICO_MUTEX_H
+
+#include <pthread.h>
+#include "pico/types.h"
+#include "pico/time.h" // Como no pico-sdk (via pico/lock_core.h)
+
+// Mutex do pico-sdk implementado sobre pthreads
+typedef struct {
+    pthread_mutex_t mtx;
+    bool initialized;
+} mutex_t;
+
+#define HAL_MUTEX_STATIC_INIT { PTHREAD_MUTEX_INITIALIZER, true }
+#define auto_init_mutex(name) static mutex_t name = HAL_MUTEX_STATIC_INIT
+
+void mutex_init(mutex_t *mtx); // Inicializa o mutex
+bool mutex_is_initialized(mutex_t *mtx); // Verifica se o mutex foi inicializado
+void mutex_enter_blocking(mutex_t *mtx); // Adquire o mutex, bloqueando
+bool mutex_try_enter(mutex_t *mtx, uint32_t *owner_out); // Tenta adquirir o mutex sem bloquear
+bool mutex_enter_timeout_ms(mutex_t *mtx, uint32_t timeout_ms); // Adquire o mutex com tempo limite
+void mutex_exit(mutex_t *mtx); // Libera o mutex
+
+#endif // HAL_PICO_MUTEX_H
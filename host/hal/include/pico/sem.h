@@ -0,0 +1,24 @@
+#ifndef HAL_PICO_SEM_H
+#define HAL_PICO_SEM_H
+
+#include <pthread.h>
+#include "pico/types.h"
+#include "pico/time.h"
+
+// Semáforo contador do pico-sdk implementado sobre pthreads
+typedef struct {
+    pthread_mutex_t mtx;
+    pthread_cond_t cond;
+    int16_t permits;
+    int16_t max_permits;
+} semaphore_t;
+
+void sem_init(semaphore_t *sem, int16_t initial_permits, int16_t max_permits); // Inicializa o semáforo
+int sem_available(semaphore_t *sem); // Retorna as permissões disponíveis
+bool sem_release(semaphore_t *sem); // Libera uma permissão
+void sem_reset(semaphore_t *sem, int16_t permits); // Redefine as permissões
+void sem_acquire_blocking(semaphore_t *sem); // Adquire uma permissão, bloqueando
+bool sem_acquire_timeout_ms(semaphore_t *sem, uint32_t timeout_ms); // Adquire uma permissão com tempo limite
+bool sem_try_acquire(semaphore_t *sem); // Tenta adquirir sem bloquear
+
+#endif // HAL_PICO_SEM_H
@@ -0,0 +1,9 @@
+#ifndef HAL_PICO_STDIO_H
+#define HAL_PICO_STDIO_H
+
+#include <stdio.h>
+#include "pico.h"
+
+bool stdio_init_all(void); // No host a saída padrão já está disponível
+
+#endif // HAL_PICO_STDIO_H
@@ -0,0 +1,11 @@
+#ifndef HAL_PICO_STDLIB_H
+#define HAL_PICO_STDLIB_H
+
+#include "pico.h"
+#include "pico/types.h"
+#include "pico/stdio.h"
+#include "pico/time.h"
+#include "hardware/gpio.h"
+#include "hardware/uart.h"
+
+#endif // HAL_PICO_STDLIB_H
@@ -0,0 +1,40 @@
+#ifndef HAL_PICO_TIME_H
+#define HAL_PICO_TIME_H
+
+#include "pico/types.h"
+#include "hardware/timer.h"
+
+absolute_time_t get_absolute_time(void); // Instante atual
+absolute_time_t make_timeout_time_ms(uint32_t ms); // Instante daqui a ms milissegundos
+absolute_time_t make_timeout_time_us(uint64_t us); // Instante daqui a us microssegundos
+int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to); // Diferença to - from em microssegundos
+uint32_t to_ms_since_boot(absolute_time_t t); // Converte para milissegundos desde o boot
+uint64_t to_us_since_boot(absolute_time_t t); // Converte para microssegundos desde o boot
+bool time_reached(absolute_time_t t); // Verifica se o instante já passou
+void sleep_ms(uint32_t ms); // Dorme por ms milissegundos
+void sleep_us(uint64_t us); // Dorme por us microssegundos
+
+// Alarmes: na simulação, disparam em tight_loop_contents, sleep_* e busy_wait_*
+typedef int32_t alarm_id_t; // Identificador de alarme (> 0)
+typedef int64_t (*alarm_callback_t)(alarm_id_t id, void *user_data); // Retorna 0, ou o próximo disparo em us (> 0: após o retorno; < 0: após o previsto)
+
+alarm_id_t add_alarm_at(absolute_time_t time, alarm_callback_t callback, void *user_data, bool fire_if_past); // Agenda um alarme num instante
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past); // Agenda um alarme daqui a us microssegundos
+alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void *user_data, bool fire_if_past); // Agenda um alarme daqui a ms milissegundos
+bool cancel_alarm(alarm_id_t alarm_id); // Cancela um alarme pendente
+
+// Timer periódico sobre os alarmes
+typedef struct repeating_timer repeating_timer_t;
+typedef bool (*repeating_timer_callback_t)(repeating_timer_t *rt); // Retorna false para parar
+struct repeating_timer {
+    int64_t delay_us; // > 0: entre o fim de um disparo e o início do próximo; < 0: entre inícios
+    alarm_id_t alarm_id;
+    repeating_timer_callback_t callback;
+    void *user_data;
+};
+
+bool add_repeating_timer_us(int64_t delay_us, repeating_timer_callback_t callback, void *user_data, repeating_timer_t *out); // Inicia um timer periódico
+bool add_repeating_timer_ms(int32_t delay_ms, repeating_timer_callback_t callback, void *user_data, repeating_timer_t *out); // Inicia um timer periódico
+bool cancel_repeating_timer(repeating_timer_t *timer); // Para o timer periódico
+
+#endif // HAL_PICO_TIME_H
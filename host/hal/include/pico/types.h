@@ -0,0 +1,19 @@
+#ifndef HAL_PICO_TYPES_H
+#define HAL_PICO_TYPES_H
+
+#include "pico.h"
+
+typedef uint64_t absolute_time_t; // Microssegundos desde o boot (relógio monotônico do host)
+
+// Estrutura de data e hora do RTC
+typedef struct {
+    int16_t year;
+    int8_t month;
+    int8_t day;
+    int8_t dotw;
+    int8_t hour;
+    int8_t min;
+    int8_t sec;
+} datetime_t;
+
+#endif // HAL_PICO_TYPES_H
@@ -0,0 +1,6 @@
+#ifndef HAL_PICO_UTIL_DATETIME_H
+#define HAL_PICO_UTIL_DATETIME_H
+
+#include "pico/types.h"
+
+#endif // HAL_PICO_UTIL_DATETIME_H
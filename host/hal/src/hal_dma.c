@@ -0,0 +1,459 @@
+#include <string.h>
+#include "hal_internal.h"
+
+// As transferências simuladas são executadas de forma síncrona no disparo do canal,
+// e as interrupções de término são entregues antes do retorno.
+
+#define HAL_IRQ_MAX_HANDLERS 4
+
+dma_hw_t hal_dma_hw;
+static hal_dma_stats_t stats;
+
+static struct {
+    bool claimed;
+    bool busy;
+    bool irq0;
+    bool irq1;
+    dma_channel_config cfg;
+    volatile void *write_addr;
+    const volatile void *read_addr;
+    uint32_t count;
+} channels[NUM_DMA_CHANNELS];
+
+static uint32_t pending_irq0, pending_irq1;
+
+static struct {
+    irq_handler_t handlers[HAL_IRQ_MAX_HANDLERS];
+    uint num_handlers;
+    bool exclusive;
+    bool enabled;
+} irqs[NUM_IRQS];
+
+// Como no pico-sdk, tratadores exclusivos e compartilhados não convivem na mesma linha
+void irq_set_exclusive_handler(uint num, irq_handler_t handler) {
+    if (irqs[num].num_handlers && !(irqs[num].exclusive && irqs[num].handlers[0] == handler))
+        panic("irq_set_exclusive_handler: IRQ %u already has a handler", num);
+    irqs[num].handlers[0] = handler;
+    irqs[num].num_handlers = 1;
+    irqs[num].exclusive = true;
+}
+
+void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority) {
+    (void)order_priority;
+    if (irqs[num].exclusive)
+        panic("irq_add_shared_handler: IRQ %u has an exclusive handler", num);
+    if (irqs[num].num_handlers >= HAL_IRQ_MAX_HANDLERS)
+        panic("irq_add_shared_handler: too many handlers on IRQ %u", num);
+    irqs[num].handlers[irqs[num].num_handlers++] = handler;
+}
+
+void irq_remove_handler(uint num, irq_handler_t handler) {
+    for (uint i = 0; i < irqs[num].num_handlers; ++i) {
+        if (irqs[num].handlers[i] == handler) {
+            irqs[num].handlers[i] = irqs[num].handlers[--irqs[num].num_handlers];
+            irqs[num].exclusive = irqs[num].exclusive && irqs[num].num_handlers;
+            return;
+        }
+    }
+}
+
+void irq_set_enabled(uint num, bool enabled) {
+    irqs[num].enabled = enabled;
+}
+
+bool irq_is_enabled(uint num) {
+    return irqs[num].enabled;
+}
+
+/**
+ * @brief Executa os tratadores registrados na linha de interrupção, se habilitada
+ * @param num Número da interrupção
+ */
+void hal_irq_raise(uint num) {
+    if (!irqs[num].enabled)
+        return;
+    for (uint i = 0; i < irqs[num].num_handlers; ++i)
+        irqs[num].handlers[i]();
+}
+
+int dma_claim_unused_channel(bool required) {
+    for (uint ch = 0; ch < NUM_DMA_CHANNELS; ++ch) {
+        if (!channels[ch].claimed) {
+            channels[ch].claimed = true;
+            return (int)ch;
+        }
+    }
+    if (required)
+        panic("No DMA channels are available");
+    return -1;
+}
+
+void dma_channel_claim(uint channel) {
+    if (channels[channel].claimed)
+        panic("DMA channel %u is already claimed", channel);
+    channels[channel].claimed = true;
+}
+
+void dma_channel_unclaim(uint channel) {
+    channels[channel].claimed = false;
+}
+
+bool dma_channel_is_claimed(uint channel) {
+    return channels[channel].claimed;
+}
+
+dma_channel_config dma_channel_get_default_config(uint channel) {
+    dma_channel_config c = {
+        .read_increment = true,
+        .write_increment = false,
+        .dreq = DREQ_FORCE,
+        .size = DMA_SIZE_32,
+        .chain_to = channel,
+        .irq_quiet = false,
+        .enable = true,
+    };
+    return c;
+}
+
+dma_channel_config dma_get_channel_config(uint channel) {
+    return channels[channel].cfg;
+}
+
+void channel_config_set_read_increment(dma_channel_config *c, bool incr) {
+    c->read_increment = incr;
+}
+
+void channel_config_set_write_increment(dma_channel_config *c, bool incr) {
+    c->write_increment = incr;
+}
+
+void channel_config_set_dreq(dma_channel_config *c, uint dreq) {
+    c->dreq = dreq;
+}
+
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size) {
+    c->size = size;
+}
+
+void channel_config_set_chain_to(dma_channel_config *c, uint chain_to) {
+    c->chain_to = chain_to;
+}
+
+void channel_config_set_irq_quiet(dma_channel_config *c, bool irq_quiet) {
+    c->irq_quiet = irq_quiet;
+}
+
+void channel_config_set_enable(dma_channel_config *c, bool enable) {
+    c->enable = enable;
+}
+
+void channel_config_set_bswap(dma_channel_config *c, bool bswap) {
+    c->bswap = bswap;
+}
+
+void channel_config_set_sniff_enable(dma_channel_config *c, bool sniff_enable) {
+    c->sniff_enable = sniff_enable;
+}
+
+/**
+ * @brief Lê um elemento da origem do canal
+ * @param ch Canal
+ * @param i Índice do elemento
+ * @return Valor lido
+ */
+static uint32_t read_elem(uint ch, uint32_t i) {
+    uint size = 1u << channels[ch].cfg.size;
+    const volatile uint8_t *p = (const volatile uint8_t *)channels[ch].read_addr;
+    if (channels[ch].cfg.read_increment)
+        p += (size_t)i * size;
+    switch (channels[ch].cfg.size) {
+    case DMA_SIZE_8:
+        return *p;
+    case DMA_SIZE_16:
+        return *(const volatile uint16_t *)p;
+    default:
+        return *(const volatile uint32_t *)p;
+    }
+}
+
+/**
+ * @brief Escreve um elemento no destino do canal
+ * @param ch Canal
+ * @param i Índice do elemento
+ * @param value Valor escrito
+ */
+static void write_elem(uint ch, uint32_t i, uint32_t value) {
+    uint size = 1u << channels[ch].cfg.size;
+    volatile uint8_t *p = (volatile uint8_t *)channels[ch].write_addr;
+    if (channels[ch].cfg.write_increment)
+        p += (size_t)i * size;
+    switch (channels[ch].cfg.size) {
+    case DMA_SIZE_8:
+        *p = (uint8_t)value;
+        break;
+    case DMA_SIZE_16:
+        *(volatile uint16_t *)p = (uint16_t)value;
+        break;
+    default:
+        *(volatile uint32_t *)p = value;
+        break;
+    }
+}
+
+/**
+ * @brief Procura entre os canais ocupados o canal de recepção pareado com o DREQ
+ * @param dreq DREQ de recepção
+ * @return Canal ou -1
+ */
+static int find_busy_channel(uint dreq) {
+    for (uint ch = 0; ch < NUM_DMA_CHANNELS; ++ch)
+        if (channels[ch].busy && channels[ch].cfg.dreq == dreq)
+            return (int)ch;
+    return -1;
+}
+
+static void complete_channel(uint ch);
+
+// Campos de SNIFF_CTRL, como no RP2040
+#define SNIFF_CTRL_EN 0x1u
+#define SNIFF_CTRL_DMACH_LSB 1
+#define SNIFF_CTRL_CALC_LSB 5
+
+/**
+ * @brief Acumula no sniffer um elemento que passou pelo canal
+ * @param ch Canal
+ * @param value Elemento
+ */
+static void sniff(uint ch, uint32_t value) {
+    uint32_t ctrl = hal_dma_hw.sniff_ctrl;
+    if (!(ctrl & SNIFF_CTRL_EN) || ((ctrl >> SNIFF_CTRL_DMACH_LSB) & 0xf) != ch || !channels[ch].cfg.sniff_enable)
+        return;
+    if (DMA_SNIFF_CTRL_CALC_VALUE_CRC16 != ((ctrl >> SNIFF_CTRL_CALC_LSB) & 0xf))
+        panic("dma sniffer: only CRC16 is simulated");
+    uint32_t crc = hal_dma_hw.sniff_data;
+    for (int bit = 8 * (1 << channels[ch].cfg.size) - 1; bit >= 0; --bit) {
+        bool feedback = ((crc >> 15) ^ (value >> bit)) & 1u;
+        crc = (crc << 1) & 0xffffu;
+        if (feedback)
+            crc ^= 0x1021u;
+    }
+    hal_dma_hw.sniff_data = crc;
+}
+
+/**
+ * @brief Executa a transferência de um canal (e do canal de recepção SPI pareado)
+ * @param ch Canal
+ */
+static void run_channel(uint ch) {
+    if (!channels[ch].busy)
+        return;
+    uint dreq = channels[ch].cfg.dreq;
+    spi_inst_t *spi = hal_spi_from_dreq(dreq);
+    uint sm;
+    PIO pio;
+    i2c_inst_t *i2c;
+    if (spi && (dreq == DREQ_SPI0_TX || dreq == DREQ_SPI1_TX)) {
+        // O canal de transmissão cadencia o barramento; o de recepção acompanha.
+        // Quando o canal de recepção termina, o encadeado assume os bytes seguintes.
+        int rx = find_busy_channel(dreq + 1);
+        uint32_t rx_i = 0;
+        spi->stats.transactions++;
+        for (uint32_t i = 0; i < channels[ch].count; ++i) {
+            uint32_t out = read_elem(ch, i);
+            sniff(ch, out);
+            uint8_t in = hal_spi_exchange(spi, (uint8_t)out);
+            if (rx >= 0) {
+                sniff((uint)rx, in);
+                write_elem((uint)rx, rx_i++, in);
+                if (rx_i == channels[rx].count) {
+                    complete_channel((uint)rx);
+                    rx = find_busy_channel(dreq + 1);
+                    rx_i = 0;
+                }
+            }
+        }
+        complete_channel(ch);
+    } else if (spi) {
+        // Recepção sem transmissão: aguarda o canal de transmissão pareado
+        return;
+    } else if ((pio = hal_pio_from_dreq(dreq, &sm))) {
+        for (uint32_t i = 0; i < channels[ch].count; ++i) {
+            uint32_t value = read_elem(ch, i);
+            sniff(ch, value);
+            hal_pio_push(pio, sm, value);
+        }
+        complete_channel(ch);
+    } else if ((i2c = hal_i2c_from_dreq(dreq))) {
+        for (uint32_t i = 0; i < channels[ch].count; ++i) {
+            uint32_t value = read_elem(ch, i);
+            sniff(ch, value);
+            hal_i2c_push(i2c, value);
+        }
+        complete_channel(ch);
+    } else {
+        for (uint32_t i = 0; i < channels[ch].count; ++i) {
+            uint32_t value = read_elem(ch, i);
+            sniff(ch, value);
+            write_elem(ch, i, value);
+        }
+        complete_channel(ch);
+    }
+}
+
+/**
+ * @brief Finaliza o canal: sinaliza a interrupção e dispara o encadeamento
+ * @param ch Canal
+ */
+static void complete_channel(uint ch) {
+    channels[ch].busy = false;
+    if (!channels[ch].cfg.irq_quiet) {
+        if (channels[ch].irq0)
+            pending_irq0 |= 1u << ch;
+        if (channels[ch].irq1)
+            pending_irq1 |= 1u << ch;
+    }
+    uint chain = channels[ch].cfg.chain_to;
+    if (chain != ch && chain < NUM_DMA_CHANNELS) {
+        channels[chain].busy = true;
+        run_channel(chain);
+    }
+}
+
+/**
+ * @brief Entrega as interrupções pendentes; os tratadores as reconhecem ao retornar
+ */
+static void deliver_irqs(void) {
+    if (pending_irq0) {
+        stats.irqs++;
+        hal_dma_hw.ints0 = pending_irq0;
+        hal_irq_raise(DMA_IRQ_0);
+        pending_irq0 = 0;
+        hal_dma_hw.ints0 = 0;
+    }
+    if (pending_irq1) {
+        stats.irqs++;
+        hal_dma_hw.ints1 = pending_irq1;
+        hal_irq_raise(DMA_IRQ_1);
+        pending_irq1 = 0;
+        hal_dma_hw.ints1 = 0;
+    }
+}
+
+void dma_start_channel_mask(uint32_t chan_mask) {
+    stats.starts++;
+    for (uint ch = 0; ch < NUM_DMA_CHANNELS; ++ch)
+        if (chan_mask & (1u << ch))
+            channels[ch].busy = true;
+    for (uint ch = 0; ch < NUM_DMA_CHANNELS; ++ch)
+        if (chan_mask & (1u << ch))
+            run_channel(ch);
+    deliver_irqs();
+}
+
+void dma_channel_start(uint channel) {
+    dma_start_channel_mask(1u << channel);
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger) {
+    stats.configures++;
+    channels[channel].cfg = *config;
+    channels[channel].write_addr = write_addr;
+    channels[channel].read_addr = read_addr;
+    channels[channel].count = transfer_count;
+    if (trigger)
+        dma_channel_start(channel);
+}
+
+void dma_channel_set_config(uint channel, const dma_channel_config *config, bool trigger) {
+    stats.configures++;
+    channels[channel].cfg = *config;
+    if (trigger)
+        dma_channel_start(channel);
+}
+
+void dma_channel_set_read_addr(uint channel, const volatile void *read_addr, bool trigger) {
+    channels[channel].read_addr = read_addr;
+    if (trigger)
+        dma_channel_start(channel);
+}
+
+void dma_channel_set_write_addr(uint channel, volatile void *write_addr, bool trigger) {
+    channels[channel].write_addr = write_addr;
+    if (trigger)
+        dma_channel_start(channel);
+}
+
+void dma_channel_set_trans_count(uint channel, uint32_t trans_count, bool trigger) {
+    channels[channel].count = trans_count;
+    if (trigger)
+        dma_channel_start(channel);
+}
+
+void dma_channel_transfer_from_buffer_now(uint channel, const volatile void *read_addr, uint32_t transfer_count) {
+    channels[channel].read_addr = read_addr;
+    channels[channel].count = transfer_count;
+    dma_channel_start(channel);
+}
+
+void dma_channel_abort(uint channel) {
+    channels[channel].busy = false;
+}
+
+bool dma_channel_is_busy(uint channel) {
+    return channels[channel].busy;
+}
+
+void dma_channel_wait_for_finish_blocking(uint channel) {
+    (void)channel;
+}
+
+void dma_channel_set_irq0_enabled(uint channel, bool enabled) {
+    channels[channel].irq0 = enabled;
+}
+
+void dma_channel_set_irq1_enabled(uint channel, bool enabled) {
+    channels[channel].irq1 = enabled;
+}
+
+bool dma_channel_get_irq0_status(uint channel) {
+    return pending_irq0 & (1u << channel);
+}
+
+bool dma_channel_get_irq1_status(uint channel) {
+    return pending_irq1 & (1u << channel);
+}
+
+void dma_channel_acknowledge_irq0(uint channel) {
+    pending_irq0 &= ~(1u << channel);
+}
+
+void dma_channel_acknowledge_irq1(uint channel) {
+    pending_irq1 &= ~(1u << channel);
+}
+
+void dma_sniffer_enable(uint channel, uint mode, bool force_channel_enable) {
+    hal_dma_hw.sniff_ctrl = SNIFF_CTRL_EN | (channel << SNIFF_CTRL_DMACH_LSB) | (mode << SNIFF_CTRL_CALC_LSB);
+    if (force_channel_enable)
+        channels[channel].cfg.sniff_enable = true;
+}
+
+void dma_sniffer_disable(void) {
+    hal_dma_hw.sniff_ctrl = 0;
+}
+
+void dma_sniffer_set_data_accumulator(uint32_t seed_value) {
+    hal_dma_hw.sniff_data = seed_value;
+}
+
+uint32_t dma_sniffer_get_data_accumulator(void) {
+    return hal_dma_hw.sniff_data;
+}
+
+/**
+ * @brief Contadores do DMA
+ * @return Ponteiro para os contadores
+ */
+hal_dma_stats_t *hal_dma_stats(void) {
+    return &stats;
+}
@@ -0,0 +1,180 @@
+#include "hal_internal.h"
+#include "hardware/adc.h"
+#include "hardware/pwm.h"
+
+#define HAL_ADC_INPUTS 5
+
+static struct {
+    bool out; // Direção
+    bool level; // Nível escrito
+    bool input; // Nível lido quando o pino é entrada
+    enum gpio_function function;
+    gpio_irq_callback_t callback;
+    uint32_t irq_mask;
+    uint16_t pwm_level;
+} gpios[NUM_BANK0_GPIOS];
+
+static uint16_t adc_values[HAL_ADC_INPUTS];
+static uint adc_input;
+
+void gpio_init(uint gpio) {
+    gpios[gpio].out = false;
+    gpios[gpio].level = false;
+    gpios[gpio].function = GPIO_FUNC_SIO;
+}
+
+void gpio_set_dir(uint gpio, bool out) {
+    gpios[gpio].out = out;
+}
+
+void gpio_put(uint gpio, bool value) {
+    gpios[gpio].level = value;
+}
+
+bool gpio_get(uint gpio) {
+    return gpios[gpio].out ? gpios[gpio].level : gpios[gpio].input;
+}
+
+void gpio_pull_up(uint gpio) {
+    gpios[gpio].input = true;
+}
+
+void gpio_pull_down(uint gpio) {
+    gpios[gpio].input = false;
+}
+
+void gpio_set_function(uint gpio, enum gpio_function fn) {
+    gpios[gpio].function = fn;
+}
+
+enum gpio_function gpio_get_function(uint gpio) {
+    return gpios[gpio].function;
+}
+
+bool gpio_is_dir_out(uint gpio) {
+    return gpios[gpio].out;
+}
+
+void gpio_set_drive_strength(uint gpio, enum gpio_drive_strength drive) {
+    (void)gpio;
+    (void)drive;
+}
+
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t event_mask, bool enabled, gpio_irq_callback_t callback) {
+    gpios[gpio].irq_mask = enabled ? event_mask : 0;
+    gpios[gpio].callback = callback;
+}
+
+/**
+ * @brief Define o nível lido em um pino de entrada, disparando a interrupção de borda registrada
+ * @param gpio Pino
+ * @param value Nível lógico
+ */
+void hal_gpio_set_input(uint gpio, bool value) {
+    bool old = gpios[gpio].input;
+    gpios[gpio].input = value;
+    uint32_t event = 0;
+    if (old && !value)
+        event = GPIO_IRQ_EDGE_FALL;
+    else if (!old && value)
+        event = GPIO_IRQ_EDGE_RISE;
+    if (event & gpios[gpio].irq_mask && gpios[gpio].callback)
+        gpios[gpio].callback(gpio, event);
+}
+
+/**
+ * @brief Nível escrito em um pino de saída
+ * @param gpio Pino
+ * @return Nível lógico
+ */
+bool hal_gpio_get_output(uint gpio) {
+    return gpios[gpio].level;
+}
+
+void adc_init(void) {
+    adc_input = 0;
+}
+
+void adc_gpio_init(uint gpio) {
+    gpios[gpio].function = GPIO_FUNC_NULL;
+}
+
+void adc_select_input(uint input) {
+    adc_input = input % HAL_ADC_INPUTS;
+}
+
+uint adc_get_selected_input(void) {
+    return adc_input;
+}
+
+uint16_t adc_read(void) {
+    return adc_values[adc_input] & 0x0FFF;
+}
+
+void adc_set_temp_sensor_enabled(bool enable) {
+    (void)enable;
+}
+
+/**
+ * @brief Define o valor convertido por um canal do ADC
+ * @param input Canal (0 a 4)
+ * @param value Valor de 12 bits
+ */
+void hal_adc_set(uint input, uint16_t value) {
+    adc_values[input % HAL_ADC_INPUTS] = value;
+}
+
+uint pwm_gpio_to_slice_num(uint gpio) {
+    return (gpio >> 1u) & 7u;
+}
+
+uint pwm_gpio_to_channel(uint gpio) {
+    return gpio & 1u;
+}
+
+pwm_config pwm_get_default_config(void) {
+    pwm_config c = {.clkdiv = 1.0f, .wrap = 0xFFFF, .phase_correct = false};
+    return c;
+}
+
+void pwm_config_set_clkdiv(pwm_config *c, float div) {
+    c->clkdiv = div;
+}
+
+void pwm_config_set_wrap(pwm_config *c, uint16_t wrap) {
+    c->wrap = wrap;
+}
+
+void pwm_init(uint slice_num, pwm_config *c, bool start) {
+    (void)slice_num;
+    (void)c;
+    (void)start;
+}
+
+void pwm_set_wrap(uint slice_num, uint16_t wrap) {
+    (void)slice_num;
+    (void)wrap;
+}
+
+void pwm_set_clkdiv(uint slice_num, float divider) {
+    (void)slice_num;
+    (void)divider;
+}
+
+void pwm_set_gpio_level(uint gpio, uint16_t level) {
+    gpios[gpio].pwm_level = level;
+}
+
+void pwm_set_enabled(uint slice_num, bool enabled) {
+    (void)slice_num;
+    (void)enabled;
+}
+
+/**
+ * @brief Nível PWM configurado para o pino
+ * @param gpio Pino
+ * @return Nível do canal
+ */
+uint16_t hal_pwm_get_level(uint gpio) {
+    return gpios[gpio].pwm_level;
+}
@@ -0,0 +1,261 @@
+#include <pthread.h>
+#include <string.h>
+#include "hal_internal.h"
+
+#define I2C_IDLE_STATUS I2C_IC_STATUS_TFE_BITS
+
+i2c_inst_t hal_i2c0_inst = {.index = 0, .hw.status = I2C_IDLE_STATUS};
+i2c_inst_t hal_i2c1_inst = {.index = 1, .hw.status = I2C_IDLE_STATUS};
+
+// Protege as FIFOs: o DMA e as esperas podem estar em threads diferentes
+static pthread_mutex_t fifo_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief Procura o dispositivo conectado ao endereço
+ * @param i2c Barramento
+ * @param addr Endereço de 7 bits
+ * @return Ponteiro para o dispositivo ou NULL
+ */
+static hal_i2c_device_t *find_device(i2c_inst_t *i2c, uint8_t addr) {
+    for (uint i = 0; i < i2c->num_devices; ++i)
+        if (i2c->addrs[i] == addr)
+            return &i2c->devices[i];
+    return NULL;
+}
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate) {
+    i2c->baudrate = baudrate;
+    return baudrate;
+}
+
+void i2c_deinit(i2c_inst_t *i2c) {
+    i2c->baudrate = 0;
+}
+
+uint i2c_set_baudrate(i2c_inst_t *i2c, uint baudrate) {
+    i2c->baudrate = baudrate;
+    return baudrate;
+}
+
+uint i2c_hw_index(i2c_inst_t *i2c) {
+    return i2c->index;
+}
+
+i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c) {
+    return &i2c->hw;
+}
+
+uint i2c_get_dreq(i2c_inst_t *i2c, bool is_tx) {
+    return DREQ_I2C0_TX + 2 * i2c->index + (is_tx ? 0 : 1);
+}
+
+// IC_STATUS é somente leitura para os drivers; só o modelo do controlador o altera
+static void set_status(i2c_inst_t *i2c, uint32_t status) {
+    *(io_rw_32 *)&i2c->hw.status = status;
+}
+
+/**
+ * @brief Desabilita e reabilita o controlador para trocar o TAR, como o pico-sdk
+ *
+ * Desabilitar o DW_apb_i2c descarta a FIFO de transmissão: palavras do DMA
+ * que ainda não saíram, e a transação que elas completariam, se perdem.
+ */
+static void retarget(i2c_inst_t *i2c, uint8_t addr) {
+    pthread_mutex_lock(&fifo_mutex);
+    i2c->stats.bytes_flushed += i2c->tx_len;
+    i2c->tx_len = 0;
+    i2c->dma_len = 0;
+    i2c->hw.tar = addr;
+    set_status(i2c, I2C_IDLE_STATUS);
+    pthread_mutex_unlock(&fifo_mutex);
+}
+
+/**
+ * @brief Entrega uma transação de escrita ao dispositivo do endereço
+ */
+static int deliver_write(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    i2c->stats.transactions++;
+    hal_i2c_device_t *dev = find_device(i2c, addr);
+    if (!dev || !dev->write)
+        return PICO_ERROR_GENERIC;
+    int rc = dev->write(dev->ctx, src, len, nostop);
+    if (rc > 0)
+        i2c->stats.bytes_tx += (uint64_t)rc;
+    return rc;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    retarget(i2c, addr);
+    return deliver_write(i2c, addr, src, len, nostop);
+}
+
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop) {
+    retarget(i2c, addr);
+    i2c->stats.transactions++;
+    hal_i2c_device_t *dev = find_device(i2c, addr);
+    if (!dev || !dev->read)
+        return PICO_ERROR_GENERIC;
+    int rc = dev->read(dev->ctx, dst, len, nostop);
+    if (rc > 0)
+        i2c->stats.bytes_rx += (uint64_t)rc;
+    return rc;
+}
+
+int i2c_write_timeout_us(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop, uint timeout_us) {
+    (void)timeout_us;
+    return i2c_write_blocking(i2c, addr, src, len, nostop);
+}
+
+int i2c_read_timeout_us(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop, uint timeout_us) {
+    (void)timeout_us;
+    return i2c_read_blocking(i2c, addr, dst, len, nostop);
+}
+
+/**
+ * @brief I2C cuja FIFO de transmissão é cadenciada pelo DREQ
+ * @param dreq DREQ
+ * @return Barramento ou NULL
+ */
+i2c_inst_t *hal_i2c_from_dreq(uint dreq) {
+    switch (dreq) {
+    case DREQ_I2C0_TX:
+        return &hal_i2c0_inst;
+    case DREQ_I2C1_TX:
+        return &hal_i2c1_inst;
+    default:
+        return NULL;
+    }
+}
+
+/**
+ * @brief Coloca uma palavra de IC_DATA_CMD na FIFO de transmissão
+ *
+ * A palavra só sai no barramento em hal_i2c_poll: até lá o controlador
+ * está ativo (IC_STATUS sem TFE e com MST_ACTIVITY).
+ * @param i2c Barramento
+ * @param cmd Palavra de IC_DATA_CMD
+ */
+void hal_i2c_push(i2c_inst_t *i2c, uint32_t cmd) {
+    pthread_mutex_lock(&fifo_mutex);
+    if (i2c->tx_len >= HAL_I2C_FIFO_MAX)
+        panic("hal_i2c_push: more than %u words queued on i2c%u", HAL_I2C_FIFO_MAX, i2c->index);
+    i2c->tx_fifo[i2c->tx_len++] = (uint16_t)cmd;
+    set_status(i2c, I2C_IC_STATUS_MST_ACTIVITY_BITS);
+    pthread_mutex_unlock(&fifo_mutex);
+}
+
+/**
+ * @brief Transmite a FIFO de um barramento; o bit STOP entrega a transação ao endereço de TAR
+ */
+static void drain(i2c_inst_t *i2c) {
+    for (size_t i = 0; i < i2c->tx_len; ++i) {
+        uint16_t cmd = i2c->tx_fifo[i];
+        if (i2c->dma_len >= sizeof i2c->dma_pending)
+            panic("hal_i2c_push: transaction longer than %u bytes on i2c%u", HAL_I2C_DMA_MAX, i2c->index);
+        i2c->dma_pending[i2c->dma_len++] = (uint8_t)cmd;
+        if (cmd & I2C_IC_DATA_CMD_STOP_BITS) {
+            deliver_write(i2c, (uint8_t)i2c->hw.tar, i2c->dma_pending, i2c->dma_len, false);
+            i2c->dma_len = 0;
+        }
+    }
+    i2c->tx_len = 0;
+    set_status(i2c, I2C_IDLE_STATUS);
+}
+
+/**
+ * @brief Transmite o que os DMAs deixaram nas FIFOs I2C
+ *
+ * Chamada nas esperas (tight_loop_contents, sleep_*, busy_wait_*), que
+ * fazem o papel do tempo de barramento.
+ */
+void hal_i2c_poll(void) {
+    if (pthread_mutex_trylock(&fifo_mutex))
+        return;
+    if (hal_i2c0_inst.tx_len)
+        drain(&hal_i2c0_inst);
+    if (hal_i2c1_inst.tx_len)
+        drain(&hal_i2c1_inst);
+    pthread_mutex_unlock(&fifo_mutex);
+}
+
+/**
+ * @brief Conecta um dispositivo simulado ao endereço, substituindo o anterior
+ * @param i2c Barramento
+ * @param addr Endereço de 7 bits
+ * @param dev Dispositivo (copiado)
+ */
+void hal_i2c_attach(i2c_inst_t *i2c, uint8_t addr, const hal_i2c_device_t *dev) {
+    hal_i2c_device_t *slot = find_device(i2c, addr);
+    if (!slot) {
+        if (i2c->num_devices >= HAL_I2C_MAX_DEVICES)
+            panic("hal_i2c_attach: too many devices on i2c%u", i2c->index);
+        i2c->addrs[i2c->num_devices] = addr;
+        slot = &i2c->devices[i2c->num_devices++];
+    }
+    *slot = *dev;
+}
+
+/**
+ * @brief Desconecta o dispositivo do endereço
+ * @param i2c Barramento
+ * @param addr Endereço de 7 bits
+ */
+void hal_i2c_detach(i2c_inst_t *i2c, uint8_t addr) {
+    for (uint i = 0; i < i2c->num_devices; ++i) {
+        if (i2c->addrs[i] == addr) {
+            --i2c->num_devices;
+            i2c->addrs[i] = i2c->addrs[i2c->num_devices];
+            i2c->devices[i] = i2c->devices[i2c->num_devices];
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Contadores do barramento I2C
+ * @param i2c Barramento
+ * @return Ponteiro para os contadores
+ */
+hal_bus_stats_t *hal_i2c_stats(i2c_inst_t *i2c) {
+    return &i2c->stats;
+}
+
+// Escrita no banco de registradores: o primeiro byte posiciona o ponteiro
+static int mem_write(void *ctx, const uint8_t *src, size_t len, bool nostop) {
+    (void)nostop;
+    hal_i2c_mem_t *mem = ctx;
+    if (len) {
+        mem->pointer = src[0];
+        for (size_t i = 1; i < len; ++i)
+            mem->regs[mem->pointer++] = src[i];
+    }
+    return (int)len;
+}
+
+// Leitura do banco de registradores a partir do ponteiro atual
+static int mem_read(void *ctx, uint8_t *dst, size_t len, bool nostop) {
+    (void)nostop;
+    hal_i2c_mem_t *mem = ctx;
+    for (size_t i = 0; i < len; ++i)
+        dst[i] = mem->regs[mem->pointer++];
+    return (int)len;
+}
+
+/**
+ * @brief Conecta um banco de registradores com auto-incremento ao endereço
+ * @param i2c Barramento
+ * @param addr Endereço de 7 bits
+ * @param mem Banco de registradores
+ */
+void hal_i2c_mem_attach(i2c_inst_t *i2c, uint8_t addr, hal_i2c_mem_t *mem) {
+    hal_i2c_device_t dev = {.write = mem_write, .read = mem_read, .ctx = mem};
+    hal_i2c_attach(i2c, addr, &dev);
+}
+
+/**
+ * @brief Zera os contadores
+ * @param stats Contadores
+ */
+void hal_stats_reset(hal_bus_stats_t *stats) {
+    memset(stats, 0, sizeof *stats);
+}
@@ -0,0 +1,45 @@
+#ifndef HAL_INTERNAL_H
+#define HAL_INTERNAL_H
+
+// Estado interno compartilhado entre os módulos da HAL de simulação
+
+#include "host_hal.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+#define HAL_I2C_MAX_DEVICES 8
+#define HAL_I2C_DMA_MAX 2048 // Maior transação escrita pelo DMA em IC_DATA_CMD
+#define HAL_I2C_FIFO_MAX 4096 // Palavras de IC_DATA_CMD ainda não transmitidas
+
+struct i2c_inst {
+    uint index;
+    uint baudrate;
+    uint8_t addrs[HAL_I2C_MAX_DEVICES];
+    hal_i2c_device_t devices[HAL_I2C_MAX_DEVICES];
+    uint num_devices;
+    hal_bus_stats_t stats;
+    i2c_hw_t hw;
+    uint16_t tx_fifo[HAL_I2C_FIFO_MAX]; // Palavras escritas pelo DMA que ainda não saíram no barramento
+    size_t tx_len;
+    uint8_t dma_pending[HAL_I2C_DMA_MAX]; // Bytes já transmitidos até o próximo STOP
+    size_t dma_len;
+};
+
+struct spi_inst {
+    uint index;
+    uint baudrate;
+    spi_hw_t hw;
+    hal_spi_device_t device;
+    bool has_device;
+    hal_bus_stats_t stats;
+};
+
+uint8_t hal_spi_exchange(spi_inst_t *spi, uint8_t out); // Troca um byte com o dispositivo conectado
+spi_inst_t *hal_spi_from_dreq(uint dreq); // SPI associado a um DREQ de transmissão ou recepção
+i2c_inst_t *hal_i2c_from_dreq(uint dreq); // I2C associado a um DREQ de transmissão
+void hal_i2c_push(i2c_inst_t *i2c, uint32_t cmd); // Coloca uma palavra de IC_DATA_CMD na FIFO de transmissão
+PIO hal_pio_from_dreq(uint dreq, uint *sm); // PIO associado a um DREQ de transmissão
+void hal_pio_push(PIO pio, uint sm, uint32_t word); // Entrega uma palavra à FIFO do PIO
+void hal_irq_raise(uint num); // Executa os tratadores registrados na linha de interrupção
+
+#endif // HAL_INTERNAL_H
@@ -0,0 +1,102 @@
+#include <stdarg.h>
+#include <stdlib.h>
+#include <time.h>
+#include "hal_internal.h"
+#include "hardware/clocks.h"
+#include "hardware/rtc.h"
+#include "hardware/structs/scb.h"
+#include "pico/bootrom.h"
+
+armv6m_scb_hw_t hal_scb;
+
+static bool rtc_started;
+static datetime_t rtc_base; // Data e hora no instante rtc_base_us
+static uint64_t rtc_base_us;
+
+void panic(const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    fputs("*** PANIC ***\n", stderr);
+    vfprintf(stderr, fmt, args);
+    fputc('\n', stderr);
+    va_end(args);
+    abort();
+}
+
+bool stdio_init_all(void) {
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    return true;
+}
+
+void reset_usb_boot(uint32_t usb_activity_gpio_pin_mask, uint32_t disable_interface_mask) {
+    (void)usb_activity_gpio_pin_mask;
+    (void)disable_interface_mask;
+    exit(0);
+}
+
+uint32_t clock_get_hz(enum clock_index clk_index) {
+    switch (clk_index) {
+    case clk_ref:
+    case clk_rtc:
+        return 12000000u;
+    case clk_usb:
+    case clk_adc:
+        return 48000000u;
+    default:
+        return 125000000u;
+    }
+}
+
+/**
+ * @brief Inicializa o RTC a partir do relógio de parede do host
+ */
+void rtc_init(void) {
+    struct timespec ts;
+    struct tm tm;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    localtime_r(&ts.tv_sec, &tm);
+    datetime_t t = {
+        .year = (int16_t)(tm.tm_year + 1900),
+        .month = (int8_t)(tm.tm_mon + 1),
+        .day = (int8_t)tm.tm_mday,
+        .dotw = (int8_t)tm.tm_wday,
+        .hour = (int8_t)tm.tm_hour,
+        .min = (int8_t)tm.tm_min,
+        .sec = (int8_t)tm.tm_sec,
+    };
+    rtc_set_datetime(&t);
+}
+
+bool rtc_set_datetime(datetime_t *t) {
+    rtc_base = *t;
+    rtc_base_us = time_us_64();
+    rtc_started = true;
+    return true;
+}
+
+bool rtc_get_datetime(datetime_t *t) {
+    if (!rtc_started)
+        return false;
+    struct tm tm = {
+        .tm_year = rtc_base.year - 1900,
+        .tm_mon = rtc_base.month - 1,
+        .tm_mday = rtc_base.day,
+        .tm_hour = rtc_base.hour,
+        .tm_min = rtc_base.min,
+        .tm_sec = rtc_base.sec + (int)((time_us_64() - rtc_base_us) / 1000000u),
+        .tm_isdst = -1,
+    };
+    timegm(&tm); // Normaliza os campos
+    t->year = (int16_t)(tm.tm_year + 1900);
+    t->month = (int8_t)(tm.tm_mon + 1);
+    t->day = (int8_t)tm.tm_mday;
+    t->dotw = (int8_t)tm.tm_wday;
+    t->hour = (int8_t)tm.tm_hour;
+    t->min = (int8_t)tm.tm_min;
+    t->sec = (int8_t)tm.tm_sec;
+    return true;
+}
+
+bool rtc_running(void) {
+    return rtc_started;
+}
@@ -0,0 +1,225 @@
+#include "hal_internal.h"
+#include "hardware/dma.h"
+
+#define PIO_INSTRUCTION_COUNT 32
+
+pio_hw_t hal_pio0_hw;
+pio_hw_t hal_pio1_hw;
+
+static struct {
+    uint used_instructions;
+    bool sm_claimed[NUM_PIO_STATE_MACHINES];
+    bool sm_enabled[NUM_PIO_STATE_MACHINES];
+    pio_sm_config sm_config[NUM_PIO_STATE_MACHINES];
+    hal_pio_sink_t sink;
+    void *sink_ctx;
+    hal_bus_stats_t stats;
+} pios[2];
+
+uint pio_get_index(PIO pio) {
+    return pio == pio1 ? 1u : 0u;
+}
+
+uint pio_get_dreq(PIO pio, uint sm, bool is_tx) {
+    return (pio_get_index(pio) ? DREQ_PIO1_TX0 : DREQ_PIO0_TX0) + sm + (is_tx ? 0u : NUM_PIO_STATE_MACHINES);
+}
+
+/**
+ * @brief PIO associado a um DREQ de transmissão
+ * @param dreq Sinal de cadência
+ * @param sm Saída: máquina de estados
+ * @return PIO ou NULL se o DREQ não for de transmissão de PIO
+ */
+PIO hal_pio_from_dreq(uint dreq, uint *sm) {
+    if (dreq < DREQ_PIO0_RX0) { // DREQ_PIO0_TX0 é 0
+        *sm = dreq - DREQ_PIO0_TX0;
+        return pio0;
+    }
+    if (dreq >= DREQ_PIO1_TX0 && dreq < DREQ_PIO1_RX0) {
+        *sm = dreq - DREQ_PIO1_TX0;
+        return pio1;
+    }
+    return NULL;
+}
+
+uint pio_add_program(PIO pio, const pio_program_t *program) {
+    uint idx = pio_get_index(pio);
+    if (!pio_can_add_program(pio, program))
+        panic("No program space");
+    uint offset = pios[idx].used_instructions;
+    pios[idx].used_instructions += program->length;
+    return offset;
+}
+
+bool pio_can_add_program(PIO pio, const pio_program_t *program) {
+    return pios[pio_get_index(pio)].used_instructions + program->length <= PIO_INSTRUCTION_COUNT;
+}
+
+void pio_remove_program(PIO pio, const pio_program_t *program, uint loaded_offset) {
+    uint idx = pio_get_index(pio);
+    if (loaded_offset + program->length == pios[idx].used_instructions)
+        pios[idx].used_instructions = loaded_offset;
+}
+
+int pio_claim_unused_sm(PIO pio, bool required) {
+    uint idx = pio_get_index(pio);
+    for (uint sm = 0; sm < NUM_PIO_STATE_MACHINES; ++sm) {
+        if (!pios[idx].sm_claimed[sm]) {
+            pios[idx].sm_claimed[sm] = true;
+            return (int)sm;
+        }
+    }
+    if (required)
+        panic("No PIO state machines are available");
+    return -1;
+}
+
+void pio_sm_claim(PIO pio, uint sm) {
+    pios[pio_get_index(pio)].sm_claimed[sm] = true;
+}
+
+void pio_sm_unclaim(PIO pio, uint sm) {
+    pios[pio_get_index(pio)].sm_claimed[sm] = false;
+}
+
+void pio_gpio_init(PIO pio, uint pin) {
+    gpio_set_function(pin, pio_get_index(pio) ? GPIO_FUNC_PIO1 : GPIO_FUNC_PIO0);
+}
+
+int pio_sm_set_consecutive_pindirs(PIO pio, uint sm, uint pin_base, uint pin_count, bool is_out) {
+    (void)pio;
+    (void)sm;
+    for (uint i = 0; i < pin_count; ++i)
+        gpio_set_dir(pin_base + i, is_out);
+    return PICO_OK;
+}
+
+int pio_sm_init(PIO pio, uint sm, uint initial_pc, const pio_sm_config *config) {
+    (void)initial_pc;
+    uint idx = pio_get_index(pio);
+    pios[idx].sm_enabled[sm] = false;
+    pios[idx].sm_config[sm] = config ? *config : pio_get_default_sm_config();
+    return PICO_OK;
+}
+
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled) {
+    pios[pio_get_index(pio)].sm_enabled[sm] = enabled;
+}
+
+/**
+ * @brief Entrega uma palavra à FIFO do PIO (consumida imediatamente pelo sink)
+ * @param pio Bloco PIO
+ * @param sm Máquina de estados
+ * @param word Palavra escrita
+ */
+void hal_pio_push(PIO pio, uint sm, uint32_t word) {
+    uint idx = pio_get_index(pio);
+    pios[idx].stats.transactions++;
+    pios[idx].stats.bytes_tx += sizeof word;
+    pio->txf[sm] = word;
+    if (pios[idx].sink)
+        pios[idx].sink(pios[idx].sink_ctx, sm, word);
+}
+
+void pio_sm_put(PIO pio, uint sm, uint32_t data) {
+    hal_pio_push(pio, sm, data);
+}
+
+void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data) {
+    hal_pio_push(pio, sm, data);
+}
+
+bool pio_sm_is_tx_fifo_full(PIO pio, uint sm) {
+    (void)pio;
+    (void)sm;
+    return false;
+}
+
+bool pio_sm_is_tx_fifo_empty(PIO pio, uint sm) {
+    (void)pio;
+    (void)sm;
+    return true;
+}
+
+void pio_sm_clear_fifos(PIO pio, uint sm) {
+    (void)pio;
+    (void)sm;
+}
+
+/**
+ * @brief Conecta um consumidor às FIFOs de transmissão do PIO
+ * @param pio Bloco PIO
+ * @param sink Função chamada a cada palavra (NULL desconecta)
+ * @param ctx Contexto repassado ao consumidor
+ */
+void hal_pio_set_sink(PIO pio, hal_pio_sink_t sink, void *ctx) {
+    uint idx = pio_get_index(pio);
+    pios[idx].sink = sink;
+    pios[idx].sink_ctx = ctx;
+}
+
+/**
+ * @brief Contadores de palavras escritas no PIO
+ * @param pio Bloco PIO
+ * @return Ponteiro para os contadores
+ */
+hal_bus_stats_t *hal_pio_stats(PIO pio) {
+    return &pios[pio_get_index(pio)].stats;
+}
+
+pio_sm_config pio_get_default_sm_config(void) {
+    pio_sm_config c = {
+        .wrap_target = 0,
+        .wrap = 31,
+        .clkdiv = 1.0f,
+        .join = PIO_FIFO_JOIN_NONE,
+        .out_shift_right = true,
+        .pull_threshold = 32,
+    };
+    return c;
+}
+
+void sm_config_set_wrap(pio_sm_config *c, uint wrap_target, uint wrap) {
+    c->wrap_target = wrap_target;
+    c->wrap = wrap;
+}
+
+void sm_config_set_set_pins(pio_sm_config *c, uint set_base, uint set_count) {
+    c->set_base = set_base;
+    c->set_count = set_count;
+}
+
+void sm_config_set_out_pins(pio_sm_config *c, uint out_base, uint out_count) {
+    c->out_base = out_base;
+    c->out_count = out_count;
+}
+
+void sm_config_set_sideset_pins(pio_sm_config *c, uint sideset_base) {
+    c->sideset_base = sideset_base;
+}
+
+void sm_config_set_sideset(pio_sm_config *c, uint bit_count, bool optional, bool pindirs) {
+    (void)optional;
+    (void)pindirs;
+    c->sideset_bits = bit_count;
+}
+
+void sm_config_set_clkdiv(pio_sm_config *c, float div) {
+    c->clkdiv = div;
+}
+
+void sm_config_set_fifo_join(pio_sm_config *c, enum pio_fifo_join join) {
+    c->join = join;
+}
+
+void sm_config_set_out_shift(pio_sm_config *c, bool shift_right, bool autopull, uint pull_threshold) {
+    c->out_shift_right = shift_right;
+    c->autopull = autopull;
+    c->pull_threshold = pull_threshold;
+}
+
+void sm_config_set_out_special(pio_sm_config *c, bool sticky, bool has_enable_pin, uint enable_pin_index) {
+    (void)has_enable_pin;
+    (void)enable_pin_index;
+    c->out_sticky = sticky;
+}
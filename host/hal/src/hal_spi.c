@@ -0,0 +1,120 @@
+#include "hal_internal.h"
+
+spi_inst_t hal_spi0_inst = {.index = 0};
+spi_inst_t hal_spi1_inst = {.index = 1};
+
+uint spi_init(spi_inst_t *spi, uint baudrate) {
+    return spi_set_baudrate(spi, baudrate);
+}
+
+void spi_deinit(spi_inst_t *spi) {
+    spi->baudrate = 0;
+}
+
+uint spi_set_baudrate(spi_inst_t *spi, uint baudrate) {
+    // Mesma granularidade do PL022 com clk_peri de 125 MHz: divisor par, mínimo 2
+    uint div = (125000000u + baudrate - 1) / baudrate;
+    if (div < 2)
+        div = 2;
+    div += div & 1u;
+    spi->baudrate = 125000000u / div;
+    return spi->baudrate;
+}
+
+uint spi_get_baudrate(const spi_inst_t *spi) {
+    return spi->baudrate;
+}
+
+uint spi_get_index(const spi_inst_t *spi) {
+    return spi->index;
+}
+
+spi_hw_t *spi_get_hw(spi_inst_t *spi) {
+    return &spi->hw;
+}
+
+void spi_set_format(spi_inst_t *spi, uint data_bits, spi_cpol_t cpol, spi_cpha_t cpha, spi_order_t order) {
+    (void)spi;
+    (void)data_bits;
+    (void)cpol;
+    (void)cpha;
+    (void)order;
+}
+
+bool spi_is_busy(const spi_inst_t *spi) {
+    (void)spi;
+    return false;
+}
+
+/**
+ * @brief Troca um byte com o dispositivo conectado (MISO em nível alto quando não há dispositivo)
+ * @param spi Barramento
+ * @param out Byte enviado
+ * @return Byte recebido
+ */
+uint8_t hal_spi_exchange(spi_inst_t *spi, uint8_t out) {
+    spi->stats.bytes_tx++;
+    spi->stats.bytes_rx++;
+    if (!spi->has_device)
+        return 0xFF;
+    return spi->device.exchange(spi->device.ctx, out);
+}
+
+int spi_write_read_blocking(spi_inst_t *spi, const uint8_t *src, uint8_t *dst, size_t len) {
+    spi->stats.transactions++;
+    for (size_t i = 0; i < len; ++i)
+        dst[i] = hal_spi_exchange(spi, src[i]);
+    return (int)len;
+}
+
+int spi_write_blocking(spi_inst_t *spi, const uint8_t *src, size_t len) {
+    spi->stats.transactions++;
+    for (size_t i = 0; i < len; ++i)
+        hal_spi_exchange(spi, src[i]);
+    return (int)len;
+}
+
+int spi_read_blocking(spi_inst_t *spi, uint8_t repeated_tx_data, uint8_t *dst, size_t len) {
+    spi->stats.transactions++;
+    for (size_t i = 0; i < len; ++i)
+        dst[i] = hal_spi_exchange(spi, repeated_tx_data);
+    return (int)len;
+}
+
+/**
+ * @brief SPI associado a um DREQ de transmissão ou recepção
+ * @param dreq Sinal de cadência
+ * @return Barramento ou NULL se o DREQ não for de SPI
+ */
+spi_inst_t *hal_spi_from_dreq(uint dreq) {
+    switch (dreq) {
+    case DREQ_SPI0_TX:
+    case DREQ_SPI0_RX:
+        return spi0;
+    case DREQ_SPI1_TX:
+    case DREQ_SPI1_RX:
+        return spi1;
+    default:
+        return NULL;
+    }
+}
+
+/**
+ * @brief Conecta um dispositivo simulado ao SPI
+ * @param spi Barramento
+ * @param dev Dispositivo (copiado) ou NULL para desconectar
+ */
+void hal_spi_attach(spi_inst_t *spi, const hal_spi_device_t *dev) {
+    spi->has_device = dev != NULL;
+    if (dev)
+        spi->device = *dev;
+}
+
+/**
+ * @brief Contadores do barramento SPI
+ * @param spi Barramento
+ * @return Ponteiro para os contadores
+ */
+hal_bus_stats_t *hal_spi_stats(spi_inst_t *spi) {
+    return &spi->stats;
+}
@@ -0,0 +1,118 @@
+#include <errno.h>
+#include <time.h>
+#include "pico/mutex.h"
+#include "pico/sem.h"
+
+/**
+ * @brief Converte um tempo limite relativo em um instante absoluto de CLOCK_REALTIME
+ * @param timeout_ms Tempo limite em milissegundos
+ * @param ts Estrutura de saída
+ */
+static void deadline_from_ms(uint32_t timeout_ms, struct timespec *ts) {
+    clock_gettime(CLOCK_REALTIME, ts);
+    ts->tv_sec += timeout_ms / 1000u;
+    ts->tv_nsec += (long)(timeout_ms % 1000u) * 1000000L;
+    if (ts->tv_nsec >= 1000000000L) {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+
+void mutex_init(mutex_t *mtx) {
+    pthread_mutex_init(&mtx->mtx, NULL);
+    mtx->initialized = true;
+}
+
+bool mutex_is_initialized(mutex_t *mtx) {
+    return mtx->initialized;
+}
+
+void mutex_enter_blocking(mutex_t *mtx) {
+    pthread_mutex_lock(&mtx->mtx);
+}
+
+bool mutex_try_enter(mutex_t *mtx, uint32_t *owner_out) {
+    if (owner_out)
+        *owner_out = 0;
+    return 0 == pthread_mutex_trylock(&mtx->mtx);
+}
+
+bool mutex_enter_timeout_ms(mutex_t *mtx, uint32_t timeout_ms) {
+    struct timespec ts;
+    deadline_from_ms(timeout_ms, &ts);
+    return 0 == pthread_mutex_timedlock(&mtx->mtx, &ts);
+}
+
+void mutex_exit(mutex_t *mtx) {
+    pthread_mutex_unlock(&mtx->mtx);
+}
+
+void sem_init(semaphore_t *sem, int16_t initial_permits, int16_t max_permits) {
+    pthread_mutex_init(&sem->mtx, NULL);
+    pthread_cond_init(&sem->cond, NULL);
+    sem->permits = initial_permits;
+    sem->max_permits = max_permits;
+}
+
+int sem_available(semaphore_t *sem) {
+    pthread_mutex_lock(&sem->mtx);
+    int permits = sem->permits;
+    pthread_mutex_unlock(&sem->mtx);
+    return permits;
+}
+
+bool sem_release(semaphore_t *sem) {
+    bool released = false;
+    pthread_mutex_lock(&sem->mtx);
+    if (sem->permits < sem->max_permits) {
+        sem->permits++;
+        released = true;
+        pthread_cond_signal(&sem->cond);
+    }
+    pthread_mutex_unlock(&sem->mtx);
+    return released;
+}
+
+void sem_reset(semaphore_t *sem, int16_t permits) {
+    pthread_mutex_lock(&sem->mtx);
+    sem->permits = permits;
+    if (permits)
+        pthread_cond_broadcast(&sem->cond);
+    pthread_mutex_unlock(&sem->mtx);
+}
+
+void sem_acquire_blocking(semaphore_t *sem) {
+    pthread_mutex_lock(&sem->mtx);
+    while (sem->permits <= 0)
+        pthread_cond_wait(&sem->cond, &sem->mtx);
+    sem->permits--;
+    pthread_mutex_unlock(&sem->mtx);
+}
+
+bool sem_acquire_timeout_ms(semaphore_t *sem, uint32_t timeout_ms) {
+    struct timespec ts;
+    deadline_from_ms(timeout_ms, &ts);
+    bool acquired = true;
+    pthread_mutex_lock(&sem->mtx);
+    while (sem->permits <= 0) {
+        if (ETIMEDOUT == pthread_cond_timedwait(&sem->cond, &sem->mtx, &ts)) {
+            acquired = false;
+            break;
+        }
+    }
+    if (acquired)
+        sem->permits--;
+    pthread_mutex_unlock(&sem->mtx);
+    return acquired;
+}
+
+bool sem_try_acquire(semaphore_t *sem) {
+    bool acquired = false;
+    pthread_mutex_lock(&sem->mtx);
+    if (sem->permits > 0) {
+        sem->permits--;
+        acquired = true;
+    }
+    pthread_mutex_unlock(&sem->mtx);
+    return acquired;
+}
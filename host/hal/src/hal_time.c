@@ -0,0 +1,250 @@
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+#include "pico/time.h"
+
+#define HAL_MAX_ALARMS 16
+
+// Alarmes pendentes; as tarefas do FreeRTOS simulado são threads, daí o mutex
+static struct {
+    alarm_id_t id; // 0: posição livre
+    absolute_time_t time;
+    alarm_callback_t callback;
+    void *user_data;
+} alarms[HAL_MAX_ALARMS];
+static alarm_id_t next_alarm_id = 1;
+static alarm_id_t running_alarm; // Alarme em execução, fora da tabela
+static bool running_cancelled; // cancel_alarm chamado durante a execução
+static pthread_mutex_t alarms_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t poll_mutex = PTHREAD_MUTEX_INITIALIZER; // Um alarme por vez, como a interrupção do timer
+
+/**
+ * @brief Lê o relógio monotônico do host
+ * @return Microssegundos desde a primeira leitura
+ */
+static uint64_t monotonic_us(void) {
+    static uint64_t boot_us;
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t now = (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+    if (!boot_us)
+        boot_us = now - 1;
+    return now - boot_us;
+}
+
+uint64_t time_us_64(void) {
+    return monotonic_us();
+}
+
+uint32_t time_us_32(void) {
+    return (uint32_t)monotonic_us();
+}
+
+absolute_time_t get_absolute_time(void) {
+    return monotonic_us();
+}
+
+absolute_time_t make_timeout_time_ms(uint32_t ms) {
+    return monotonic_us() + (uint64_t)ms * 1000u;
+}
+
+absolute_time_t make_timeout_time_us(uint64_t us) {
+    return monotonic_us() + us;
+}
+
+int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to) {
+    return (int64_t)(to - from);
+}
+
+uint32_t to_ms_since_boot(absolute_time_t t) {
+    return (uint32_t)(t / 1000u);
+}
+
+uint64_t to_us_since_boot(absolute_time_t t) {
+    return t;
+}
+
+bool time_reached(absolute_time_t t) {
+    return monotonic_us() >= t;
+}
+
+/**
+ * @brief Instante do próximo alarme pendente
+ * @return Instante, ou UINT64_MAX se não houver alarme
+ */
+static absolute_time_t next_alarm_time(void) {
+    absolute_time_t next = UINT64_MAX;
+    pthread_mutex_lock(&alarms_mutex);
+    for (uint i = 0; i < HAL_MAX_ALARMS; ++i)
+        if (alarms[i].id && alarms[i].time < next)
+            next = alarms[i].time;
+    pthread_mutex_unlock(&alarms_mutex);
+    return next;
+}
+
+alarm_id_t add_alarm_at(absolute_time_t time, alarm_callback_t callback, void *user_data, bool fire_if_past) {
+    if (!fire_if_past && time_reached(time))
+        return 0;
+    alarm_id_t id = -1;
+    pthread_mutex_lock(&alarms_mutex);
+    for (uint i = 0; i < HAL_MAX_ALARMS; ++i) {
+        if (!alarms[i].id) {
+            id = next_alarm_id++;
+            if (next_alarm_id <= 0)
+                next_alarm_id = 1;
+            alarms[i].id = id;
+            alarms[i].time = time;
+            alarms[i].callback = callback;
+            alarms[i].user_data = user_data;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&alarms_mutex);
+    return id;
+}
+
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past) {
+    return add_alarm_at(make_timeout_time_us(us), callback, user_data, fire_if_past);
+}
+
+alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void *user_data, bool fire_if_past) {
+    return add_alarm_at(make_timeout_time_ms(ms), callback, user_data, fire_if_past);
+}
+
+bool cancel_alarm(alarm_id_t alarm_id) {
+    bool found = false;
+    pthread_mutex_lock(&alarms_mutex);
+    for (uint i = 0; i < HAL_MAX_ALARMS; ++i) {
+        if (alarm_id > 0 && alarms[i].id == alarm_id) {
+            alarms[i].id = 0;
+            found = true;
+        }
+    }
+    if (alarm_id > 0 && alarm_id == running_alarm) {
+        running_cancelled = true;
+        found = true;
+    }
+    pthread_mutex_unlock(&alarms_mutex);
+    return found;
+}
+
+/**
+ * @brief Executa os alarmes vencidos, um de cada vez e fora do mutex
+ *
+ * O callback pode agendar ou cancelar alarmes; o retorno reagenda o próprio
+ * alarme, como no pico-sdk. Esperas dentro do callback, ou em outra thread
+ * durante ele, não executam alarmes: a interrupção do timer não é reentrante.
+ */
+void hal_timer_poll(void) {
+    if (pthread_mutex_trylock(&poll_mutex))
+        return;
+    for (;;) {
+        uint64_t now = monotonic_us();
+        alarm_id_t id = 0;
+        absolute_time_t time = 0;
+        alarm_callback_t callback = NULL;
+        void *user_data = NULL;
+        pthread_mutex_lock(&alarms_mutex);
+        int due = -1;
+        for (uint i = 0; i < HAL_MAX_ALARMS; ++i)
+            if (alarms[i].id && alarms[i].time <= now && (due < 0 || alarms[i].time < alarms[due].time))
+                due = (int)i;
+        if (due >= 0) {
+            id = alarms[due].id;
+            time = alarms[due].time;
+            callback = alarms[due].callback;
+            user_data = alarms[due].user_data;
+            alarms[due].id = 0;
+            running_alarm = id;
+            running_cancelled = false;
+        }
+        pthread_mutex_unlock(&alarms_mutex);
+        if (due < 0)
+            break;
+        int64_t again = callback(id, user_data);
+        absolute_time_t next = again > 0 ? monotonic_us() + (uint64_t)again : time + (uint64_t)-again;
+        pthread_mutex_lock(&alarms_mutex);
+        running_alarm = 0;
+        for (uint i = 0; again && !running_cancelled && i < HAL_MAX_ALARMS; ++i) {
+            if (!alarms[i].id) {
+                alarms[i].id = id;
+                alarms[i].time = next;
+                alarms[i].callback = callback;
+                alarms[i].user_data = user_data;
+                break;
+            }
+        }
+        pthread_mutex_unlock(&alarms_mutex);
+    }
+    pthread_mutex_unlock(&poll_mutex);
+}
+
+static int64_t repeating_timer_fire(alarm_id_t id, void *user_data) {
+    (void)id;
+    repeating_timer_t *rt = user_data;
+    if (!rt->callback(rt)) {
+        rt->alarm_id = 0;
+        return 0;
+    }
+    return rt->delay_us;
+}
+
+bool add_repeating_timer_us(int64_t delay_us, repeating_timer_callback_t callback, void *user_data, repeating_timer_t *out) {
+    if (!delay_us)
+        delay_us = 1;
+    out->delay_us = delay_us;
+    out->callback = callback;
+    out->user_data = user_data;
+    out->alarm_id = add_alarm_in_us((uint64_t)(delay_us > 0 ? delay_us : -delay_us), repeating_timer_fire, out, true);
+    return out->alarm_id > 0;
+}
+
+bool add_repeating_timer_ms(int32_t delay_ms, repeating_timer_callback_t callback, void *user_data, repeating_timer_t *out) {
+    return add_repeating_timer_us(delay_ms * (int64_t)1000, callback, user_data, out);
+}
+
+bool cancel_repeating_timer(repeating_timer_t *timer) {
+    bool found = timer->alarm_id > 0 && cancel_alarm(timer->alarm_id);
+    timer->alarm_id = 0;
+    return found;
+}
+
+/**
+ * @brief Dorme até o instante, acordando para executar os alarmes que vencerem antes
+ */
+static void sleep_until_us(uint64_t end) {
+    for (;;) {
+        hal_i2c_poll();
+        hal_timer_poll();
+        uint64_t now = monotonic_us();
+        if (now >= end)
+            return;
+        uint64_t wake = next_alarm_time();
+        uint64_t us = (wake < end ? (wake > now ? wake : now) : end) - now;
+        struct timespec ts = {.tv_sec = us / 1000000u, .tv_nsec = (us % 1000000u) * 1000u};
+        while (nanosleep(&ts, &ts) && errno == EINTR) {
+        }
+    }
+}
+
+void sleep_us(uint64_t us) {
+    sleep_until_us(monotonic_us() + us);
+}
+
+void sleep_ms(uint32_t ms) {
+    sleep_us((uint64_t)ms * 1000u);
+}
+
+void busy_wait_us(uint64_t delay_us) {
+    uint64_t end = monotonic_us() + delay_us;
+    while (monotonic_us() < end)
+        tight_loop_contents();
+}
+
+void busy_wait_us_32(uint32_t delay_us) {
+    busy_wait_us(delay_us);
+}
+
+void busy_wait_ms(uint32_t delay_ms) {
+    busy_wait_us((uint64_t)delay_ms * 1000u);
+}
@@ -0,0 +1,2402 @@
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "pico/stdlib.h"
+#include "host_hal.h"
+#include "bench.h"
+
+#include "display/ssd1306.h"
+#include "display/font.h"
+#include "display/ui.h"
+#include "drivers/matrix.h"
+#include "drivers/matrix_anim.h"
+#include "drivers/matrix_parallel.h"
+#include "drivers/joystick.h"
+#include "sensors/bmp280.h"
+#include "sensors/mpu6050.h"
+#include "drivers/sdcard.h"
+#include "sd_sim.h"
+#include "ssd1306_sim.h"
+#include "sd_image.h"
+#include "sector_cache.h"
+#include "core/my_tasks.h"
+#include "crc.h"
+#include "ff_lock_stats.h"
+#include "sd_stripe.h"
+
+static int failures; // Verificações que falharam
+
+/**
+ * @brief Registra o resultado de uma verificação de corretude
+ */
+static void check(bool ok, const char *what) {
+    printf("# %s: %s\n", what, ok ? "ok" : "FALHOU");
+    if (!ok)
+        failures++;
+}
+
+static ssd1306_sim_t panel; // Painel SSD1306 emulado no barramento do display
+
+/**
+ * @brief O painel emulado exibe o conteúdo do framebuffer
+ */
+static bool panel_sim_matches(const ssd1306_sim_t *sim, const ssd1306_t *disp) {
+    for (uint8_t x = 0; x < disp->width; ++x)
+        for (uint8_t page = 0; page < disp->pages; ++page)
+            if (sim->ram[page][x] != disp->ram_buffer[1 + x * disp->pages + page])
+                return false;
+    return true;
+}
+
+static bool panel_matches(const ssd1306_t *disp) {
+    return panel_sim_matches(&panel, disp);
+}
+
+static ssd1306_t ssd;
+
+static void bench_fill(void *ctx) {
+    (void)ctx;
+    ssd1306_fill(&ssd, false);
+}
+
+static void bench_draw_string(void *ctx) {
+    (void)ctx;
+    ssd1306_draw_string(&ssd, "CEPEDI   TIC37", 8, 10);
+}
+
+static void bench_send_data(void *ctx) {
+    (void)ctx;
+    ssd1306_send_data(&ssd);
+}
+
+static void count_flush(ssd1306_t *disp, void *ctx) {
+    (void)disp;
+    ++*(unsigned *)ctx;
+}
+
+static void bench_status_display(void *ctx) {
+    (void)ctx;
+    status_display(&ssd, "Conectado", "192.168.0.1");
+}
+
+/**
+ * @brief Benchmarks do framebuffer e do envio ao display
+ */
+static void run_display(void) {
+    ssd1306_sim_attach(&panel, I2C_PORT_DISP, SSD1306_ADDR, 400000);
+    display_init(&ssd);
+    check(panel_matches(&ssd), "display_init_full_frame");
+
+    hal_bus_stats_t *stats = hal_i2c_stats(I2C_PORT_DISP);
+    bench_run("display_fill", bench_fill, NULL, 2000);
+    bench_run("display_draw_string", bench_draw_string, NULL, 20000);
+    hal_stats_reset(stats);
+    ssd1306_invalidate(&ssd);
+    ssd1306_send_data(&ssd);
+    uint64_t full = stats->bytes_tx;
+    printf("# display_send_data_full: %llu bytes I2C por quadro em %llu transacoes\n", (unsigned long long)full,
+           (unsigned long long)stats->transactions);
+    check(panel_matches(&ssd) && 2 == stats->transactions, "display_send_full_frame");
+    bench_run("display_send_data", bench_send_data, NULL, 20000);
+
+    // status_display redesenha tudo, mas só a linha alterada vai ao painel
+    status_display(&ssd, "Conectado", "192.168.0.1");
+    hal_stats_reset(stats);
+    status_display(&ssd, "Conectado", "192.168.0.2");
+    uint64_t one_line = stats->bytes_tx;
+    hal_stats_reset(stats);
+    status_display(&ssd, "Conectado", "192.168.0.2");
+    uint64_t unchanged = stats->bytes_tx;
+    printf("# status_display: %llu bytes I2C com uma linha alterada, %llu sem alteracao\n",
+           (unsigned long long)one_line, (unsigned long long)unchanged);
+    check(panel_matches(&ssd) && one_line * 10 < full && 0 == unchanged, "display_partial_update");
+    // Alterações em várias páginas e colunas distantes
+    status_display(&ssd, "Desconectado", NULL);
+    ssd1306_pixel(&ssd, 0, 0, true);
+    ssd1306_pixel(&ssd, 127, 63, true);
+    ssd1306_send_data(&ssd);
+    check(panel_matches(&ssd), "display_partial_update_scattered");
+
+    // Envio assíncrono: o quadro é copiado para o buffer de DMA e notificado ao terminar
+    unsigned flushes = 0;
+    ssd1306_set_flush_callback(&ssd, count_flush, &flushes);
+    ssd1306_draw_string(&ssd, "DMA", 90, 0);
+    hal_stats_reset(stats);
+    bool started = ssd1306_send_data_async(&ssd);
+    ssd1306_draw_string(&ssd, "---", 90, 0); // Redesenho durante o envio não altera o quadro enviado
+    ssd1306_wait(&ssd);
+    bool sent_dma = !panel_matches(&ssd), lit = false;
+    for (uint8_t x = 90; x < 114; ++x) {
+        sent_dma = sent_dma && panel.ram[0][x] == ssd.sent_buffer[x * ssd.pages];
+        lit = lit || panel.ram[0][x];
+    }
+    sent_dma = sent_dma && lit;
+    check(started && sent_dma && 1 == flushes && 2 == stats->transactions, "display_async_flush");
+    ssd1306_send_data_async(&ssd);
+    ssd1306_send_data_async(&ssd); // Nada mudou: notifica sem transmitir
+    ssd1306_wait(&ssd);
+    check(panel_matches(&ssd) && 3 == flushes, "display_async_flush_callback");
+    ssd1306_set_flush_callback(&ssd, NULL, NULL);
+
+    // O fim do DMA não esvazia a FIFO do I2C: trocar o TAR logo em seguida a descartaria
+    ssd1306_draw_string(&ssd, "FIFO", 0, 56);
+    hal_stats_reset(stats);
+    ssd1306_send_data_async(&ssd);
+    ssd1306_command(&ssd, SET_NORM_INV); // Espera o barramento antes do i2c_write_blocking
+    check(0 == stats->bytes_flushed && panel_matches(&ssd), "display_command_after_dma_waits_fifo");
+    ssd1306_draw_string(&ssd, "LOST", 0, 56);
+    ssd1306_send_data_async(&ssd);
+    while (dma_channel_is_busy(ssd.dma_channel))
+        ;
+    i2c_write_blocking(I2C_PORT_DISP, SSD1306_ADDR, (const uint8_t[]){0x80, SET_NORM_INV}, 2, false);
+    check(stats->bytes_flushed && !panel_matches(&ssd), "display_fifo_flush_modeled");
+    ssd1306_invalidate(&ssd);
+    ssd1306_send_data(&ssd);
+
+    // Dois displays no mesmo barramento: o segundo espera a FIFO esvaziar para trocar o
+    // TAR, sem bloquear quem enviou, e parte do alarme de nova tentativa
+    static ssd1306_sim_t panel_b;
+    static ssd1306_t ssd_b;
+    ssd1306_sim_attach(&panel_b, I2C_PORT_DISP, SSD1306_ADDR + 1, 400000);
+    ssd1306_init(&ssd_b, SSD1306_WIDTH, SSD1306_HEIGHT, false, SSD1306_ADDR + 1, I2C_PORT_DISP);
+    ssd1306_config(&ssd_b);
+    ssd1306_send_data(&ssd_b);
+    ssd1306_draw_string(&ssd, "BUS A", 0, 24);
+    ssd1306_draw_string(&ssd_b, "BUS B", 0, 24);
+    hal_stats_reset(stats);
+    bool sent_a = ssd1306_send_data_async(&ssd);
+    bool sent_b = ssd1306_send_data_async(&ssd_b);
+    bool deferred = SSD1306_DMA_IDLE != ssd_b.dma_active;
+    ssd1306_draw_string(&ssd, "BUS A2", 0, 24); // Na vez seguinte à do segundo display
+    bool again_a = ssd1306_send_data_async(&ssd);
+    ssd1306_wait(&ssd_b);
+    ssd1306_wait(&ssd);
+    check(sent_a && sent_b && again_a && deferred && 0 == stats->bytes_flushed && panel_matches(&ssd) &&
+              panel_sim_matches(&panel_b, &ssd_b),
+          "display_two_on_one_bus");
+    ssd1306_deinit(&ssd_b);
+    hal_i2c_detach(I2C_PORT_DISP, SSD1306_ADDR + 1);
+
+    bench_run("display_status_display", bench_status_display, NULL, 2000);
+    ssd1306_deinit(&ssd);
+}
+
+// Primitivas de referência pixel a pixel (a implementação anterior), para comparar resultado e custo
+static void ref_fill(ssd1306_t *disp, bool value) {
+    for (uint8_t y = 0; y < disp->height; ++y)
+        for (uint8_t x = 0; x < disp->width; ++x)
+            ssd1306_pixel(disp, x, y, value);
+}
+
+static void ref_rect(ssd1306_t *disp, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
+    for (uint8_t x = left; x < left + width; ++x) {
+        ssd1306_pixel(disp, x, top, value);
+        ssd1306_pixel(disp, x, top + height - 1, value);
+    }
+    for (uint8_t y = top; y < top + height; ++y) {
+        ssd1306_pixel(disp, left, y, value);
+        ssd1306_pixel(disp, left + width - 1, y, value);
+    }
+    if (fill)
+        for (uint8_t x = left + 1; x < left + width - 1; ++x)
+            for (uint8_t y = top + 1; y < top + height - 1; ++y)
+                ssd1306_pixel(disp, x, y, value);
+}
+
+static void ref_hline(ssd1306_t *disp, uint8_t x0, uint8_t x1, uint8_t y, bool value) {
+    for (uint8_t x = x0; x <= x1; ++x)
+        ssd1306_pixel(disp, x, y, value);
+}
+
+static void ref_vline(ssd1306_t *disp, uint8_t x, uint8_t y0, uint8_t y1, bool value) {
+    for (uint8_t y = y0; y <= y1; ++y)
+        ssd1306_pixel(disp, x, y, value);
+}
+
+static void ref_draw_char(ssd1306_t *disp, char c, uint8_t x, uint8_t y) {
+    uint16_t index = (c - ' ') * 8;
+    for (uint8_t i = 0; i < 8; ++i)
+        for (uint8_t j = 0; j < 8; ++j)
+            ssd1306_pixel(disp, x + i, y + j, font[index + i] & (1 << j));
+}
+
+static void ref_draw_string(ssd1306_t *disp, const char *str, uint8_t x, uint8_t y) {
+    while (*str) {
+        ref_draw_char(disp, *str++, x, y);
+        x += 8;
+        if (x + 8 >= disp->width) {
+            x = 0;
+            y += 8;
+        }
+        if (y + 8 >= disp->height)
+            break;
+    }
+}
+
+static ssd1306_t raster_ref;
+
+/**
+ * @brief Quadro típico da aplicação: limpa, moldura, separador, textos e um medidor
+ */
+static void bench_frame_words(void *ctx) {
+    (void)ctx;
+    ssd1306_fill(&ssd, false);
+    ssd1306_rect(&ssd, 0, 0, 128, 64, true, false);
+    ssd1306_hline(&ssd, 1, 126, 20, true);
+    ssd1306_draw_string(&ssd, "CEPEDI   TIC37", 8, 6);
+    ssd1306_draw_string(&ssd, "Conectado", 4, 28);
+    ssd1306_draw_string(&ssd, "192.168.0.1", 4, 43);
+    ssd1306_rect(&ssd, 54, 4, 80, 6, true, true);
+    ssd1306_vline(&ssd, 100, 24, 60, true);
+}
+
+static void bench_frame_pixels(void *ctx) {
+    (void)ctx;
+    ref_fill(&raster_ref, false);
+    ref_rect(&raster_ref, 0, 0, 128, 64, true, false);
+    ref_hline(&raster_ref, 1, 126, 20, true);
+    ref_draw_string(&raster_ref, "CEPEDI   TIC37", 8, 6);
+    ref_draw_string(&raster_ref, "Conectado", 4, 28);
+    ref_draw_string(&raster_ref, "192.168.0.1", 4, 43);
+    ref_rect(&raster_ref, 54, 4, 80, 6, true, true);
+    ref_vline(&raster_ref, 100, 24, 60, true);
+}
+
+static void bench_fill_pixels(void *ctx) {
+    (void)ctx;
+    ref_fill(&raster_ref, false);
+}
+
+static void bench_rect_fill_words(void *ctx) {
+    (void)ctx;
+    ssd1306_rect(&ssd, 3, 5, 100, 50, true, true);
+}
+
+static void bench_rect_fill_pixels(void *ctx) {
+    (void)ctx;
+    ref_rect(&raster_ref, 3, 5, 100, 50, true, true);
+}
+
+static void bench_draw_string_pixels(void *ctx) {
+    (void)ctx;
+    ref_draw_string(&raster_ref, "CEPEDI   TIC37", 8, 10);
+}
+
+/**
+ * @brief Compara uma primitiva por palavras com a referência pixel a pixel e imprime o ganho
+ */
+static double raster_speedup(const char *name, bench_fn_t words, bench_fn_t pixels, uint32_t iterations) {
+    char label[48];
+    snprintf(label, sizeof label, "raster_%s_pixels", name);
+    uint64_t slow = bench_run(label, pixels, NULL, iterations);
+    snprintf(label, sizeof label, "raster_%s_words", name);
+    uint64_t fast = bench_run(label, words, NULL, iterations);
+    double ratio = (double)slow / (double)(fast ? fast : 1);
+    printf("# raster_%s: %.1fx mais rapido\n", name, ratio);
+    return ratio;
+}
+
+static bool raster_same(void) {
+    return 0 == memcmp(ssd.ram_buffer, raster_ref.ram_buffer, ssd.bufsize);
+}
+
+/**
+ * @brief Primitivas do framebuffer por bytes de página/palavras de coluna contra a referência pixel a pixel
+ */
+static void run_raster(void) {
+    ssd1306_init(&ssd, SSD1306_WIDTH, SSD1306_HEIGHT, false, SSD1306_ADDR, I2C_PORT_DISP);
+    ssd1306_init(&raster_ref, SSD1306_WIDTH, SSD1306_HEIGHT, false, SSD1306_ADDR, I2C_PORT_DISP);
+
+    // Operações aleatórias, inclusive parcialmente fora do painel
+    uint32_t seed = 12345;
+    bool same = true;
+    for (int i = 0; i < 4000 && same; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        uint8_t a = (seed >> 8) % 140, b = (seed >> 16) % 72, c = 1 + (seed >> 4) % 100, d = 1 + (seed >> 12) % 70;
+        bool value = (seed >> 30) & 1;
+        switch ((seed >> 24) % 6) {
+        case 0:
+            ssd1306_rect(&ssd, b, a, c, d, value, (seed >> 29) & 1);
+            ref_rect(&raster_ref, b, a, c, d, value, (seed >> 29) & 1);
+            break;
+        case 1:
+            ssd1306_hline(&ssd, a < c ? a : c, a < c ? c : a, b, value);
+            ref_hline(&raster_ref, a < c ? a : c, a < c ? c : a, b, value);
+            break;
+        case 2:
+            ssd1306_vline(&ssd, a, b < d ? b : d, b < d ? d : b, value);
+            ref_vline(&raster_ref, a, b < d ? b : d, b < d ? d : b, value);
+            break;
+        case 3:
+        case 4:
+            ssd1306_draw_char(&ssd, ' ' + c % 95, a, b);
+            ref_draw_char(&raster_ref, ' ' + c % 95, a, b);
+            break;
+        default:
+            if (0 == (seed >> 20) % 50) {
+                ssd1306_fill(&ssd, value);
+                ref_fill(&raster_ref, value);
+            }
+            break;
+        }
+        same = raster_same();
+    }
+    check(same, "raster_matches_pixel_reference");
+    bench_frame_words(NULL);
+    bench_frame_pixels(NULL);
+    check(raster_same(), "raster_frame_matches_pixel_reference");
+
+    raster_speedup("fill", bench_fill, bench_fill_pixels, 2000);
+    raster_speedup("rect_fill", bench_rect_fill_words, bench_rect_fill_pixels, 2000);
+    raster_speedup("draw_string", bench_draw_string, bench_draw_string_pixels, 20000);
+    double frame = raster_speedup("frame", bench_frame_words, bench_frame_pixels, 2000);
+    check(frame >= 10.0, "raster_frame_speedup_10x");
+
+    ssd1306_deinit(&ssd);
+    ssd1306_deinit(&raster_ref);
+}
+
+static ssd1306_text_t font_header;
+
+static void bench_header_string(void *ctx) {
+    (void)ctx;
+    ssd1306_draw_string(&ssd, "CEPEDI   TIC37", 8, 10);
+}
+
+static void bench_header_cached(void *ctx) {
+    (void)ctx;
+    ssd1306_draw_text_cached(&ssd, &font_header, 8, 10);
+}
+
+static void bench_header_pixels(void *ctx) {
+    (void)ctx;
+    ref_draw_string(&raster_ref, "CEPEDI   TIC37", 8, 10);
+}
+
+static void bench_text_proportional(void *ctx) {
+    (void)ctx;
+    ssd1306_draw_text(&ssd, "Temp 25.4C  Umid 61%", 0, 20, SSD1306_TEXT_PROPORTIONAL);
+}
+
+static void bench_text_scale2(void *ctx) {
+    (void)ctx;
+    ssd1306_draw_text(&ssd, "25.4C", 0, 40, SSD1306_TEXT_SCALE2);
+}
+
+static bool font_pixel(const ssd1306_t *disp, uint8_t x, uint8_t y) {
+    return disp->ram_buffer[1 + x * disp->pages + (y >> 3)] >> (y & 7) & 1;
+}
+
+/**
+ * @brief Texto proporcional, em escala 2x e pré-renderizado contra o desenho por caractere
+ */
+static void run_font(void) {
+    ssd1306_init(&ssd, SSD1306_WIDTH, SSD1306_HEIGHT, false, SSD1306_ADDR, I2C_PORT_DISP);
+    ssd1306_init(&raster_ref, SSD1306_WIDTH, SSD1306_HEIGHT, false, SSD1306_ADDR, I2C_PORT_DISP);
+
+    // O rótulo pré-renderizado é idêntico à string desenhada caractere a caractere, alinhado ou não
+    ssd1306_text_render(&font_header, "CEPEDI   TIC37", 0);
+    ssd1306_draw_text_cached(&ssd, &font_header, 8, 10);
+    ssd1306_draw_string(&raster_ref, "CEPEDI   TIC37", 8, 10);
+    ssd1306_draw_text_cached(&ssd, &font_header, 8, 48);
+    ssd1306_draw_string(&raster_ref, "CEPEDI   TIC37", 8, 48);
+    check(raster_same() && 112 == font_header.width, "font_cached_matches_draw_string");
+
+    // Caracteres fora da tabela viram '?', sem ler além da fonte
+    ssd1306_fill(&ssd, false);
+    ssd1306_fill(&raster_ref, false);
+    ssd1306_draw_char(&ssd, '\x01', 0, 0);
+    ssd1306_draw_char(&ssd, (char)0xC3, 8, 0);
+    ssd1306_draw_char(&raster_ref, '?', 0, 0);
+    ssd1306_draw_char(&raster_ref, '?', 8, 0);
+    check(raster_same(), "font_out_of_range_fallback");
+
+    // Proporcional: largura de cada glifo mais uma coluna de espaço
+    uint8_t prop = ssd1306_text_width("il 1", SSD1306_TEXT_PROPORTIONAL);
+    uint8_t end = ssd1306_draw_text(&ssd, "il 1", 10, 20, SSD1306_TEXT_PROPORTIONAL);
+    check(4 + 4 + 4 + 4 == prop && 10 + prop == end && 32 == ssd1306_text_width("il 1", 0),
+          "font_proportional_width");
+
+    // Escala 2x: cada pixel vira um bloco 2x2
+    ssd1306_fill(&ssd, false);
+    ssd1306_draw_text(&ssd, "A7%", 0, 0, SSD1306_TEXT_SCALE2);
+    ssd1306_draw_text(&ssd, "A7%", 0, 40, 0);
+    bool scaled = 48 == ssd1306_text_width("A7%", SSD1306_TEXT_SCALE2);
+    for (uint8_t x = 0; x < 48; ++x)
+        for (uint8_t y = 0; y < 16; ++y)
+            scaled = scaled && font_pixel(&ssd, x, y) == font_pixel(&ssd, x / 2, 40 + y / 2);
+    check(scaled, "font_scale2");
+
+    ssd1306_text_t cached;
+    ssd1306_fill(&ssd, false);
+    ssd1306_fill(&raster_ref, false);
+    ssd1306_text_render(&cached, "Umid 61%", SSD1306_TEXT_PROPORTIONAL | SSD1306_TEXT_SCALE2);
+    ssd1306_draw_text_cached(&ssd, &cached, 3, 21);
+    ssd1306_draw_text(&raster_ref, "Umid 61%", 3, 21, SSD1306_TEXT_PROPORTIONAL | SSD1306_TEXT_SCALE2);
+    check(raster_same(), "font_cached_proportional_scale2");
+
+    uint64_t pixels = bench_run("font_header_pixels", bench_header_pixels, NULL, 20000);
+    uint64_t string = bench_run("font_header_draw_string", bench_header_string, NULL, 20000);
+    uint64_t cached_us = bench_run("font_header_cached", bench_header_cached, NULL, 20000);
+    printf("# font_header: cache %.1fx mais rapido que draw_string, %.1fx que pixel a pixel\n",
+           (double)string / (double)(cached_us ? cached_us : 1), (double)pixels / (double)(cached_us ? cached_us : 1));
+    bench_run("font_text_proportional", bench_text_proportional, NULL, 20000);
+    bench_run("font_text_scale2", bench_text_scale2, NULL, 20000);
+
+    ssd1306_deinit(&ssd);
+    ssd1306_deinit(&raster_ref);
+}
+
+/**
+ * @brief CRC16 da imagem exibida em PBM, para comparar com imagens de referência
+ */
+static uint16_t panel_crc(void) {
+    uint8_t image[32 + SSD1306_SIM_WIDTH / 8 * SSD1306_SIM_HEIGHT];
+    return sd_sim_crc16(image, ssd1306_sim_pbm(&panel, image, sizeof image));
+}
+
+/**
+ * @brief Grava a imagem exibida em TEMPLATE_FRAMES_DIR, se definido
+ */
+static void panel_dump(const char *name) {
+    const char *dir = getenv("TEMPLATE_FRAMES_DIR");
+    if (!dir)
+        return;
+    char path[256];
+    snprintf(path, sizeof path, "%s/%s.pbm", dir, name);
+    if (!ssd1306_sim_write_pbm(&panel, path))
+        printf("# %s: falha ao gravar\n", path);
+}
+
+/**
+ * @brief A imagem reconstruída pelo painel é a do framebuffer
+ */
+static bool panel_shows(const ssd1306_t *disp) {
+    for (uint8_t y = 0; y < disp->height; ++y)
+        for (uint8_t x = 0; x < disp->width; ++x)
+            if (ssd1306_sim_pixel(&panel, x, y) != font_pixel(disp, x, y))
+                return false;
+    return true;
+}
+
+/**
+ * @brief Painel emulado: imagens de referência das telas, modos de endereçamento e quadros por segundo
+ */
+static void run_oled(void) {
+    ssd1306_sim_attach(&panel, I2C_PORT_DISP, SSD1306_ADDR, 400000);
+    display_init(&ssd);
+    start_display(&ssd);
+    uint16_t crc_start = panel_crc();
+    printf("# oled start_display: crc 0x%04x\n", crc_start);
+    check(panel_shows(&ssd) && 0xcd58 == crc_start, "oled_start_display_golden");
+    panel_dump("start_display");
+    status_display(&ssd, "Conectado", "192.168.0.1");
+    uint16_t crc_status = panel_crc();
+    printf("# oled status_display: crc 0x%04x\n", crc_status);
+    check(panel_shows(&ssd) && 0xbb1b == crc_status, "oled_status_display_golden");
+    panel_dump("status_display");
+
+    // Inversão e painel desligado alteram a imagem, não a RAM
+    ssd1306_command(&ssd, SET_NORM_INV | 0x01);
+    bool inverted = true, off = true;
+    for (uint8_t y = 0; y < SSD1306_HEIGHT; ++y)
+        for (uint8_t x = 0; x < SSD1306_WIDTH; ++x)
+            inverted = inverted && ssd1306_sim_pixel(&panel, x, y) != font_pixel(&ssd, x, y);
+    ssd1306_command(&ssd, SET_NORM_INV);
+    ssd1306_command(&ssd, SET_DISP);
+    for (uint8_t y = 0; y < SSD1306_HEIGHT; ++y)
+        for (uint8_t x = 0; x < SSD1306_WIDTH; ++x)
+            off = off && !ssd1306_sim_pixel(&panel, x, y);
+    ssd1306_command(&ssd, SET_DISP | 0x01);
+    check(inverted && off && panel_shows(&ssd), "oled_invert_and_display_off");
+
+    // Arquivo PBM: cabeçalho P4 e uma linha de 16 bytes por linha de pixels
+    char path[] = "/tmp/oled_XXXXXX";
+    int fd = mkstemp(path);
+    uint8_t expected[32 + SSD1306_SIM_WIDTH / 8 * SSD1306_SIM_HEIGHT], written[sizeof expected];
+    size_t len = ssd1306_sim_pbm(&panel, expected, sizeof expected);
+    bool pbm = fd >= 0 && ssd1306_sim_write_pbm(&panel, path);
+    FILE *f = pbm ? fopen(path, "rb") : NULL;
+    pbm = f && fread(written, 1, sizeof written, f) == len && 0 == memcmp(written, expected, len) &&
+          0 == memcmp(expected, "P4\n128 64\n", 10) && 10 + 16 * 64 == len;
+    if (f)
+        fclose(f);
+    if (fd >= 0) {
+        close(fd);
+        unlink(path);
+    }
+    check(pbm, "oled_pbm_file");
+
+    // Modo horizontal: a janela é percorrida linha de páginas a linha de páginas
+    const uint8_t horizontal[] = {0x00, SET_MEM_ADDR, 0x00, SET_COL_ADDR, 10, 11, SET_PAGE_ADDR, 2, 3};
+    const uint8_t horizontal_data[] = {0x40, 1, 2, 3, 4};
+    i2c_write_blocking(I2C_PORT_DISP, SSD1306_ADDR, horizontal, sizeof horizontal, false);
+    i2c_write_blocking(I2C_PORT_DISP, SSD1306_ADDR, horizontal_data, sizeof horizontal_data, false);
+    bool modes = 1 == panel.ram[2][10] && 2 == panel.ram[2][11] && 3 == panel.ram[3][10] && 4 == panel.ram[3][11];
+    // Modo de página: página por 0xB0-0xB7, coluna por nibbles, volta ao início da linha
+    const uint8_t page_mode[] = {0x00, SET_MEM_ADDR, 0x02, 0xB5, 0x0E, 0x17};
+    const uint8_t page_data[] = {0x40, 7, 8, 9};
+    i2c_write_blocking(I2C_PORT_DISP, SSD1306_ADDR, page_mode, sizeof page_mode, false);
+    i2c_write_blocking(I2C_PORT_DISP, SSD1306_ADDR, page_data, sizeof page_data, false);
+    modes = modes && 7 == panel.ram[5][126] && 8 == panel.ram[5][127] && 9 == panel.ram[5][0];
+    // Co = 1: um byte de comando e um de dados na mesma transação
+    const uint8_t mixed[] = {0x80, 0xB6, 0xC0, 0x55};
+    i2c_write_blocking(I2C_PORT_DISP, SSD1306_ADDR, mixed, sizeof mixed, false);
+    modes = modes && 0x55 == panel.ram[6][1];
+    check(modes, "oled_addressing_modes");
+    ssd1306_config(&ssd); // Volta ao endereçamento vertical e reenvia o quadro
+    ssd1306_send_data(&ssd);
+    check(panel_shows(&ssd), "oled_reconfigure");
+
+    // Painel de sensores: só os valores mudam a cada quadro
+    char value[24];
+    ssd1306_sim_reset_stats(&panel);
+    for (int i = 0; i < 500; ++i) {
+        snprintf(value, sizeof value, "T %d.%d C", 20 + i % 10, i % 7);
+        status_display(&ssd, "Conectado", value);
+        ssd1306_sim_end_frame(&panel);
+    }
+    double partial_bytes = ssd1306_sim_bytes_per_frame(&panel), partial_bus = ssd1306_sim_bus_fps(&panel);
+    printf("# oled_dashboard: %.1f bytes I2C/quadro, %.0f quadros/s no host, %.1f quadros/s no barramento a 400 kHz\n",
+           partial_bytes, ssd1306_sim_fps(&panel), partial_bus);
+    panel_dump("dashboard");
+    ssd1306_sim_reset_stats(&panel);
+    for (int i = 0; i < 100; ++i) {
+        ssd1306_invalidate(&ssd);
+        ssd1306_send_data(&ssd);
+        ssd1306_sim_end_frame(&panel);
+    }
+    double full_bus = ssd1306_sim_bus_fps(&panel);
+    printf("# oled_full_frame: %.1f bytes I2C/quadro, %.0f quadros/s no host, %.1f quadros/s no barramento a 400 kHz\n",
+           ssd1306_sim_bytes_per_frame(&panel), ssd1306_sim_fps(&panel), full_bus);
+    check(panel_shows(&ssd) && partial_bus > 5 * full_bus && 1032 == panel.stats.max_frame_bytes, "oled_frame_rate");
+    ssd1306_deinit(&ssd);
+}
+
+// Painel de sensores em widgets retidos, associados a estas variáveis
+static char ui_temp_text[UI_LABEL_MAX + 1];
+static char ui_status_text[UI_LABEL_MAX + 1];
+static int32_t ui_humidity;
+static uint8_t ui_wifi;
+static const uint8_t ui_wifi_icons[2][8] = {
+    {0x00, 0x41, 0x22, 0x14, 0x08, 0x14, 0x22, 0x41}, // Desconectado
+    {0x04, 0x12, 0x49, 0x25, 0x25, 0x49, 0x12, 0x04}, // Conectado
+};
+
+typedef struct {
+    ui_screen_t screen;
+    ui_label_t title, temp, status;
+    ui_icon_t wifi;
+    ui_bar_t humidity;
+    ui_sparkline_t history;
+} ui_dashboard_t;
+
+static void ui_dashboard_build(ui_dashboard_t *d) {
+    ui_screen_init(&d->screen, 0, 0);
+    ui_label_init(&d->title, "CEPEDI TIC37", SSD1306_TEXT_PROPORTIONAL);
+    ui_icon_init(&d->wifi, ui_wifi_icons, count_of(ui_wifi_icons), &ui_wifi);
+    ui_label_init(&d->temp, ui_temp_text, SSD1306_TEXT_PROPORTIONAL | SSD1306_TEXT_SCALE2);
+    ui_label_init(&d->status, ui_status_text, SSD1306_TEXT_PROPORTIONAL);
+    ui_bar_init(&d->humidity, &ui_humidity, 0, 100, 60, 8);
+    ui_sparkline_init(&d->history, 150, 350, 64, 20);
+    ui_screen_add(&d->screen, &d->title.base, false);
+    ui_screen_add(&d->screen, &d->wifi.base, false);
+    ui_screen_add(&d->screen, &d->temp.base, true);
+    ui_screen_add(&d->screen, &d->status.base, false);
+    ui_screen_add(&d->screen, &d->humidity.base, true);
+    ui_screen_add(&d->screen, &d->history.base, false);
+}
+
+static ui_dashboard_t ui_dash;
+static int ui_tick;
+
+/**
+ * @brief Um quadro de leituras: temperatura a cada 4 quadros, umidade a cada 5, gráfico a cada 10, Wi-Fi a cada 100
+ */
+static void ui_dashboard_step(void) {
+    ui_tick++;
+    int temp = 200 + ui_tick / 4 * 7 % 120;
+    if (0 == ui_tick % 4)
+        snprintf(ui_temp_text, sizeof ui_temp_text, "%d.%dC", temp / 10, temp % 10);
+    if (0 == ui_tick % 5)
+        ui_humidity = 40 + ui_tick / 5 % 40;
+    if (0 == ui_tick % 10)
+        ui_sparkline_push(&ui_dash.history, (int16_t)(temp + 100));
+    if (0 == ui_tick % 100)
+        ui_wifi ^= 1;
+}
+
+static void bench_ui_retained(void *ctx) {
+    (void)ctx;
+    ui_dashboard_step();
+    ui_render(&ui_dash.screen, &ssd);
+    ssd1306_send_data(&ssd);
+    ssd1306_sim_end_frame(&panel);
+}
+
+// Composição imperativa: limpa o quadro e redesenha tudo a cada leitura
+static void bench_ui_immediate(void *ctx) {
+    (void)ctx;
+    ui_dashboard_step();
+    ssd1306_fill(&ssd, false);
+    ui_invalidate(&ui_dash.screen);
+    ui_render(&ui_dash.screen, &ssd);
+    ssd1306_send_data(&ssd);
+    ssd1306_sim_end_frame(&panel);
+}
+
+/**
+ * @brief Renderiza do zero, noutro framebuffer, uma tela com os mesmos valores
+ */
+static bool ui_matches_fresh(void) {
+    static ui_dashboard_t fresh;
+    ui_dashboard_build(&fresh);
+    memcpy(fresh.history.samples, ui_dash.history.samples, sizeof fresh.history.samples);
+    fresh.history.head = ui_dash.history.head;
+    fresh.history.count = ui_dash.history.count;
+    ssd1306_fill(&raster_ref, false);
+    ui_render(&fresh.screen, &raster_ref);
+    return raster_same();
+}
+
+/**
+ * @brief Widgets retidos: só o que mudou é redesenhado e enviado
+ */
+static void run_ui(void) {
+    ssd1306_sim_attach(&panel, I2C_PORT_DISP, SSD1306_ADDR, 400000);
+    display_init(&ssd);
+    ssd1306_init(&raster_ref, SSD1306_WIDTH, SSD1306_HEIGHT, false, SSD1306_ADDR, I2C_PORT_DISP);
+    hal_bus_stats_t *stats = hal_i2c_stats(I2C_PORT_DISP);
+
+    strcpy(ui_temp_text, "25.4C");
+    strcpy(ui_status_text, "Conectado");
+    ui_humidity = 61;
+    ui_wifi = 1;
+    ui_tick = 0;
+    ui_dashboard_build(&ui_dash);
+    for (int i = 0; i < 10; ++i)
+        ui_sparkline_push(&ui_dash.history, (int16_t)(250 + i * 5));
+    uint8_t first = ui_render(&ui_dash.screen, &ssd);
+    ssd1306_send_data(&ssd);
+    uint8_t again = ui_render(&ui_dash.screen, &ssd);
+    hal_stats_reset(stats);
+    ssd1306_send_data(&ssd);
+    check(6 == first && 0 == again && 0 == stats->bytes_tx && panel_shows(&ssd) && ui_matches_fresh(),
+          "ui_first_render");
+
+    ui_humidity = 80;
+    uint8_t bar = ui_render(&ui_dash.screen, &ssd);
+    hal_stats_reset(stats);
+    ssd1306_send_data(&ssd);
+    uint64_t bar_bytes = stats->bytes_tx;
+    printf("# ui bar: %u widget redesenhado, %llu bytes I2C\n", bar, (unsigned long long)bar_bytes);
+    check(1 == bar && bar_bytes < 100 && panel_shows(&ssd) && ui_matches_fresh(), "ui_only_changed_widget");
+
+    // Texto mais largo desloca o vizinho da linha; ao encolher não sobram pixels
+    strcpy(ui_temp_text, "125.4C");
+    uint8_t grown = ui_render(&ui_dash.screen, &ssd);
+    bool grown_ok = 2 == grown && ui_matches_fresh();
+    strcpy(ui_temp_text, "5C");
+    uint8_t shrunk = ui_render(&ui_dash.screen, &ssd);
+    ssd1306_send_data(&ssd);
+    check(grown_ok && 2 == shrunk && panel_shows(&ssd) && ui_matches_fresh(), "ui_relayout");
+
+    ui_wifi = 0;
+    ui_sparkline_push(&ui_dash.history, 340);
+    uint8_t two = ui_render(&ui_dash.screen, &ssd);
+    ssd1306_send_data(&ssd);
+    check(2 == two && panel_shows(&ssd) && ui_matches_fresh(), "ui_icon_and_sparkline");
+
+    ssd1306_sim_reset_stats(&panel);
+    uint64_t retained = bench_run("ui_dashboard_retained", bench_ui_retained, NULL, 2000);
+    double retained_bytes = ssd1306_sim_bytes_per_frame(&panel);
+    double retained_bus = ssd1306_sim_bus_fps(&panel);
+    bool retained_ok = panel_shows(&ssd) && ui_matches_fresh();
+    ssd1306_sim_reset_stats(&panel);
+    uint64_t immediate = bench_run("ui_dashboard_immediate", bench_ui_immediate, NULL, 2000);
+    double immediate_bytes = ssd1306_sim_bytes_per_frame(&panel);
+    printf("# ui_dashboard: retido %.1f bytes I2C/quadro (%.0f quadros/s no barramento), imediato %.1f; CPU %.1fx menor no retido\n",
+           retained_bytes, retained_bus, immediate_bytes, (double)immediate / (double)(retained ? retained : 1));
+    check(retained_ok && retained_bytes <= immediate_bytes && 2 * retained < immediate, "ui_dashboard_incremental");
+
+    ssd1306_deinit(&ssd);
+    ssd1306_deinit(&raster_ref);
+}
+
+// Caminho de cor anterior: três doubles por LED, convertidos a cada quadro
+typedef struct {
+    double R, G, B;
+} ref_rgb_t;
+
+static uint32_t ref_matrix_rgb(double r, double g, double b) {
+    unsigned char R = r * 100, G = g * 100, B = b * 100;
+    return (G << 24) | (R << 16) | (B << 8);
+}
+
+// Disposição fixa anterior da matriz 5x5: serpentina a partir do canto inferior direito
+static int ref_matrix_index(int x, int y) {
+    return y % 2 == 0 ? 24 - (y * 5 + x) : 24 - (y * 5 + (4 - x));
+}
+
+static void ref_matrix_encode(const ref_rgb_t pixels[NUM_PIXELS], uint32_t words[NUM_PIXELS]) {
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        const ref_rgb_t *c = &pixels[ref_matrix_index(i % 5, i / 5)];
+        words[i] = ref_matrix_rgb(c->R, c->G, c->B);
+    }
+}
+
+static GRB matrix_frame[NUM_PIXELS];
+static ref_rgb_t matrix_ref_frame[NUM_PIXELS];
+static uint32_t matrix_words[NUM_PIXELS];
+static uint32_t matrix_captured[NUM_PIXELS];
+static uint matrix_captured_count;
+
+static uint64_t matrix_word_us[2 * NUM_PIXELS]; // Instante de cada palavra capturada
+static unsigned matrix_frames_done;
+
+static void matrix_capture(void *ctx, uint sm, uint32_t word) {
+    (void)ctx;
+    (void)sm;
+    if (matrix_captured_count < NUM_PIXELS)
+        matrix_captured[matrix_captured_count] = word;
+    if (matrix_captured_count < count_of(matrix_word_us))
+        matrix_word_us[matrix_captured_count] = time_us_64();
+    matrix_captured_count++;
+}
+
+static void matrix_count_done(void *ctx) {
+    (void)ctx;
+    matrix_frames_done++;
+}
+
+// Painéis comerciais, com as tabelas montadas pelo compilador como a da matriz
+#define MAP_16X16(i) (uint16_t)MATRIX_LAYOUT_INDEX((i) % 16, (i) / 16, 16, 16, 1, MATRIX_LAYOUT_SERPENTINE)
+#define MAP_32X8(i) \
+    (uint16_t)MATRIX_LAYOUT_INDEX((i) % 32, (i) / 32, 32, 8, 1, MATRIX_LAYOUT_VERTICAL | MATRIX_LAYOUT_SERPENTINE)
+#define MAP_2X2_8X8(i)                                                                                            \
+    (uint16_t)MATRIX_LAYOUT_INDEX((i) % 16, (i) / 16, 8, 8, 2,                                                     \
+                                  MATRIX_LAYOUT_BOTTOM | MATRIX_LAYOUT_SERPENTINE | MATRIX_LAYOUT_TILE_SERPENTINE)
+static const uint16_t map_16x16[256] = {MATRIX_REPEAT_256(MAP_16X16, 0)};
+static const uint16_t map_32x8[256] = {MATRIX_REPEAT_256(MAP_32X8, 0)};
+static const uint16_t map_2x2_8x8[256] = {MATRIX_REPEAT_256(MAP_2X2_8X8, 0)};
+
+/**
+ * @brief A tabela é uma permutação e LEDs vizinhos na cadeia são vizinhos na grade (dentro de cada painel)
+ */
+static bool matrix_map_valid(const uint16_t *map, int width, int height, int panel_leds) {
+    int n = width * height;
+    int16_t at[256];
+    memset(at, 0xff, sizeof at);
+    for (int i = 0; i < n; ++i) {
+        if (map[i] >= n || at[map[i]] >= 0)
+            return false;
+        at[map[i]] = (int16_t)i;
+    }
+    for (int p = 1; p < n; ++p) {
+        if (0 == p % panel_leds)
+            continue;
+        int dx = at[p] % width - at[p - 1] % width, dy = at[p] / width - at[p - 1] / width;
+        if (dx * dx + dy * dy != 1)
+            return false;
+    }
+    return true;
+}
+
+static void bench_matrix_encode_divmod(void *ctx) {
+    (void)ctx;
+    for (int i = 0; i < NUM_PIXELS; i++)
+        matrix_words[i] = matrix_word(matrix_frame[ref_matrix_index(i % 5, i / 5)]);
+}
+
+static void bench_matrix_dma_frame(void *ctx) {
+    (void)ctx;
+    matrix_submit(matrix_frame);
+    matrix_wait();
+}
+
+static int64_t matrix_idle_alarm(alarm_id_t id, void *user_data) {
+    (void)id;
+    (void)user_data;
+    return 0;
+}
+
+static void bench_matrix_double(void *ctx) {
+    (void)ctx;
+    ref_matrix_encode(matrix_ref_frame, matrix_words);
+}
+
+static void bench_matrix_lut(void *ctx) {
+    (void)ctx;
+    matrix_encode(matrix_frame, matrix_words);
+}
+
+/**
+ * @brief Cores da matriz WS2812 em GRB888 com tabelas de gama/brilho contra o caminho em double
+ */
+static void run_matrix(void) {
+    static const ref_rgb_t ref_palette[] = {
+        {0.1, 0, 0}, {0, 0.1, 0}, {0, 0, 0.1}, {0.1, 0.1, 0},
+        {0, 0.1, 0.1}, {0.1, 0, 0.1}, {0.1, 0.1, 0.1}, {0, 0, 0},
+    };
+    const GRB *palette[] = {&RED, &GREEN, &BLUE, &YELLOW, &CYAN, &MAGENTA, &WHITE, &BLACK};
+
+    // O brilho padrão reproduz as palavras das cores em double
+    matrix_set_brightness(MATRIX_BRIGHTNESS);
+    bool same = true;
+    for (size_t i = 0; i < count_of(palette); ++i)
+        same = same && matrix_word(*palette[i]) == ref_matrix_rgb(ref_palette[i].R, ref_palette[i].G, ref_palette[i].B);
+    check(same, "matrix_palette_words");
+
+    for (int i = 0; i < NUM_PIXELS; ++i) {
+        matrix_frame[i] = *palette[(i * 7) % count_of(palette)];
+        matrix_ref_frame[i] = ref_palette[(i * 7) % count_of(palette)];
+    }
+    uint32_t expected[NUM_PIXELS];
+    ref_matrix_encode(matrix_ref_frame, expected);
+    uint sm = matrix_init();
+    matrix_captured_count = 0;
+    hal_pio_set_sink(pio0, matrix_capture, NULL);
+    draw_matrix(matrix_frame, pio0, sm);
+    hal_pio_set_sink(pio0, NULL, NULL);
+    check(NUM_PIXELS == matrix_captured_count && 0 == memcmp(matrix_captured, expected, sizeof expected),
+          "matrix_draw_matches_double_path");
+
+    // Envio por DMA: o segundo quadro espera o latch do primeiro; o terceiro é recusado
+    matrix_wait();
+    matrix_frames_done = 0;
+    matrix_captured_count = 0;
+    matrix_set_done_callback(matrix_count_done, NULL);
+    hal_pio_set_sink(pio0, matrix_capture, NULL);
+    uint64_t starts = hal_dma_stats()->starts;
+    bool sent = matrix_submit(matrix_frame);
+    bool queued = matrix_submit(matrix_frame);
+    bool refused = !matrix_submit(matrix_frame);
+    bool pending = matrix_busy() && NUM_PIXELS == matrix_captured_count && 0 == matrix_frames_done;
+    matrix_wait();
+    hal_pio_set_sink(pio0, NULL, NULL);
+    // O DMA simulado termina de uma vez: o intervalo inclui o esvaziamento da
+    // FIFO unida (8 palavras + 1 em deslocamento, 30 us cada) e o latch
+    uint64_t gap = matrix_word_us[NUM_PIXELS] - matrix_word_us[NUM_PIXELS - 1];
+    printf("# matrix_dma: latch de %llu us entre quadros\n", (unsigned long long)gap);
+    check(sent && queued && refused && pending && 2 * NUM_PIXELS == matrix_captured_count &&
+          2 == matrix_frames_done && 2 == hal_dma_stats()->starts - starts && gap >= 9 * 30 + MATRIX_RESET_US &&
+          0 == memcmp(matrix_captured, expected, sizeof expected),
+          "matrix_dma_double_buffer_latch");
+    bench_run("matrix_dma_frame", bench_matrix_dma_frame, NULL, 200);
+
+    // Sem alarme livre, o quadro enfileirado ainda espera o esvaziamento da FIFO e o latch
+    alarm_id_t hogs[32];
+    uint hog_count = 0;
+    while (hog_count < count_of(hogs) &&
+           (hogs[hog_count] = add_alarm_in_ms(60000, matrix_idle_alarm, NULL, true)) > 0)
+        ++hog_count;
+    matrix_frames_done = 0;
+    matrix_captured_count = 0;
+    hal_pio_set_sink(pio0, matrix_capture, NULL);
+    sent = matrix_submit(matrix_frame);
+    queued = matrix_submit(matrix_frame);
+    pending = matrix_busy() && 0 == matrix_frames_done;
+    matrix_wait();
+    hal_pio_set_sink(pio0, NULL, NULL);
+    for (uint i = 0; i < hog_count; ++i)
+        cancel_alarm(hogs[i]);
+    gap = matrix_word_us[NUM_PIXELS] - matrix_word_us[NUM_PIXELS - 1];
+    check(hog_count < count_of(hogs) && sent && queued && pending && 2 * NUM_PIXELS == matrix_captured_count &&
+              2 == matrix_frames_done && gap >= 9 * 30 + MATRIX_RESET_US,
+          "matrix_dma_latch_without_alarm");
+    matrix_set_done_callback(NULL, NULL);
+
+    // Geometria: a tabela padrão reproduz a disposição 5x5 e as coordenadas são inversas
+    bool legacy = MATRIX_WIDTH == 5 && NUM_PIXELS == 25;
+    for (int y = 0; legacy && y < 5; ++y)
+        for (int x = 0; x < 5; ++x) {
+            int cx, cy;
+            getCoordinates((int)coordenates_to_index(x, y), &cx, &cy);
+            legacy = legacy && getIndex(x, y) == ref_matrix_index(x, y) && cx == x && cy == y;
+        }
+    check(legacy && matrix_map_valid(matrix_map, 5, 5, 25), "matrix_map_5x5");
+    check(matrix_map_valid(map_16x16, 16, 16, 256) && 0 == map_16x16[0] && 16 == map_16x16[16 + 15], "matrix_map_16x16");
+    check(matrix_map_valid(map_32x8, 32, 8, 256) && 15 == map_32x8[1] && 8 == map_32x8[32 * 7 + 1] && 255 == map_32x8[31], "matrix_map_32x8");
+    // Painéis 0 e 1 em cima (esquerda -> direita), 2 e 3 embaixo (direita -> esquerda)
+    check(matrix_map_valid(map_2x2_8x8, 16, 16, 64) && 0 == map_2x2_8x8[16 * 7] && 127 == map_2x2_8x8[8] &&
+              191 == map_2x2_8x8[16 * 8 + 8] && 255 == map_2x2_8x8[16 * 8],
+          "matrix_map_tiled");
+    uint64_t divmod = bench_run("matrix_encode_divmod", bench_matrix_encode_divmod, NULL, 200000);
+    uint64_t table = bench_run("matrix_encode_map", bench_matrix_lut, NULL, 200000);
+    printf("# matrix_map: %.1fx mais rapido com a tabela\n", (double)divmod / (double)(table ? table : 1));
+
+    // Gama antes do brilho: metade da intensidade fica bem abaixo da metade do byte
+    matrix_set_brightness(255);
+    bool gamma_ok = matrix_word(grb(255, 128, 0)) == (56u << 24 | 255u << 16) && 0 == matrix_word(BLACK);
+    uint32_t prev = 0;
+    for (uint v = 0; v < 256; ++v) {
+        uint32_t g = matrix_word(grb(0, (uint8_t)v, 0)) >> 24;
+        gamma_ok = gamma_ok && g >= prev;
+        prev = g;
+    }
+    check(gamma_ok && 255 == prev && 255 == matrix_get_brightness(), "matrix_gamma_monotonic");
+    matrix_set_brightness(MATRIX_BRIGHTNESS);
+
+    GRB a = grb(0, 100, 255), b = grb(255, 0, 3);
+    GRB first = grb_blend(a, b, 0), last = grb_blend(a, b, 256), mid = grb_blend(a, b, 128);
+    GRB half = grb_scale(WHITE, 127);
+    check(0 == memcmp(&first, &a, sizeof a) && 0 == memcmp(&last, &b, sizeof b) && mid.R == 128 && mid.G == 50 &&
+          mid.B == 129 && half.R == 127 && grb_scale(WHITE, 255).G == 255 && grb_scale(RED, 0).R == 0,
+          "matrix_blend_fixed_point");
+
+    printf("# matrix: quadro de %u LEDs em %zu bytes (antes %zu, %zux menor)\n", NUM_PIXELS,
+           sizeof matrix_frame, sizeof matrix_ref_frame, sizeof(ref_rgb_t) / sizeof(GRB));
+    check(8 * sizeof matrix_frame == sizeof matrix_ref_frame, "matrix_frame_8x_smaller");
+
+    uint64_t slow = bench_run("matrix_encode_double", bench_matrix_double, NULL, 200000);
+    uint64_t fast = bench_run("matrix_encode_lut", bench_matrix_lut, NULL, 200000);
+    printf("# matrix_encode: %.1fx mais rapido com as tabelas\n", (double)slow / (double)(fast ? fast : 1));
+}
+
+// Animação de status: ponto azul que cresce para um anel verde, pausa e pisca os cantos
+static const matrix_anim_delta_t anim_key0[] = {{12, {0, 0, 255}}};
+static const matrix_anim_delta_t anim_key1[] = {
+    {12, {255, 255, 255}}, {6, {255, 0, 0}}, {7, {255, 0, 0}}, {8, {255, 0, 0}}, {11, {255, 0, 0}},
+    {13, {255, 0, 0}}, {16, {255, 0, 0}}, {17, {255, 0, 0}}, {18, {255, 0, 0}},
+};
+static const matrix_anim_delta_t anim_key2[] = {{12, {0, 0, 0}}};
+static const matrix_anim_delta_t anim_key3[] = {
+    {6, {0, 0, 0}}, {7, {0, 0, 0}}, {8, {0, 0, 0}}, {11, {0, 0, 0}}, {13, {0, 0, 0}}, {16, {0, 0, 0}},
+    {17, {0, 0, 0}}, {18, {0, 0, 0}}, {0, {0, 255, 0}}, {4, {0, 255, 0}}, {20, {0, 255, 0}}, {24, {0, 255, 0}},
+};
+static const matrix_anim_key_t anim_keys[] = {
+    {anim_key0, count_of(anim_key0), 200, 0},
+    {anim_key1, count_of(anim_key1), 200, 0},
+    {anim_key2, count_of(anim_key2), 300, MATRIX_ANIM_HOLD},
+    {anim_key3, count_of(anim_key3), 200, 0},
+};
+static const matrix_anim_t anim_status = {NULL, anim_keys, count_of(anim_keys), true};
+static const matrix_anim_t anim_status_once = {NULL, anim_keys, count_of(anim_keys), false};
+
+static matrix_anim_player_t anim_player;
+static uint32_t anim_last_words[NUM_PIXELS]; // Último quadro recebido pelo PIO
+static unsigned anim_words;
+
+static void anim_capture(void *ctx, uint sm, uint32_t word) {
+    (void)ctx;
+    (void)sm;
+    anim_last_words[anim_words++ % NUM_PIXELS] = word;
+}
+
+/**
+ * @brief Quadro de uma keyframe montado diretamente das listas de deltas
+ */
+static void anim_expected_key(uint16_t k, GRB frame[NUM_PIXELS]) {
+    memset(frame, 0, sizeof(GRB) * NUM_PIXELS);
+    for (uint16_t i = 0; i <= k; ++i)
+        for (uint16_t d = 0; d < anim_keys[i].count; ++d)
+            frame[anim_keys[i].deltas[d].pixel] = anim_keys[i].deltas[d].color;
+}
+
+/**
+ * @brief Grava os quadros em TEMPLATE_FRAMES_DIR, se definido: PPM com um quadro abaixo do outro
+ */
+static void anim_dump(const char *name, const uint8_t *rgb, unsigned frames) {
+    const char *dir = getenv("TEMPLATE_FRAMES_DIR");
+    if (!dir)
+        return;
+    char path[256];
+    snprintf(path, sizeof path, "%s/%s.ppm", dir, name);
+    FILE *f = fopen(path, "wb");
+    bool ok = f && fprintf(f, "P6\n%u %u\n255\n", MATRIX_WIDTH, MATRIX_HEIGHT * frames) > 0 &&
+              fwrite(rgb, 3 * NUM_PIXELS, frames, f) == frames;
+    if (!f || 0 != fclose(f) || !ok)
+        printf("# %s: falha ao gravar\n", path);
+}
+
+/**
+ * @brief Animação por keyframes: interpolação, pausa, repetição e envio só dos quadros alterados
+ */
+static void run_anim(void) {
+    GRB key[NUM_PIXELS];
+    uint32_t period = matrix_anim_duration_ms(&anim_status);
+    size_t flash = matrix_anim_flash_size(&anim_status);
+    printf("# anim: %u keyframes, %u ms, %zu bytes em flash (quadros completos: %zu)\n", anim_status.num_keys,
+           period, flash, anim_status.num_keys * sizeof key);
+    check(900 == period && 700 == matrix_anim_duration_ms(&anim_status_once) &&
+              flash < anim_status.num_keys * sizeof key,
+          "anim_flash_footprint");
+
+    // Duas passagens no período do timer, desenhadas num dump de pixels
+    enum { FRAMES = 2 * 900 / MATRIX_ANIM_TICK_MS + 1 };
+    static uint8_t dump[FRAMES][NUM_PIXELS][3];
+    matrix_anim_start(&anim_player, &anim_status);
+    unsigned changes = 0, hold_changes = 0;
+    bool keys_exact = true, interpolated = false;
+    for (unsigned f = 0; f < FRAMES; ++f) {
+        uint32_t t = f * MATRIX_ANIM_TICK_MS;
+        bool changed = matrix_anim_step(&anim_player, t);
+        changes += changed;
+        if (t % 900 > 400 && t % 900 < 700)
+            hold_changes += changed;
+        static const uint32_t key_ms[] = {0, 200, 400, 700};
+        for (uint16_t k = 0; k < count_of(key_ms); ++k)
+            if (t % 900 == key_ms[k]) {
+                anim_expected_key(k, key);
+                keys_exact = keys_exact && 0 == memcmp(key, anim_player.frame, sizeof key);
+            }
+        if (100 == t) {
+            GRB mid = grb_blend((GRB){0, 0, 255}, (GRB){255, 255, 255}, 128);
+            interpolated = 0 == memcmp(&mid, &anim_player.frame[12], sizeof mid);
+        }
+        for (int i = 0; i < NUM_PIXELS; ++i) {
+            dump[f][i][0] = anim_player.frame[i].R;
+            dump[f][i][1] = anim_player.frame[i].G;
+            dump[f][i][2] = anim_player.frame[i].B;
+        }
+    }
+    uint16_t crc = sd_sim_crc16(&dump[0][0][0], sizeof dump);
+    printf("# anim: %u quadros, %u alterados, crc 0x%04x\n", FRAMES, changes, crc);
+    check(keys_exact && interpolated, "anim_keyframes_and_interpolation");
+    check(0 == hold_changes && changes < FRAMES, "anim_only_changed_frames");
+    check(0xeb0c == crc, "anim_pixel_dump_golden");
+    anim_dump("anim_status", &dump[0][0][0], FRAMES);
+
+    // Reprodução no timer: termina na última keyframe, sem reenviar quadros repetidos
+    matrix_init();
+    anim_words = 0;
+    hal_pio_set_sink(pio0, anim_capture, NULL);
+    uint64_t start = time_us_64();
+    bool started = matrix_anim_play(&anim_player, &anim_status_once);
+    while (matrix_anim_playing(&anim_player) && time_us_64() - start < 5000000)
+        sleep_ms(1);
+    matrix_wait();
+    hal_pio_set_sink(pio0, NULL, NULL);
+    uint32_t expected[NUM_PIXELS];
+    anim_expected_key(3, key);
+    matrix_encode(key, expected);
+    unsigned ticks = 700 / MATRIX_ANIM_TICK_MS;
+    printf("# anim play: %u quadros enviados em %u periodos, %.0f ms\n", (unsigned)anim_player.frames_sent, ticks,
+           (time_us_64() - start) / 1000.0);
+    check(started && !matrix_anim_playing(&anim_player) && anim_words == anim_player.frames_sent * NUM_PIXELS &&
+              anim_player.frames_sent > 1 && anim_player.frames_sent < ticks &&
+              0 == memcmp(anim_last_words, expected, sizeof expected),
+          "anim_timer_playback");
+    matrix_anim_stop(&anim_player);
+
+    // Interrompida no meio da sequência, a reprodução consta como terminada
+    hal_pio_set_sink(pio0, anim_capture, NULL);
+    started = matrix_anim_play(&anim_player, &anim_status_once);
+    sleep_ms(100);
+    bool mid_playing = matrix_anim_playing(&anim_player);
+    matrix_anim_stop(&anim_player);
+    matrix_wait();
+    unsigned words_at_stop = anim_words;
+    sleep_ms(100);
+    check(started && mid_playing && !matrix_anim_playing(&anim_player) && words_at_stop == anim_words,
+          "anim_stop_mid_sequence");
+    hal_pio_set_sink(pio0, NULL, NULL);
+}
+
+/**
+ * @brief Transposição de referência, bit a bit
+ */
+static void ref_parallel_transpose(const uint32_t words[MATRIX_PARALLEL_MAX_STRIPS], uint32_t planes[MATRIX_PARALLEL_WORDS_PER_LED]) {
+    memset(planes, 0, MATRIX_PARALLEL_WORDS_PER_LED * sizeof(uint32_t));
+    for (uint p = 0; p < 24; ++p)
+        for (uint i = 0; i < MATRIX_PARALLEL_MAX_STRIPS; ++i)
+            if (words[i] >> (31 - p) & 1)
+                planes[p / 4] |= 1u << (8 * (p % 4) + i);
+}
+
+static uint32_t parallel_in[MATRIX_PARALLEL_MAX_STRIPS];
+static uint32_t parallel_out[MATRIX_PARALLEL_WORDS_PER_LED];
+static uint32_t parallel_words[25 * MATRIX_PARALLEL_WORDS_PER_LED]; // Palavras recebidas pelo PIO
+static unsigned parallel_count;
+
+static void parallel_capture(void *ctx, uint sm, uint32_t word) {
+    (void)ctx;
+    (void)sm;
+    if (parallel_count < count_of(parallel_words))
+        parallel_words[parallel_count] = word;
+    parallel_count++;
+}
+
+static void bench_parallel_transpose(void *ctx) {
+    (void)ctx;
+    matrix_parallel_transpose(parallel_in, parallel_out);
+}
+
+static void bench_parallel_transpose_bits(void *ctx) {
+    (void)ctx;
+    ref_parallel_transpose(parallel_in, parallel_out);
+}
+
+/**
+ * @brief Bits que o programa pio_matrix_parallel coloca na fita durante o LED dado
+ *
+ * Decodifica as palavras como a máquina de estados: um plano por OUT de 8
+ * bits, do byte menos significativo ao mais significativo.
+ */
+static uint32_t parallel_decode(const uint32_t *words, uint led, uint strip) {
+    uint32_t value = 0;
+    for (uint p = 0; p < 24; ++p) {
+        uint8_t plane = (uint8_t)(words[led * MATRIX_PARALLEL_WORDS_PER_LED + p / 4] >> (8 * (p % 4)));
+        value = value << 1 | (plane >> strip & 1);
+    }
+    return value;
+}
+
+/**
+ * @brief Fitas em paralelo: layout dos planos de bits e tempo de quadro independente do número de fitas
+ */
+static void run_parallel(void) {
+    bool same = true;
+    uint32_t ref[MATRIX_PARALLEL_WORDS_PER_LED];
+    srand(25);
+    for (int n = 0; n < 2000 && same; ++n) {
+        for (uint i = 0; i < MATRIX_PARALLEL_MAX_STRIPS; ++i)
+            parallel_in[i] = ((uint32_t)rand() << 8) ^ ((uint32_t)rand() << 20);
+        matrix_parallel_transpose(parallel_in, parallel_out);
+        ref_parallel_transpose(parallel_in, ref);
+        same = 0 == memcmp(parallel_out, ref, sizeof ref);
+    }
+    // Fita 0 com o verde 0x80 e fita 7 com o azul 0x01: primeiro e último plano
+    memset(parallel_in, 0, sizeof parallel_in);
+    parallel_in[0] = 0x80u << 24;
+    parallel_in[7] = 0x01u << 8;
+    matrix_parallel_transpose(parallel_in, parallel_out);
+    check(same && 0x01 == parallel_out[0] && 0x80000000u == parallel_out[5] && 0 == parallel_out[1] + parallel_out[4],
+          "parallel_transpose_layout");
+
+    // Cinco fitas de 25 LEDs, a segunda com só 10 e a quarta desligada (NULL): o PIO recebe o
+    // quadro inteiro em planos, com zeros depois do fim da fita curta
+    static GRB strips[MATRIX_PARALLEL_MAX_STRIPS][25];
+    const GRB *rows[MATRIX_PARALLEL_MAX_STRIPS];
+    for (uint i = 0; i < MATRIX_PARALLEL_MAX_STRIPS; ++i) {
+        for (uint led = 0; led < 25; ++led)
+            strips[i][led] = grb((uint8_t)(i * 32 + led), (uint8_t)(255 - led * 7), (uint8_t)(i ^ led) * 9);
+        rows[i] = strips[i];
+    }
+    rows[3] = NULL;
+    const uint16_t lengths[MATRIX_PARALLEL_MAX_STRIPS] = {25, 10, 25, 25, 25};
+    matrix_set_brightness(255);
+    matrix_parallel_t par;
+    bool init = matrix_parallel_init(&par, pio1, 8, 5, 25);
+    parallel_count = 0;
+    hal_pio_set_sink(pio1, parallel_capture, NULL);
+    matrix_parallel_show(&par, rows, lengths);
+    matrix_parallel_wait(&par);
+    hal_pio_set_sink(pio1, NULL, NULL);
+    bool decoded = init && 25 * MATRIX_PARALLEL_WORDS_PER_LED == parallel_count;
+    for (uint led = 0; decoded && led < 25; ++led)
+        for (uint i = 0; decoded && i < MATRIX_PARALLEL_MAX_STRIPS; ++i) {
+            uint32_t expected = i < 5 && rows[i] && led < lengths[i] ? matrix_word(strips[i][led]) >> 8 : 0;
+            decoded = parallel_decode(parallel_words, led, i) == expected;
+        }
+    check(decoded, "parallel_pio_bit_layout");
+    uint32_t five_us = matrix_parallel_frame_us(&par);
+    matrix_parallel_deinit(&par);
+    bool released = true;
+    for (uint pin = 8; pin < 8 + 5; ++pin)
+        released &= GPIO_FUNC_SIO == gpio_get_function(pin) && gpio_is_dir_out(pin) && !gpio_get(pin);
+    check(released, "parallel_deinit_releases_pins");
+
+    // Palavras e tempo por quadro iguais com 1 e 8 fitas; em série, 8 fitas levariam 8 quadros
+    matrix_parallel_t one, eight;
+    bool both = matrix_parallel_init(&one, pio1, 8, 1, 25) && matrix_parallel_init(&eight, pio1, 16, 8, 25);
+    hal_bus_stats_t *stats = hal_pio_stats(pio1);
+    hal_stats_reset(stats);
+    matrix_parallel_show(&one, rows, NULL);
+    matrix_parallel_wait(&one);
+    uint64_t one_bytes = stats->bytes_tx;
+    hal_stats_reset(stats);
+    for (uint i = 0; i < MATRIX_PARALLEL_MAX_STRIPS; ++i)
+        rows[i] = strips[i];
+    matrix_parallel_show(&eight, rows, NULL);
+    matrix_parallel_wait(&eight);
+    uint64_t eight_bytes = stats->bytes_tx;
+    printf("# parallel: quadro de 25 LEDs em %u us com 1, 5 ou 8 fitas (%llu bytes ao PIO); em série, 8 fitas: %u us\n",
+           (unsigned)matrix_parallel_frame_us(&eight), (unsigned long long)eight_bytes,
+           (unsigned)(8 * matrix_parallel_frame_us(&one)));
+    check(both && one_bytes == eight_bytes && matrix_parallel_frame_us(&one) == matrix_parallel_frame_us(&eight) &&
+              five_us == matrix_parallel_frame_us(&eight),
+          "parallel_constant_refresh");
+    matrix_parallel_deinit(&one);
+    matrix_parallel_deinit(&eight);
+    matrix_set_brightness(MATRIX_BRIGHTNESS);
+
+    uint64_t bits = bench_run("parallel_transpose_bits", bench_parallel_transpose_bits, NULL, 200000);
+    uint64_t fast = bench_run("parallel_transpose_8x8", bench_parallel_transpose, NULL, 200000);
+    printf("# parallel_transpose: %.1fx mais rapido que bit a bit\n", (double)bits / (double)(fast ? fast : 1));
+}
+
+static hal_i2c_mem_t bmp280_mem;
+static hal_i2c_mem_t mpu6050_mem;
+static struct bmp280_calib_param bmp280_params;
+
+static void bench_bmp280(void *ctx) {
+    volatile int32_t *out = ctx;
+    int32_t raw_temp, raw_pressure;
+    bmp280_read_raw(i2c0, &raw_temp, &raw_pressure);
+    out[0] = bmp280_convert_temp(raw_temp, &bmp280_params);
+    out[1] = bmp280_convert_pressure(raw_pressure, raw_temp, &bmp280_params);
+}
+
+static void bench_mpu6050(void *ctx) {
+    volatile int16_t *out = ctx;
+    MPU6050_Data data = get_mpu6050_data();
+    *out = data.accel_x;
+}
+
+static void bench_joystick(void *ctx) {
+    uint16_t *xy = ctx;
+    reading_joystick(&xy[0], &xy[1]);
+}
+
+/**
+ * @brief Benchmarks de leitura e conversão dos sensores
+ */
+static void run_sensors(void) {
+    // Parâmetros de calibração do exemplo da folha de dados do BMP280
+    static const uint8_t calib[NUM_CALIB_PARAMS] = {
+        0x70, 0x6B, 0x43, 0x67, 0x18, 0xFC, 0x7D, 0x8E, 0x43, 0xD6, 0xD0, 0x0B,
+        0x27, 0x0B, 0x8C, 0x00, 0xF9, 0xFF, 0x8C, 0x3C, 0xF8, 0xC6, 0x70, 0x17};
+    memcpy(&bmp280_mem.regs[REG_DIG_T1_LSB], calib, sizeof calib);
+    // Leituras cruas: pressão 415148, temperatura 519888
+    static const uint8_t raw[6] = {0x65, 0x5A, 0xC0, 0x7E, 0xED, 0x00};
+    memcpy(&bmp280_mem.regs[REG_PRESSURE_MSB], raw, sizeof raw);
+    hal_i2c_mem_attach(i2c0, ADDR, &bmp280_mem);
+    bmp280_init(i2c0);
+    bmp280_get_calib_params(i2c0, &bmp280_params);
+
+    for (uint8_t i = 0; i < 14; ++i)
+        mpu6050_mem.regs[0x3B + i] = (uint8_t)(i * 17);
+    hal_i2c_mem_attach(I2C_PORT, (uint8_t)addr, &mpu6050_mem);
+
+    hal_adc_set(0, 2048);
+    hal_adc_set(1, 3100);
+    joystick_init();
+
+    int32_t bmp_out[2];
+    int16_t mpu_out;
+    uint16_t joy_out[2];
+    bench_run("sensor_bmp280_read_convert", bench_bmp280, bmp_out, 100000);
+    bench_run("sensor_mpu6050_read", bench_mpu6050, &mpu_out, 100000);
+    bench_run("sensor_joystick_read", bench_joystick, joy_out, 1000000);
+    printf("# bmp280: %ld centi-C, %ld Pa\n", (long)bmp_out[0], (long)bmp_out[1]);
+}
+
+#define SIM_SECTORS (64 * 1024) // Cartão simulado de 32 MB
+#define SD_READ_BLOCKS 64
+
+static sd_sim_t sd_sim;
+static sd_card_t *sd;
+static uint8_t sd_buf[SD_READ_BLOCKS * SD_SIM_BLOCK_SIZE];
+static uint64_t sd_lba;
+
+static void bench_sd_read_single(void *ctx) {
+    (void)ctx;
+    sd->read_blocks(sd, sd_buf, sd_lba, 1);
+    sd_lba = (sd_lba + 1) % (SIM_SECTORS - SD_READ_BLOCKS);
+}
+
+static void bench_sd_read_multi(void *ctx) {
+    uint32_t count = *(uint32_t *)ctx;
+    sd->read_blocks(sd, sd_buf, sd_lba, count);
+    sd_lba = (sd_lba + count) % (SIM_SECTORS - SD_READ_BLOCKS);
+}
+
+/**
+ * @brief Mede uma leitura multibloco e relata o custo no barramento por bloco
+ * @param name Nome do benchmark
+ * @param count Blocos por leitura
+ * @param iterations Repetições
+ */
+static void run_sd_read(const char *name, uint32_t count, uint32_t iterations) {
+    hal_bus_stats_t *stats = hal_spi_stats(spi0);
+    hal_stats_reset(stats);
+    *hal_dma_stats() = (hal_dma_stats_t){0};
+    if (1 == count)
+        bench_run(name, bench_sd_read_single, NULL, iterations);
+    else
+        bench_run(name, bench_sd_read_multi, &count, iterations);
+    uint64_t blocks = (uint64_t)(iterations + 1) * count;
+    double efficiency = 100.0 * blocks * SD_SIM_BLOCK_SIZE / (double)stats->bytes_tx;
+    printf("# %s: %.1f bytes SPI/bloco, %.2f transferencias/bloco (%.2f por DMA), %.1f%% da taxa da linha\n", name,
+           (double)stats->bytes_tx / blocks, (double)stats->transactions / blocks,
+           (double)hal_dma_stats()->starts / blocks, efficiency);
+}
+
+static FIL bench_fil;
+static uint8_t fatfs_buf[4096];
+
+static void bench_fatfs_write(void *ctx) {
+    (void)ctx;
+    UINT bw;
+    f_open(&bench_fil, "0:/bench.bin", FA_CREATE_ALWAYS | FA_WRITE);
+    for (int i = 0; i < 16; ++i)
+        f_write(&bench_fil, fatfs_buf, sizeof fatfs_buf, &bw);
+    f_close(&bench_fil);
+}
+
+static void bench_fatfs_read(void *ctx) {
+    (void)ctx;
+    UINT br;
+    f_open(&bench_fil, "0:/bench.bin", FA_READ);
+    for (int i = 0; i < 16; ++i)
+        f_read(&bench_fil, fatfs_buf, sizeof fatfs_buf, &br);
+    f_close(&bench_fil);
+}
+
+#define LOG_RECORDS 256
+#define LOG_SYNC_EVERY 8
+
+static FIL event_fil;
+
+static void bench_fatfs_log(void *ctx) {
+    (void)ctx;
+    UINT bw;
+    static char record[64];
+    f_open(&bench_fil, "0:/log.txt", FA_OPEN_APPEND | FA_WRITE);
+    f_open(&event_fil, "0:/events.txt", FA_OPEN_APPEND | FA_WRITE);
+    for (int i = 0; i < LOG_RECORDS; ++i) {
+        snprintf(record, sizeof record, "%08d,23.51,1013.25,0.012,-0.998,0.043,0,0,0,0,0,0,0\n", i);
+        f_write(&bench_fil, record, sizeof record - 1, &bw);
+        f_write(&event_fil, record, 16, &bw);
+        if (LOG_SYNC_EVERY - 1 == i % LOG_SYNC_EVERY) {
+            f_sync(&bench_fil);
+            f_sync(&event_fil);
+        }
+    }
+    f_close(&event_fil);
+    f_close(&bench_fil);
+}
+
+/**
+ * @brief Registrador típico: registros curtos com f_sync frequente
+ */
+static void run_fatfs_log(void) {
+    sd_sim_stats_t before = sd_sim.stats;
+    sector_cache_stats_t cache_before = *sector_cache_stats(0);
+    bench_run("fatfs_log_append_sync", bench_fatfs_log, NULL, 10);
+    const sector_cache_stats_t *cache = sector_cache_stats(0);
+    double syncs = 11.0 * LOG_RECORDS / LOG_SYNC_EVERY;
+    printf("# fatfs_log_append_sync: por ciclo de f_sync %.2f blocos gravados, %.2f CMD24, %.2f CMD25, "
+           "%.2f gravacoes do cache\n",
+           (sd_sim.stats.blocks_written - before.blocks_written) / syncs,
+           (sd_sim.stats.single_writes - before.single_writes) / syncs,
+           (sd_sim.stats.multi_writes - before.multi_writes) / syncs,
+           (cache->write_commands - cache_before.write_commands) / syncs);
+}
+
+/**
+ * @brief Um setor sujo deixado no cache chega ao cartão sem nenhum outro acesso ao volume
+ */
+static void run_sd_flusher(void) {
+    uint64_t lba = SIM_SECTORS - 1; // Fora dos arquivos usados pelas suítes
+    check(0 == sector_cache_read(0, sd_buf, lba, 1), "sd_flusher_read");
+    memset(sd_buf, 0xA5, SD_SIM_BLOCK_SIZE);
+    uint32_t writebacks = sector_cache_stats(0)->writebacks;
+    check(0 == sector_cache_write(0, sd_buf, lba, 1) && sd_sim_sector(&sd_sim, lba)[0] != 0xA5,
+          "sd_flusher_write_cached");
+    check(sd_flusher_start(), "sd_flusher_start");
+    uint64_t start = time_us_64();
+    while (sector_cache_stats(0)->writebacks == writebacks &&
+           time_us_64() - start < 2000 * (SECTOR_CACHE_FLUSH_MS + SD_FLUSHER_PERIOD_MS))
+        sleep_ms(10);
+    uint32_t age_ms = (uint32_t)((time_us_64() - start) / 1000);
+    sd_flusher_stop();
+    printf("# sd_flusher: setor gravado %lu ms depois de iniciada a tarefa\n", (unsigned long)age_ms);
+    check(0 == memcmp(sd_sim_sector(&sd_sim, lba), sd_buf, SD_SIM_BLOCK_SIZE) &&
+              age_ms <= SECTOR_CACHE_FLUSH_MS + 2 * SD_FLUSHER_PERIOD_MS,
+          "sd_flusher_writes_expired_sector");
+}
+
+#define SD_LOG_RECORD 32
+#define SD_LOG_FILE_SIZE (64 * 1024)
+
+static sd_log_t sd_log;
+static uint32_t sd_log_seq;
+
+static uint8_t *sd_log_record(void) {
+    static uint8_t record[SD_LOG_RECORD];
+    for (int i = 0; i < SD_LOG_RECORD; i += 4)
+        memcpy(record + i, &sd_log_seq, 4);
+    ++sd_log_seq;
+    return record;
+}
+
+static void bench_sd_log_append(void *ctx) {
+    (void)ctx;
+    sd_log_append(&sd_log, sd_log_record(), SD_LOG_RECORD);
+}
+
+static void bench_fwrite_append(void *ctx) {
+    (void)ctx;
+    UINT bw;
+    f_write(&bench_fil, sd_log_record(), SD_LOG_RECORD, &bw);
+}
+
+/**
+ * @brief Registrador pré-alocado: custo por registro, rotação e conteúdo
+ */
+static void run_sd_log(void) {
+    enum { RECORDS = 5000 };
+    check(FR_OK == sd_log_open(&sd_log, "0:/adc", SD_LOG_FILE_SIZE), "sd_log_open");
+    sd_sim_stats_t before = sd_sim.stats;
+    hal_stats_reset(hal_spi_stats(spi0));
+    bench_run("sd_log_append_32b", bench_sd_log_append, NULL, RECORDS - 1);
+    printf("# sd_log_append_32b: %.1f bytes SPI, %.3f blocos, %.3f CMD24, %.3f CMD25 por registro\n",
+           (double)hal_spi_stats(spi0)->bytes_tx / RECORDS, (double)(sd_sim.stats.blocks_written - before.blocks_written) / RECORDS,
+           (double)(sd_sim.stats.single_writes - before.single_writes) / RECORDS,
+           (double)(sd_sim.stats.multi_writes - before.multi_writes) / RECORDS);
+    check(FR_OK == sd_log_sync(&sd_log), "sd_log_sync");
+    check(FR_OK == sd_log_close(&sd_log), "sd_log_close");
+
+    // 160000 bytes: dois arquivos cheios e o terceiro truncado no tamanho usado
+    FILINFO fno;
+    check(FR_OK == f_stat("0:/adc.001", &fno) && SD_LOG_FILE_SIZE == fno.fsize &&
+              FR_OK == f_stat("0:/adc.002", &fno) && RECORDS * SD_LOG_RECORD - 2 * SD_LOG_FILE_SIZE == fno.fsize,
+          "sd_log_rotate_truncate");
+    bool same = FR_OK == f_open(&bench_fil, "0:/adc.002", FA_READ);
+    uint32_t seq = 2 * SD_LOG_FILE_SIZE / SD_LOG_RECORD;
+    uint8_t record[SD_LOG_RECORD];
+    UINT br;
+    while (same && FR_OK == f_read(&bench_fil, record, sizeof record, &br) && br) {
+        uint32_t v;
+        memcpy(&v, record + SD_LOG_RECORD - 4, 4);
+        same = sizeof record == br && seq++ == v;
+    }
+    f_close(&bench_fil);
+    check(same && RECORDS == seq, "sd_log_read_verify");
+    // Uma nova abertura continua na numeração em vez de sobrescrever
+    check(FR_OK == sd_log_open(&sd_log, "0:/adc", SD_LOG_FILE_SIZE) && 3 == sd_log.index &&
+              FR_OK == sd_log_close(&sd_log),
+          "sd_log_reopen_next_index");
+
+    f_open(&bench_fil, "0:/fwrite.bin", FA_CREATE_ALWAYS | FA_WRITE);
+    before = sd_sim.stats;
+    hal_stats_reset(hal_spi_stats(spi0));
+    bench_run("f_write_append_32b", bench_fwrite_append, NULL, RECORDS - 1);
+    f_close(&bench_fil);
+    printf("# f_write_append_32b: %.1f bytes SPI, %.3f blocos, %.3f CMD24, %.3f CMD25 por registro\n",
+           (double)hal_spi_stats(spi0)->bytes_tx / RECORDS, (double)(sd_sim.stats.blocks_written - before.blocks_written) / RECORDS,
+           (double)(sd_sim.stats.single_writes - before.single_writes) / RECORDS,
+           (double)(sd_sim.stats.multi_writes - before.multi_writes) / RECORDS);
+    for (int i = 0; i < 4; ++i) {
+        char path[16];
+        snprintf(path, sizeof path, "0:/adc.%03d", i);
+        f_unlink(path);
+    }
+    f_unlink("0:/fwrite.bin");
+}
+
+#define WRITER_RECORDS 4000
+#define WRITER_PERIOD_US 200 // Produtor a 5 kHz
+#define WRITER_STALL_US 20000
+
+/**
+ * @brief Produz registros em ritmo fixo e mede o pior tempo de entrega
+ * @param async true para sd_writer_submit, false para sd_log_append direto
+ * @return Pior latência de um registro, em microssegundos
+ */
+static uint64_t produce_records(bool async) {
+    uint64_t worst = 0, next = time_us_64();
+    sd_log_seq = 0;
+    for (int i = 0; i < WRITER_RECORDS; ++i) {
+        while (time_us_64() < next)
+            sleep_us(next - time_us_64());
+        next += WRITER_PERIOD_US;
+        uint64_t start = time_us_64();
+        if (async)
+            sd_writer_submit(sd_log_record(), SD_LOG_RECORD, 0);
+        else
+            sd_log_append(&sd_log, sd_log_record(), SD_LOG_RECORD);
+        uint64_t elapsed = time_us_64() - start;
+        if (elapsed > worst)
+            worst = elapsed;
+    }
+    return worst;
+}
+
+/**
+ * @brief Gravador assíncrono com o cartão parando 20 ms a cada 64 blocos
+ */
+static void run_sd_writer(void) {
+    sd_sim.stall_every = 64;
+    sd_sim.stall_us = WRITER_STALL_US;
+
+    check(FR_OK == sd_log_open(&sd_log, "0:/sync", SD_LOG_FILE_SIZE * 4), "sd_log_open_sync");
+    uint64_t sync_worst = produce_records(false);
+    sd_log_close(&sd_log);
+    printf("# sd_log_append_sync: pior registro %llu us\n", (unsigned long long)sync_worst);
+    check(sync_worst >= WRITER_STALL_US, "sd_sim_stall_injected");
+
+    check(sd_writer_start("0:/async", SD_LOG_FILE_SIZE * 4), "sd_writer_start");
+    uint64_t async_worst = produce_records(true);
+    static uint8_t oversized[SD_WRITER_STREAM_SIZE + 1];
+    check(0 == sd_writer_submit(oversized, sizeof oversized, pdMS_TO_TICKS(10)), "sd_writer_refuses_oversized");
+    check(sd_writer_stop(pdMS_TO_TICKS(5000)), "sd_writer_stop");
+    const sd_writer_stats_t *st = sd_writer_stats();
+    printf("# sd_writer_submit: pior registro %llu us, %lu buffers, pior gravacao %lu us, "
+           "stream ate %lu bytes, %lu bytes descartados\n",
+           (unsigned long long)async_worst, (unsigned long)st->buffers_written, (unsigned long)st->max_write_us,
+           (unsigned long)st->max_stream_used, (unsigned long)st->bytes_dropped);
+    check(async_worst < WRITER_STALL_US / 2, "sd_writer_submit_not_stalled");
+    check(0 == sd_writer_submit(sd_log_record(), SD_LOG_RECORD, 0), "sd_writer_submit_after_stop");
+
+    // O arquivo tem exatamente os registros aceitos, inteiros e em ordem
+    FILINFO fno;
+    bool ok = FR_OK == f_stat("0:/async.000", &fno) && st->bytes_submitted == fno.fsize &&
+              FR_OK == f_open(&bench_fil, "0:/async.000", FA_READ);
+    uint32_t last = 0, count = 0;
+    uint8_t record[SD_LOG_RECORD];
+    UINT br;
+    while (ok && FR_OK == f_read(&bench_fil, record, sizeof record, &br) && br) {
+        uint32_t v;
+        memcpy(&v, record, 4);
+        ok = sizeof record == br && (0 == count || v > last);
+        for (int i = 4; ok && i < SD_LOG_RECORD; i += 4)
+            ok = 0 == memcmp(record + i, &v, 4);
+        last = v;
+        ++count;
+    }
+    f_close(&bench_fil);
+    check(ok && WRITER_RECORDS - (st->bytes_dropped - sizeof oversized) / SD_LOG_RECORD == count,
+          "sd_writer_read_verify");
+    f_unlink("0:/sync.000");
+    f_unlink("0:/async.000");
+    sd_sim.stall_every = 0;
+}
+
+/**
+ * @brief Reinicializa o cartão 0: e relata o clock escolhido pela afinação
+ */
+static bool sd_reinit_tuned(const char *what) {
+    sd->m_Status |= STA_NOINIT;
+    bool ok = 0 == (sd->init(sd) & STA_NOINIT);
+    printf("# %s: %u Hz%s, %lu leituras de teste falharam\n", what, sd->baud_rate,
+           sd->high_speed ? " (High Speed)" : "", (unsigned long)sd->tune_errors);
+    return ok;
+}
+
+/**
+ * @brief Afinação do clock SPI no sd_init: teto do barramento, limite do cartão e da ligação
+ */
+static void run_sd_clock_tuning(void) {
+    check(spi_get_baudrate(spi0) == sd->baud_rate && sd->baud_rate <= sd->spi->baud_rate && !sd->high_speed,
+          "sd_clock_tuning_ceiling");
+    const uint ceiling = sd->spi->baud_rate;
+    sd->spi->baud_rate = 62500000; // Divisor 2 do PL022
+    // Com High Speed o cartão vai a 50 MHz: 31,25 MHz é o maior clock possível abaixo disso
+    check(sd_reinit_tuned("sd_clock_high_speed") && sd->high_speed && 31250000 == sd->baud_rate &&
+              0 == sd->tune_errors,
+          "sd_clock_tuning_high_speed");
+    // Sem High Speed, até 25 MHz
+    sd_sim.high_speed_capable = false;
+    check(sd_reinit_tuned("sd_clock_default_speed") && !sd->high_speed && 20833333 == sd->baud_rate,
+          "sd_clock_tuning_default_speed");
+    sd_sim.high_speed_capable = true;
+    // Uma ligação que só aguenta 16 MHz: a afinação falha acima disso e recua
+    sd_sim.max_baud_rate = 16000000;
+    check(sd_reinit_tuned("sd_clock_limited") && 15625000 == sd->baud_rate && sd->tune_errors > 0 &&
+              SD_BLOCK_DEVICE_ERROR_NONE == sd->read_blocks(sd, sd_buf, 1000, SD_READ_BLOCKS),
+          "sd_clock_tuning_backs_off");
+    // Nem o clock de inicialização lê certo: o cartão não é inicializado
+    sd_sim.corrupt_sectors = true;
+    check(!sd_reinit_tuned("sd_clock_unusable") && 0 == sd->baud_rate && 1 == sd->tune_errors,
+          "sd_clock_tuning_fails_init");
+    sd_sim.corrupt_sectors = false;
+    sd_sim.max_baud_rate = 0;
+    sd->spi->baud_rate = ceiling;
+    check(sd_reinit_tuned("sd_clock_configured") && spi_get_baudrate(spi0) == sd->baud_rate,
+          "sd_clock_tuning_restored");
+}
+
+/**
+ * @brief Benchmarks do driver SD e do FatFs sobre o cartão simulado
+ */
+static void run_sdcard(void) {
+    if (!sd_sim_init(&sd_sim, SIM_SECTORS, 17)) {
+        check(false, "sd_sim_init");
+        return;
+    }
+    for (uint64_t lba = 0; lba < SIM_SECTORS; ++lba)
+        for (int i = 0; i < SD_SIM_BLOCK_SIZE; i += 8)
+            memcpy(sd_sim_sector(&sd_sim, lba) + i, &(uint64_t){lba * 64 + i / 8}, 8);
+    sd_sim_attach(&sd_sim, spi0);
+
+    sd_init_driver();
+    sd = sd_get_by_num(0);
+    check(0 == (sd->init(sd) & STA_NOINIT), "sd_init");
+    check(SIM_SECTORS == sd->sectors, "sd_sectors");
+    check(2048 == sd->au_sectors, "sd_au_size");
+    run_sd_clock_tuning();
+
+    // Corretude da leitura multibloco, inclusive o último setor do cartão
+    int rc = sd->read_blocks(sd, sd_buf, 1000, SD_READ_BLOCKS);
+    check(0 == rc && 0 == memcmp(sd_buf, sd_sim_sector(&sd_sim, 1000), sizeof sd_buf), "sd_read_multi_verify");
+    rc = sd->read_blocks(sd, sd_buf, SIM_SECTORS - 4, 4);
+    check(0 == rc && 0 == memcmp(sd_buf, sd_sim_sector(&sd_sim, SIM_SECTORS - 4), 4 * SD_SIM_BLOCK_SIZE),
+          "sd_read_multi_last_sectors");
+    sd_sim.corrupt_read_crc = 1;
+    sd_sim.read_latency = 0; // O bloco corrompido não é o primeiro da transferência
+    rc = sd->read_blocks(sd, sd_buf, 2000, 1);
+    rc = rc ? rc : sd->read_blocks(sd, sd_buf, 2000, 8);
+    check(SD_BLOCK_DEVICE_ERROR_NONE != rc, "sd_read_crc_error_detected");
+    sd_sim.corrupt_read_crc = 0;
+
+    // O mesmo com o CRC calculado pelo sniffer do DMA, inclusive na escrita
+    sd->spi->dma_crc = true;
+    rc = sd->read_blocks(sd, sd_buf, 1000, SD_READ_BLOCKS);
+    bool read_ok = 0 == rc && 0 == memcmp(sd_buf, sd_sim_sector(&sd_sim, 1000), SD_READ_BLOCKS * SD_SIM_BLOCK_SIZE);
+    rc = sd->read_blocks(sd, sd_buf, 3000, 1);
+    check(read_ok && 0 == rc && 0 == memcmp(sd_buf, sd_sim_sector(&sd_sim, 3000), SD_SIM_BLOCK_SIZE), "sd_read_dma_crc");
+    sd_sim.corrupt_read_crc = 1;
+    rc = sd->read_blocks(sd, sd_buf, 2000, 1);
+    rc = rc ? rc : sd->read_blocks(sd, sd_buf, 2000, 8);
+    check(SD_BLOCK_DEVICE_ERROR_NONE != rc, "sd_read_dma_crc_error_detected");
+    sd_sim.corrupt_read_crc = 0;
+    uint64_t crc_errors = sd_sim.stats.crc_errors;
+    rc = sd->write_blocks(sd, sd_sim_sector(&sd_sim, 4000), 4000, 4);
+    check(0 == rc && crc_errors == sd_sim.stats.crc_errors, "sd_write_dma_crc");
+    sd->spi->dma_crc = false;
+
+    // Custo por bloco com latência típica (Nac) e sem latência
+    sd_sim.read_latency = 8;
+    sd->spi->polled_max = 0; // Tudo por DMA, como antes de SPI_POLLED_MAX
+    run_sd_read("sd_read_1_block_dma_only", 1, 2000);
+    sd->spi->polled_max = SPI_POLLED_MAX;
+    run_sd_read("sd_read_1_block", 1, 2000);
+    run_sd_read("sd_read_8_blocks", 8, 500);
+    run_sd_read("sd_read_64_blocks", SD_READ_BLOCKS, 100);
+    sd_sim.read_latency = 0;
+    run_sd_read("sd_read_64_blocks_nac0", SD_READ_BLOCKS, 100);
+    sd_sim.read_latency = 8;
+
+    // E/S de arquivos pelo FatFs
+    static FATFS fs;
+    static uint8_t work[FF_MAX_SS * 4];
+    MKFS_PARM opt = {FM_ANY, 0, 0, 0, 0};
+    FRESULT fr = f_mkfs("0:", &opt, work, sizeof work);
+    if (fr) printf("# f_mkfs: %s\n", FRESULT_str(fr));
+    check(FR_OK == fr, "f_mkfs");
+    fr = fr ? fr : f_mount(&fs, "0:", 1);
+    check(FR_OK == fr, "f_mount");
+    check(0 == fs.database % sd->au_sectors, "f_mkfs_data_area_aligned_to_au");
+    for (size_t i = 0; i < sizeof fatfs_buf; ++i)
+        fatfs_buf[i] = (uint8_t)(i * 7);
+    bench_run("fatfs_write_64k", bench_fatfs_write, NULL, 50);
+    bench_run("fatfs_read_64k", bench_fatfs_read, NULL, 50);
+    memset(fatfs_buf, 0, sizeof fatfs_buf);
+    bench_fatfs_read(NULL);
+    bool same = true;
+    for (size_t i = 0; i < sizeof fatfs_buf; ++i)
+        same = same && fatfs_buf[i] == (uint8_t)(i * 7);
+    check(same, "fatfs_read_verify");
+    run_fatfs_log();
+    run_sd_log();
+    run_sd_writer();
+    run_sd_flusher();
+    FILINFO fno;
+    check(FR_OK == f_stat("0:/log.txt", &fno) && 11 * LOG_RECORDS * 63 == fno.fsize, "fatfs_log_size");
+    // Remover um arquivo apaga (CMD38) os clusters liberados
+    uint64_t erased = sd_sim.stats.blocks_erased;
+    check(FR_OK == f_unlink("0:/bench.bin") && sd_sim.stats.blocks_erased - erased >= 64 * 1024 / 512,
+          "f_unlink_trims_clusters");
+    // Bench do cartão pelo barramento SPI simulado
+    check(FR_OK == sd_bench("0:", "all", 256) && FR_NO_FILE == f_stat("0:/bench.tmp", &fno), "sd_bench_spi");
+    f_unmount("0:");
+    // Remontar a partir do cartão: nada pode ter ficado só no cache
+    sector_cache_invalidate(0);
+    check(FR_OK == f_mount(&fs, "0:", 1) && FR_OK == f_stat("0:/log.txt", &fno) &&
+              11 * LOG_RECORDS * 63 == fno.fsize,
+          "fatfs_remount_after_sync");
+    f_unmount("0:");
+    hal_spi_attach(spi0, NULL);
+    sd_sim_free(&sd_sim);
+}
+
+#define IMAGE_PATH "Template_host_sd.img" // O mesmo do hw_config
+#define IMAGE_SECTORS (64 * 1024)
+#define FUZZ_FILES 8
+#define FUZZ_MAX_SIZE (24 * 1024)
+
+static uint8_t fuzz_data[FUZZ_FILES][FUZZ_MAX_SIZE]; // Conteúdo esperado de cada arquivo
+static UINT fuzz_size[FUZZ_FILES];
+static bool fuzz_exists[FUZZ_FILES];
+static uint8_t fuzz_buf[FUZZ_MAX_SIZE];
+
+/**
+ * @brief Operações aleatórias de arquivo na unidade 1:, comparadas com um modelo em memória
+ * @param ops Número de operações
+ * @param seed Semente
+ * @param verify false quando há erros injetados: só importa não travar
+ * @return true se o conteúdo lido sempre bateu com o modelo
+ */
+static bool fuzz_files(uint32_t ops, uint32_t seed, bool verify) {
+    bool ok = true;
+    for (uint32_t i = 0; i < ops; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        uint32_t r = seed >> 8;
+        uint32_t n = r % FUZZ_FILES;
+        char path[16];
+        snprintf(path, sizeof path, "1:/f%lu.bin", (unsigned long)n);
+        FIL fil;
+        UINT bw;
+        switch ((r >> 4) % 4) {
+        case 0:
+        case 1: { // Regrava com tamanho aleatório
+            UINT size = (r >> 8) % FUZZ_MAX_SIZE;
+            for (UINT k = 0; k < size; ++k)
+                fuzz_data[n][k] = (uint8_t)(seed + k * 13);
+            FRESULT fr = f_open(&fil, path, FA_CREATE_ALWAYS | FA_WRITE);
+            fr = fr ? fr : f_write(&fil, fuzz_data[n], size, &bw);
+            FRESULT fr_close = fr ? FR_OK : f_close(&fil);
+            fuzz_exists[n] = FR_OK == fr && FR_OK == fr_close;
+            fuzz_size[n] = size;
+            ok = ok && (!verify || (fuzz_exists[n] && size == bw));
+            break;
+        }
+        case 2: { // Lê e confere
+            FRESULT fr = f_open(&fil, path, FA_READ);
+            if (FR_OK == fr) {
+                fr = f_read(&fil, fuzz_buf, sizeof fuzz_buf, &bw);
+                f_close(&fil);
+            }
+            if (verify)
+                ok = ok && (fuzz_exists[n] ? FR_OK == fr && bw == fuzz_size[n] &&
+                                                  0 == memcmp(fuzz_buf, fuzz_data[n], bw)
+                                           : FR_NO_FILE == fr);
+            break;
+        }
+        default: { // Remove
+            FRESULT fr = f_unlink(path);
+            ok = ok && (!verify || (fuzz_exists[n] ? FR_OK == fr : FR_NO_FILE == fr));
+            fuzz_exists[n] = false;
+            break;
+        }
+        }
+    }
+    return ok;
+}
+
+#define MT_RECORDS 2000
+#define MT_WEB_SIZE (8 * 1024)
+#define MT_WEB_READS 300
+
+static SemaphoreHandle_t mt_done;
+static volatile bool mt_log_ok, mt_web_ok;
+
+/**
+ * @brief Tarefa de registro: registros de 64 bytes com f_sync periódico
+ */
+static void mt_log_task(void *arg) {
+    (void)arg;
+    FIL fil;
+    uint8_t rec[64];
+    FRESULT fr = f_open(&fil, "1:/mt_log.bin", FA_CREATE_ALWAYS | FA_WRITE);
+    for (uint32_t i = 0; FR_OK == fr && i < MT_RECORDS; ++i) {
+        UINT bw;
+        memset(rec, (int)(i & 0xFF), sizeof rec);
+        fr = f_write(&fil, rec, sizeof rec, &bw);
+        if (FR_OK == fr && 0 == i % 50)
+            fr = f_sync(&fil);
+    }
+    FRESULT fr_close = f_close(&fil);
+    mt_log_ok = FR_OK == fr && FR_OK == fr_close;
+    xSemaphoreGive(mt_done);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Tarefa "servidor web": lê e confere o mesmo arquivo repetidamente
+ */
+static void mt_web_task(void *arg) {
+    (void)arg;
+    static uint8_t page[MT_WEB_SIZE];
+    bool ok = true;
+    for (uint32_t i = 0; ok && i < MT_WEB_READS; ++i) {
+        FIL fil;
+        UINT br = 0;
+        ok = FR_OK == f_open(&fil, "1:/mt_web.bin", FA_READ);
+        ok = ok && FR_OK == f_read(&fil, page, sizeof page, &br) && sizeof page == br;
+        f_close(&fil);
+        for (UINT k = 0; ok && k < br; ++k)
+            ok = page[k] == (uint8_t)(k * 3);
+    }
+    mt_web_ok = ok;
+    xSemaphoreGive(mt_done);
+    vTaskDelete(NULL);
+}
+
+static volatile FRESULT mt_stat_fr;
+
+/**
+ * @brief Consulta um arquivo enquanto outra tarefa segura o volume
+ */
+static void mt_stat_task(void *arg) {
+    (void)arg;
+    FILINFO fno;
+    mt_stat_fr = f_stat("1:/mt_web.bin", &fno);
+    xSemaphoreGive(mt_done);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Registro e leitura concorrentes no mesmo volume, com FF_FS_REENTRANT
+ */
+static void run_fatfs_concurrent(void) {
+    static uint8_t page[MT_WEB_SIZE];
+    for (size_t k = 0; k < sizeof page; ++k)
+        page[k] = (uint8_t)(k * 3);
+    FIL fil;
+    UINT bw = 0;
+    FRESULT fr = f_open(&fil, "1:/mt_web.bin", FA_CREATE_ALWAYS | FA_WRITE);
+    fr = fr ? fr : f_write(&fil, page, sizeof page, &bw);
+    fr = fr ? fr : f_close(&fil);
+
+    // Gravações lentas: a tarefa de leitura encontra o volume ocupado
+    sd_image_t *image = sd_get_by_num(1)->device;
+    image->write_latency_us = 100;
+    image->read_latency_us = 50;
+    ff_lock_stats_reset(1);
+    mt_done = xSemaphoreCreateCounting(2, 0);
+    xTaskCreate(mt_log_task, "mt_log", 1024, NULL, 1, NULL);
+    xTaskCreate(mt_web_task, "mt_web", 1024, NULL, 1, NULL);
+    bool finished = pdTRUE == xSemaphoreTake(mt_done, 30000) && pdTRUE == xSemaphoreTake(mt_done, 30000);
+    vSemaphoreDelete(mt_done);
+    image->write_latency_us = 0;
+    image->read_latency_us = 0;
+
+    FILINFO fno;
+    bool ok = FR_OK == fr && finished && mt_log_ok && mt_web_ok && FR_OK == f_stat("1:/mt_log.bin", &fno) &&
+              MT_RECORDS * 64 == fno.fsize;
+    uint8_t rec[64];
+    fr = f_open(&fil, "1:/mt_log.bin", FA_READ);
+    for (uint32_t i = 0; ok && i < MT_RECORDS; ++i) {
+        ok = FR_OK == f_read(&fil, rec, sizeof rec, &bw) && sizeof rec == bw;
+        for (size_t k = 0; ok && k < sizeof rec; ++k)
+            ok = rec[k] == (uint8_t)i;
+    }
+    f_close(&fil);
+    check(ok, "fatfs_reentrant_log_and_web");
+    const ff_lock_stats_t *st = ff_lock_stats(1);
+    check(st && st->takes >= MT_RECORDS && st->contended && st->wait_us && 0 == st->timeouts, "fatfs_lock_stats");
+    if (st)
+        printf("# fatfs 1: %lu takes, %lu contended, wait %llu us (max %lu), hold %llu us (max %lu)\n",
+               (unsigned long)st->takes, (unsigned long)st->contended, (unsigned long long)st->wait_us,
+               (unsigned long)st->max_wait_us, (unsigned long long)st->hold_us, (unsigned long)st->max_hold_us);
+
+    // Volume preso além de FF_FS_TIMEOUT: a espera vencida conta só em timeouts
+    ff_lock_stats_reset(1);
+    mt_done = xSemaphoreCreateCounting(1, 0);
+    check(ff_mutex_take(1), "fatfs_lock_hold");
+    xTaskCreate(mt_stat_task, "mt_stat", 1024, NULL, 1, NULL);
+    finished = pdTRUE == xSemaphoreTake(mt_done, 2 * FF_FS_TIMEOUT);
+    ff_mutex_give(1);
+    vSemaphoreDelete(mt_done);
+    check(finished && FR_TIMEOUT == mt_stat_fr && st && 1 == st->timeouts && 0 == st->contended && 1 == st->takes,
+          "fatfs_lock_timeout_counted");
+}
+
+#define SEEK_FILE_SIZE (8u * 1024 * 1024)
+#define SEEK_READS 500
+
+static uint8_t seek_chunk[32 * 1024];
+
+/**
+ * @brief Preenche um trecho com o deslocamento de cada palavra no arquivo
+ */
+static void seek_pattern(uint8_t *buf, FSIZE_t ofs, UINT len) {
+    for (UINT k = 0; k < len; k += 4)
+        memcpy(buf + k, &(uint32_t){(uint32_t)(ofs + k)}, 4);
+}
+
+/**
+ * @brief Leituras de 512 bytes em posições aleatórias, conferindo o conteúdo
+ * @return Leituras de setores pedidas à imagem, ou UINT64_MAX em caso de erro
+ */
+static uint64_t seek_random_reads(FIL *fil, FSIZE_t size, const char *name) {
+    sd_image_t *image = sd_get_by_num(1)->device;
+    uint64_t reads = image->stats.reads;
+    uint32_t seed = 99;
+    uint8_t buf[512], want[512];
+    uint64_t t = time_us_64();
+    for (int i = 0; i < SEEK_READS; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        FSIZE_t ofs = (FSIZE_t)(seed >> 4) % (size - sizeof buf) / 4 * 4;
+        UINT br = 0;
+        if (FR_OK != f_lseek(fil, ofs) || FR_OK != f_read(fil, buf, sizeof buf, &br) || sizeof buf != br)
+            return UINT64_MAX;
+        seek_pattern(want, ofs, sizeof want);
+        if (memcmp(buf, want, sizeof buf))
+            return UINT64_MAX;
+    }
+    t = time_us_64() - t;
+    reads = image->stats.reads - reads;
+    printf("# %s: %.2f leituras da imagem e %.1f us por busca + leitura\n", name, (double)reads / SEEK_READS,
+           (double)t / SEEK_READS);
+    return reads;
+}
+
+/**
+ * @brief Busca rápida com tabela de clusters em cache contra o percurso da FAT
+ */
+static void run_fastseek(void) {
+    FIL fil, frag;
+    UINT bw;
+    // Um arquivo longo e contíguo, e um intercalado com outro (fragmentado)
+    FRESULT fr = f_open(&fil, "1:/big.log", FA_CREATE_ALWAYS | FA_WRITE);
+    for (FSIZE_t ofs = 0; FR_OK == fr && ofs < SEEK_FILE_SIZE; ofs += sizeof seek_chunk) {
+        seek_pattern(seek_chunk, ofs, sizeof seek_chunk);
+        fr = f_write(&fil, seek_chunk, sizeof seek_chunk, &bw);
+    }
+    fr = fr ? fr : f_close(&fil);
+    fr = fr ? fr : f_open(&fil, "1:/frag_a.log", FA_CREATE_ALWAYS | FA_WRITE);
+    fr = fr ? fr : f_open(&frag, "1:/frag_b.log", FA_CREATE_ALWAYS | FA_WRITE);
+    const UINT piece = 2 * 1024; // Um cluster por vez em cada arquivo
+    for (FSIZE_t ofs = 0; FR_OK == fr && ofs < 256 * 1024; ofs += piece) {
+        seek_pattern(seek_chunk, ofs, piece);
+        fr = f_write(&fil, seek_chunk, piece, &bw);
+        fr = fr ? fr : f_write(&frag, seek_chunk, piece, &bw);
+    }
+    f_close(&frag);
+    fr = fr ? fr : f_close(&fil);
+    check(FR_OK == fr, "fastseek_files_written");
+
+    fr = f_open(&fil, "1:/big.log", FA_READ);
+    uint64_t walk = FR_OK == fr ? seek_random_reads(&fil, SEEK_FILE_SIZE, "seek_fat_walk") : UINT64_MAX;
+    f_close(&fil);
+    const sd_fastseek_stats_t *st = sd_fastseek_stats();
+    sd_fastseek_stats_t before = *st;
+    fr = sd_fastseek_open(&fil, "1:/big.log");
+    uint64_t fast = FR_OK == fr && fil.cltbl ? seek_random_reads(&fil, SEEK_FILE_SIZE, "seek_clmt") : UINT64_MAX;
+    check(UINT64_MAX != walk && UINT64_MAX != fast && fast < walk, "fastseek_random_reads");
+    // Segunda abertura simultânea: mesma tabela
+    FIL again;
+    fr = sd_fastseek_open(&again, "1:/big.log");
+    check(FR_OK == fr && again.cltbl == fil.cltbl && 1 == st->builds - before.builds &&
+              1 == st->hits - before.hits,
+          "fastseek_shared_table");
+    sd_fastseek_close(&again);
+    sd_fastseek_close(&fil);
+
+    // Arquivo alterado: a tabela é recriada na próxima abertura
+    fr = f_open(&fil, "1:/big.log", FA_OPEN_APPEND | FA_WRITE);
+    seek_pattern(seek_chunk, SEEK_FILE_SIZE, sizeof seek_chunk);
+    fr = fr ? fr : f_write(&fil, seek_chunk, sizeof seek_chunk, &bw);
+    fr = fr ? fr : f_close(&fil);
+    fr = fr ? fr : sd_fastseek_open(&fil, "1:/big.log");
+    check(FR_OK == fr && 2 == st->builds - before.builds &&
+              UINT64_MAX != seek_random_reads(&fil, SEEK_FILE_SIZE + sizeof seek_chunk, "seek_clmt_rebuilt"),
+          "fastseek_rebuilds_changed_file");
+    FSIZE_t size = f_size(&fil);
+    DWORD sclust = fil.obj.sclust;
+    sd_fastseek_close(&fil);
+
+    // Regravado no lugar, um minuto depois: mesmo primeiro cluster e tamanho, outra data
+    datetime_t now;
+    rtc_get_datetime(&now);
+    now.min = (int8_t)((now.min + 1) % 60);
+    rtc_set_datetime(&now);
+    fr = f_open(&fil, "1:/big.log", FA_WRITE);
+    seek_pattern(seek_chunk, 0, sizeof seek_chunk);
+    fr = fr ? fr : f_write(&fil, seek_chunk, sizeof seek_chunk, &bw);
+    fr = fr ? fr : f_close(&fil);
+    fr = fr ? fr : sd_fastseek_open(&fil, "1:/big.log");
+    check(FR_OK == fr && size == f_size(&fil) && sclust == fil.obj.sclust && 3 == st->builds - before.builds,
+          "fastseek_rebuilds_rewritten_file");
+    sd_fastseek_close(&fil);
+
+    // Fragmentos demais para a tabela: abre normalmente
+    fr = sd_fastseek_open(&fil, "1:/frag_a.log");
+    check(FR_OK == fr && !fil.cltbl && 1 == st->too_fragmented - before.too_fragmented &&
+              UINT64_MAX != seek_random_reads(&fil, 256 * 1024, "seek_fragmented"),
+          "fastseek_fragmented_fallback");
+    sd_fastseek_close(&fil);
+
+    // LRU: mais arquivos que entradas despejam a tabela mais antiga
+    char path[24];
+    for (int i = 0; FR_OK == fr && i <= SD_FASTSEEK_ENTRIES; ++i) {
+        snprintf(path, sizeof path, "1:/lru%d.log", i);
+        fr = f_open(&fil, path, FA_CREATE_ALWAYS | FA_WRITE);
+        fr = fr ? fr : f_write(&fil, seek_chunk, 4096, &bw);
+        fr = fr ? fr : f_close(&fil);
+        fr = fr ? fr : sd_fastseek_open(&fil, path);
+        fr = fr ? fr : sd_fastseek_close(&fil);
+    }
+    check(FR_OK == fr && st->evictions > before.evictions, "fastseek_lru_eviction");
+    sd_fastseek_invalidate(NULL);
+}
+
+/**
+ * @brief Unidade 1: sobre a imagem de disco: bench, injeção de falhas e fuzzing
+ */
+static void run_sdbench(void) {
+    remove(IMAGE_PATH); // Imagem nova, criada pelo hw_config na inicialização
+    sd_card_t *img = sd_get_by_num(1);
+    sd_image_t *image = img->device;
+    sd_init_driver();
+    check(0 == (img->init(img) & STA_NOINIT) && IMAGE_SECTORS == img->sectors, "sd_image_init");
+
+    static FATFS fs;
+    static uint8_t work[FF_MAX_SS * 4];
+    MKFS_PARM opt = {FM_ANY, 0, 0, 0, 0};
+    FRESULT fr = f_mkfs("1:", &opt, work, sizeof work);
+    fr = fr ? fr : f_mount(&fs, "1:", 1);
+    check(FR_OK == fr, "sd_image_mkfs_mount");
+
+    // Linha de comando como no console do firmware
+    char cmd[] = "bench all 1: 1024";
+    strtok(cmd, " ");
+    run_bench();
+    FILINFO fno;
+    check(FR_NO_FILE == f_stat("1:/bench.tmp", &fno), "sd_bench_removes_file");
+    check(FR_INVALID_PARAMETER == sd_bench("1:", "nope", 64), "sd_bench_rejects_unknown_test");
+
+    // Latência injetada
+    uint64_t t = time_us_64();
+    image->read_latency_us = 2000;
+    int rc = img->read_blocks(img, sd_buf, 0, 1);
+    image->read_latency_us = 0;
+    check(0 == rc && time_us_64() - t >= 2000, "sd_image_read_latency");
+
+    // Erros injetados chegam ao FatFs como FR_DISK_ERR
+    FIL fil;
+    UINT bw = 0;
+    static uint8_t big[16 * 1024];
+    image->fail_after = 1;
+    fr = f_open(&fil, "1:/fail.bin", FA_CREATE_ALWAYS | FA_WRITE);
+    fr = fr ? fr : f_write(&fil, big, sizeof big, &bw);
+    check(FR_DISK_ERR == fr && 1 == image->stats.injected_errors, "sd_image_write_error");
+    f_close(&fil);
+    image->bad_start = 0;
+    image->bad_count = 1;
+    rc = img->read_blocks(img, sd_buf, 0, 4);
+    image->bad_count = 0;
+    check(SD_BLOCK_DEVICE_ERROR_CRC == rc, "sd_image_bad_sector");
+    image->write_protected = true;
+    check(RES_WRPRT == disk_write(1, sd_buf, 100, 4), "sd_image_write_protected");
+    image->write_protected = false;
+    f_unmount("1:");
+    image->removed = true;
+    check(FR_NOT_READY == f_mount(&fs, "1:", 1), "sd_image_removed");
+    image->removed = false;
+
+    // Fuzzing: sem falhas o conteúdo bate com o modelo; com falhas, nada trava
+    fr = f_mkfs("1:", &opt, work, sizeof work);
+    fr = fr ? fr : f_mount(&fs, "1:", 1);
+    check(FR_OK == fr && fuzz_files(2000, 7, true), "sd_image_fuzz");
+    image->fail_one_in = 40;
+    fuzz_files(500, 11, false);
+    image->fail_one_in = 0;
+    f_unmount("1:");
+    check(image->stats.injected_errors > 1 && FR_OK == f_mount(&fs, "1:", 1), "sd_image_fuzz_with_errors");
+    printf("# sd_image: %llu leituras, %llu gravações, %llu erros injetados\n",
+           (unsigned long long)image->stats.reads, (unsigned long long)image->stats.writes,
+           (unsigned long long)image->stats.injected_errors);
+
+    run_fatfs_concurrent();
+    run_fastseek();
+
+    // Os dados sobrevivem a desmapear e mapear a imagem de novo
+    fr = f_open(&fil, "1:/persist.txt", FA_CREATE_ALWAYS | FA_WRITE);
+    fr = fr ? fr : f_write(&fil, "imagem", 6, &bw);
+    fr = fr ? fr : f_close(&fil);
+    f_unmount("1:");
+    sd_image_close(img);
+    char text[8] = {0};
+    bool ok = FR_OK == fr && sd_image_open(img, IMAGE_PATH, 0) && FR_OK == f_mount(&fs, "1:", 1) &&
+              FR_OK == f_open(&fil, "1:/persist.txt", FA_READ) && FR_OK == f_read(&fil, text, sizeof text, &bw);
+    f_close(&fil);
+    check(ok && 6 == bw && 0 == strcmp(text, "imagem"), "sd_image_persists");
+    f_unmount("1:");
+    sd_image_close(img);
+    remove(IMAGE_PATH);
+}
+
+typedef struct {
+    const char *name;
+    void (*run)(void);
+} suite_t;
+
+typedef unsigned short (*crc16_fn_t)(unsigned short crc, const void *data, size_t length);
+
+static const struct {
+    const char *name;
+    crc16_fn_t fn;
+} crc16_impls[] = {
+    {"crc16_table", crc16_table},
+    {"crc16_slice4", crc16_slice4},
+    {"crc16_slice8", crc16_slice8},
+    {"crc16_tableless", crc16_tableless},
+};
+
+static uint8_t crc_block[SD_SIM_BLOCK_SIZE];
+static volatile unsigned short crc_sink;
+
+static void bench_crc16(void *ctx) {
+    crc_sink = ((crc16_fn_t)ctx)(0, crc_block, sizeof crc_block);
+}
+
+/**
+ * @brief Implementações de CRC16 contra a referência bit a bit e vazão por bloco de 512 bytes
+ */
+static void run_crc(void) {
+    static uint8_t data[1024];
+    uint32_t x = 12345;
+    for (size_t i = 0; i < sizeof data; ++i) {
+        x = x * 1103515245u + 12345u;
+        data[i] = (uint8_t)(x >> 16);
+    }
+    memcpy(crc_block, data, sizeof crc_block);
+
+    for (size_t i = 0; i < count_of(crc16_impls); ++i) {
+        crc16_fn_t fn = crc16_impls[i].fn;
+        bool ok = 0x31C3 == fn(0, "123456789", 9);
+        // Todos os comprimentos e alinhamentos, e a continuação incremental
+        for (size_t len = 0; ok && len <= 64; ++len)
+            for (size_t off = 0; ok && off < 8; ++off)
+                ok = sd_sim_crc16(data + off, len) == fn(0, data + off, len);
+        ok = ok && sd_sim_crc16(data, 1000) == fn(fn(0, data, 333), data + 333, 667);
+        char what[48];
+        snprintf(what, sizeof what, "%s_matches_reference", crc16_impls[i].name);
+        check(ok, what);
+    }
+    check(sd_sim_crc16(data, 512) == crc16((const char *)data, 512), "crc16_default_impl");
+
+    // O sniffer do DMA, numa cópia memória a memória
+    static uint8_t copy[SD_SIM_BLOCK_SIZE];
+    uint ch = (uint)dma_claim_unused_channel(true);
+    dma_channel_config c = dma_channel_get_default_config(ch);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_sniff_enable(&c, true);
+    dma_sniffer_enable(ch, DMA_SNIFF_CTRL_CALC_VALUE_CRC16, false);
+    dma_sniffer_set_data_accumulator(0);
+    dma_channel_configure(ch, &c, copy, crc_block, sizeof crc_block, true);
+    check(sd_sim_crc16(crc_block, sizeof crc_block) == (uint16_t)dma_sniffer_get_data_accumulator(),
+          "dma_sniffer_crc16");
+    dma_sniffer_disable();
+    dma_channel_unclaim(ch);
+
+    for (size_t i = 0; i < count_of(crc16_impls); ++i) {
+        uint64_t us = bench_run(crc16_impls[i].name, bench_crc16, (void *)crc16_impls[i].fn, 200000);
+        printf("# %s: %.1f MB/s\n", crc16_impls[i].name, 200000.0 * sizeof crc_block / (double)(us ? us : 1));
+    }
+}
+
+static spi_t *bench_spi;
+
+typedef struct {
+    const uint8_t *tx;
+    uint8_t *rx;
+    size_t length;
+    spi_xfer_t xfer;
+} spi_case_t;
+
+static uint8_t spi_loopback(void *ctx, uint8_t out) {
+    (void)ctx;
+    return out;
+}
+
+static void bench_spi_transfer(void *ctx) {
+    spi_case_t *c = ctx;
+    spi_transfer(bench_spi, c->tx, c->rx, c->length);
+}
+
+static void bench_spi_xfer(void *ctx) {
+    spi_case_t *c = ctx;
+    spi_xfer_start(bench_spi, &c->xfer);
+    spi_transfer_wait_complete(bench_spi, 1000);
+}
+
+/**
+ * @brief Mede uma forma de transferência e o trabalho de DMA por chamada
+ * @param name Nome do benchmark
+ * @param fn Função medida
+ * @param c Transferência
+ * @param polled_max Limite de E/S programada
+ */
+static void run_spi_case(const char *name, bench_fn_t fn, spi_case_t *c, size_t polled_max) {
+    const uint32_t iterations = 20000;
+    bench_spi->polled_max = polled_max;
+    *hal_dma_stats() = (hal_dma_stats_t){0};
+    bench_run(name, fn, c, iterations);
+    const hal_dma_stats_t *dma = hal_dma_stats();
+    printf("# %s: %.2f canais configurados, %.2f disparos de DMA, %.2f interrupcoes por transferencia\n", name,
+           (double)dma->configures / (iterations + 1), (double)dma->starts / (iterations + 1),
+           (double)dma->irqs / (iterations + 1));
+}
+
+/**
+ * @brief Custo fixo por transferência do spi_transfer contra um SPI em laço (MISO = MOSI)
+ */
+static void run_spi(void) {
+    bench_spi = spi_get_by_num(0);
+    my_spi_init(bench_spi);
+    hal_spi_attach(bench_spi->hw_inst, &(hal_spi_device_t){spi_loopback, NULL});
+    static uint8_t tx[512], rx[512];
+    for (size_t i = 0; i < sizeof tx; ++i)
+        tx[i] = (uint8_t)(i * 13 + 1);
+
+    // Os dois caminhos devolvem o que foi enviado
+    bool same = true;
+    for (size_t polled_max = 0; polled_max <= SPI_POLLED_MAX; polled_max += SPI_POLLED_MAX) {
+        bench_spi->polled_max = polled_max;
+        for (size_t len = 1; len <= sizeof tx; len *= 8) {
+            memset(rx, 0, sizeof rx);
+            same = same && spi_transfer(bench_spi, tx, rx, len) && 0 == memcmp(tx, rx, len);
+        }
+    }
+    check(same, "spi_transfer_loopback");
+
+    spi_case_t token = {.tx = tx, .length = 1};
+    spi_case_t crc = {.rx = rx, .length = 2};
+    spi_case_t block = {.rx = rx, .length = 512};
+    run_spi_case("spi_write_1_dma", bench_spi_transfer, &token, 0);
+    run_spi_case("spi_write_1_polled", bench_spi_transfer, &token, SPI_POLLED_MAX);
+    run_spi_case("spi_read_2_dma", bench_spi_transfer, &crc, 0);
+    run_spi_case("spi_read_2_polled", bench_spi_transfer, &crc, SPI_POLLED_MAX);
+    run_spi_case("spi_read_512_transfer", bench_spi_transfer, &block, SPI_POLLED_MAX);
+    spi_xfer_prepare(bench_spi, &block.xfer, NULL, rx, 512, NULL, 0);
+    run_spi_case("spi_read_512_xfer", bench_spi_xfer, &block, SPI_POLLED_MAX);
+
+    bench_spi->polled_max = SPI_POLLED_MAX;
+    hal_spi_attach(bench_spi->hw_inst, NULL);
+}
+
+#define STRIPE_SIM_SECTORS (8 * 1024) // Cada membro: 4 MB
+#define STRIPE_WRITE_BLOCKS 256       // Quatro faixas de 64 setores
+
+static sd_sim_t stripe_sims[2];
+static uint8_t stripe_buf[STRIPE_WRITE_BLOCKS * SD_SIM_BLOCK_SIZE];
+
+/**
+ * @brief Setor do membro que guarda um setor virtual da unidade 2:
+ */
+static uint8_t *stripe_member_sector(const sd_stripe_t *s, uint64_t sector) {
+    uint64_t unit = sector / s->stripe_sectors;
+    return sd_sim_sector(&stripe_sims[unit % s->num_cards],
+                         unit / s->num_cards * s->stripe_sectors + sector % s->stripe_sectors);
+}
+
+static void bench_stripe_write(void *ctx) {
+    sd_card_t *card = ctx;
+    card->write_blocks(card, stripe_buf, 0, STRIPE_WRITE_BLOCKS);
+}
+
+/**
+ * @brief Unidade 2:: dois cartões, um em cada SPI, como um só disco (RAID-0)
+ */
+static void run_stripe(void) {
+    sd_card_t *stripe = sd_get_by_name("2:");
+    const sd_stripe_t *s = stripe->device;
+    bool ok = true;
+    for (size_t i = 0; i < s->num_cards; ++i) {
+        ok = ok && sd_sim_init(&stripe_sims[i], STRIPE_SIM_SECTORS, s->cards[i]->ss_gpio);
+        if (ok) sd_sim_attach(&stripe_sims[i], s->cards[i]->spi->hw_inst);
+    }
+    sd_init_driver();
+    check(ok && 0 == (stripe->init(stripe) & STA_NOINIT), "stripe_init");
+    check(s->num_cards * STRIPE_SIM_SECTORS == stripe->sectors &&
+              s->num_cards * s->cards[0]->au_sectors == stripe->au_sectors &&
+              0 == (stripe->au_sectors & (stripe->au_sectors - 1)),
+          "stripe_geometry");
+
+    // Gravação desalinhada atravessando várias faixas: cada setor no membro certo
+    for (size_t i = 0; i < sizeof stripe_buf; i += 8)
+        memcpy(stripe_buf + i, &(uint64_t){i}, 8);
+    uint64_t multi[2] = {stripe_sims[0].stats.multi_writes, stripe_sims[1].stats.multi_writes};
+    const uint64_t first = 40;
+    int rc = stripe->write_blocks(stripe, stripe_buf, first, 200);
+    ok = 0 == rc;
+    for (uint64_t k = 0; ok && k < 200; ++k)
+        ok = 0 == memcmp(stripe_member_sector(s, first + k), stripe_buf + k * SD_SIM_BLOCK_SIZE, SD_SIM_BLOCK_SIZE);
+    // Uma escrita multibloco por membro, não uma por faixa
+    check(ok && 1 == stripe_sims[0].stats.multi_writes - multi[0] && 1 == stripe_sims[1].stats.multi_writes - multi[1],
+          "stripe_write_layout");
+    memset(stripe_buf, 0, sizeof stripe_buf);
+    rc = stripe->read_blocks(stripe, stripe_buf, first + 3, 190);
+    ok = 0 == rc;
+    for (uint64_t k = 0; ok && k < 190; ++k)
+        ok = 0 == memcmp(stripe_member_sector(s, first + 3 + k), stripe_buf + k * SD_SIM_BLOCK_SIZE, SD_SIM_BLOCK_SIZE);
+    check(ok, "stripe_read_verify");
+    // Dentro de uma faixa só um membro trabalha
+    rc = stripe->read_blocks(stripe, stripe_buf, 130, 2);
+    check(0 == rc && 0 == memcmp(stripe_member_sector(s, 130), stripe_buf, SD_SIM_BLOCK_SIZE), "stripe_read_one_unit");
+    stripe_sims[1].corrupt_read_crc = 1;
+    rc = stripe->read_blocks(stripe, stripe_buf, 0, 256);
+    stripe_sims[1].corrupt_read_crc = 0;
+    check(SD_BLOCK_DEVICE_ERROR_NONE != rc, "stripe_read_crc_error_detected");
+
+    // Com tempo de programação, os membros gravam ao mesmo tempo
+    for (size_t i = 0; i < s->num_cards; ++i)
+        stripe_sims[i].write_busy_us = 200;
+    uint64_t single = bench_run("stripe_write_128k_one_card", bench_stripe_write, s->cards[0], 5);
+    uint64_t striped = bench_run("stripe_write_128k_striped", bench_stripe_write, stripe, 5);
+    printf("# stripe: %.2fx a vazao de um cartao\n", striped ? (double)single / striped : 0.0);
+    check(striped * 10 < single * 7, "stripe_write_overlaps_cards");
+    for (size_t i = 0; i < s->num_cards; ++i)
+        stripe_sims[i].write_busy_us = 0;
+
+    // FatFs sobre o volume em faixas
+    static FATFS fs;
+    static uint8_t work[FF_MAX_SS * 4];
+    MKFS_PARM opt = {FM_ANY, 0, 0, 0, 0};
+    FRESULT fr = f_mkfs("2:", &opt, work, sizeof work);
+    fr = fr ? fr : f_mount(&fs, "2:", 1);
+    FIL fil;
+    UINT bw = 0, br = 0;
+    for (size_t i = 0; i < sizeof stripe_buf; ++i)
+        stripe_buf[i] = (uint8_t)(i * 5 + 1);
+    fr = fr ? fr : f_open(&fil, "2:/stripe.bin", FA_CREATE_ALWAYS | FA_WRITE);
+    fr = fr ? fr : f_write(&fil, stripe_buf, sizeof stripe_buf, &bw);
+    fr = fr ? fr : f_close(&fil);
+    memset(stripe_buf, 0, sizeof stripe_buf);
+    fr = fr ? fr : f_open(&fil, "2:/stripe.bin", FA_READ);
+    fr = fr ? fr : f_read(&fil, stripe_buf, sizeof stripe_buf, &br);
+    f_close(&fil);
+    ok = FR_OK == fr && sizeof stripe_buf == bw && sizeof stripe_buf == br;
+    for (size_t i = 0; ok && i < sizeof stripe_buf; ++i)
+        ok = stripe_buf[i] == (uint8_t)(i * 5 + 1);
+    if (fr) printf("# stripe fatfs: %s\n", FRESULT_str(fr));
+    check(ok, "stripe_fatfs_write_read");
+    f_unmount("2:");
+
+    for (size_t i = 0; i < s->num_cards; ++i) {
+        hal_spi_attach(s->cards[i]->spi->hw_inst, NULL);
+        sd_sim_free(&stripe_sims[i]);
+    }
+}
+
+static const suite_t suites[] = {
+    {"display", run_display},
+    {"raster", run_raster},
+    {"font", run_font},
+    {"oled", run_oled},
+    {"ui", run_ui},
+    {"matrix", run_matrix},
+    {"anim", run_anim},
+    {"parallel", run_parallel},
+    {"sensors", run_sensors},
+    {"sdcard", run_sdcard},
+    {"spi", run_spi},
+    {"crc", run_crc},
+    {"sdbench", run_sdbench},
+    {"stripe", run_stripe},
+};
+
+/**
+ * @brief Ponto de entrada do alvo Template_host: executa as suítes pedidas (ou todas)
+ */
+int main(int argc, char **argv) {
+    stdio_init_all();
+    bench_header();
+    for (size_t s = 0; s < count_of(suites); ++s) {
+        bool selected = argc < 2;
+        for (int a = 1; a < argc; ++a)
+            if (0 == strcmp(argv[a], suites[s].name) || 0 == strcmp(argv[a], "all"))
+                selected = true;
+        if (selected)
+            suites[s].run();
+    }
+    return failures ? 1 : 0;
+}
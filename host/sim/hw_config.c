@@ -0,0 +1,81 @@
+#include <assert.h>
+#include "hw_config.h"
+#include "diskio.h"
+#include "sd_image.h"
+#include "sd_stripe.h"
+
+// Configuração do alvo nativo, no lugar de lib/FatFs_SPI/sd_driver/hw_config.c:
+// a unidade 0: é o cartão SPI simulado (sd_sim) no spi0, como na placa, e a
+// 1: é uma imagem de disco (sd_image) mapeada em memória. A 2: distribui os
+// setores entre dois cartões simulados, um no spi0 e outro no spi1 (RAID-0).
+
+static spi_t spis[] = {
+    {
+        .hw_inst = spi0,
+        .miso_gpio = 16,
+        .mosi_gpio = 19,
+        .sck_gpio = 18,
+        .baud_rate = 1000 * 1000,
+    },
+    {
+        .hw_inst = spi1,
+        .miso_gpio = 12,
+        .mosi_gpio = 15,
+        .sck_gpio = 14,
+        .baud_rate = 1000 * 1000,
+    }};
+
+// Imagem de disco da unidade 1:, criada no diretório corrente na primeira montagem
+static sd_image_t images[] = {
+    {
+        .path = "Template_host_sd.img",
+        .sectors = 64 * 1024, // 32 MB
+    }};
+
+static sd_stripe_t stripes[1];
+
+// Os membros da faixa vêm depois das FF_VOLUMES unidades: o FatFs não os vê
+static sd_card_t sd_cards[] = {
+    {
+        .pcName = "0:",
+        .spi = &spis[0],
+        .ss_gpio = 17,
+        .use_card_detect = false,
+    },
+    {
+        SD_IMAGE_CARD("1:", &images[0]),
+    },
+    {
+        SD_STRIPE_CARD("2:", &stripes[0]),
+    },
+    {
+        .pcName = "stripe0",
+        .spi = &spis[0],
+        .ss_gpio = 22,
+        .use_card_detect = false,
+    },
+    {
+        .pcName = "stripe1",
+        .spi = &spis[1],
+        .ss_gpio = 13,
+        .use_card_detect = false,
+    }};
+
+// Unidade 2: faixas de 64 setores (32 KB) alternadas entre sd_cards[3] e sd_cards[4]
+static sd_stripe_t stripes[1] = {
+    {
+        .cards = {&sd_cards[3], &sd_cards[4]},
+        .num_cards = 2,
+        .stripe_sectors = 64,
+    }};
+
+size_t sd_get_num() { return count_of(sd_cards); }
+sd_card_t *sd_get_by_num(size_t num) {
+    assert(num < sd_get_num());
+    return num < sd_get_num() ? &sd_cards[num] : NULL;
+}
+size_t spi_get_num() { return count_of(spis); }
+spi_t *spi_get_by_num(size_t num) {
+    assert(num < spi_get_num());
+    return num < spi_get_num() ? &spis[num] : NULL;
+}
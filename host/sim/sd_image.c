@@ -0,0 +1,181 @@
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "pico/time.h"
+#include "hw_config.h"
+#include "diskio.h"
+#include "sd_image.h"
+
+#define SD_IMAGE_BLOCK_SIZE 512
+
+/**
+ * @brief Abre, redimensiona e mapeia o arquivo da imagem
+ * @param img Imagem (fd e map ainda fechados)
+ * @param path Caminho do arquivo
+ * @param sectors Novo tamanho em setores, ou 0 para manter o do arquivo
+ * @return true se o mapa está pronto
+ */
+static bool image_map(sd_image_t *img, const char *path, uint64_t sectors) {
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if ((sectors && ftruncate(fd, (off_t)(sectors * SD_IMAGE_BLOCK_SIZE))) || fstat(fd, &st) ||
+        st.st_size < SD_IMAGE_BLOCK_SIZE) {
+        close(fd);
+        return false;
+    }
+    uint64_t n = (uint64_t)st.st_size / SD_IMAGE_BLOCK_SIZE;
+    void *map = mmap(NULL, n * SD_IMAGE_BLOCK_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (MAP_FAILED == map) {
+        close(fd);
+        return false;
+    }
+    img->fd = fd;
+    img->map = map;
+    img->map_sectors = n;
+    return true;
+}
+
+/**
+ * @brief Mapeia uma imagem no lugar da configurada no hw_config
+ * @param sd Cartão com um sd_image_t em device
+ * @param path Caminho do arquivo
+ * @param sectors Novo tamanho em setores, ou 0 para manter o do arquivo
+ * @return true se a imagem está pronta
+ */
+bool sd_image_open(sd_card_t *sd, const char *path, uint64_t sectors) {
+    sd_image_t *img = sd->device;
+    if (!img)
+        return false;
+    sd_image_close(sd);
+    img->path = path;
+    img->sectors = sectors;
+    if (!image_map(img, path, sectors))
+        return false;
+    sd->sectors = img->map_sectors;
+    sd->m_Status = STA_NOINIT;
+    return true;
+}
+
+/**
+ * @brief Grava o mapa no arquivo e o desfaz; o cartão passa a ser visto como ausente
+ */
+void sd_image_close(sd_card_t *sd) {
+    sd_image_t *img = sd->device;
+    if (!img || !img->map)
+        return;
+    msync(img->map, img->map_sectors * SD_IMAGE_BLOCK_SIZE, MS_SYNC);
+    munmap(img->map, img->map_sectors * SD_IMAGE_BLOCK_SIZE);
+    close(img->fd);
+    img->map = NULL;
+    img->map_sectors = 0;
+    sd->m_Status = STA_NOINIT | STA_NODISK;
+}
+
+/**
+ * @brief Conteúdo de um setor, direto no mapa (NULL se fora da imagem)
+ */
+uint8_t *sd_image_sector(sd_card_t *sd, uint64_t sector) {
+    sd_image_t *img = sd->device;
+    if (!img || !img->map || sector >= img->map_sectors)
+        return NULL;
+    return img->map + sector * SD_IMAGE_BLOCK_SIZE;
+}
+
+/**
+ * @brief Inicializa o cartão, mapeando na primeira vez a imagem do hw_config
+ */
+int sd_image_init(sd_card_t *sd) {
+    sd_image_t *img = sd->device;
+    if (!img || img->removed || (!img->map && (!img->path || !image_map(img, img->path, img->sectors)))) {
+        sd->m_Status = STA_NOINIT | STA_NODISK;
+        return sd->m_Status;
+    }
+    sd->sectors = img->map_sectors;
+    sd->au_sectors = 1;
+    sd->m_Status = 0;
+    return sd->m_Status;
+}
+
+/**
+ * @brief Aplica a latência e a injeção de erros a uma E/S
+ * @param sd Cartão
+ * @param sector Primeiro setor
+ * @param count Número de setores
+ * @param latency_us Latência fixa da operação
+ * @return SD_BLOCK_DEVICE_ERROR_NONE se a E/S deve prosseguir
+ */
+static int image_io(sd_card_t *sd, uint64_t sector, uint64_t count, uint32_t latency_us) {
+    sd_image_t *img = sd->device;
+    if (img->removed) {
+        sd->m_Status |= STA_NOINIT | STA_NODISK;
+        return SD_BLOCK_DEVICE_ERROR_NO_DEVICE;
+    }
+    if (!img->map || (sd->m_Status & STA_NOINIT))
+        return SD_BLOCK_DEVICE_ERROR_NO_INIT;
+    if (!count || sector + count > img->map_sectors)
+        return SD_BLOCK_DEVICE_ERROR_PARAMETER;
+    uint64_t us = latency_us + count * img->us_per_block;
+    if (us)
+        sleep_us(us);
+    bool fail = img->fail_after && 0 == --img->fail_after;
+    if (img->fail_one_in) {
+        img->rng = img->rng * 1103515245u + 12345u;
+        fail = fail || 0 == (img->rng >> 8) % img->fail_one_in;
+    }
+    fail = fail || (img->bad_count && sector < img->bad_start + img->bad_count && sector + count > img->bad_start);
+    if (fail) {
+        img->stats.injected_errors++;
+        return img->error ? img->error : SD_BLOCK_DEVICE_ERROR_CRC;
+    }
+    return SD_BLOCK_DEVICE_ERROR_NONE;
+}
+
+int sd_image_write_blocks(sd_card_t *sd, const uint8_t *buffer, uint64_t sector, uint32_t count) {
+    sd_image_t *img = sd->device;
+    img->stats.writes++;
+    if (img->write_protected)
+        return SD_BLOCK_DEVICE_ERROR_WRITE_PROTECTED;
+    int rc = image_io(sd, sector, count, img->write_latency_us);
+    if (rc)
+        return rc;
+    memcpy(img->map + sector * SD_IMAGE_BLOCK_SIZE, buffer, (size_t)count * SD_IMAGE_BLOCK_SIZE);
+    img->stats.blocks_written += count;
+    return SD_BLOCK_DEVICE_ERROR_NONE;
+}
+
+int sd_image_read_blocks(sd_card_t *sd, uint8_t *buffer, uint64_t sector, uint32_t count) {
+    sd_image_t *img = sd->device;
+    img->stats.reads++;
+    int rc = image_io(sd, sector, count, img->read_latency_us);
+    if (rc)
+        return rc;
+    memcpy(buffer, img->map + sector * SD_IMAGE_BLOCK_SIZE, (size_t)count * SD_IMAGE_BLOCK_SIZE);
+    img->stats.blocks_read += count;
+    return SD_BLOCK_DEVICE_ERROR_NONE;
+}
+
+/**
+ * @brief Apaga os setores start..end; como num cartão, passam a ler zeros
+ */
+int sd_image_trim(sd_card_t *sd, uint64_t start, uint64_t end) {
+    sd_image_t *img = sd->device;
+    if (end < start)
+        return SD_BLOCK_DEVICE_ERROR_PARAMETER;
+    if (img->write_protected)
+        return SD_BLOCK_DEVICE_ERROR_WRITE_PROTECTED;
+    int rc = image_io(sd, start, end - start + 1, img->write_latency_us);
+    if (rc)
+        return rc;
+    memset(img->map + start * SD_IMAGE_BLOCK_SIZE, 0, (size_t)(end - start + 1) * SD_IMAGE_BLOCK_SIZE);
+    img->stats.trims++;
+    return SD_BLOCK_DEVICE_ERROR_NONE;
+}
+
+bool sd_image_test_com(sd_card_t *sd) {
+    sd_image_t *img = sd->device;
+    return img && img->map && !img->removed;
+}
@@ -0,0 +1,67 @@
+#ifndef SD_IMAGE_H
+#define SD_IMAGE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sd_card.h"
+
+// Cartão sem barramento: os blocos ficam num arquivo de imagem de disco
+// mapeado em memória (mmap), de modo que FatFs, glue.c e sdcard.c rodam no
+// Linux à velocidade da memória. Os métodos e o sd_image_t são ligados ao
+// sd_card_t no hw_config (campo device); sd_init_driver não os substitui.
+
+// Contadores da imagem
+typedef struct {
+    uint64_t reads;           // Chamadas a read_blocks
+    uint64_t writes;          // Chamadas a write_blocks
+    uint64_t blocks_read;
+    uint64_t blocks_written;
+    uint64_t trims;
+    uint64_t injected_errors; // Erros devolvidos pela injeção
+} sd_image_stats_t;
+
+typedef struct {
+    // Configuração (hw_config)
+    const char *path;          // Arquivo da imagem, criado se não existir
+    uint64_t sectors;          // Tamanho ao criar ou redimensionar; 0 usa o do arquivo
+
+    // Latência injetada em cada chamada: fixa + por bloco
+    uint32_t read_latency_us;
+    uint32_t write_latency_us;
+    uint32_t us_per_block;
+
+    // Erros injetados (error, ou SD_BLOCK_DEVICE_ERROR_CRC se 0)
+    int error;
+    uint32_t fail_after;       // Falha a (fail_after)-ésima E/S a partir de agora (0 = nunca)
+    uint32_t fail_one_in;      // Falha em média uma a cada fail_one_in E/S (0 = nunca)
+    uint64_t bad_start;        // Os bad_count setores a partir de bad_start
+    uint64_t bad_count;        // sempre falham (0 = nenhum)
+    bool write_protected;      // Gravações devolvem WRITE_PROTECTED
+    bool removed;              // Cartão retirado: NO_DEVICE e STA_NODISK
+
+    sd_image_stats_t stats;
+
+    // Estado
+    int fd;
+    uint8_t *map;
+    uint64_t map_sectors;
+    uint32_t rng;
+} sd_image_t;
+
+bool sd_image_open(sd_card_t *sd, const char *path, uint64_t sectors); // Mapeia a imagem (sectors > 0 redimensiona)
+void sd_image_close(sd_card_t *sd); // Grava e desmapeia a imagem; o cartão fica sem mídia
+uint8_t *sd_image_sector(sd_card_t *sd, uint64_t sector); // Conteúdo de um setor, direto no mapa
+
+int sd_image_init(sd_card_t *sd);
+int sd_image_write_blocks(sd_card_t *sd, const uint8_t *buffer, uint64_t sector, uint32_t count);
+int sd_image_read_blocks(sd_card_t *sd, uint8_t *buffer, uint64_t sector, uint32_t count);
+int sd_image_trim(sd_card_t *sd, uint64_t start, uint64_t end);
+bool sd_image_test_com(sd_card_t *sd);
+
+// Métodos de um sd_card_t sobre a imagem img, para a tabela do hw_config
+#define SD_IMAGE_CARD(name, img)                                                                       \
+    .pcName = (name), .m_Status = STA_NOINIT, .init = sd_image_init, .write_blocks = sd_image_write_blocks, \
+    .read_blocks = sd_image_read_blocks, .trim = sd_image_trim, .sd_test_com = sd_image_test_com,      \
+    .device = (img)
+
+#endif // SD_IMAGE_H
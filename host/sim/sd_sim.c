@@ -0,0 +1,445 @@
+#include <stdlib.h>
+#include <string.h>
+#include "pico/time.h"
+#include "sd_sim.h"
+
+// Modelo do protocolo SPI dos cartões SD: o byte do MISO de cada ciclo é
+// decidido antes de interpretar o byte recebido no MOSI, de modo que as
+// respostas sempre aparecem a partir do ciclo seguinte ao comando.
+
+enum {
+    SIM_CMD,         // Aguardando comandos
+    SIM_READ_STREAM, // CMD17/CMD18: enviando blocos (até o CMD12, no CMD18)
+    SIM_WRITE_TOKEN, // CMD24/CMD25: aguardando o token de início
+    SIM_WRITE_DATA,  // Recebendo dados + CRC
+};
+
+#define R1_IDLE 0x01
+#define R1_ILLEGAL 0x04
+#define R1_CRC 0x08
+#define R1_ERASE_SEQ 0x10
+#define R1_ADDRESS 0x20
+
+#define TOKEN_START 0xFE
+#define TOKEN_START_MULTI 0xFC
+#define TOKEN_STOP 0xFD
+#define TOKEN_ERR_RANGE 0x08
+
+/**
+ * @brief CRC7 dos comandos (polinômio x^7 + x^3 + 1), bit a bit
+ */
+static uint8_t sim_crc7(const uint8_t *data, size_t len) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < len; ++i) {
+        uint8_t byte = data[i];
+        for (int b = 0; b < 8; ++b) {
+            crc <<= 1;
+            if ((byte ^ crc) & 0x80)
+                crc ^= 0x09;
+            byte <<= 1;
+        }
+    }
+    return crc & 0x7F;
+}
+
+/**
+ * @brief CRC16-CCITT dos blocos de dados (polinômio 0x1021, valor inicial 0), bit a bit
+ * @param data Dados
+ * @param len Tamanho em bytes
+ * @return CRC calculado
+ */
+uint16_t sd_sim_crc16(const uint8_t *data, size_t len) {
+    uint16_t crc = 0;
+    for (size_t i = 0; i < len; ++i) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int b = 0; b < 8; ++b)
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
+
+static void sim_push(sd_sim_t *sim, uint8_t byte) {
+    if (sim->q_len < sizeof sim->queue)
+        sim->queue[(sim->q_head + sim->q_len++) % sizeof sim->queue] = byte;
+}
+
+static void sim_push_r1(sd_sim_t *sim, uint8_t r1) {
+    sim_push(sim, r1 | (sim->idle ? R1_IDLE : 0));
+}
+
+/**
+ * @brief Clock do barramento acima do suportado pelo cartão ou pela ligação
+ */
+static bool sim_too_fast(const sd_sim_t *sim) {
+    uint limit = sim->high_speed ? 50000000u : 25000000u;
+    if (sim->max_baud_rate && sim->max_baud_rate < limit)
+        limit = sim->max_baud_rate;
+    return sim->spi && spi_get_baudrate(sim->spi) > limit;
+}
+
+/**
+ * @brief Enfileira um bloco de dados: token, conteúdo e CRC16 (sector: bloco de um setor do cartão)
+ */
+static void sim_push_block(sd_sim_t *sim, const uint8_t *data, size_t len, bool sector) {
+    uint16_t crc = sd_sim_crc16(data, len);
+    if (sim->corrupt_read_crc) {
+        sim->corrupt_read_crc--;
+        crc ^= 0x5A5A;
+    }
+    // Rápido demais: um bit lido errado no meio do bloco
+    uint8_t flip = sim_too_fast(sim) || (sector && sim->corrupt_sectors) ? 0x10 : 0x00;
+    sim_push(sim, TOKEN_START);
+    for (size_t i = 0; i < len; ++i)
+        sim_push(sim, data[i] ^ (i == len / 2 ? flip : 0));
+    sim_push(sim, crc >> 8);
+    sim_push(sim, crc & 0xFF);
+}
+
+/**
+ * @brief Enfileira o próximo bloco de uma leitura (ou o token de erro fora da faixa)
+ */
+static void sim_push_read_block(sd_sim_t *sim) {
+    if (sim->addr >= sim->sectors) {
+        sim_push(sim, TOKEN_ERR_RANGE);
+        sim->state = SIM_CMD;
+        return;
+    }
+    sim_push_block(sim, sd_sim_sector(sim, sim->addr), SD_SIM_BLOCK_SIZE, true);
+    sim->addr++;
+    sim->stats.blocks_read++;
+    if (!sim->multi)
+        sim->state = SIM_CMD;
+}
+
+/**
+ * @brief Monta o registrador CSD versão 2.0 para a capacidade do cartão
+ */
+static void sim_push_csd(sd_sim_t *sim) {
+    uint8_t csd[16] = {0};
+    uint32_t c_size = (uint32_t)(sim->sectors / 1024 - 1);
+    csd[0] = 0x40;                // CSD_STRUCTURE = 1
+    csd[3] = 0x32;                // TRAN_SPEED: 25 MHz
+    csd[5] = 0x59;                // CCC / READ_BL_LEN = 9
+    csd[7] = (c_size >> 16) & 0x3F; // C_SIZE[69:48]
+    csd[8] = (c_size >> 8) & 0xFF;
+    csd[9] = c_size & 0xFF;
+    csd[10] = 0x7F;
+    csd[11] = 0x80;
+    csd[12] = 0x0A;
+    csd[13] = 0x40;
+    csd[15] = (uint8_t)(sim_crc7(csd, 15) << 1) | 1;
+    sim_push(sim, 0xFF);
+    sim_push_block(sim, csd, sizeof csd, false);
+}
+
+/**
+ * @brief Interpreta um comando completo recebido no MOSI
+ */
+static void sim_command(sd_sim_t *sim) {
+    uint8_t index = sim->cmd[0] & 0x3F;
+    uint32_t arg = ((uint32_t)sim->cmd[1] << 24) | ((uint32_t)sim->cmd[2] << 16) |
+                   ((uint32_t)sim->cmd[3] << 8) | sim->cmd[4];
+    bool acmd = sim->app_cmd;
+    sim->app_cmd = false;
+    sim->stats.commands++;
+
+    if ((sim->crc_enabled || 0 == index || 8 == index) &&
+        (sim->cmd[5] >> 1) != sim_crc7(sim->cmd, 5)) {
+        sim_push_r1(sim, R1_CRC);
+        return;
+    }
+    if (acmd) {
+        switch (index) {
+        case 41: // ACMD41: o primeiro pedido ainda encontra o cartão inicializando
+            if (sim->idle && !sim->init_started) {
+                sim->init_started = true;
+                sim_push_r1(sim, 0);
+                return;
+            }
+            sim->idle = false;
+            sim_push_r1(sim, 0);
+            return;
+        case 13: { // ACMD13: R2 seguido do SD Status (64 bytes)
+            uint8_t status[64] = {0};
+            status[10] = (uint8_t)(sim->au_size << 4);
+            status[12] = 1;            // ERASE_SIZE: 1 AU
+            status[13] = (1 << 2) | 1; // ERASE_TIMEOUT: 1 s, ERASE_OFFSET: 1 s
+            sim_push_r1(sim, 0);
+            sim_push(sim, 0x00);
+            sim_push(sim, 0xFF);
+            sim_push_block(sim, status, sizeof status, false);
+            return;
+        }
+        case 23: // ACMD23: pré-apagamento, apenas aceito
+            sim_push_r1(sim, 0);
+            return;
+        default:
+            break; // Os demais são tratados como comandos comuns
+        }
+    }
+    switch (index) {
+    case 0:
+        sim->idle = true;
+        sim->init_started = false;
+        sim->high_speed = false;
+        sim->state = SIM_CMD;
+        sim_push_r1(sim, 0);
+        break;
+    case 6: { // CMD6: status das funções (64 bytes); o modo 1 troca a do grupo 1
+        uint8_t status[64] = {0};
+        uint32_t fn = arg & 0xF;
+        bool supported = 0 == fn || (1 == fn && sim->high_speed_capable);
+        status[1] = 100;                                  // Corrente máxima: 100 mA
+        status[13] = sim->high_speed_capable ? 0x03 : 0x01; // Grupo 1: funções 0 e 1
+        if (0xF == fn)
+            status[16] = sim->high_speed ? 1 : 0;
+        else
+            status[16] = supported ? fn : 0xF;
+        if ((arg & 0x80000000u) && supported)
+            sim->high_speed = 1 == fn;
+        sim_push_r1(sim, 0);
+        sim_push(sim, 0xFF);
+        sim_push_block(sim, status, sizeof status, false);
+        break;
+    }
+    case 8:
+        sim_push_r1(sim, 0);
+        sim_push(sim, 0x00);
+        sim_push(sim, 0x00);
+        sim_push(sim, (arg >> 8) & 0x0F);
+        sim_push(sim, arg & 0xFF);
+        break;
+    case 9:
+        sim_push_r1(sim, 0);
+        sim_push_csd(sim);
+        break;
+    case 12:
+        sim->state = SIM_CMD;
+        sim->q_len = 0;
+        sim->nac_remaining = 0;
+        sim_push(sim, 0xFF); // Byte de enchimento após o CMD12
+        sim_push_r1(sim, 0);
+        sim->busy_remaining = sim->busy_bytes;
+        break;
+    case 13:
+        sim_push_r1(sim, 0);
+        sim_push(sim, 0x00);
+        break;
+    case 16:
+        sim_push_r1(sim, arg == SD_SIM_BLOCK_SIZE ? 0 : 0x40);
+        break;
+    case 17:
+    case 18:
+        if (arg >= sim->sectors) {
+            sim_push_r1(sim, R1_ADDRESS);
+            break;
+        }
+        sim_push_r1(sim, 0);
+        sim->addr = arg;
+        sim->multi = (18 == index);
+        sim->nac_remaining = sim->read_latency;
+        sim->state = SIM_READ_STREAM;
+        break;
+    case 24:
+    case 25:
+        if (arg >= sim->sectors) {
+            sim_push_r1(sim, R1_ADDRESS);
+            break;
+        }
+        sim_push_r1(sim, 0);
+        if (25 == index)
+            sim->stats.multi_writes++;
+        else
+            sim->stats.single_writes++;
+        sim->addr = arg;
+        sim->multi = (25 == index);
+        sim->state = SIM_WRITE_TOKEN;
+        break;
+    case 32:
+    case 33:
+        if (arg >= sim->sectors) {
+            sim_push_r1(sim, R1_ADDRESS);
+            break;
+        }
+        if (32 == index) {
+            sim->erase_start = arg;
+            sim->erase_start_set = true;
+        } else {
+            sim->erase_end = arg;
+            sim->erase_end_set = true;
+        }
+        sim_push_r1(sim, 0);
+        break;
+    case 38:
+        if (!sim->erase_start_set || !sim->erase_end_set || sim->erase_end < sim->erase_start) {
+            sim_push_r1(sim, R1_ERASE_SEQ);
+            break;
+        }
+        // DATA_STAT_AFTER_ERASE = 0: blocos apagados são lidos como zeros
+        memset(sd_sim_sector(sim, sim->erase_start), 0,
+               (size_t)(sim->erase_end - sim->erase_start + 1) * SD_SIM_BLOCK_SIZE);
+        sim->stats.erases++;
+        sim->stats.blocks_erased += sim->erase_end - sim->erase_start + 1;
+        sim->erase_start_set = sim->erase_end_set = false;
+        sim_push_r1(sim, 0);
+        sim->busy_remaining = sim->busy_bytes;
+        break;
+    case 55:
+        sim->app_cmd = true;
+        sim_push_r1(sim, 0);
+        break;
+    case 58: {
+        uint32_t ocr = 0x00FF8000 | (sim->idle ? 0 : 0xC0000000);
+        sim_push_r1(sim, 0);
+        sim_push(sim, ocr >> 24);
+        sim_push(sim, (ocr >> 16) & 0xFF);
+        sim_push(sim, (ocr >> 8) & 0xFF);
+        sim_push(sim, ocr & 0xFF);
+        break;
+    }
+    case 59:
+        sim->crc_enabled = arg & 1;
+        sim_push_r1(sim, 0);
+        break;
+    default:
+        sim_push_r1(sim, R1_ILLEGAL);
+        break;
+    }
+}
+
+/**
+ * @brief Recebe um byte de dados de escrita (token, conteúdo ou CRC)
+ */
+static void sim_write_byte(sd_sim_t *sim, uint8_t in) {
+    if (SIM_WRITE_TOKEN == sim->state) {
+        if (in == (sim->multi ? TOKEN_START_MULTI : TOKEN_START)) {
+            sim->state = SIM_WRITE_DATA;
+            sim->wr_pos = 0;
+        } else if (sim->multi && TOKEN_STOP == in) {
+            sim->state = SIM_CMD;
+            sim->busy_remaining = sim->busy_bytes + 1;
+        }
+        return;
+    }
+    sim->wr_buf[sim->wr_pos++] = in;
+    if (sim->wr_pos < sizeof sim->wr_buf)
+        return;
+    uint16_t crc = (uint16_t)(sim->wr_buf[SD_SIM_BLOCK_SIZE] << 8) | sim->wr_buf[SD_SIM_BLOCK_SIZE + 1];
+    if (sim->crc_enabled && crc != sd_sim_crc16(sim->wr_buf, SD_SIM_BLOCK_SIZE)) {
+        sim->stats.crc_errors++;
+        sim_push(sim, 0x0B); // Dados rejeitados: erro de CRC
+        sim->state = SIM_CMD;
+        return;
+    }
+    memcpy(sd_sim_sector(sim, sim->addr), sim->wr_buf, SD_SIM_BLOCK_SIZE);
+    sim->addr++;
+    sim->stats.blocks_written++;
+    sim_push(sim, 0x05); // Dados aceitos
+    sim->busy_remaining = sim->busy_bytes;
+    uint64_t busy_us = sim->write_busy_us;
+    if (sim->stall_every && 0 == sim->stats.blocks_written % sim->stall_every)
+        busy_us += sim->stall_us;
+    if (busy_us)
+        sim->busy_until_us = time_us_64() + busy_us;
+    sim->state = (sim->multi && sim->addr < sim->sectors) ? SIM_WRITE_TOKEN : SIM_CMD;
+}
+
+/**
+ * @brief Próximo byte enviado pelo cartão no MISO
+ */
+static uint8_t sim_next_output(sd_sim_t *sim) {
+    if (sim->q_len) {
+        uint8_t byte = sim->queue[sim->q_head];
+        sim->q_head = (sim->q_head + 1) % sizeof sim->queue;
+        sim->q_len--;
+        return byte;
+    }
+    if (sim->busy_remaining) {
+        sim->busy_remaining--;
+        return 0x00;
+    }
+    if (sim->busy_until_us && time_us_64() < sim->busy_until_us)
+        return 0x00;
+    if (SIM_READ_STREAM == sim->state) {
+        if (sim->nac_remaining) {
+            sim->nac_remaining--;
+            return 0xFF;
+        }
+        sim_push_read_block(sim);
+        sim->nac_remaining = sim->read_latency;
+        return sim_next_output(sim);
+    }
+    return 0xFF;
+}
+
+/**
+ * @brief Troca de um byte no barramento SPI
+ */
+static uint8_t sim_exchange(void *ctx, uint8_t in) {
+    sd_sim_t *sim = ctx;
+    if (hal_gpio_get_output(sim->cs_gpio)) {
+        sim->cmd_len = 0; // Cartão não selecionado: MISO em alta impedância
+        return 0xFF;
+    }
+    uint8_t out = sim_next_output(sim);
+    if (SIM_WRITE_TOKEN == sim->state || SIM_WRITE_DATA == sim->state) {
+        if (!sim->q_len && !sim->busy_remaining)
+            sim_write_byte(sim, in);
+        return out;
+    }
+    if (sim->cmd_len || 0x40 == (in & 0xC0)) {
+        sim->cmd[sim->cmd_len++] = in;
+        if (sizeof sim->cmd == sim->cmd_len) {
+            sim->cmd_len = 0;
+            sim_command(sim);
+        }
+    }
+    return out;
+}
+
+/**
+ * @brief Cria um cartão SDHC simulado vazio
+ * @param sim Cartão
+ * @param sectors Número de setores (múltiplo de 1024)
+ * @param cs_gpio Pino de seleção do cartão
+ * @return true se o armazenamento foi alocado
+ */
+bool sd_sim_init(sd_sim_t *sim, uint64_t sectors, uint cs_gpio) {
+    memset(sim, 0, sizeof *sim);
+    sim->storage = calloc(sectors, SD_SIM_BLOCK_SIZE);
+    if (!sim->storage)
+        return false;
+    sim->sectors = sectors;
+    sim->cs_gpio = cs_gpio;
+    sim->idle = true;
+    sim->read_latency = 8;
+    sim->busy_bytes = 8;
+    sim->au_size = 7;
+    sim->high_speed_capable = true;
+    sim->device.exchange = sim_exchange;
+    sim->device.ctx = sim;
+    return true;
+}
+
+/**
+ * @brief Libera o armazenamento do cartão
+ */
+void sd_sim_free(sd_sim_t *sim) {
+    free(sim->storage);
+    sim->storage = NULL;
+}
+
+/**
+ * @brief Conecta o cartão ao barramento SPI
+ */
+void sd_sim_attach(sd_sim_t *sim, spi_inst_t *spi) {
+    sim->spi = spi;
+    hal_spi_attach(spi, &sim->device);
+}
+
+/**
+ * @brief Conteúdo de um setor do cartão
+ */
+uint8_t *sd_sim_sector(sd_sim_t *sim, uint64_t sector) {
+    return sim->storage + sector * SD_SIM_BLOCK_SIZE;
+}
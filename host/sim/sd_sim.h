@@ -0,0 +1,68 @@
+#ifndef SD_SIM_H
+#define SD_SIM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "hardware/spi.h"
+#include "host_hal.h"
+
+#define SD_SIM_BLOCK_SIZE 512 // Tamanho do bloco (cartão SDHC)
+
+// Contadores do cartão simulado
+typedef struct {
+    uint64_t commands;       // Comandos recebidos
+    uint64_t blocks_read;    // Blocos enviados ao host
+    uint64_t blocks_written; // Blocos gravados
+    uint64_t single_writes;  // Comandos CMD24
+    uint64_t multi_writes;   // Comandos CMD25
+    uint64_t erases;         // Comandos CMD38 executados
+    uint64_t blocks_erased;  // Blocos apagados
+    uint64_t crc_errors;     // Blocos recebidos com CRC inválido
+} sd_sim_stats_t;
+
+// Cartão SDHC simulado no modo SPI, com armazenamento em memória
+typedef struct {
+    uint8_t *storage;         // Conteúdo do cartão
+    uint64_t sectors;         // Número de setores
+    uint cs_gpio;             // Pino de seleção (ativo em nível baixo)
+    hal_spi_device_t device;  // Dispositivo conectado ao barramento
+
+    // Parâmetros injetáveis
+    uint32_t read_latency;    // Bytes 0xFF antes do token de cada bloco lido (Nac)
+    uint32_t busy_bytes;      // Bytes ocupados (0x00) após gravações e CMD12
+    uint32_t corrupt_read_crc; // Número de próximos blocos lidos com CRC corrompido
+    uint8_t au_size;          // Campo AU_SIZE do SD Status (7 = 1 MB)
+    uint32_t write_busy_us;   // Tempo real de programação de cada bloco gravado
+    uint32_t stall_every;     // A cada stall_every blocos gravados (0 = nunca)...
+    uint32_t stall_us;        // ...o cartão fica ocupado por mais stall_us
+    bool high_speed_capable;  // Aceita o modo High Speed (CMD6), até 50 MHz
+    uint max_baud_rate;       // Clock acima do qual os blocos lidos chegam corrompidos (0 = só o limite do cartão)
+    bool corrupt_sectors;     // Setores lidos (CMD17/CMD18) chegam corrompidos a qualquer clock
+
+    sd_sim_stats_t stats;
+
+    // Estado do protocolo
+    int state;
+    bool idle, init_started, app_cmd, crc_enabled, multi;
+    bool high_speed;          // Modo High Speed selecionado
+    spi_inst_t *spi;          // Barramento ao qual está conectado
+    uint8_t cmd[6];
+    uint8_t cmd_len;
+    uint64_t addr;            // Próximo bloco a ler/gravar
+    uint64_t erase_start, erase_end; // Faixa definida por CMD32/CMD33
+    bool erase_start_set, erase_end_set;
+    uint8_t queue[1024];      // Bytes a enviar pelo MISO
+    uint32_t q_head, q_len;
+    uint32_t busy_remaining, nac_remaining;
+    uint64_t busy_until_us;   // Ocupado (MISO em 0x00) até este instante
+    uint8_t wr_buf[SD_SIM_BLOCK_SIZE + 2];
+    uint32_t wr_pos;
+} sd_sim_t;
+
+bool sd_sim_init(sd_sim_t *sim, uint64_t sectors, uint cs_gpio); // Cria o cartão (sectors múltiplo de 1024)
+void sd_sim_free(sd_sim_t *sim); // Libera o armazenamento
+void sd_sim_attach(sd_sim_t *sim, spi_inst_t *spi); // Conecta o cartão ao barramento SPI
+uint8_t *sd_sim_sector(sd_sim_t *sim, uint64_t sector); // Conteúdo de um setor
+uint16_t sd_sim_crc16(const uint8_t *data, size_t len); // CRC16-CCITT de referência (bit a bit)
+
+#endif // SD_SIM_H
@@ -0,0 +1,302 @@
+#include <stdio.h>
+#include <string.h>
+#include "pico/time.h"
+#include "ssd1306_sim.h"
+
+// Modelo do controlador SSD1306 na interface I2C: cada transação começa por
+// um byte de controle (Co = bit 7, D/C = bit 6). Com Co = 0, o restante da
+// transação é só comandos ou só dados; com Co = 1, segue um único byte e
+// depois outro byte de controle.
+
+#define CONTROL_CO 0x80
+#define CONTROL_DATA 0x40
+
+/**
+ * @brief Número de bytes do comando (incluindo o código) a partir do primeiro byte
+ */
+static uint8_t sim_command_length(uint8_t code) {
+    switch (code) {
+    case 0x21: // Janela de colunas
+    case 0x22: // Janela de páginas
+    case 0xA3: // Área de rolagem vertical
+        return 3;
+    case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+    case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+        return 2;
+    case 0x26: case 0x27: // Rolagem horizontal
+        return 7;
+    case 0x29: case 0x2A: // Rolagem vertical e horizontal
+        return 6;
+    default:
+        return 1;
+    }
+}
+
+/**
+ * @brief Executa um comando completo
+ */
+static void sim_execute(ssd1306_sim_t *sim) {
+    const uint8_t *c = sim->cmd;
+    if (c[0] < 0x10) { // Nibble baixo da coluna (modo de página)
+        sim->x = (sim->x & 0xF0) | c[0];
+        return;
+    }
+    if (c[0] < 0x20) { // Nibble alto da coluna (modo de página)
+        sim->x = (uint8_t)(((c[0] & 0x07) << 4) | (sim->x & 0x0F));
+        return;
+    }
+    if (c[0] >= 0x40 && c[0] < 0x80) {
+        sim->start_line = c[0] & 0x3F;
+        return;
+    }
+    if (c[0] >= 0xB0 && c[0] < 0xB8) {
+        sim->page = c[0] & 0x07;
+        return;
+    }
+    switch (c[0]) {
+    case 0x20:
+        sim->mode = c[1] & 0x03;
+        break;
+    case 0x21:
+        sim->x = sim->x0 = c[1] & 0x7F;
+        sim->x1 = c[2] & 0x7F;
+        break;
+    case 0x22:
+        sim->page = sim->p0 = c[1] & 0x07;
+        sim->p1 = c[2] & 0x07;
+        break;
+    case 0x81:
+        sim->contrast = c[1];
+        break;
+    case 0xA0: case 0xA1:
+        sim->seg_remap = c[0] & 1;
+        break;
+    case 0xA4: case 0xA5:
+        sim->entire_on = c[0] & 1;
+        break;
+    case 0xA6: case 0xA7:
+        sim->inverted = c[0] & 1;
+        break;
+    case 0xA8:
+        sim->mux_ratio = c[1] & 0x3F;
+        break;
+    case 0xAE: case 0xAF:
+        sim->display_on = c[0] & 1;
+        break;
+    case 0xC0: case 0xC8:
+        sim->com_reversed = c[0] & 0x08;
+        break;
+    case 0xD3:
+        sim->offset = c[1] & 0x3F;
+        break;
+    default: // Temporização, bomba de carga, rolagem: sem efeito na imagem
+        break;
+    }
+}
+
+/**
+ * @brief Acumula um byte de comando e executa o comando ao completar os argumentos
+ */
+static void sim_command(ssd1306_sim_t *sim, uint8_t byte) {
+    if (!sim->cmd_need) {
+        sim->cmd_len = 0;
+        sim->cmd_need = sim_command_length(byte);
+    }
+    sim->cmd[sim->cmd_len++] = byte;
+    if (sim->cmd_len < sim->cmd_need)
+        return;
+    sim->cmd_need = 0;
+    sim_execute(sim);
+}
+
+/**
+ * @brief Grava um byte na GDDRAM e avança os ponteiros conforme o modo de endereçamento
+ */
+static void sim_data(ssd1306_sim_t *sim, uint8_t byte) {
+    sim->ram[sim->page][sim->x] = byte;
+    switch (sim->mode) {
+    case SSD1306_SIM_HORIZONTAL:
+        if (sim->x++ == sim->x1) {
+            sim->x = sim->x0;
+            sim->page = sim->page == sim->p1 ? sim->p0 : sim->page + 1;
+        }
+        break;
+    case SSD1306_SIM_VERTICAL:
+        if (sim->page++ == sim->p1) {
+            sim->page = sim->p0;
+            sim->x = sim->x == sim->x1 ? sim->x0 : sim->x + 1;
+        }
+        break;
+    default: // Modo de página: só a coluna avança, voltando ao início da linha
+        sim->x = (sim->x + 1) & (SSD1306_SIM_WIDTH - 1);
+        break;
+    }
+}
+
+/**
+ * @brief Recebe uma transação I2C endereçada ao painel
+ */
+static int sim_write(void *ctx, const uint8_t *src, size_t len, bool nostop) {
+    (void)nostop;
+    ssd1306_sim_t *sim = ctx;
+    sim->frame_bytes += len;
+    sim->frame_transactions++;
+    size_t i = 0;
+    while (i < len) {
+        uint8_t control = src[i++];
+        if (!(control & CONTROL_CO)) {
+            for (; i < len; ++i)
+                if (control & CONTROL_DATA)
+                    sim_data(sim, src[i]);
+                else
+                    sim_command(sim, src[i]);
+            break;
+        }
+        if (i < len) {
+            if (control & CONTROL_DATA)
+                sim_data(sim, src[i]);
+            else
+                sim_command(sim, src[i]);
+            i++;
+        }
+    }
+    return (int)len;
+}
+
+/**
+ * @brief Liga o painel ao barramento com o estado de reset e a RAM indefinida
+ * @param sim Painel
+ * @param i2c Barramento
+ * @param addr Endereço de 7 bits
+ * @param bus_hz Clock do barramento, para estimar o tempo de cada quadro
+ */
+void ssd1306_sim_attach(ssd1306_sim_t *sim, i2c_inst_t *i2c, uint8_t addr, uint bus_hz) {
+    memset(sim, 0, sizeof *sim);
+    memset(sim->ram, 0xA5, sizeof sim->ram);
+    sim->bus_hz = bus_hz;
+    sim->mode = SSD1306_SIM_PAGE;
+    sim->x1 = SSD1306_SIM_WIDTH - 1;
+    sim->p1 = SSD1306_SIM_PAGES - 1;
+    sim->contrast = 0x7F;
+    sim->mux_ratio = SSD1306_SIM_HEIGHT - 1;
+    ssd1306_sim_reset_stats(sim);
+    hal_i2c_device_t dev = {.write = sim_write, .ctx = sim};
+    hal_i2c_attach(i2c, addr, &dev);
+}
+
+/**
+ * @brief Pixel aceso na imagem exibida
+ *
+ * As coordenadas são as do módulo montado, vistas com a configuração de
+ * ssd1306_config (segmentos remapeados e varredura de COM invertida), em que
+ * a coluna x e a linha y da imagem são a coluna e a linha da GDDRAM.
+ * @param sim Painel
+ * @param x Coluna da imagem
+ * @param y Linha da imagem
+ */
+bool ssd1306_sim_pixel(const ssd1306_sim_t *sim, uint x, uint y) {
+    if (!sim->display_on || x >= SSD1306_SIM_WIDTH || y > sim->mux_ratio)
+        return false;
+    if (sim->entire_on)
+        return true;
+    uint column = sim->seg_remap ? x : SSD1306_SIM_WIDTH - 1 - x;
+    uint row = sim->com_reversed ? y : sim->mux_ratio - y;
+    row = (row + sim->start_line + sim->offset) % SSD1306_SIM_HEIGHT;
+    bool lit = sim->ram[row >> 3][column] >> (row & 7) & 1;
+    return lit != sim->inverted;
+}
+
+/**
+ * @brief Fecha o quadro: contabiliza o tráfego recebido desde o fechamento anterior
+ * @param sim Painel
+ */
+void ssd1306_sim_end_frame(ssd1306_sim_t *sim) {
+    ssd1306_sim_stats_t *st = &sim->stats;
+    st->frames++;
+    st->bytes += sim->frame_bytes;
+    st->transactions += sim->frame_transactions;
+    if (sim->frame_bytes > st->max_frame_bytes)
+        st->max_frame_bytes = sim->frame_bytes;
+    // Cada transação: START, endereço + ACK (9 bits) e STOP; cada byte: 8 bits + ACK
+    double bits = sim->frame_transactions * 11.0 + sim->frame_bytes * 9.0;
+    st->bus_us += sim->bus_hz ? bits * 1e6 / sim->bus_hz : 0.0;
+    st->last_frame_us = time_us_64();
+    sim->frame_bytes = 0;
+    sim->frame_transactions = 0;
+}
+
+/**
+ * @brief Zera as medidas e reinicia o relógio; o tráfego em aberto é descartado
+ * @param sim Painel
+ */
+void ssd1306_sim_reset_stats(ssd1306_sim_t *sim) {
+    memset(&sim->stats, 0, sizeof sim->stats);
+    sim->stats.start_us = sim->stats.last_frame_us = time_us_64();
+    sim->frame_bytes = 0;
+    sim->frame_transactions = 0;
+}
+
+/**
+ * @brief Média de bytes I2C por quadro fechado
+ */
+double ssd1306_sim_bytes_per_frame(const ssd1306_sim_t *sim) {
+    return sim->stats.frames ? (double)sim->stats.bytes / sim->stats.frames : 0.0;
+}
+
+/**
+ * @brief Quadros por segundo medidos no relógio do host (custo de desenho e envio)
+ */
+double ssd1306_sim_fps(const ssd1306_sim_t *sim) {
+    uint64_t elapsed = sim->stats.last_frame_us - sim->stats.start_us;
+    return elapsed ? sim->stats.frames * 1e6 / elapsed : 0.0;
+}
+
+/**
+ * @brief Quadros por segundo que o barramento comporta com o tráfego médio medido
+ */
+double ssd1306_sim_bus_fps(const ssd1306_sim_t *sim) {
+    return sim->stats.bus_us > 0.0 ? sim->stats.frames * 1e6 / sim->stats.bus_us : 0.0;
+}
+
+/**
+ * @brief Imagem exibida em PBM binário (P4): pixel aceso = 1 (preto no arquivo)
+ * @param sim Painel
+ * @param out Buffer de saída (NULL apenas calcula o tamanho)
+ * @param size Tamanho do buffer
+ * @return Tamanho da imagem, ou 0 se o buffer for pequeno
+ */
+size_t ssd1306_sim_pbm(const ssd1306_sim_t *sim, uint8_t *out, size_t size) {
+    char header[16];
+    int n = snprintf(header, sizeof header, "P4\n%u %u\n", SSD1306_SIM_WIDTH, SSD1306_SIM_HEIGHT);
+    size_t total = (size_t)n + SSD1306_SIM_WIDTH / 8 * SSD1306_SIM_HEIGHT;
+    if (!out)
+        return total;
+    if (size < total)
+        return 0;
+    memcpy(out, header, (size_t)n);
+    uint8_t *p = out + n;
+    for (uint y = 0; y < SSD1306_SIM_HEIGHT; ++y)
+        for (uint x = 0; x < SSD1306_SIM_WIDTH; x += 8) {
+            uint8_t byte = 0;
+            for (uint b = 0; b < 8; ++b)
+                byte |= (uint8_t)(ssd1306_sim_pixel(sim, x + b, y) << (7 - b));
+            *p++ = byte;
+        }
+    return total;
+}
+
+/**
+ * @brief Grava a imagem exibida num arquivo PBM
+ * @param sim Painel
+ * @param path Caminho do arquivo
+ * @return true se o arquivo foi gravado
+ */
+bool ssd1306_sim_write_pbm(const ssd1306_sim_t *sim, const char *path) {
+    uint8_t image[32 + SSD1306_SIM_WIDTH / 8 * SSD1306_SIM_HEIGHT];
+    size_t len = ssd1306_sim_pbm(sim, image, sizeof image);
+    FILE *f = fopen(path, "wb");
+    if (!f)
+        return false;
+    bool ok = len && fwrite(image, 1, len, f) == len;
+    return 0 == fclose(f) && ok;
+}
@@ -0,0 +1,61 @@
+#ifndef SSD1306_SIM_H
+#define SSD1306_SIM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "hardware/i2c.h"
+#include "host_hal.h"
+
+#define SSD1306_SIM_WIDTH 128 // Colunas da GDDRAM
+#define SSD1306_SIM_PAGES 8   // Páginas de 8 linhas da GDDRAM
+#define SSD1306_SIM_HEIGHT (SSD1306_SIM_PAGES * 8)
+
+// Modos de endereçamento (comando 0x20)
+enum {
+    SSD1306_SIM_HORIZONTAL = 0,
+    SSD1306_SIM_VERTICAL = 1,
+    SSD1306_SIM_PAGE = 2
+};
+
+// Medidas dos quadros fechados por ssd1306_sim_end_frame
+typedef struct {
+    uint32_t frames;          // Quadros fechados
+    uint64_t bytes;           // Bytes I2C dos quadros (sem o byte de endereço)
+    uint64_t transactions;    // Transações I2C dos quadros
+    uint64_t max_frame_bytes; // Maior quadro
+    double bus_us;            // Tempo estimado no barramento (START, endereço, 9 bits por byte, STOP)
+    uint64_t start_us;        // Início da medição (ssd1306_sim_reset_stats)
+    uint64_t last_frame_us;   // Fechamento do último quadro
+} ssd1306_sim_stats_t;
+
+// Painel SSD1306 emulado no barramento I2C: interpreta comandos e dados e mantém a GDDRAM
+typedef struct {
+    uint8_t ram[SSD1306_SIM_PAGES][SSD1306_SIM_WIDTH]; // GDDRAM (bit j da página p = linha 8p + j)
+    uint bus_hz;              // Clock do barramento usado na estimativa de tempo
+
+    // Registradores de configuração
+    uint8_t mode;             // Modo de endereçamento
+    uint8_t x0, x1, p0, p1;   // Janela dos modos horizontal e vertical
+    uint8_t x, page;          // Ponteiros de coluna e página
+    bool display_on, inverted, entire_on, seg_remap, com_reversed;
+    uint8_t contrast, mux_ratio, start_line, offset;
+
+    // Comando em montagem (os argumentos podem chegar em transações separadas)
+    uint8_t cmd[8];
+    uint8_t cmd_len, cmd_need;
+
+    uint64_t frame_bytes, frame_transactions; // Tráfego do quadro em aberto
+    ssd1306_sim_stats_t stats;
+} ssd1306_sim_t;
+
+void ssd1306_sim_attach(ssd1306_sim_t *sim, i2c_inst_t *i2c, uint8_t addr, uint bus_hz); // Liga o painel (RAM indefinida) ao endereço
+bool ssd1306_sim_pixel(const ssd1306_sim_t *sim, uint x, uint y); // Pixel aceso na imagem exibida
+void ssd1306_sim_end_frame(ssd1306_sim_t *sim); // Fecha o quadro: contabiliza o tráfego desde o anterior
+void ssd1306_sim_reset_stats(ssd1306_sim_t *sim); // Zera as medidas e reinicia o relógio
+double ssd1306_sim_bytes_per_frame(const ssd1306_sim_t *sim); // Média de bytes I2C por quadro
+double ssd1306_sim_fps(const ssd1306_sim_t *sim); // Quadros por segundo medidos no relógio do host
+double ssd1306_sim_bus_fps(const ssd1306_sim_t *sim); // Quadros por segundo que o barramento comporta
+bool ssd1306_sim_write_pbm(const ssd1306_sim_t *sim, const char *path); // Grava a imagem exibida em PBM (P4)
+size_t ssd1306_sim_pbm(const ssd1306_sim_t *sim, uint8_t *out, size_t size); // Imagem em PBM num buffer; retorna o tamanho
+
+#endif // SSD1306_SIM_H
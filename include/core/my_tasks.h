@@ -1,15 +1,55 @@
 #ifndef MY_TASKS_H
 #define MY_TASKS_H
 
+#include <stdbool.h>
+
 #include "FreeRTOS.h"
 #include "FreeRTOSConfig.h"
 #include "task.h"
 #include "queue.h"
 #include "semphr.h"
 #include "timers.h"
+#include "stream_buffer.h"
+#include "ff.h"
+
+#ifndef SD_WRITER_BUFFER_SECTORS
+#define SD_WRITER_BUFFER_SECTORS 8 // Setores de cada buffer ping-pong (uma gravação multibloco)
+#endif
+#ifndef SD_WRITER_STREAM_SIZE
+#define SD_WRITER_STREAM_SIZE (8 * 1024) // Bytes entre os produtores e a tarefa de gravação
+#endif
+#ifndef SD_WRITER_IDLE_MS
+#define SD_WRITER_IDLE_MS 500 // Sem dados por este tempo, o buffer parcial é gravado e sincronizado
+#endif
+#ifndef SD_FLUSHER_PERIOD_MS
+#define SD_FLUSHER_PERIOD_MS 250 // Intervalo entre verificações do cache de setores
+#endif
+#ifndef SD_WRITER_PRIORITY
+#define SD_WRITER_PRIORITY (tskIDLE_PRIORITY + 1) // Abaixo das tarefas de amostragem
+#endif
+
+// Contadores do gravador assíncrono
+typedef struct
+{
+    uint32_t bytes_submitted; // Bytes aceitos no stream buffer
+    uint32_t bytes_dropped;   // Bytes recusados por falta de espaço
+    uint32_t buffers_written; // Buffers entregues ao cartão
+    uint32_t syncs;           // Sincronizações por ociosidade ou parada
+    uint32_t errors;          // Falhas do FatFs ou do cartão
+    uint32_t max_write_us;    // Pior tempo de gravação de um buffer
+    size_t max_stream_used;   // Maior ocupação observada do stream buffer
+} sd_writer_stats_t;
 
 void init_queues(void);
 void init_semaphores(void);
 void init_tasks(void);
 
+bool sd_writer_start(const char *base, FSIZE_t file_size); // Cria o gravador sobre um sd_log (volume já montado)
+size_t sd_writer_submit(const void *data, size_t len, TickType_t timeout); // Enfileira um registro
+bool sd_writer_stop(TickType_t timeout); // Grava o restante, fecha o arquivo e encerra as tarefas
+const sd_writer_stats_t *sd_writer_stats(void); // Contadores do gravador
+
+bool sd_flusher_start(void); // Grava periodicamente os setores sujos antigos do cache
+void sd_flusher_stop(void); // Encerra a tarefa de gravação periódica
+
 #endif // MY_TASKS_H
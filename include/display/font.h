@@ -1,8 +1,12 @@
 
 // Fontes para A-Z e 0-9. Os caracteres tem 8x8 pixels
+// Cada glifo são 8 colunas de 1 byte (bit j = linha j), já no formato do framebuffer
 
+#define FONT_FIRST ' ' // Primeiro caractere da tabela
+#define FONT_LAST '~' // Último caractere da tabela
+#define FONT_FALLBACK '?' // Desenhado no lugar de caracteres fora da tabela
 
-static uint8_t font[] = {
+static const uint8_t font[] = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //32 - Space
     0x00, 0x00, 0x00, 0x2f, 0x00, 0x00, 0x00, 0x00, //33 - !
     0x00, 0x00, 0x07, 0x00, 0x07, 0x00, 0x00, 0x00, //34 - "
@@ -99,3 +103,20 @@ static uint8_t font[] = {
     0x00, 0x00, 0x41, 0x36, 0x08, 0x00, 0x00, 0x00, //125 - }
     0x00, 0x02, 0x01, 0x02, 0x01, 0x00, 0x00, 0x00, //126 - ~
 };
+
+// Extensão horizontal de cada glifo para texto proporcional: primeira coluna
+// com pixels no nibble alto, largura no nibble baixo (espaço: 3 colunas vazias)
+static const uint8_t font_extent[] = {
+    0x03, 0x31, 0x23, 0x15, 0x15, 0x15, 0x15, 0x22, //   ! " # $ % & '
+    0x23, 0x23, 0x15, 0x15, 0x22, 0x15, 0x22, 0x15, // ( ) * + , - . /
+    0x15, 0x23, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15, // 0 1 2 3 4 5 6 7
+    0x15, 0x15, 0x22, 0x22, 0x14, 0x15, 0x24, 0x15, // 8 9 : ; < = > ?
+    0x15, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15, // @ A B C D E F G
+    0x15, 0x23, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15, // H I J K L M N O
+    0x15, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15, // P Q R S T U V W
+    0x15, 0x15, 0x15, 0x23, 0x15, 0x23, 0x15, 0x15, // X Y Z [ \ ] ^ _
+    0x23, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15, // ` a b c d e f g
+    0x15, 0x23, 0x14, 0x14, 0x23, 0x15, 0x15, 0x15, // h i j k l m n o
+    0x15, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15, 0x15, // p q r s t u v w
+    0x15, 0x15, 0x15, 0x23, 0x31, 0x23, 0x14, // x y z { | } ~
+};
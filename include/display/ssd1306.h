@@ -16,6 +16,11 @@
 #define HEIGHT 64 // Altura
 #define I2C_SDA_DISP 14 // Pino SDA
 #define I2C_SCL_DISP 15 // Pino SCL
+#define SSD1306_MAX_PAGES 8 // Páginas com alterações rastreadas (altura até 64)
+#define SSD1306_DMA_IDLE 0xFF // Nenhum buffer de envio em transmissão
+#define SSD1306_TEXT_PROPORTIONAL 0x01 // Texto com a largura de cada glifo mais 1 coluna de espaço
+#define SSD1306_TEXT_SCALE2 0x02 // Texto com o dobro da largura e da altura
+#define SSD1306_TEXT_MAX_COLUMNS SSD1306_WIDTH // Colunas de um texto pré-renderizado
 
 typedef enum {
   SET_CONTRAST = 0x81,
@@ -37,20 +42,50 @@ typedef enum {
   SET_CHARGE_PUMP = 0x8D
 } ssd1306_command_t; // Comandos do display OLED SSD1306
 
-// Estrutura para armazenar as configurações do display OLED SSD1306 
+typedef struct ssd1306 ssd1306_t;
+
+// Texto pré-renderizado em colunas, para rótulos redesenhados com frequência
 typedef struct {
+  uint16_t columns[SSD1306_TEXT_MAX_COLUMNS]; // Colunas do texto: o bit y é a linha y
+  uint8_t width; // Colunas usadas
+  uint8_t height; // Linhas (8, ou 16 com SSD1306_TEXT_SCALE2)
+} ssd1306_text_t;
+
+// Chamado ao término de cada envio por DMA (na interrupção) ou logo, se não houver o que enviar
+typedef void (*ssd1306_flush_cb_t)(ssd1306_t *ssd, void *ctx);
+
+// Estrutura para armazenar as configurações do display OLED SSD1306 
+struct ssd1306 {
   uint8_t width, height, pages, address; // Parâmetros do display
   i2c_inst_t *i2c_port; // Porta I2C
   bool external_vcc; // Tensão de alimentação
   uint8_t *ram_buffer; // Buffer de memória
   size_t bufsize; // Tamanho do buffer
   uint8_t port_buffer[2]; // Buffer de porta
-} ssd1306_t; 
+  uint8_t *sent_buffer; // O que o painel exibe (sem o byte de controle)
+  uint16_t *dma_buffer[2]; // Envios em quadro duplo: palavras de IC_DATA_CMD (byte + STOP)
+  size_t dma_len[2]; // Palavras de cada buffer de envio
+  uint dma_channel; // Canal de DMA que alimenta a FIFO de transmissão I2C
+  volatile uint8_t dma_active; // Buffer em transmissão ou à espera do barramento (SSD1306_DMA_IDLE: nenhum)
+  volatile bool dma_queued; // O outro buffer aguarda o término do atual
+  ssd1306_flush_cb_t on_flush; // Notificação de término do envio
+  void *on_flush_ctx; // Contexto repassado a on_flush
+  uint8_t dirty_x0[SSD1306_MAX_PAGES]; // Primeira coluna alterada de cada página
+  uint8_t dirty_x1[SSD1306_MAX_PAGES]; // Última coluna alterada (x0 > x1: nenhuma)
+  bool panel_synced; // sent_buffer corresponde à RAM do painel
+};
 
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c); // Inicializa o display OLED SSD1306
 void ssd1306_config(ssd1306_t *ssd);  // Configura o display OLED SSD1306
 void ssd1306_command(ssd1306_t *ssd, uint8_t command); // Envia um comando para o display OLED SSD1306
-void ssd1306_send_data(ssd1306_t *ssd); // Envia dados para o display OLED SSD1306
+void ssd1306_send_data(ssd1306_t *ssd); // Envia ao display as regiões alteradas desde o último envio
+bool ssd1306_send_data_async(ssd1306_t *ssd); // Inicia (ou enfileira) por DMA o envio das regiões alteradas
+bool ssd1306_busy(const ssd1306_t *ssd); // Há envio por DMA em curso ou enfileirado
+void ssd1306_wait(const ssd1306_t *ssd); // Aguarda o término dos envios por DMA
+void ssd1306_set_flush_callback(ssd1306_t *ssd, ssd1306_flush_cb_t cb, void *ctx); // Define a notificação de término do envio
+void ssd1306_deinit(ssd1306_t *ssd); // Libera os buffers e o canal de DMA
+void ssd1306_mark_dirty(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1); // Marca uma região do buffer como alterada
+void ssd1306_invalidate(ssd1306_t *ssd); // Força o reenvio do quadro inteiro no próximo ssd1306_send_data
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value); // Desenha um pixel no display OLED SSD1306
 void ssd1306_fill(ssd1306_t *ssd, bool value); // Preenche o display OLED SSD1306
 void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill); // Desenha um retângulo no display OLED SSD1306
@@ -59,6 +94,11 @@ void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value); // Desenha uma linha vertical no display OLED SSD1306
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y); // Desenha um caractere no display OLED SSD1306
 void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y); // Desenha uma string no display OLED SSD1306
+void ssd1306_draw_bitmap(ssd1306_t *ssd, const uint8_t *columns, uint8_t n, uint8_t x, uint8_t y); // Desenha um bitmap de 8 linhas em colunas
+uint8_t ssd1306_draw_text(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y, uint8_t flags); // Desenha um texto numa linha, retorna a coluna seguinte
+uint8_t ssd1306_text_width(const char *str, uint8_t flags); // Largura de um texto em colunas
+uint8_t ssd1306_text_render(ssd1306_text_t *text, const char *str, uint8_t flags); // Pré-renderiza um texto, retorna a largura
+void ssd1306_draw_text_cached(ssd1306_t *ssd, const ssd1306_text_t *text, uint8_t x, uint8_t y); // Copia um texto pré-renderizado para o buffer
 void display_init(ssd1306_t *ssd); // Inicializa o display OLED SSD1306
 void ssd1306_clear(ssd1306_t *ssd); // Limpa o display OLED SSD1306
 void start_display(ssd1306_t *ssd); // Inicia a exibição da tela de início
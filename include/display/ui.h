@@ -0,0 +1,80 @@
+#ifndef UI_H
+#define UI_H
+
+#include "display/ssd1306.h"
+
+#define UI_LABEL_MAX 21 // Caracteres de um rótulo
+#define UI_SPARKLINE_MAX 64 // Amostras de um gráfico de linha
+#define UI_SPACING 2 // Colunas entre widgets vizinhos numa linha
+
+typedef struct ui_widget ui_widget_t;
+
+// Operações de cada tipo de widget
+typedef struct {
+  uint8_t (*measure)(ui_widget_t *w); // Largura natural (a altura é fixa)
+  bool (*update)(ui_widget_t *w); // Lê o valor associado; true se a imagem mudou
+  void (*draw)(ui_widget_t *w, ssd1306_t *ssd); // Desenha o widget nos seus limites
+} ui_widget_class_t;
+
+// Widget retido: posição calculada pelo layout e o retângulo desenhado por último
+struct ui_widget {
+  const ui_widget_class_t *cls; // Tipo do widget
+  ui_widget_t *next; // Próximo widget da tela
+  bool row_break; // Começa uma nova linha
+  uint8_t x, y, width, height; // Limites atuais
+  uint8_t drawn_x, drawn_y, drawn_width, drawn_height; // Limites da última renderização (largura 0: nunca)
+  bool redraw; // Redesenho forçado (layout ou sobreposição)
+};
+
+// Texto associado a um buffer da aplicação
+typedef struct {
+  ui_widget_t base;
+  const char *text; // Texto exibido (lido a cada renderização)
+  uint8_t flags; // SSD1306_TEXT_*
+  char shown[UI_LABEL_MAX + 1]; // Texto da última renderização
+} ui_label_t;
+
+// Barra horizontal proporcional a um valor entre min e max
+typedef struct {
+  ui_widget_t base;
+  const int32_t *value; // Valor exibido
+  int32_t min, max; // Faixa do valor
+  uint8_t shown; // Colunas preenchidas na última renderização
+} ui_bar_t;
+
+// Gráfico de linha das últimas amostras, uma por coluna
+typedef struct {
+  ui_widget_t base;
+  int16_t samples[UI_SPARKLINE_MAX]; // Anel de amostras
+  uint8_t head, count; // Próxima posição e amostras válidas
+  int16_t min, max; // Faixa do eixo vertical
+  bool changed; // Amostra nova desde a última renderização
+} ui_sparkline_t;
+
+// Ícone 8x8 escolhido por um índice
+typedef struct {
+  ui_widget_t base;
+  const uint8_t (*bitmaps)[8]; // Ícones em colunas (bit j = linha j), como a fonte
+  uint8_t count; // Número de ícones
+  const uint8_t *index; // Ícone exibido
+  uint8_t shown; // Índice da última renderização
+} ui_icon_t;
+
+// Tela: lista de widgets dispostos em linhas
+typedef struct {
+  ui_widget_t *first, *last; // Widgets, na ordem do layout
+  uint8_t x, y; // Canto superior esquerdo
+  bool layout_dirty; // Algum widget mudou de tamanho
+} ui_screen_t;
+
+void ui_screen_init(ui_screen_t *screen, uint8_t x, uint8_t y); // Inicializa uma tela vazia
+void ui_screen_add(ui_screen_t *screen, ui_widget_t *w, bool row_break); // Acrescenta um widget (opcionalmente numa nova linha)
+uint8_t ui_render(ui_screen_t *screen, ssd1306_t *ssd); // Redesenha só os widgets alterados, retorna quantos
+void ui_invalidate(ui_screen_t *screen); // Força o redesenho de todos os widgets
+void ui_label_init(ui_label_t *label, const char *text, uint8_t flags); // Rótulo associado a um texto
+void ui_bar_init(ui_bar_t *bar, const int32_t *value, int32_t min, int32_t max, uint8_t width, uint8_t height); // Barra associada a um valor
+void ui_sparkline_init(ui_sparkline_t *spark, int16_t min, int16_t max, uint8_t width, uint8_t height); // Gráfico de linha vazio
+void ui_sparkline_push(ui_sparkline_t *spark, int16_t sample); // Acrescenta uma amostra ao gráfico
+void ui_icon_init(ui_icon_t *icon, const uint8_t (*bitmaps)[8], uint8_t count, const uint8_t *index); // Ícone associado a um índice
+
+#endif // UI_H
@@ -7,35 +7,88 @@
 #include "hardware/pio.h"
 #include "hardware/clocks.h"
 #include "ws2812.pio.h"
+#include "drivers/matrix_map.h"
 
 #define WS2812_PIN 7 // Define o pino do LED RGB
-#define NUM_PIXELS 25 // Define o número de LEDs RGB
 #define FRAME_DELAY 200 // Define o atraso entre os frames
 
-// Definição da estrutura RGB para representar as cores
+// Geometria: painéis iguais, encadeados em linhas de MATRIX_TILES_X
+#ifndef MATRIX_PANEL_WIDTH
+#define MATRIX_PANEL_WIDTH 5 // Colunas de um painel
+#endif
+#ifndef MATRIX_PANEL_HEIGHT
+#define MATRIX_PANEL_HEIGHT 5 // Linhas de um painel
+#endif
+#ifndef MATRIX_TILES_X
+#define MATRIX_TILES_X 1 // Painéis por linha
+#endif
+#ifndef MATRIX_TILES_Y
+#define MATRIX_TILES_Y 1 // Linhas de painéis
+#endif
+#ifndef MATRIX_LAYOUT
+#define MATRIX_LAYOUT (MATRIX_LAYOUT_RIGHT | MATRIX_LAYOUT_BOTTOM | MATRIX_LAYOUT_SERPENTINE) // Matriz 5x5 da BitDogLab
+#endif
+
+#define MATRIX_WIDTH (MATRIX_PANEL_WIDTH * MATRIX_TILES_X) // Colunas da imagem
+#define MATRIX_HEIGHT (MATRIX_PANEL_HEIGHT * MATRIX_TILES_Y) // Linhas da imagem
+#define NUM_PIXELS (MATRIX_WIDTH * MATRIX_HEIGHT) // Define o número de LEDs RGB
+
+#ifndef MATRIX_BRIGHTNESS
+#define MATRIX_BRIGHTNESS 10 // Brilho global inicial (0-255); 10 mantém a intensidade das cores de antes
+#endif
+
+#ifndef MATRIX_RESET_US
+#define MATRIX_RESET_US 300 // Linha em nível baixo após o quadro para o WS2812 aplicar as cores (latch)
+#endif
+
+#ifndef MATRIX_GAMMA
+#define MATRIX_GAMMA 1 // Aplica a correção de gama 2.2 antes do brilho
+#endif
+
+// Cor de um LED em 8 bits por canal, na ordem em que o WS2812 recebe (3 bytes por LED)
 typedef struct {
-    double R; // Intensidade da cor vermelha
-    double G; // Intensidade da cor verde
-    double B; // Intensidade da cor azul
-} RGB;
-
-//Cores 
-extern const RGB RED; // Vermelho
-extern const RGB GREEN; // Verde
-extern const RGB BLUE; // Azul
-extern const RGB YELLOW; // Amarelo
-extern const RGB CYAN; // Ciano
-extern const RGB MAGENTA; // Magenta
-extern const RGB WHITE; // Branco
-extern const RGB BLACK; // Preto
+    uint8_t G; // Intensidade da cor verde
+    uint8_t R; // Intensidade da cor vermelha
+    uint8_t B; // Intensidade da cor azul
+} GRB;
+
+//Cores (intensidade máxima; a intensidade exibida vem do brilho global)
+extern const GRB RED; // Vermelho
+extern const GRB GREEN; // Verde
+extern const GRB BLUE; // Azul
+extern const GRB YELLOW; // Amarelo
+extern const GRB CYAN; // Ciano
+extern const GRB MAGENTA; // Magenta
+extern const GRB WHITE; // Branco
+extern const GRB BLACK; // Preto
+
+typedef void (*matrix_done_cb_t)(void *ctx); // Notificação de quadro exibido (contexto de interrupção)
+
+/**
+ * @brief Monta uma cor a partir dos canais na ordem usual
+ */
+static inline GRB grb(uint8_t r, uint8_t g, uint8_t b) {
+    return (GRB){g, r, b};
+}
 
 uint matrix_init(); // Inicializa a matriz de LEDs RGB
-uint32_t matrix_rgb(double r, double g, double b); // Função para converter as intensidades de cor para um valor RGB
-void set_leds(PIO pio, uint sm, double r, double g, double b); // Função para definir as cores dos LEDs
-int getIndex(int x, int y); // Função para obter o índice do LED RGB
+void matrix_set_brightness(uint8_t level); // Define o brilho global e recalcula a tabela de conversão
+uint8_t matrix_get_brightness(void); // Retorna o brilho global
+uint32_t matrix_rgb(uint8_t r, uint8_t g, uint8_t b); // Função para converter as intensidades de cor para a palavra do PIO
+uint32_t matrix_word(GRB color); // Converte uma cor para a palavra do PIO (gama e brilho aplicados)
+GRB grb_blend(GRB a, GRB b, uint16_t t); // Mistura duas cores com peso t/256 da segunda
+GRB grb_scale(GRB color, uint8_t scale); // Escala uma cor por scale/256 (255 mantém a cor)
+bool matrix_submit(const GRB pixels[NUM_PIXELS]); // Enfileira um quadro para envio por DMA, sem esperar
+bool matrix_busy(void); // Há quadro em envio, enfileirado ou aguardando o latch
+void matrix_wait(void); // Aguarda o envio e o latch de todos os quadros
+void matrix_set_done_callback(matrix_done_cb_t cb, void *ctx); // Define a notificação de quadro exibido
+void set_leds(PIO pio, uint sm, uint8_t r, uint8_t g, uint8_t b); // Função para definir as cores dos LEDs
+extern const uint16_t matrix_map[]; // Posição na cadeia de cada pixel (índice y * MATRIX_WIDTH + x)
+int getIndex(int x, int y); // Função para obter a posição do LED RGB na cadeia
 void getCoordinates(int index, int *x, int *y); // Função para obter as coordenadas do LED RGB
-void draw_matrix(RGB pixels[NUM_PIXELS], PIO pio, uint sm); // Função para desenhar a matriz de LEDs RGB
-uint coordenates_to_index(int x, int y); // Função para converter as coordenadas para o índice do LED RGB
+void matrix_encode(const GRB pixels[NUM_PIXELS], uint32_t words[NUM_PIXELS]); // Converte um quadro para as palavras do PIO, na ordem da cadeia
+void draw_matrix(const GRB pixels[NUM_PIXELS], PIO pio, uint sm); // Função para desenhar a matriz de LEDs RGB
+uint coordenates_to_index(int x, int y); // Função para converter as coordenadas para o índice do pixel no quadro
 void clear_matrix(); // Função para apagar a matriz de LEDs RGB
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,65 @@
+#ifndef MATRIX_ANIM_H
+#define MATRIX_ANIM_H
+
+#include "drivers/matrix.h"
+
+#ifndef MATRIX_ANIM_TICK_MS
+#define MATRIX_ANIM_TICK_MS 20 // Período do timer de interpolação (50 quadros/s no máximo)
+#endif
+
+#define MATRIX_ANIM_HOLD 0x01 // Mantém a keyframe até a próxima, sem interpolar
+
+#if NUM_PIXELS <= 256
+typedef uint8_t matrix_anim_pixel_t; // Índice de pixel nos deltas (1 byte até 256 LEDs)
+#else
+typedef uint16_t matrix_anim_pixel_t;
+#endif
+
+// Pixel alterado em relação à keyframe anterior
+typedef struct {
+    matrix_anim_pixel_t pixel; // Índice no quadro (y * MATRIX_WIDTH + x)
+    GRB color; // Nova cor
+} matrix_anim_delta_t;
+
+// Keyframe: diferenças para a anterior e o tempo até a seguinte
+typedef struct {
+    const matrix_anim_delta_t *deltas; // Pixels alterados
+    uint16_t count; // Número de pixels alterados
+    uint16_t duration_ms; // Transição até a próxima keyframe
+    uint8_t flags; // MATRIX_ANIM_*
+} matrix_anim_key_t;
+
+// Sequência em flash: quadro base e keyframes (a primeira parte do quadro base)
+typedef struct {
+    const GRB *base; // Quadro base (NULL: todos apagados)
+    const matrix_anim_key_t *keys; // Keyframes
+    uint16_t num_keys; // Número de keyframes (> 0)
+    bool loop; // A última keyframe transiciona para a primeira
+} matrix_anim_t;
+
+// Reprodutor: quadros de origem, destino e atual da transição em andamento
+typedef struct {
+    const matrix_anim_t *anim; // Sequência
+    uint16_t key; // Keyframe de origem
+    uint32_t key_start_ms; // Início da transição atual no relógio da animação
+    uint32_t elapsed_ms; // Relógio da animação
+    GRB from[NUM_PIXELS]; // Quadro da keyframe de origem
+    GRB to[NUM_PIXELS]; // Quadro da keyframe de destino
+    GRB frame[NUM_PIXELS]; // Quadro atual
+    uint16_t changing[NUM_PIXELS]; // Pixels que diferem entre origem e destino
+    uint16_t num_changing;
+    bool dirty; // O quadro atual ainda não foi enviado
+    bool finished; // Última keyframe alcançada (sem repetição)
+    uint32_t frames_sent; // Quadros enviados à matriz
+    repeating_timer_t timer;
+} matrix_anim_player_t;
+
+void matrix_anim_start(matrix_anim_player_t *player, const matrix_anim_t *anim); // Posiciona o reprodutor na primeira keyframe
+bool matrix_anim_step(matrix_anim_player_t *player, uint32_t elapsed_ms); // Calcula o quadro no instante; true se mudou
+bool matrix_anim_play(matrix_anim_player_t *player, const matrix_anim_t *anim); // Reproduz pela matriz, no timer
+void matrix_anim_stop(matrix_anim_player_t *player); // Interrompe a reprodução
+bool matrix_anim_playing(const matrix_anim_player_t *player); // A reprodução não terminou
+uint32_t matrix_anim_duration_ms(const matrix_anim_t *anim); // Duração de uma passagem pela sequência
+size_t matrix_anim_flash_size(const matrix_anim_t *anim); // Bytes da sequência em flash
+
+#endif // MATRIX_ANIM_H
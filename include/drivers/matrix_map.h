@@ -0,0 +1,52 @@
+#ifndef MATRIX_MAP_H
+#define MATRIX_MAP_H
+
+// Geometria de matrizes WS2812: posição de cada LED na cadeia a partir da
+// coluna x (esquerda para a direita) e da linha y (de cima para baixo).
+// As macros são expressões constantes, para que as tabelas sejam montadas
+// pelo compilador.
+
+// Opções de disposição de um painel e do encadeamento dos painéis
+#define MATRIX_LAYOUT_RIGHT 0x01 // O primeiro LED do painel está à direita
+#define MATRIX_LAYOUT_BOTTOM 0x02 // O primeiro LED do painel está embaixo
+#define MATRIX_LAYOUT_VERTICAL 0x04 // As fileiras do painel são colunas (senão, linhas)
+#define MATRIX_LAYOUT_SERPENTINE 0x08 // Fileiras alternam o sentido (senão, todas no mesmo sentido)
+#define MATRIX_LAYOUT_TILE_SERPENTINE 0x10 // Linhas ímpares de painéis vão da direita para a esquerda
+
+// Coordenadas no painel vistas a partir do canto do primeiro LED
+#define MATRIX_LAYOUT_UX(px, pw, f) ((f) & MATRIX_LAYOUT_RIGHT ? (pw) - 1 - (px) : (px))
+#define MATRIX_LAYOUT_UY(py, ph, f) ((f) & MATRIX_LAYOUT_BOTTOM ? (ph) - 1 - (py) : (py))
+
+// Posição na fileira major, de comprimento len
+#define MATRIX_LAYOUT_STRIP(major, minor, len, f) \
+  ((major) * (len) + (((f) & MATRIX_LAYOUT_SERPENTINE) && (major) % 2 ? (len) - 1 - (minor) : (minor)))
+
+// Posição dentro de um painel pw x ph
+#define MATRIX_LAYOUT_PANEL(px, py, pw, ph, f)                                                   \
+  ((f) & MATRIX_LAYOUT_VERTICAL                                                                  \
+     ? MATRIX_LAYOUT_STRIP(MATRIX_LAYOUT_UX(px, pw, f), MATRIX_LAYOUT_UY(py, ph, f), ph, f)     \
+     : MATRIX_LAYOUT_STRIP(MATRIX_LAYOUT_UY(py, ph, f), MATRIX_LAYOUT_UX(px, pw, f), pw, f))
+
+// Painel na cadeia: linhas de tx painéis, a partir do canto superior esquerdo
+#define MATRIX_LAYOUT_TILE(x, y, pw, ph, tx, f) \
+  ((y) / (ph) * (tx) + (((f) & MATRIX_LAYOUT_TILE_SERPENTINE) && (y) / (ph) % 2 ? (tx) - 1 - (x) / (pw) : (x) / (pw)))
+
+/**
+ * @brief Posição na cadeia do LED (x, y) numa grade de painéis pw x ph, tx painéis por linha
+ */
+#define MATRIX_LAYOUT_INDEX(x, y, pw, ph, tx, f) \
+  (MATRIX_LAYOUT_TILE(x, y, pw, ph, tx, f) * (pw) * (ph) + MATRIX_LAYOUT_PANEL((x) % (pw), (y) % (ph), pw, ph, f))
+
+// Repetição para inicializar tabelas: M(n), M(n + 1), ... separados por vírgulas
+#define MATRIX_REPEAT_4(M, n) M(n), M((n) + 1), M((n) + 2), M((n) + 3)
+#define MATRIX_REPEAT_16(M, n) \
+  MATRIX_REPEAT_4(M, n), MATRIX_REPEAT_4(M, (n) + 4), MATRIX_REPEAT_4(M, (n) + 8), MATRIX_REPEAT_4(M, (n) + 12)
+#define MATRIX_REPEAT_64(M, n) \
+  MATRIX_REPEAT_16(M, n), MATRIX_REPEAT_16(M, (n) + 16), MATRIX_REPEAT_16(M, (n) + 32), MATRIX_REPEAT_16(M, (n) + 48)
+#define MATRIX_REPEAT_256(M, n) \
+  MATRIX_REPEAT_64(M, n), MATRIX_REPEAT_64(M, (n) + 64), MATRIX_REPEAT_64(M, (n) + 128), MATRIX_REPEAT_64(M, (n) + 192)
+#define MATRIX_REPEAT_1024(M, n)                                                                  \
+  MATRIX_REPEAT_256(M, n), MATRIX_REPEAT_256(M, (n) + 256), MATRIX_REPEAT_256(M, (n) + 512), \
+    MATRIX_REPEAT_256(M, (n) + 768)
+
+#endif // MATRIX_MAP_H
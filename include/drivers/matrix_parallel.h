@@ -0,0 +1,30 @@
+#ifndef MATRIX_PARALLEL_H
+#define MATRIX_PARALLEL_H
+
+#include "drivers/matrix.h"
+#include "ws2812_parallel.pio.h"
+
+#define MATRIX_PARALLEL_MAX_STRIPS 8 // Fitas por máquina de estados (um byte por plano de bits)
+#define MATRIX_PARALLEL_WORDS_PER_LED 6 // 24 planos de bits, 4 por palavra do PIO
+
+// Fitas WS2812 em pinos consecutivos, atualizadas ao mesmo tempo por uma máquina de estados
+typedef struct {
+    PIO pio; // Bloco PIO
+    uint sm; // Máquina de estados
+    uint offset; // Posição do programa na memória do PIO
+    uint pin_base; // Pino da fita 0; a fita i fica em pin_base + i
+    uint8_t num_strips; // Número de fitas
+    uint16_t leds_per_strip; // LEDs da fita mais longa
+    int dma_channel; // Canal que alimenta a FIFO
+    uint32_t *planes; // Planos de bits do quadro (MATRIX_PARALLEL_WORDS_PER_LED por LED)
+    uint64_t ready_us; // Instante a partir do qual o próximo quadro pode começar (fim do latch)
+} matrix_parallel_t;
+
+bool matrix_parallel_init(matrix_parallel_t *par, PIO pio, uint pin_base, uint8_t num_strips, uint16_t leds_per_strip); // Configura as fitas, a máquina de estados e o DMA
+void matrix_parallel_deinit(matrix_parallel_t *par); // Libera o buffer, o DMA, a máquina de estados, o programa e os pinos
+void matrix_parallel_transpose(const uint32_t words[MATRIX_PARALLEL_MAX_STRIPS], uint32_t planes[MATRIX_PARALLEL_WORDS_PER_LED]); // Transpõe um LED de cada fita em planos de bits
+void matrix_parallel_show(matrix_parallel_t *par, const GRB *const strips[], const uint16_t lengths[]); // Envia um quadro de cada fita, em paralelo
+void matrix_parallel_wait(const matrix_parallel_t *par); // Aguarda o envio e o latch do último quadro
+uint32_t matrix_parallel_frame_us(const matrix_parallel_t *par); // Tempo de um quadro na linha, com o latch
+
+#endif // MATRIX_PARALLEL_H
@@ -17,6 +17,7 @@
 #include "my_debug.h"
 #include "rtc.h"
 #include "sd_card.h"
+#include "sector_cache.h"
 
 typedef void (*p_fn_t)();
 typedef struct
@@ -26,6 +27,66 @@ typedef struct
     char const *const help;
 } cmd_def_t;
 
+#define SD_LOG_MAX_INDEX 999 // Extensão de três dígitos: base.000 a base.999
+#ifndef SD_LOG_BUFFER_SECTORS
+#define SD_LOG_BUFFER_SECTORS 8 // Setores acumulados antes de cada gravação multibloco
+#endif
+
+#ifndef SD_BENCH_MAX_SECTORS
+#define SD_BENCH_MAX_SECTORS 32 // Maior transferência sequencial do bench (buffer estático)
+#endif
+#ifndef SD_BENCH_DEFAULT_KIB
+#define SD_BENCH_DEFAULT_KIB 1024 // Área de teste padrão do comando bench
+#endif
+#ifndef SD_BENCH_RANDOM_OPS
+#define SD_BENCH_RANDOM_OPS 256 // Operações de 4 KiB por teste aleatório
+#endif
+#ifndef SD_BENCH_SYNC_OPS
+#define SD_BENCH_SYNC_OPS 64 // Pares f_write + f_sync medidos
+#endif
+#ifndef SD_BENCH_HIST_BUCKETS
+#define SD_BENCH_HIST_BUCKETS 20 // Baldes de potência de 2 (us) do histograma de latência
+#endif
+
+#ifndef SD_FASTSEEK_ENTRIES
+#define SD_FASTSEEK_ENTRIES 4 // Arquivos com tabela de clusters (CLMT) mantida em RAM
+#endif
+#ifndef SD_FASTSEEK_CLMT_WORDS
+#define SD_FASTSEEK_CLMT_WORDS 64 // Palavras por tabela: (n - 2) / 2 fragmentos
+#endif
+
+// Contadores do cache de tabelas de clusters
+typedef struct
+{
+    uint32_t hits;       // Aberturas que reaproveitaram uma tabela
+    uint32_t builds;     // Tabelas criadas (arquivo novo, alterado ou despejado)
+    uint32_t evictions;  // Tabelas descartadas pelo LRU
+    uint32_t too_fragmented; // Arquivos com fragmentos demais: abertos sem busca rápida
+    uint32_t full;       // Todas as tabelas em uso: aberto sem busca rápida
+} sd_fastseek_stats_t;
+
+/**
+ * @brief Registrador contínuo sobre arquivos pré-alocados
+ *
+ * Cada arquivo é reservado de uma vez com f_expand como uma cadeia contígua
+ * de clusters; os dados são gravados direto nos setores dessa faixa de LBA,
+ * sem percorrer a FAT a cada escrita. Ao encher, o arquivo é fechado e o
+ * registro continua no próximo da sequência (base.000, base.001, ...).
+ */
+typedef struct
+{
+    FIL fil;
+    char base[32];  // Caminho sem o número de sequência
+    uint32_t index; // Número do arquivo atual
+    FSIZE_t size;   // Bytes reservados por arquivo
+    LBA_t lba;      // Primeiro setor do arquivo atual
+    LBA_t sectors;  // Setores reservados
+    LBA_t written;  // Setores completos já gravados
+    UINT fill;      // Bytes pendentes em buf
+    bool open;
+    uint8_t buf[SD_LOG_BUFFER_SECTORS * FF_MAX_SS];
+} sd_log_t;
+
 sd_card_t *sd_get_by_name(const char *const name); // Obtém o cartão SD pelo nome
 FATFS *sd_get_fs_by_name(const char *name); // Obtém o sistema de arquivos pelo nome
 void run_setrtc(void); // Configura a data e hora do RTC
@@ -36,5 +97,16 @@ void run_getfree(void); // Obtém o espaço livre no cartão SD
 void run_ls(void); // Lista os arquivos do cartão SD
 void run_cat(void); // Lê o conteúdo de um arquivo
 void read_file(const char *filename); // Lê o conteúdo de um arquivo 
+FRESULT sd_log_open(sd_log_t *log, const char *base, FSIZE_t size); // Abre o registrador no primeiro arquivo livre
+FRESULT sd_log_append(sd_log_t *log, const void *data, UINT len); // Acrescenta dados ao registro
+FRESULT sd_log_sync(sd_log_t *log); // Grava os dados pendentes no cartão
+FRESULT sd_log_rotate(sd_log_t *log); // Fecha o arquivo atual e abre o próximo
+FRESULT sd_log_close(sd_log_t *log); // Fecha o registrador
+FRESULT sd_fastseek_open(FIL *fil, const char *path); // Abre para leitura com busca rápida (CLMT em cache)
+FRESULT sd_fastseek_close(FIL *fil); // Fecha um arquivo aberto com sd_fastseek_open
+void sd_fastseek_invalidate(const char *path); // Descarta a tabela de um arquivo (NULL: todas)
+const sd_fastseek_stats_t *sd_fastseek_stats(void); // Contadores do cache de tabelas
+FRESULT sd_bench(const char *drive, const char *test, UINT kib); // Testes de desempenho com saída CSV
+void run_bench(void); // Comando bench: desempenho do cartão em CSV
 
 #endif
\ No newline at end of file
@@ -3,6 +3,8 @@
 /*------------------------------------------------------------------------*/
 
 #include "ff.h"
+#include "ff_lock_stats.h"
+#include <string.h>
 
 
 #if FF_USE_LFN == 3	/* Use dynamic memory allocation */
@@ -39,7 +41,7 @@ void ff_memfree (
 /* Definitions of Mutex                                                   */
 /*------------------------------------------------------------------------*/
 
-#define OS_TYPE	0	/* 0:Win32, 1:uITRON4.0, 2:uC/OS-II, 3:FreeRTOS, 4:CMSIS-RTOS */
+#define OS_TYPE	3	/* 0:Win32, 1:uITRON4.0, 2:uC/OS-II, 3:FreeRTOS, 4:CMSIS-RTOS */
 
 
 #if   OS_TYPE == 0	/* Win32 */
@@ -58,6 +60,7 @@ static OS_EVENT *Mutex[FF_VOLUMES + 1];	/* Table of mutex pinter */
 #elif OS_TYPE == 3	/* FreeRTOS */
 #include "FreeRTOS.h"
 #include "semphr.h"
+#include "task.h"
 static SemaphoreHandle_t Mutex[FF_VOLUMES + 1];	/* Table of mutex handle */
 
 #elif OS_TYPE == 4	/* CMSIS-RTOS */
@@ -66,6 +69,21 @@ static osMutexId Mutex[FF_VOLUMES + 1];	/* Table of mutex ID */
 
 #endif
 
+/* Contention counters, see ff_lock_stats.h */
+#include "pico/time.h"
+static ff_lock_stats_t LockStats[FF_VOLUMES + 1];
+static uint64_t TakenAt[FF_VOLUMES + 1];	/* When the current owner got the mutex */
+
+const ff_lock_stats_t *ff_lock_stats (int vol)
+{
+	return (vol >= 0 && vol <= FF_VOLUMES) ? &LockStats[vol] : 0;
+}
+
+void ff_lock_stats_reset (int vol)
+{
+	if (vol >= 0 && vol <= FF_VOLUMES) memset(&LockStats[vol], 0, sizeof LockStats[vol]);
+}
+
 
 
 /*------------------------------------------------------------------------*/
@@ -166,7 +184,29 @@ int ff_mutex_take (	/* Returns 1:Succeeded or 0:Timeout */
 	return (int)(err == OS_NO_ERR);
 
 #elif OS_TYPE == 3	/* FreeRTOS */
-	return (int)(xSemaphoreTake(Mutex[vol], FF_FS_TIMEOUT) == pdTRUE);
+	ff_lock_stats_t *st = &LockStats[vol];
+	uint64_t t0 = time_us_64();
+
+	if (xSemaphoreTake(Mutex[vol], 0) != pdTRUE) {	/* Busy: wait for it and account the wait */
+		if (xSemaphoreTake(Mutex[vol], FF_FS_TIMEOUT) != pdTRUE) {
+			/* Not the owner: other tasks may be updating the counters */
+			taskENTER_CRITICAL();
+			st->timeouts++;
+			taskEXIT_CRITICAL();
+			return 0;
+		}
+		uint64_t now = time_us_64();
+		uint32_t wait = (uint32_t)(now - t0);
+
+		st->contended++;
+		st->wait_us += wait;
+		if (wait > st->max_wait_us) st->max_wait_us = wait;
+		t0 = now;
+	}
+	/* Past this point the counters are only updated by the owner, so the mutex protects them */
+	st->takes++;
+	TakenAt[vol] = t0;
+	return 1;
 
 #elif OS_TYPE == 4	/* CMSIS-RTOS */
 	return (int)(osMutexWait(Mutex[vol], FF_FS_TIMEOUT) == osOK);
@@ -196,6 +236,11 @@ void ff_mutex_give (
 	OSMutexPost(Mutex[vol]);
 
 #elif OS_TYPE == 3	/* FreeRTOS */
+	ff_lock_stats_t *st = &LockStats[vol];
+	uint32_t hold = (uint32_t)(time_us_64() - TakenAt[vol]);
+
+	st->hold_us += hold;
+	if (hold > st->max_hold_us) st->max_hold_us = hold;
 	xSemaphoreGive(Mutex[vol]);
 
 #elif OS_TYPE == 4	/* CMSIS-RTOS */
@@ -204,5 +249,18 @@ void ff_mutex_give (
 #endif
 }
 
+#else
+
+const ff_lock_stats_t *ff_lock_stats (int vol)
+{
+	(void)vol;
+	return 0;
+}
+
+void ff_lock_stats_reset (int vol)
+{
+	(void)vol;
+}
+
 #endif	/* FF_FS_REENTRANT */
 
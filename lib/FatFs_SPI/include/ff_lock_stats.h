@@ -0,0 +1,36 @@
+/* ff_lock_stats.h
+Contention counters for the FatFs re-entrancy mutexes (FF_FS_REENTRANT).
+
+ffsystem.c keeps one set per volume mutex, plus one for the system mutex
+FatFs takes together with a volume while it allocates file lock entries.
+Times are in microseconds. A take is "contended" when the mutex was not
+free on the first try. contended and the wait times cover successful takes
+only; a take that gives up is counted in timeouts alone.
+*/
+#pragma once
+
+#include <stdint.h>
+#include "ff.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint32_t takes;       // Successful takes
+    uint32_t contended;   // Successful takes that had to wait for another task
+    uint32_t timeouts;    // Takes that gave up after FF_FS_TIMEOUT (FR_TIMEOUT)
+    uint64_t wait_us;     // Total time spent waiting
+    uint32_t max_wait_us;
+    uint64_t hold_us;     // Total time the mutex was held
+    uint32_t max_hold_us;
+} ff_lock_stats_t;
+
+// vol: 0 to FF_VOLUMES - 1, or FF_VOLUMES for the system mutex.
+// Returns NULL if vol is out of range or FF_FS_REENTRANT is 0.
+const ff_lock_stats_t *ff_lock_stats(int vol);
+void ff_lock_stats_reset(int vol);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,66 @@
+/* sector_cache.h
+Write-back sector cache between the FatFs glue and the SD card driver.
+
+Single-sector writes (FAT, directory entries, partial data sectors) are held
+in an N-way set-associative cache and written back on CTRL_SYNC, on
+eviction, or once the oldest dirty sector is older than
+SECTOR_CACHE_FLUSH_MS. Adjacent dirty sectors go out together as one
+multi-block (CMD25) write. Multi-sector transfers bypass the cache but are
+kept coherent with it.
+*/
+#pragma once
+
+#include <stdint.h>
+#include "ff.h"
+
+#ifndef SECTOR_CACHE_ENABLED
+#define SECTOR_CACHE_ENABLED 1
+#endif
+// Number of physical drives, starting at pdrv 0, that get a cache
+#ifndef SECTOR_CACHE_DRIVES
+#define SECTOR_CACHE_DRIVES 1
+#endif
+// Sets: sector n maps to set n % SECTOR_CACHE_SETS. Also the longest run
+// that can be coalesced into one write. Must be a power of 2.
+#ifndef SECTOR_CACHE_SETS
+#define SECTOR_CACHE_SETS 8
+#endif
+// Ways (sectors per set)
+#ifndef SECTOR_CACHE_WAYS
+#define SECTOR_CACHE_WAYS 2
+#endif
+// Maximum age of a dirty sector, checked on each access and by
+// sector_cache_flush_expired(). 0 disables the timed flush.
+#ifndef SECTOR_CACHE_FLUSH_MS
+#define SECTOR_CACHE_FLUSH_MS 1000
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint32_t read_hits;
+    uint32_t read_misses;
+    uint32_t write_hits;      // Writes to a sector that was already cached
+    uint32_t write_misses;
+    uint32_t writebacks;      // Sectors written back to the card
+    uint32_t write_commands;  // Card writes issued for those write-backs
+} sector_cache_stats_t;
+
+// These return SD_BLOCK_DEVICE_ERROR_* codes
+int sector_cache_read(BYTE pdrv, uint8_t *buffer, uint64_t sector, uint32_t count);
+int sector_cache_write(BYTE pdrv, const uint8_t *buffer, uint64_t sector, uint32_t count);
+int sector_cache_flush(BYTE pdrv);
+// Call periodically (e.g. from a low-priority task) to bound the time
+// dirty sectors stay in RAM when the file system is idle.
+int sector_cache_flush_expired(BYTE pdrv);
+// Drop everything, including dirty sectors (e.g. the card was replaced)
+void sector_cache_invalidate(BYTE pdrv);
+// Drop the sectors start..end (inclusive), dirty or not (e.g. trimmed)
+void sector_cache_discard(BYTE pdrv, uint64_t start, uint64_t end);
+const sector_cache_stats_t *sector_cache_stats(BYTE pdrv);
+
+#ifdef __cplusplus
+}
+#endif
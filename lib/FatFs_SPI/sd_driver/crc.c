@@ -28,6 +28,9 @@ specific language governing permissions and limitations under the License.
  * limitations under the License.
  */
 
+#include <stdbool.h>
+#include <stdint.h>
+
 #include "crc.h"
 
 static const char m_Crc7Table[] = {0x00, 0x09, 0x12, 0x1B, 0x24, 0x2D, 0x36,
@@ -96,21 +99,90 @@ char crc7(const char* data, int length)
 	return crc;
 }
 
+#if SD_CRC16_IMPL == SD_CRC16_SLICE4
+#  define CRC16_UPDATE crc16_slice4
+#elif SD_CRC16_IMPL == SD_CRC16_SLICE8
+#  define CRC16_UPDATE crc16_slice8
+#elif SD_CRC16_IMPL == SD_CRC16_TABLELESS
+#  define CRC16_UPDATE crc16_tableless
+#else
+#  define CRC16_UPDATE crc16_table
+#endif
+
 unsigned short crc16(const char* data, int length)
 {
 	//Calculate the CRC16 checksum for the specified data block
-	unsigned short crc = 0;
-	for (int i = 0; i < length; i++) {
-		crc = (crc << 8) ^ m_Crc16Table[((crc >> 8) ^ data[i]) & 0x00FF];
-	}
+	return CRC16_UPDATE(0, data, (size_t)length);
+}
 
-	//Return the calculated checksum
+void update_crc16(unsigned short *pCrc16, const char data[], size_t length) {
+	*pCrc16 = CRC16_UPDATE(*pCrc16, data, length);
+}
+
+unsigned short crc16_table(unsigned short crc, const void *data, size_t length)
+{
+	const uint8_t *p = data;
+	while (length--) {
+		crc = (crc << 8) ^ m_Crc16Table[((crc >> 8) ^ *p++) & 0x00FF];
+	}
 	return crc;
 }
 
-void update_crc16(unsigned short *pCrc16, const char data[], size_t length) {
-	for (size_t i = 0; i < length; i++) {
-		*pCrc16 = (*pCrc16 << 8) ^ m_Crc16Table[((*pCrc16 >> 8) ^ data[i]) & 0x00FF];
-	}    
+// crc16_slices[k][n]: CRC of byte n followed by k zero bytes
+static uint16_t crc16_slices[8][256];
+static volatile bool crc16_slices_ready;
+
+static void crc16_init_slices(void)
+{
+	for (int n = 0; n < 256; n++) {
+		crc16_slices[0][n] = m_Crc16Table[n];
+	}
+	for (int k = 1; k < 8; k++) {
+		for (int n = 0; n < 256; n++) {
+			uint16_t c = crc16_slices[k - 1][n];
+			crc16_slices[k][n] = (uint16_t)(c << 8) ^ m_Crc16Table[c >> 8];
+		}
+	}
+	crc16_slices_ready = true;
+}
+
+unsigned short crc16_slice4(unsigned short crc, const void *data, size_t length)
+{
+	const uint8_t *p = data;
+	if (!crc16_slices_ready) crc16_init_slices();
+	const uint16_t (*t)[256] = crc16_slices;
+	// The running CRC only overlaps the first two bytes of each group
+	while (length >= 4) {
+		crc = t[3][(crc >> 8) ^ p[0]] ^ t[2][(crc & 0xFF) ^ p[1]] ^ t[1][p[2]] ^ t[0][p[3]];
+		p += 4;
+		length -= 4;
+	}
+	return crc16_table(crc, p, length);
+}
+
+unsigned short crc16_slice8(unsigned short crc, const void *data, size_t length)
+{
+	const uint8_t *p = data;
+	if (!crc16_slices_ready) crc16_init_slices();
+	const uint16_t (*t)[256] = crc16_slices;
+	while (length >= 8) {
+		crc = t[7][(crc >> 8) ^ p[0]] ^ t[6][(crc & 0xFF) ^ p[1]] ^ t[5][p[2]] ^ t[4][p[3]] ^
+		      t[3][p[4]] ^ t[2][p[5]] ^ t[1][p[6]] ^ t[0][p[7]];
+		p += 8;
+		length -= 8;
+	}
+	return crc16_table(crc, p, length);
+}
+
+unsigned short crc16_tableless(unsigned short crc, const void *data, size_t length)
+{
+	const uint8_t *p = data;
+	while (length--) {
+		// x^16 + x^12 + x^5 + 1 applied to the top byte in one step
+		uint16_t x = ((crc >> 8) ^ *p++) & 0xFF;
+		x ^= x >> 4;
+		crc = (crc << 8) ^ (x << 12) ^ (x << 5) ^ x;
+	}
+	return crc;
 }
 /* [] END OF FILE */
@@ -32,11 +32,33 @@ specific language governing permissions and limitations under the License.
 #define SD_CRC_H
 
 #include <stddef.h>
-    
+
+/* CRC16-CCITT implementations (polynomial 0x1021, MSB first, as used for SD
+ * data blocks). All of them are built; SD_CRC16_IMPL picks the one behind
+ * crc16() and update_crc16():
+ *   SD_CRC16_TABLE      one byte per step, 256-entry table in flash (512 B)
+ *   SD_CRC16_SLICE4     four bytes per step, tables in RAM (2 KiB)
+ *   SD_CRC16_SLICE8     eight bytes per step, tables in RAM (4 KiB)
+ *   SD_CRC16_TABLELESS  one byte per step, shifts and XORs only
+ * The slice tables are derived from the flash table on first use.
+ */
+#define SD_CRC16_TABLE 0
+#define SD_CRC16_SLICE4 1
+#define SD_CRC16_SLICE8 2
+#define SD_CRC16_TABLELESS 3
+#ifndef SD_CRC16_IMPL
+#define SD_CRC16_IMPL SD_CRC16_SLICE8
+#endif
+
 char crc7(const char* data, int length);
 unsigned short crc16(const char* data, int length);
 void update_crc16(unsigned short *pCrc16, const char data[], size_t length);
 
+unsigned short crc16_table(unsigned short crc, const void *data, size_t length);
+unsigned short crc16_slice4(unsigned short crc, const void *data, size_t length);
+unsigned short crc16_slice8(unsigned short crc, const void *data, size_t length);
+unsigned short crc16_tableless(unsigned short crc, const void *data, size_t length);
+
 #endif
 
 /* [] END OF FILE */
@@ -35,9 +35,10 @@ static spi_t spis[] = {  // One for each SPI.
         .mosi_gpio = 19,
         .sck_gpio = 18,
 
-        // .baud_rate = 1000 * 1000
-        .baud_rate = 1000 * 1000
-        // .baud_rate = 25 * 1000 * 1000 // Actual frequency: 20833333.
+        // Upper limit for the clock: sd_init settles on the fastest rate
+        // at which the card passes test reads (see SD_CLOCK_TUNING).
+        // Above 25 MHz the card is switched to High Speed, if it can.
+        .baud_rate = 50 * 1000 * 1000  // Actual frequency: 31250000.
     }};
 
 // Hardware Configuration of the SD Card "objects"
@@ -179,8 +179,18 @@ specific language governing permissions and limitations under the License.
 #define SD_CRC_ENABLED 1
 #endif
 
-#if SD_CRC_ENABLED
+// Overlap the DMA of each CMD18 block with the CRC check of the previous one
+#ifndef SD_READ_PIPELINE
+#define SD_READ_PIPELINE 1
+#endif
+
+// Probe for the fastest SPI clock the card passes test reads at (sd_init)
+#ifndef SD_CLOCK_TUNING
+#define SD_CLOCK_TUNING 1
+#endif
+
 #include "crc.h"
+#if SD_CRC_ENABLED
 static bool crc_on = true;
 #endif
 
@@ -809,6 +819,41 @@ static int sd_read_bytes(sd_card_t *pSD, uint8_t *buffer, uint32_t length) {
 
     return 0;
 }
+// Data block CRC16s come from the DMA sniffer instead of the CPU
+static bool sd_dma_crc(sd_card_t *pSD) {
+#if SD_CRC_ENABLED
+    return crc_on && pSD->spi->dma_crc;
+#else
+    (void)pSD;
+    return false;
+#endif
+}
+
+// Verify the CRC16 received after a data block. sniffed is the CRC the DMA
+// sniffer computed while the block streamed in, or NULL to compute it here.
+static int sd_check_block_crc(const uint8_t *buffer, uint32_t length, uint16_t crc,
+                              const uint16_t *sniffed) {
+#if SD_CRC_ENABLED
+    if (crc_on) {
+        uint32_t crc_result;
+        // Compute and verify checksum
+        crc_result = sniffed ? *sniffed : crc16((void *)buffer, length);
+        if ((uint16_t)crc_result != crc) {
+            DBG_PRINTF("%s: Invalid CRC received 0x%" PRIx16
+                       " result of computation 0x%" PRIx16 "\r\n",
+                       __FUNCTION__, crc, (uint16_t)crc_result);
+            return SD_BLOCK_DEVICE_ERROR_CRC;
+        }
+    }
+#else
+    (void)buffer;
+    (void)length;
+    (void)crc;
+    (void)sniffed;
+#endif
+    return SD_BLOCK_DEVICE_ERROR_NONE;
+}
+
 static int sd_read_block(sd_card_t *pSD, uint8_t *buffer, uint32_t length) {
     uint16_t crc;
 
@@ -819,29 +864,92 @@ static int sd_read_block(sd_card_t *pSD, uint8_t *buffer, uint32_t length) {
     }
     // read data
     // bool spi_transfer(const uint8_t *tx, uint8_t *rx, size_t length)
-    if (!sd_spi_transfer(pSD, NULL, buffer, length)) {
+    uint16_t sniffed;
+    bool dma_crc = sd_dma_crc(pSD);
+    bool ok = dma_crc ? sd_spi_transfer_crc(pSD, NULL, buffer, length, &sniffed)
+                      : sd_spi_transfer(pSD, NULL, buffer, length);
+    if (!ok) {
         return SD_BLOCK_DEVICE_ERROR_NO_RESPONSE;
     }
     // Read the CRC16 checksum for the data block
     crc = (sd_spi_write(pSD, SPI_FILL_CHAR) << 8);
     crc |= sd_spi_write(pSD, SPI_FILL_CHAR);
 
-#if SD_CRC_ENABLED
-    if (crc_on) {
-        uint32_t crc_result;
-        // Compute and verify checksum
-        crc_result = crc16((void *)buffer, length);
-        if ((uint16_t)crc_result != crc) {
-            DBG_PRINTF("%s: Invalid CRC received 0x%" PRIx16
-                       " result of computation 0x%" PRIx16 "\r\n",
-                       __FUNCTION__, crc, (uint16_t)crc_result);
-            return SD_BLOCK_DEVICE_ERROR_CRC;
+    return sd_check_block_crc(buffer, length, crc, dma_crc ? &sniffed : NULL);
+}
+
+#if SD_READ_PIPELINE
+/* Trailer clocked in after each block of a pipelined read:
+ * +-----------+----------+-----------+
+ * | crc[15:8] | crc[7:0] | lookahead |
+ * +-----------+----------+-----------+
+ * The lookahead byte is usually the start token of the next block, in which
+ * case there is nothing left to poll for. */
+#define SD_READ_TRAILER_SIZE 3
+
+/* Receive the blocks of a CMD18 transfer.
+ *
+ * Each block is fetched with a single DMA transfer: the data goes straight
+ * into the caller's buffer and a chained channel stores the trailer, so there
+ * is one interrupt per block instead of one for the data plus two more for
+ * the CRC bytes. While block n is on the wire the CPU verifies the CRC of
+ * block n-1.
+ */
+static int sd_read_blocks_pipelined(sd_card_t *pSD, uint8_t *buffer, uint32_t blockCnt) {
+    uint8_t trailers[2][SD_READ_TRAILER_SIZE];
+    uint16_t sniffed[2];  // With dma_crc: CRC computed while each block streamed
+    bool dma_crc = sd_dma_crc(pSD);
+    bool have_token = false;
+    int status = SD_BLOCK_DEVICE_ERROR_NONE;
+    uint32_t i;
+
+    for (i = 0; i < blockCnt; ++i) {
+        uint8_t *trailer = trailers[i & 1];
+        uint8_t *block = buffer + i * _block_size;
+
+        // read until start byte (0xFE), unless the lookahead already got it
+        if (!have_token && false == sd_wait_token(pSD, SPI_START_BLOCK)) {
+            DBG_PRINTF("%s:%d Read timeout\r\n", __FILE__, __LINE__);
+            status = SD_BLOCK_DEVICE_ERROR_NO_RESPONSE;
+            break;
+        }
+        sd_spi_transfer_start(pSD, block, _block_size, trailer, SD_READ_TRAILER_SIZE, dma_crc);
+
+        // Check the previous block while this one is being received
+        if (i > 0) {
+            const uint8_t *prev = trailers[(i - 1) & 1];
+            status = sd_check_block_crc(block - _block_size, _block_size,
+                                        (prev[0] << 8) | prev[1],
+                                        dma_crc ? &sniffed[(i - 1) & 1] : NULL);
+        }
+        if (!sd_spi_transfer_wait_complete(pSD)) {
+            status = SD_BLOCK_DEVICE_ERROR_NO_RESPONSE;
+            break;
+        }
+        if (dma_crc) sniffed[i & 1] = sd_spi_sniffed_crc(pSD);
+        if (SD_BLOCK_DEVICE_ERROR_NONE != status) break;
+
+        // What follows the last block is of no interest (CMD12 comes next)
+        if (i + 1 < blockCnt) {
+            have_token = (SPI_START_BLOCK == trailer[2]);
+            if (!(trailer[2] & ~SPI_DATA_READ_ERROR_MASK)) {
+                // Data Error Token instead of the next block
+                DBG_PRINTF("%s: Data error token 0x%02x\r\n", __FUNCTION__, trailer[2]);
+                status = SD_BLOCK_DEVICE_ERROR_NO_RESPONSE;
+                break;
+            }
         }
     }
-#endif
-
-    return SD_BLOCK_DEVICE_ERROR_NONE;
+    // The last block received still has to be checked
+    if (i == blockCnt && SD_BLOCK_DEVICE_ERROR_NONE == status && blockCnt) {
+        const uint8_t *last = trailers[(blockCnt - 1) & 1];
+        status = sd_check_block_crc(buffer + (blockCnt - 1) * _block_size, _block_size,
+                                    (last[0] << 8) | last[1],
+                                    dma_crc ? &sniffed[(blockCnt - 1) & 1] : NULL);
+    }
+    return status;
 }
+#endif
 
 static int in_sd_read_blocks(sd_card_t *pSD, uint8_t *buffer,
                              uint64_t ulSectorNumber, uint32_t ulSectorCount) {
@@ -871,8 +979,14 @@ static int in_sd_read_blocks(sd_card_t *pSD, uint8_t *buffer,
     if (SD_BLOCK_DEVICE_ERROR_NONE != status) {
         return status;
     }
-    // receive the data : one block at a time
     int rd_status = 0;
+#if SD_READ_PIPELINE
+    if (blockCnt > 1) {
+        rd_status = sd_read_blocks_pipelined(pSD, buffer, blockCnt);
+        blockCnt = 0;
+    }
+#endif
+    // receive the data : one block at a time
     while (blockCnt) {
         if (0 != sd_read_block(pSD, buffer, _block_size)) {
             rd_status = SD_BLOCK_DEVICE_ERROR_NO_RESPONSE;
@@ -906,16 +1020,20 @@ static uint8_t sd_write_block(sd_card_t *pSD, const uint8_t *buffer,
     // indicate start of block
     sd_spi_write(pSD, token);
 
-    // write the data
-    bool ret = sd_spi_transfer(pSD, buffer, NULL, length);
-    myASSERT(ret);
-
+    // write the data; with dma_crc the sniffer computes the CRC on the way out
+    bool ret;
+    if (sd_dma_crc(pSD)) {
+        ret = sd_spi_transfer_crc(pSD, buffer, NULL, length, &crc);
+    } else {
+        ret = sd_spi_transfer(pSD, buffer, NULL, length);
 #if SD_CRC_ENABLED
-    if (crc_on) {
-        // Compute CRC
-        crc = crc16((void *)buffer, length);
-    }
+        if (crc_on) {
+            // Compute CRC
+            crc = crc16((void *)buffer, length);
+        }
 #endif
+    }
+    myASSERT(ret);
 
     // write the checksum CRC16
     sd_spi_write(pSD, crc >> 8);
@@ -1024,6 +1142,247 @@ int sd_write_blocks(sd_card_t *pSD, const uint8_t *buffer,
     return status;
 }
 
+#ifndef SD_PARALLEL_MAX
+#define SD_PARALLEL_MAX 4 /*!< Cards in one parallel transfer */
+#endif
+
+// Block address for a command: SDSC cards (CCS=0) use bytes
+static uint64_t sd_block_addr(sd_card_t *pSD, uint64_t sector) {
+    return SDCARD_V2HC == pSD->card_type ? sector : sector * _block_size;
+}
+
+static int sd_parallel_check(const sd_parallel_run_t *runs, size_t n) {
+    if (n > SD_PARALLEL_MAX) return SD_BLOCK_DEVICE_ERROR_PARAMETER;
+    for (size_t i = 0; i < n; ++i) {
+        sd_card_t *pSD = runs[i].card;
+        if (!runs[i].count) continue;
+        if (!pSD->spi || runs[i].sector + runs[i].count > pSD->sectors)
+            return SD_BLOCK_DEVICE_ERROR_PARAMETER;
+        if (pSD->m_Status & (STA_NOINIT | STA_NODISK))
+            return SD_BLOCK_DEVICE_ERROR_PARAMETER;
+        for (size_t j = 0; j < i; ++j)
+            if (runs[j].count && runs[j].card->spi == pSD->spi)
+                return SD_BLOCK_DEVICE_ERROR_PARAMETER;  // Shared bus: nothing to overlap
+    }
+    return SD_BLOCK_DEVICE_ERROR_NONE;
+}
+
+int sd_write_blocks_parallel(const sd_parallel_run_t *runs, size_t n, sd_block_buffer_fn_t buffer,
+                             void *ctx) {
+    int status = sd_parallel_check(runs, n);
+    if (status) return status;
+    int card_status[SD_PARALLEL_MAX] = {0};
+    uint32_t rounds = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (!runs[i].count) continue;
+        sd_acquire(runs[i].card);
+        if (runs[i].count > rounds) rounds = runs[i].count;
+    }
+    // Start a multiple block write on every card
+    for (size_t i = 0; i < n; ++i) {
+        sd_card_t *pSD = runs[i].card;
+        if (!runs[i].count) continue;
+        sd_cmd(pSD, ACMD23_SET_WR_BLK_ERASE_COUNT, runs[i].count, 1, 0);
+        sd_spi_deselect_pulse(pSD);
+        card_status[i] = sd_cmd(pSD, CMD25_WRITE_MULTIPLE_BLOCK, sd_block_addr(pSD, runs[i].sector),
+                                false, 0);
+    }
+    for (uint32_t b = 0; b < rounds; ++b) {
+        uint16_t crc[SD_PARALLEL_MAX];
+        bool started[SD_PARALLEL_MAX] = {false};
+        // Send block b to every card that is ready for it...
+        for (size_t i = 0; i < n; ++i) {
+            sd_card_t *pSD = runs[i].card;
+            if (b >= runs[i].count || card_status[i]) continue;
+            if (b && !sd_wait_ready(pSD, SD_COMMAND_TIMEOUT)) {
+                card_status[i] = SD_BLOCK_DEVICE_ERROR_NO_RESPONSE;
+                continue;
+            }
+            sd_spi_write(pSD, SPI_START_BLK_MUL_WRITE);
+            started[i] = sd_spi_write_start(pSD, buffer(ctx, i, b), _block_size);
+            if (!started[i]) card_status[i] = SD_BLOCK_DEVICE_ERROR_WRITE;
+        }
+        // ...compute the CRCs while the blocks are on the wire...
+        for (size_t i = 0; i < n; ++i) {
+            crc[i] = 0xFFFF;
+#if SD_CRC_ENABLED
+            if (started[i] && crc_on) crc[i] = crc16((void *)buffer(ctx, i, b), _block_size);
+#endif
+        }
+        // ...and collect the data response tokens
+        for (size_t i = 0; i < n; ++i) {
+            sd_card_t *pSD = runs[i].card;
+            if (!started[i]) continue;
+            if (!sd_spi_transfer_wait_complete(pSD)) {
+                card_status[i] = SD_BLOCK_DEVICE_ERROR_WRITE;
+                continue;
+            }
+            sd_spi_write(pSD, crc[i] >> 8);
+            sd_spi_write(pSD, crc[i]);
+            uint8_t response = sd_spi_write(pSD, SPI_FILL_CHAR) & SPI_DATA_RESPONSE_MASK;
+            if (response != SPI_DATA_ACCEPTED) {
+                DBG_PRINTF("%s: card %zu block %lu failed: 0x%x\r\n", __FUNCTION__, i, (unsigned long)b,
+                           response);
+                card_status[i] = SD_BLOCK_DEVICE_ERROR_WRITE;
+            }
+        }
+    }
+    // Finish: each card programs its last block while the others are stopped
+    for (size_t i = 0; i < n; ++i) {
+        sd_card_t *pSD = runs[i].card;
+        if (!runs[i].count) continue;
+        if (!sd_wait_ready(pSD, SD_COMMAND_TIMEOUT) && !card_status[i])
+            card_status[i] = SD_BLOCK_DEVICE_ERROR_NO_RESPONSE;
+        sd_spi_write(pSD, SPI_STOP_TRAN);
+        sd_spi_deselect_pulse(pSD);
+        uint32_t stat = 0;
+        int rc = sd_cmd(pSD, CMD13_SEND_STATUS, 0, false, &stat);
+        if (!card_status[i]) card_status[i] = rc;
+        sd_release(pSD);
+        if (!status) status = card_status[i];
+    }
+    return status;
+}
+
+int sd_read_blocks_parallel(const sd_parallel_run_t *runs, size_t n, sd_block_buffer_fn_t buffer,
+                            void *ctx) {
+    int status = sd_parallel_check(runs, n);
+    if (status) return status;
+    int card_status[SD_PARALLEL_MAX] = {0};
+    uint32_t rounds = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (!runs[i].count) continue;
+        sd_acquire(runs[i].card);
+        if (runs[i].count > rounds) rounds = runs[i].count;
+        card_status[i] = sd_cmd(runs[i].card, CMD18_READ_MULTIPLE_BLOCK,
+                                sd_block_addr(runs[i].card, runs[i].sector), false, 0);
+    }
+    for (uint32_t b = 0; b < rounds; ++b) {
+        uint8_t crc[SD_PARALLEL_MAX][2];
+        bool started[SD_PARALLEL_MAX] = {false};
+        // Wait for each card's start token and let the DMA take the block
+        // while polling the next card
+        for (size_t i = 0; i < n; ++i) {
+            sd_card_t *pSD = runs[i].card;
+            if (b >= runs[i].count || card_status[i]) continue;
+            if (!sd_wait_token(pSD, SPI_START_BLOCK)) {
+                card_status[i] = SD_BLOCK_DEVICE_ERROR_NO_RESPONSE;
+                continue;
+            }
+            started[i] = sd_spi_transfer_start(pSD, buffer(ctx, i, b), _block_size, crc[i], 2, false);
+            if (!started[i]) card_status[i] = SD_BLOCK_DEVICE_ERROR_NO_RESPONSE;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            if (!started[i]) continue;
+            if (!sd_spi_transfer_wait_complete(runs[i].card)) {
+                card_status[i] = SD_BLOCK_DEVICE_ERROR_NO_RESPONSE;
+                continue;
+            }
+            card_status[i] = sd_check_block_crc(buffer(ctx, i, b), _block_size,
+                                                (crc[i][0] << 8) | crc[i][1], NULL);
+        }
+    }
+    for (size_t i = 0; i < n; ++i) {
+        sd_card_t *pSD = runs[i].card;
+        if (!runs[i].count) continue;
+        int rc = sd_cmd(pSD, CMD12_STOP_TRANSMISSION, 0x0, false, 0);
+        if (!card_status[i]) card_status[i] = rc;
+        sd_release(pSD);
+        if (!status) status = card_status[i];
+    }
+    return status;
+}
+
+/* SD Status register (ACMD13): 512 bits, sent MSB first
+ *   AU_SIZE       [431:428]
+ *   ERASE_SIZE    [423:408]  Number of AUs erased within ERASE_TIMEOUT
+ *   ERASE_TIMEOUT [407:402]  Seconds
+ *   ERASE_OFFSET  [401:400]  Seconds
+ */
+#define SD_STATUS_SIZE 64
+
+static void sd_read_sd_status(sd_card_t *pSD) {
+    uint8_t status[SD_STATUS_SIZE];
+    uint32_t response;
+
+    pSD->au_sectors = 1;  // Unknown
+    pSD->erase_ms_per_au = 250;
+    pSD->erase_offset_ms = 0;
+    // ACMD13, Response R2 (R1 byte + status byte) followed by a data block
+    if (SD_BLOCK_DEVICE_ERROR_NONE != sd_cmd(pSD, ACMD13_SD_STATUS, 0, true, &response) ||
+        sd_read_bytes(pSD, status, sizeof status) != 0) {
+        DBG_PRINTF("Couldn't read SD Status\r\n");
+        return;
+    }
+    uint32_t au_size = status[10] >> 4;
+    if (au_size) {
+        // 1..9: 16 KiB << (AU_SIZE - 1); A..F: 8, 12, 16, 24, 32, 64 MiB
+        static const uint32_t large_au_mib[] = {8, 12, 16, 24, 32, 64};
+        uint64_t bytes = au_size <= 9 ? (16 * 1024ULL) << (au_size - 1)
+                                      : large_au_mib[au_size - 10] * 1024ULL * 1024;
+        uint64_t sectors = bytes / _block_size;
+        // FatFs wants a power of 2 between 1 and 32768
+        uint32_t pow2 = 1;
+        while (pow2 * 2 <= sectors && pow2 < 32768) pow2 *= 2;
+        pSD->au_sectors = pow2;
+    }
+    uint32_t erase_size = (status[11] << 8) | status[12];
+    uint32_t erase_timeout = status[13] >> 2;
+    if (erase_size && erase_timeout) {
+        pSD->erase_ms_per_au = erase_timeout * 1000 / erase_size;
+        pSD->erase_offset_ms = (status[13] & 0x3) * 1000;
+    }
+    DBG_PRINTF("AU: %" PRIu32 " sectors, erase: %" PRIu32 " ms/AU + %" PRIu32 " ms\r\n",
+               pSD->au_sectors, pSD->erase_ms_per_au, pSD->erase_offset_ms);
+}
+
+/** Erase blocks (CMD32, CMD33, CMD38)
+ *
+ *  @param start        First block to erase (LBA)
+ *  @param end          Last block to erase (LBA), inclusive
+ *  @return         SD_BLOCK_DEVICE_ERROR_NONE(0) - success
+ *                  SD_BLOCK_DEVICE_ERROR_PARAMETER - invalid parameter
+ *                  SD_BLOCK_DEVICE_ERROR_ERASE - erase error or timeout
+ */
+static int in_sd_trim(sd_card_t *pSD, uint64_t start, uint64_t end) {
+    if (end < start || end >= pSD->sectors)
+        return SD_BLOCK_DEVICE_ERROR_PARAMETER;
+    if (pSD->m_Status & (STA_NOINIT | STA_NODISK))
+        return SD_BLOCK_DEVICE_ERROR_PARAMETER;
+
+    uint64_t start_addr = start, end_addr = end;
+    // SDSC Card (CCS=0) uses byte unit address
+    if (SDCARD_V2HC != pSD->card_type) {
+        start_addr *= _block_size;
+        end_addr *= _block_size;
+    }
+    int status = sd_cmd(pSD, CMD32_ERASE_WR_BLK_START_ADDR, start_addr, false, 0);
+    if (SD_BLOCK_DEVICE_ERROR_NONE != status) return status;
+    status = sd_cmd(pSD, CMD33_ERASE_WR_BLK_END_ADDR, end_addr, false, 0);
+    if (SD_BLOCK_DEVICE_ERROR_NONE != status) return status;
+    status = sd_cmd(pSD, CMD38_ERASE, 0, false, 0);
+    if (SD_BLOCK_DEVICE_ERROR_NONE != status) return status;
+
+    // sd_cmd only waits SD_COMMAND_TIMEOUT for the busy signal; a large
+    // erase is allowed to take as long as the SD Status says.
+    uint64_t aus = (end - start) / pSD->au_sectors + 1;
+    uint64_t timeout = aus * pSD->erase_ms_per_au + pSD->erase_offset_ms;
+    if (timeout > INT32_MAX) timeout = INT32_MAX;
+    if (false == sd_wait_ready(pSD, (int)timeout)) {
+        DBG_PRINTF("%s: erase timed out\r\n", __FUNCTION__);
+        return SD_BLOCK_DEVICE_ERROR_ERASE;
+    }
+    return SD_BLOCK_DEVICE_ERROR_NONE;
+}
+
+static int sd_trim(sd_card_t *pSD, uint64_t start, uint64_t end) {
+    sd_acquire(pSD);
+    TRACE_PRINTF("sd_trim(0x%llx, 0x%llx)\r\n", start, end);
+    int status = in_sd_trim(pSD, start, end);
+    sd_release(pSD);
+    return status;
+}
+
 static int sd_init_medium(sd_card_t *pSD) {
     int32_t status = SD_BLOCK_DEVICE_ERROR_NONE;
     uint32_t response, arg;
@@ -1137,6 +1496,7 @@ static void sd_ctor(sd_card_t *pSD) {
     pSD->init = sd_init;
     pSD->write_blocks = sd_write_blocks;
     pSD->read_blocks = sd_read_blocks;
+    pSD->trim = sd_trim;
     pSD->sd_test_com = sd_test_com;
 }
 bool sd_init_driver() {
@@ -1146,6 +1506,9 @@ bool sd_init_driver() {
     if (!initialized) {
         for (size_t i = 0; i < sd_get_num(); ++i) {
             sd_card_t *pSD = sd_get_by_num(i);
+            // Methods preset in hw_config belong to another block device
+            // implementation (e.g. a disk image); it has no SPI or GPIOs.
+            if (pSD->init) continue;
 
             sd_ctor(pSD);
 
@@ -1176,6 +1539,107 @@ bool sd_init_driver() {
     mutex_exit(&sd_init_driver_mutex);
     return true;
 }
+#define SD_DEFAULT_SPEED_HZ (25 * 1000 * 1000)
+#define SD_HIGH_SPEED_HZ (50 * 1000 * 1000)
+#if SD_CLOCK_TUNING
+#define SD_TUNE_FIRST_HZ (1000 * 1000) /*!< First clock probed above the init clock */
+#define SD_TUNE_BLOCKS 4               /*!< Test reads per pass, spread over the card */
+#define SD_TUNE_CONFIRM_PASSES 8       /*!< Passes the chosen clock has to survive */
+
+/* Switch function status (CMD6): 512 bits, sent MSB first
+ *   Function group 1 support    [415:400]
+ *   Function group 1 selection  [379:376]
+ */
+#define SD_SWITCH_STATUS_SIZE 64
+
+// Switch to High Speed (function 1 of group 1, access mode) if the card has it
+static bool sd_switch_high_speed(sd_card_t *pSD) {
+    uint8_t status[SD_SWITCH_STATUS_SIZE];
+    // Mode 0 only checks; 0xF leaves the other groups as they are
+    if (SD_BLOCK_DEVICE_ERROR_NONE != sd_cmd(pSD, CMD6_SWITCH_FUNC, 0x00FFFFF1, false, 0) ||
+        sd_read_bytes(pSD, status, sizeof status))
+        return false;  // Version 1.0 card: no CMD6
+    if (!(status[13] & 0x02) || 0x1 != (status[16] & 0xF)) return false;
+    // Mode 1 switches
+    if (SD_BLOCK_DEVICE_ERROR_NONE != sd_cmd(pSD, CMD6_SWITCH_FUNC, 0x80FFFFF1, false, 0) ||
+        sd_read_bytes(pSD, status, sizeof status))
+        return false;
+    // The new timing applies 8 clocks after the status block
+    sd_spi_write(pSD, SPI_FILL_CHAR);
+    return 0x1 == (status[16] & 0xF);
+}
+
+// Read the test blocks. With record, store their checksums in sums;
+// otherwise fail on any error or checksum that differs from sums.
+static bool sd_tune_read(sd_card_t *pSD, uint16_t sums[], bool record) {
+    uint8_t block[BLOCK_SIZE_HC];
+    for (size_t i = 0; i < SD_TUNE_BLOCKS; ++i) {
+        uint64_t sector = pSD->sectors / SD_TUNE_BLOCKS * i;
+        int status = sd_cmd(pSD, CMD17_READ_SINGLE_BLOCK, sd_block_addr(pSD, sector), false, 0);
+        if (SD_BLOCK_DEVICE_ERROR_NONE == status) status = sd_read_block(pSD, block, _block_size);
+        // Compared even without CRC checking on the bus
+        uint16_t sum = crc16((const char *)block, _block_size);
+        if (SD_BLOCK_DEVICE_ERROR_NONE != status || (!record && sum != sums[i])) return false;
+        if (record) sums[i] = sum;
+    }
+    return true;
+}
+
+static bool sd_tune_try(sd_card_t *pSD, uint16_t sums[], int passes) {
+    bool ok = true;
+    for (int pass = 0; ok && pass < passes; ++pass) ok = sd_tune_read(pSD, sums, false);
+    if (!ok) ++pSD->tune_errors;
+    return ok;
+}
+
+/* Find the fastest clock, up to both the SPI's baud_rate and the card's
+ * limit, at which the test reads come back intact: double the clock from
+ * SD_TUNE_FIRST_HZ until a read fails, then back off one divisor at a time.
+ * The clock kept must also pass SD_TUNE_CONFIRM_PASSES.
+ *
+ * Called at the init clock, which serves as the reference. Returns the
+ * clock, or 0 if the test reads fail even at the init clock. */
+static uint sd_tune_clock(sd_card_t *pSD) {
+    uint16_t sums[SD_TUNE_BLOCKS];
+    const uint init_hz = spi_get_baudrate(pSD->spi->hw_inst);
+    if (!sd_tune_read(pSD, sums, true)) {
+        ++pSD->tune_errors;
+        return 0;
+    }
+    uint ceiling = pSD->high_speed ? SD_HIGH_SPEED_HZ : SD_DEFAULT_SPEED_HZ;
+    if (pSD->spi->baud_rate < ceiling) ceiling = pSD->spi->baud_rate;
+
+    uint good = init_hz, fail = 0;
+    for (uint hz = SD_TUNE_FIRST_HZ; !fail; hz *= 2) {
+        if (hz > ceiling) hz = ceiling;
+        uint actual = sd_spi_set_frequency(pSD, hz);
+        if (actual > good) {
+            if (sd_tune_try(pSD, sums, 1))
+                good = actual;
+            else
+                fail = actual;
+        }
+        if (hz == ceiling) break;
+    }
+    while (fail) {
+        uint actual = sd_spi_set_frequency_below(pSD, fail);
+        if (actual <= good) break;
+        if (sd_tune_try(pSD, sums, 1)) {
+            good = actual;
+            break;
+        }
+        fail = actual;
+    }
+    for (;;) {
+        sd_spi_set_frequency(pSD, good);
+        if (good <= init_hz || sd_tune_try(pSD, sums, SD_TUNE_CONFIRM_PASSES)) break;
+        good = sd_spi_set_frequency_below(pSD, good);
+        if (good < init_hz) good = init_hz;
+    }
+    return good;
+}
+#endif
+
 static int sd_init(sd_card_t *pSD) {
     TRACE_PRINTF("> %s\r\n", __FUNCTION__);
 
@@ -1199,6 +1663,9 @@ static int sd_init(sd_card_t *pSD) {
     }
     // Initialize the member variables
     pSD->card_type = SDCARD_NONE;
+    pSD->high_speed = false;
+    pSD->baud_rate = 0;
+    pSD->tune_errors = 0;
 
     sd_spi_acquire(pSD);
 
@@ -1224,6 +1691,27 @@ static int sd_init(sd_card_t *pSD) {
         sd_unlock(pSD);
         return pSD->m_Status;
     }
+    // Erase unit and timeouts, for GET_BLOCK_SIZE and trim
+    sd_read_sd_status(pSD);
+
+#if SD_CLOCK_TUNING
+    // High Speed raises the card's limit from 25 to 50 MHz
+    if (pSD->spi->baud_rate > SD_DEFAULT_SPEED_HZ) pSD->high_speed = sd_switch_high_speed(pSD);
+    pSD->baud_rate = sd_tune_clock(pSD);
+    DBG_PRINTF("SPI clock: %u Hz%s, %" PRIu32 " test reads failed\r\n", pSD->baud_rate,
+               pSD->high_speed ? " (High Speed)" : "", pSD->tune_errors);
+    if (!pSD->baud_rate) {
+        // Not even the init clock reads back: the card is not usable
+        DBG_PRINTF("Test reads failed at the init clock\r\n");
+        sd_spi_release(pSD);
+        sd_unlock(pSD);
+        return pSD->m_Status;
+    }
+#else
+    // Without tuning the card stays in Default Speed: no faster than 25 MHz
+    pSD->baud_rate = sd_spi_set_frequency(
+        pSD, pSD->spi->baud_rate < SD_DEFAULT_SPEED_HZ ? pSD->spi->baud_rate : SD_DEFAULT_SPEED_HZ);
+#endif
     // Set SCK for data transfer
     sd_spi_go_high_frequency(pSD);
 
@@ -51,6 +51,12 @@ struct sd_card_t {
     int m_Status;                                    // Card status
     uint64_t sectors;                                // Assigned dynamically
     int card_type;                                   // Assigned dynamically
+    uint32_t au_sectors;       // Allocation (erase) unit size; 1 if unknown. From SD Status (ACMD13)
+    uint32_t erase_ms_per_au;  // Erase timeout per AU, from SD Status
+    uint32_t erase_offset_ms;  // Erase timeout offset, from SD Status
+    bool high_speed;           // Switched to High Speed (CMD6): up to 50 MHz
+    uint baud_rate;            // SPI clock settled on by sd_init; 0 until initialized
+    uint32_t tune_errors;      // Test reads that failed while tuning the clock
     mutex_t mutex;
     FATFS fatfs;
     bool mounted;
@@ -60,10 +66,15 @@ struct sd_card_t {
                     uint64_t ulSectorNumber, uint32_t blockCnt);
     int (*read_blocks)(sd_card_t *sd_card_p, uint8_t *buffer, uint64_t ulSectorNumber,
                     uint32_t ulSectorCount);
+    // Erase sectors start..end (inclusive); their contents become undefined
+    int (*trim)(sd_card_t *sd_card_p, uint64_t start, uint64_t end);
 
     // Useful when use_card_detect is false - call periodically to check for presence of SD card
     // Returns true if and only if SD card was sensed on the bus
     bool (*sd_test_com)(sd_card_t *sd_card_p);
+
+    // State of a non-SPI implementation whose methods are preset in hw_config
+    void *device;
 };
 
 #define SD_BLOCK_DEVICE_ERROR_NONE 0
@@ -90,6 +101,24 @@ struct sd_card_t {
 bool sd_card_detect(sd_card_t *pSD);
 uint64_t sd_sectors(sd_card_t *pSD);
 
+// One run of consecutive blocks on one card, for the parallel transfers
+typedef struct {
+    sd_card_t *card;
+    uint64_t sector;  // First block on the card
+    uint32_t count;   // Number of blocks (0: card not involved)
+} sd_parallel_run_t;
+// Where block `block` of runs[run] lives in the caller's memory
+typedef uint8_t *(*sd_block_buffer_fn_t)(void *ctx, size_t run, uint32_t block);
+
+// Transfer one run on each of several SPI cards at once, in lock step: the
+// DMA transfers of the same block index go out on all buses together and
+// each card's busy (programming) time overlaps the others' transfers.
+// Every card must be on a different SPI. Returns the first error.
+int sd_write_blocks_parallel(const sd_parallel_run_t *runs, size_t n, sd_block_buffer_fn_t buffer,
+                             void *ctx);
+int sd_read_blocks_parallel(const sd_parallel_run_t *runs, size_t n, sd_block_buffer_fn_t buffer,
+                            void *ctx);
+
 bool sd_init_driver();
 bool sd_card_detect(sd_card_t *sd_card_p);
 
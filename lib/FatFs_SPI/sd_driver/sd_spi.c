@@ -31,9 +31,19 @@ specific language governing permissions and limitations under the License.
 #pragma GCC diagnostic ignored "-Wunused-variable"
 
 void sd_spi_go_high_frequency(sd_card_t *pSD) {
-    uint actual = spi_set_baudrate(pSD->spi->hw_inst, pSD->spi->baud_rate);
+    // The rate sd_init settled on, never the raw spi->baud_rate ceiling
+    myASSERT(pSD->baud_rate);
+    uint actual = sd_spi_set_frequency(pSD, pSD->baud_rate);
     TRACE_PRINTF("%s: Actual frequency: %lu\n", __FUNCTION__, (long)actual);
 }
+uint sd_spi_set_frequency(sd_card_t *pSD, uint hz) {
+    // spi_set_baudrate() reports the actual rate rounded down: asking for
+    // exactly that would get the next slower divisor.
+    return spi_set_baudrate(pSD->spi->hw_inst, hz + 1);
+}
+uint sd_spi_set_frequency_below(sd_card_t *pSD, uint hz) {
+    return spi_set_baudrate(pSD->spi->hw_inst, hz - 1);
+}
 void sd_spi_go_low_frequency(sd_card_t *pSD) {
     uint actual = spi_set_baudrate(pSD->spi->hw_inst, 400 * 1000); // Actual frequency: 398089
     TRACE_PRINTF("%s: Actual frequency: %lu\n", __FUNCTION__, (long)actual);
@@ -78,6 +88,9 @@ void sd_spi_deselect_pulse(sd_card_t *pSD) {
 }
 void sd_spi_acquire(sd_card_t *pSD) {
     sd_spi_lock(pSD);
+    // Cards sharing a bus may have been tuned to different clocks
+    if (pSD->baud_rate && spi_get_baudrate(pSD->spi->hw_inst) != pSD->baud_rate)
+        sd_spi_set_frequency(pSD, pSD->baud_rate);
     sd_spi_select(pSD);
 }
 
@@ -91,6 +104,31 @@ bool sd_spi_transfer(sd_card_t *pSD, const uint8_t *tx, uint8_t *rx,
     return spi_transfer(pSD->spi, tx, rx, length);
 }
 
+bool sd_spi_transfer_start(sd_card_t *pSD, uint8_t *rx, size_t length,
+                           uint8_t *tail, size_t tail_length, bool sniff_crc) {
+    spi_xfer_t xfer;
+    spi_xfer_prepare(pSD->spi, &xfer, NULL, rx, length, tail, tail_length);
+    xfer.sniff_crc16 = sniff_crc;
+    return spi_xfer_start(pSD->spi, &xfer);
+}
+
+bool sd_spi_write_start(sd_card_t *pSD, const uint8_t *tx, size_t length) {
+    return spi_transfer_start(pSD->spi, tx, NULL, length, NULL, 0);
+}
+
+bool sd_spi_transfer_wait_complete(sd_card_t *pSD) {
+    return spi_transfer_wait_complete(pSD->spi, 1000); /* Timeout 1 sec */
+}
+
+bool sd_spi_transfer_crc(sd_card_t *pSD, const uint8_t *tx, uint8_t *rx, size_t length, uint16_t *crc) {
+    return spi_transfer_crc16(pSD->spi, tx, rx, length, crc);
+}
+
+uint16_t sd_spi_sniffed_crc(sd_card_t *pSD) {
+    (void)pSD;
+    return spi_sniffed_crc16();
+}
+
 uint8_t sd_spi_write(sd_card_t *pSD, const uint8_t value) {
     // TRACE_PRINTF("%s\n", __FUNCTION__);
     uint8_t received = SPI_FILL_CHAR;
@@ -21,12 +21,29 @@ specific language governing permissions and limitations under the License.
 /* Transfer tx to SPI while receiving SPI to rx. 
 tx or rx can be NULL if not important. */
 bool sd_spi_transfer(sd_card_t *pSD, const uint8_t *tx, uint8_t *rx, size_t length);
+/* Start receiving length bytes into rx plus tail_length bytes into tail
+without waiting; finish with sd_spi_transfer_wait_complete(). */
+bool sd_spi_transfer_start(sd_card_t *pSD, uint8_t *rx, size_t length,
+                           uint8_t *tail, size_t tail_length, bool sniff_crc);
+/* Start sending length bytes from tx without waiting; the received bytes
+are discarded. Finish with sd_spi_transfer_wait_complete(). */
+bool sd_spi_write_start(sd_card_t *pSD, const uint8_t *tx, size_t length);
+bool sd_spi_transfer_wait_complete(sd_card_t *pSD);
+/* sd_spi_transfer() by DMA, with the data CRC16 computed by the DMA sniffer */
+bool sd_spi_transfer_crc(sd_card_t *pSD, const uint8_t *tx, uint8_t *rx, size_t length, uint16_t *crc);
+/* CRC16 of the last completed transfer started with sniff_crc */
+uint16_t sd_spi_sniffed_crc(sd_card_t *pSD);
 uint8_t sd_spi_write(sd_card_t *pSD, const uint8_t value);
 void sd_spi_deselect_pulse(sd_card_t *pSD);
 void sd_spi_acquire(sd_card_t *pSD);
 void sd_spi_release(sd_card_t *pSD);
 void sd_spi_go_low_frequency(sd_card_t *this);
 void sd_spi_go_high_frequency(sd_card_t *this);
+/* Set the SPI clock to the fastest the SPI can make up to hz and return it.
+A frequency it returned can be passed back to get the same one again. */
+uint sd_spi_set_frequency(sd_card_t *pSD, uint hz);
+/* Set the next slower clock the SPI can make below frequency hz */
+uint sd_spi_set_frequency_below(sd_card_t *pSD, uint hz);
 
 /* 
 After power up, the host starts the clock and sends the initializing sequence on the CMD line. 
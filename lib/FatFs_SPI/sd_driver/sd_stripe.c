@@ -0,0 +1,161 @@
+/* sd_stripe.c
+Striped (RAID-0) block device over several SD cards. See sd_stripe.h.
+*/
+#include <string.h>
+//
+#include "sd_stripe.h"
+//
+#include "diskio.h"
+#include "my_debug.h"
+
+#define SECTOR_SIZE 512
+
+// A request split into one run per member
+typedef struct {
+    const sd_stripe_t *stripe;
+    uint64_t start;  // First virtual sector of the request
+    uint8_t *buffer;
+    sd_parallel_run_t runs[SD_STRIPE_MAX_CARDS];
+} stripe_request_t;
+
+// Virtual sector -> member and sector on that member
+static void stripe_map(const sd_stripe_t *s, uint64_t sector, size_t *card, uint64_t *card_sector) {
+    uint64_t unit = sector / s->stripe_sectors;
+    *card = unit % s->num_cards;
+    *card_sector = unit / s->num_cards * s->stripe_sectors + sector % s->stripe_sectors;
+}
+
+// The sectors of a request that land on one member are consecutive there
+static void stripe_split(stripe_request_t *r, uint64_t sector, uint32_t count) {
+    const sd_stripe_t *s = r->stripe;
+    memset(r->runs, 0, sizeof r->runs);
+    for (size_t i = 0; i < s->num_cards; ++i) r->runs[i].card = s->cards[i];
+    r->start = sector;
+    uint64_t end = sector + count;
+    while (sector < end) {
+        uint64_t unit_end = (sector / s->stripe_sectors + 1) * s->stripe_sectors;
+        uint32_t n = (uint32_t)((unit_end < end ? unit_end : end) - sector);
+        size_t card;
+        uint64_t card_sector;
+        stripe_map(s, sector, &card, &card_sector);
+        if (!r->runs[card].count) r->runs[card].sector = card_sector;
+        r->runs[card].count += n;
+        sector += n;
+    }
+}
+
+// Block `block` of member `card`'s run -> its place in the caller's buffer
+static uint8_t *stripe_buffer(void *ctx, size_t card, uint32_t block) {
+    stripe_request_t *r = ctx;
+    const sd_stripe_t *s = r->stripe;
+    uint64_t card_sector = r->runs[card].sector + block;
+    uint64_t unit = card_sector / s->stripe_sectors * s->num_cards + card;
+    uint64_t sector = unit * s->stripe_sectors + card_sector % s->stripe_sectors;
+    return r->buffer + (sector - r->start) * SECTOR_SIZE;
+}
+
+// Members all SPI cards, each on its own bus
+static bool stripe_parallel(const sd_stripe_t *s) {
+    for (size_t i = 0; i < s->num_cards; ++i) {
+        if (!s->cards[i]->spi) return false;
+        for (size_t j = 0; j < i; ++j)
+            if (s->cards[j]->spi == s->cards[i]->spi) return false;
+    }
+    return true;
+}
+
+// One stripe unit at a time, through the members' own methods
+static int stripe_serial(sd_card_t *sd_card_p, uint8_t *buffer, uint64_t sector, uint32_t count,
+                         bool write) {
+    const sd_stripe_t *s = sd_card_p->device;
+    while (count) {
+        uint32_t n = s->stripe_sectors - sector % s->stripe_sectors;
+        if (n > count) n = count;
+        size_t card;
+        uint64_t card_sector;
+        stripe_map(s, sector, &card, &card_sector);
+        sd_card_t *member = s->cards[card];
+        int rc = write ? member->write_blocks(member, buffer, card_sector, n)
+                       : member->read_blocks(member, buffer, card_sector, n);
+        if (rc) return rc;
+        buffer += n * SECTOR_SIZE;
+        sector += n;
+        count -= n;
+    }
+    return SD_BLOCK_DEVICE_ERROR_NONE;
+}
+
+static int stripe_transfer(sd_card_t *sd_card_p, uint8_t *buffer, uint64_t sector, uint32_t count,
+                           bool write) {
+    const sd_stripe_t *s = sd_card_p->device;
+    if (sd_card_p->m_Status & (STA_NOINIT | STA_NODISK)) return SD_BLOCK_DEVICE_ERROR_NO_INIT;
+    if (sector + count > sd_card_p->sectors) return SD_BLOCK_DEVICE_ERROR_PARAMETER;
+    // Within one stripe unit only one card is involved anyway
+    if (!stripe_parallel(s) || sector % s->stripe_sectors + count <= s->stripe_sectors)
+        return stripe_serial(sd_card_p, buffer, sector, count, write);
+    stripe_request_t r = {.stripe = s, .buffer = buffer};
+    stripe_split(&r, sector, count);
+    return write ? sd_write_blocks_parallel(r.runs, s->num_cards, stripe_buffer, &r)
+                 : sd_read_blocks_parallel(r.runs, s->num_cards, stripe_buffer, &r);
+}
+
+int sd_stripe_init(sd_card_t *sd_card_p) {
+    const sd_stripe_t *s = sd_card_p->device;
+    myASSERT(s && s->num_cards && s->num_cards <= SD_STRIPE_MAX_CARDS && s->stripe_sectors);
+    uint64_t units = UINT64_MAX;
+    uint32_t au = UINT32_MAX;
+    sd_card_p->m_Status = STA_NOINIT;
+    for (size_t i = 0; i < s->num_cards; ++i) {
+        sd_card_t *member = s->cards[i];
+        int status = member->init(member);
+        if (status & (STA_NOINIT | STA_NODISK)) {
+            DBG_PRINTF("%s: member %s failed: 0x%x\r\n", __FUNCTION__, member->pcName, status);
+            sd_card_p->m_Status |= status & STA_NODISK;
+            return sd_card_p->m_Status;
+        }
+        // The smallest member limits the size
+        uint64_t member_units = member->sectors / s->stripe_sectors;
+        if (member_units < units) units = member_units;
+        if (member->au_sectors < au) au = member->au_sectors;
+    }
+    sd_card_p->sectors = units * s->stripe_sectors * s->num_cards;
+    // One AU per member, rounded down to a power of 2: FatFs treats any other
+    // GET_BLOCK_SIZE as 1. With 2 or 4 members this is exact; with 3 the data
+    // area alignment is only approximate.
+    au *= s->num_cards;
+    while (au & (au - 1)) au &= au - 1;
+    sd_card_p->au_sectors = au;
+    sd_card_p->m_Status = 0;
+    return sd_card_p->m_Status;
+}
+
+int sd_stripe_write_blocks(sd_card_t *sd_card_p, const uint8_t *buffer, uint64_t ulSectorNumber,
+                           uint32_t blockCnt) {
+    return stripe_transfer(sd_card_p, (uint8_t *)buffer, ulSectorNumber, blockCnt, true);
+}
+
+int sd_stripe_read_blocks(sd_card_t *sd_card_p, uint8_t *buffer, uint64_t ulSectorNumber,
+                          uint32_t ulSectorCount) {
+    return stripe_transfer(sd_card_p, buffer, ulSectorNumber, ulSectorCount, false);
+}
+
+int sd_stripe_trim(sd_card_t *sd_card_p, uint64_t start, uint64_t end) {
+    const sd_stripe_t *s = sd_card_p->device;
+    if (end < start || end >= sd_card_p->sectors) return SD_BLOCK_DEVICE_ERROR_PARAMETER;
+    stripe_request_t r = {.stripe = s};
+    stripe_split(&r, start, (uint32_t)(end - start + 1));
+    for (size_t i = 0; i < s->num_cards; ++i) {
+        sd_card_t *member = s->cards[i];
+        if (!r.runs[i].count || !member->trim) continue;
+        int rc = member->trim(member, r.runs[i].sector, r.runs[i].sector + r.runs[i].count - 1);
+        if (rc) return rc;
+    }
+    return SD_BLOCK_DEVICE_ERROR_NONE;
+}
+
+bool sd_stripe_test_com(sd_card_t *sd_card_p) {
+    const sd_stripe_t *s = sd_card_p->device;
+    for (size_t i = 0; i < s->num_cards; ++i)
+        if (!s->cards[i]->sd_test_com(s->cards[i])) return false;
+    return true;
+}
@@ -0,0 +1,60 @@
+/* sd_stripe.h
+Striped (RAID-0) block device over several SD cards.
+
+A sd_card_t set up with SD_STRIPE_CARD() presents its member cards as one
+disk: the virtual sectors are dealt out stripe_sectors at a time, card 0,
+card 1, ..., card 0 again. Each request becomes one run of consecutive
+blocks per member, transferred with sd_{read,write}_blocks_parallel() when
+every member is an SPI card on a bus of its own, so the members work at the
+same time. Otherwise (shared bus, non-SPI members) the stripe units are
+transferred one after the other through the members' own methods.
+The allocation unit reported to FatFs is the smallest member AU times
+num_cards, rounded down to a power of 2.
+
+There is no redundancy: losing one card loses the volume. Members come
+after the FatFs volumes in hw_config's sd_cards[] so sd_init_driver()
+initializes their SPI and GPIOs, e.g.:
+
+    static sd_stripe_t stripe = {.cards = {&sd_cards[1], &sd_cards[2]}, .num_cards = 2,
+                                 .stripe_sectors = 64};
+    static sd_card_t sd_cards[] = {
+        {SD_STRIPE_CARD("0:", &stripe)},
+        {.pcName = "spi0 member", .spi = &spis[0], .ss_gpio = 17},
+        {.pcName = "spi1 member", .spi = &spis[1], .ss_gpio = 13}};
+*/
+#pragma once
+
+#include <stdint.h>
+#include "sd_card.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef SD_STRIPE_MAX_CARDS
+#define SD_STRIPE_MAX_CARDS 4
+#endif
+
+typedef struct {
+    sd_card_t *cards[SD_STRIPE_MAX_CARDS];
+    size_t num_cards;
+    uint32_t stripe_sectors;  // Stripe unit; ideally divides the cards' AU
+} sd_stripe_t;
+
+int sd_stripe_init(sd_card_t *sd_card_p);
+int sd_stripe_write_blocks(sd_card_t *sd_card_p, const uint8_t *buffer, uint64_t ulSectorNumber,
+                           uint32_t blockCnt);
+int sd_stripe_read_blocks(sd_card_t *sd_card_p, uint8_t *buffer, uint64_t ulSectorNumber,
+                          uint32_t ulSectorCount);
+int sd_stripe_trim(sd_card_t *sd_card_p, uint64_t start, uint64_t end);
+bool sd_stripe_test_com(sd_card_t *sd_card_p);
+
+// Methods of a sd_card_t striped over *stripe_p, for hw_config's sd_cards[]
+#define SD_STRIPE_CARD(name, stripe_p)                                                            \
+    .pcName = (name), .m_Status = STA_NOINIT, .init = sd_stripe_init,                             \
+    .write_blocks = sd_stripe_write_blocks, .read_blocks = sd_stripe_read_blocks,                 \
+    .trim = sd_stripe_trim, .sd_test_com = sd_stripe_test_com, .device = (stripe_p)
+
+#ifdef __cplusplus
+}
+#endif
@@ -32,9 +32,12 @@ static void in_spi_irq_handler(const uint DMA_IRQ_num, io_rw_32 *dma_hw_ints_p)
         spi_t *spi_p = spi_get_by_num(i);
         if (DMA_IRQ_num == spi_p->DMA_IRQ_num)  {
             // Is the SPI's channel requesting interrupt?
-            if (*dma_hw_ints_p & (1 << spi_p->rx_dma)) {
-                *dma_hw_ints_p = 1 << spi_p->rx_dma;  // Clear it.
+            // (rx_tail_dma when the receive side was chained)
+            uint32_t mask = (1u << spi_p->rx_dma) | (1u << spi_p->rx_tail_dma);
+            if (*dma_hw_ints_p & mask) {
+                *dma_hw_ints_p = *dma_hw_ints_p & mask;  // Clear it.
                 assert(!dma_channel_is_busy(spi_p->rx_dma));
+                assert(!dma_channel_is_busy(spi_p->rx_tail_dma));
                 assert(!sem_available(&spi_p->sem));
                 bool ok = sem_release(&spi_p->sem);
                 assert(ok);
@@ -54,47 +57,68 @@ void set_spi_dma_irq_channel(bool useChannel1, bool shared) {
     irqShared = shared;
 }
 
-// SPI Transfer: Read & Write (simultaneously) on SPI bus
+// Resolve a transfer into a descriptor (see spi_xfer_t).
 //   If the data that will be received is not important, pass NULL as rx.
 //   If the data that will be transmitted is not important,
 //     pass NULL as tx and then the SPI_FILL_CHAR is sent out as each data
 //     element.
-bool spi_transfer(spi_t *spi_p, const uint8_t *tx, uint8_t *rx, size_t length) {
-    // assert(512 == length || 1 == length);
+//   If tail is not NULL, tail_length more bytes are clocked after length
+//     and a chained DMA channel stores them in tail. This lets a data block
+//     and its trailer (CRC, next token) land in different buffers with a
+//     single transfer and a single interrupt. Receive only: tx must be NULL.
+void spi_xfer_prepare(spi_t *spi_p, spi_xfer_t *xfer, const uint8_t *tx, uint8_t *rx, size_t length,
+                      uint8_t *tail, size_t tail_length) {
+    static const uint8_t fill = SPI_FILL_CHAR;
+    static uint8_t dummy;
     assert(tx || rx);
-    // assert(!(tx && rx));
-
-    // tx write increment is already false
-    if (tx) {
-        channel_config_set_read_increment(&spi_p->tx_dma_cfg, true);
-    } else {
-        static const uint8_t dummy = SPI_FILL_CHAR;
-        tx = &dummy;
-        channel_config_set_read_increment(&spi_p->tx_dma_cfg, false);
-    }
-
-    // rx read increment is already false
-    if (rx) {
-        channel_config_set_write_increment(&spi_p->rx_dma_cfg, true);
-    } else {
-        static uint8_t dummy = 0xA5;
-        rx = &dummy;
-        channel_config_set_write_increment(&spi_p->rx_dma_cfg, false);
-    }
+    assert(!tail || (!tx && rx && tail_length));
+
+    xfer->tx_cfg = tx ? &spi_p->tx_dma_cfg : &spi_p->tx_fill_dma_cfg;
+    xfer->tx = tx ? tx : &fill;
+    if (tail)
+        xfer->rx_cfg = &spi_p->rx_chain_dma_cfg;
+    else
+        xfer->rx_cfg = rx ? &spi_p->rx_dma_cfg : &spi_p->rx_discard_dma_cfg;
+    xfer->rx = rx ? rx : &dummy;
+    xfer->length = length;
+    xfer->tail = tail;
+    xfer->tail_length = tail ? tail_length : 0;
+    xfer->sniff_crc16 = false;
+}
 
-    dma_channel_configure(spi_p->tx_dma, &spi_p->tx_dma_cfg,
+// Start a prepared transfer and return without waiting for it to finish;
+// call spi_transfer_wait_complete() before touching the buffers or the bus.
+bool spi_xfer_start(spi_t *spi_p, const spi_xfer_t *xfer) {
+    // With a tail, rx_dma hands over to rx_tail_dma quietly and the
+    // completion interrupt comes from the end of the chain.
+    if (xfer->tail)
+        dma_channel_configure(spi_p->rx_tail_dma, &spi_p->rx_tail_dma_cfg,
+                              xfer->tail,                       // write address
+                              &spi_get_hw(spi_p->hw_inst)->dr,  // read address
+                              xfer->tail_length,
+                              false);  // triggered by rx_dma
+
+    dma_channel_configure(spi_p->tx_dma, xfer->tx_cfg,
                           &spi_get_hw(spi_p->hw_inst)->dr,  // write address
-                          tx,                              // read address
-                          length,  // element count (each element is of
-                                   // size transfer_data_size)
+                          xfer->tx,                        // read address
+                          xfer->length + xfer->tail_length,  // element count (each element is of
+                                                             // size transfer_data_size)
                           false);  // start
-    dma_channel_configure(spi_p->rx_dma, &spi_p->rx_dma_cfg,
-                          rx,                              // write address
+    dma_channel_configure(spi_p->rx_dma, xfer->rx_cfg,
+                          xfer->rx,                        // write address
                           &spi_get_hw(spi_p->hw_inst)->dr,  // read address
-                          length,  // element count (each element is of
-                                   // size transfer_data_size)
+                          xfer->length,  // element count (each element is of
+                                         // size transfer_data_size)
                           false);  // start
 
+    // The sniffer watches the channel that carries the data bytes: tx when
+    // sending a buffer, rx otherwise (never the tail).
+    if (xfer->sniff_crc16) {
+        uint channel = xfer->tx_cfg == &spi_p->tx_dma_cfg ? spi_p->tx_dma : spi_p->rx_dma;
+        dma_sniffer_enable(channel, DMA_SNIFF_CTRL_CALC_VALUE_CRC16, true);
+        dma_sniffer_set_data_accumulator(0);
+    }
+
     switch (spi_p->DMA_IRQ_num) {
         case DMA_IRQ_0:
             assert(!dma_channel_get_irq0_status(spi_p->rx_dma));
@@ -111,10 +135,24 @@ bool spi_transfer(spi_t *spi_p, const uint8_t *tx, uint8_t *rx, size_t length) {
     // the FIFO could overflow)
     dma_start_channel_mask((1u << spi_p->tx_dma) | (1u << spi_p->rx_dma));
 
+    return true;
+}
+
+// SPI Transfer: Read & Write (simultaneously) on SPI bus, by DMA.
+//   Arguments as for spi_xfer_prepare(); the transfer is started and the
+//   function returns without waiting for it to finish.
+bool spi_transfer_start(spi_t *spi_p, const uint8_t *tx, uint8_t *rx, size_t length,
+                        uint8_t *tail, size_t tail_length) {
+    spi_xfer_t xfer;
+    spi_xfer_prepare(spi_p, &xfer, tx, rx, length, tail, tail_length);
+    return spi_xfer_start(spi_p, &xfer);
+}
+
+// Wait for the transfer started by spi_transfer_start() to finish
+bool spi_transfer_wait_complete(spi_t *spi_p, uint32_t timeout_ms) {
     /* Wait until master completes transfer or time out has occured. */
-    uint32_t timeOut = 1000; /* Timeout 1 sec */
     bool rc = sem_acquire_timeout_ms(
-        &spi_p->sem, timeOut);  // Wait for notification from ISR
+        &spi_p->sem, timeout_ms);  // Wait for notification from ISR
     if (!rc) {
         // If the timeout is reached the function will return false
         DBG_PRINTF("Notification wait timed out in %s\n", __FUNCTION__);
@@ -127,10 +165,51 @@ bool spi_transfer(spi_t *spi_p, const uint8_t *tx, uint8_t *rx, size_t length) {
     assert(!sem_available(&spi_p->sem));
     assert(!dma_channel_is_busy(spi_p->tx_dma));
     assert(!dma_channel_is_busy(spi_p->rx_dma));
+    assert(!dma_channel_is_busy(spi_p->rx_tail_dma));
 
     return true;
 }
 
+// Programmed I/O for short transfers: no DMA setup, interrupt or semaphore
+static void spi_transfer_polled(spi_t *spi_p, const uint8_t *tx, uint8_t *rx, size_t length) {
+    if (tx && rx)
+        spi_write_read_blocking(spi_p->hw_inst, tx, rx, length);
+    else if (tx)
+        spi_write_blocking(spi_p->hw_inst, tx, length);
+    else
+        spi_read_blocking(spi_p->hw_inst, SPI_FILL_CHAR, rx, length);
+}
+
+// SPI Transfer: Read & Write (simultaneously) on SPI bus, and wait for it.
+//   Arguments as for spi_xfer_prepare() (no tail). Transfers of up to
+//   polled_max bytes don't use DMA.
+bool spi_transfer(spi_t *spi_p, const uint8_t *tx, uint8_t *rx, size_t length) {
+    assert(tx || rx);
+    if (length <= spi_p->polled_max) {
+        spi_transfer_polled(spi_p, tx, rx, length);
+        return true;
+    }
+    spi_transfer_start(spi_p, tx, rx, length, NULL, 0);
+    return spi_transfer_wait_complete(spi_p, 1000); /* Timeout 1 sec */
+}
+
+// Like spi_transfer(), always by DMA, also returning the CRC16-CCITT of the
+// data bytes as computed by the DMA sniffer.
+bool spi_transfer_crc16(spi_t *spi_p, const uint8_t *tx, uint8_t *rx, size_t length, uint16_t *crc) {
+    spi_xfer_t xfer;
+    spi_xfer_prepare(spi_p, &xfer, tx, rx, length, NULL, 0);
+    xfer.sniff_crc16 = true;
+    spi_xfer_start(spi_p, &xfer);
+    bool ok = spi_transfer_wait_complete(spi_p, 1000); /* Timeout 1 sec */
+    *crc = spi_sniffed_crc16();
+    return ok;
+}
+
+// CRC16 of the last transfer started with sniff_crc16 (valid once complete)
+uint16_t spi_sniffed_crc16(void) {
+    return (uint16_t)dma_sniffer_get_data_accumulator();
+}
+
 void spi_lock(spi_t *spi_p) {
     assert(mutex_is_initialized(&spi_p->mutex));
     mutex_enter_blocking(&spi_p->mutex);
@@ -186,11 +265,14 @@ bool my_spi_init(spi_t *spi_p) {
         // Grab some unused dma channels
         spi_p->tx_dma = dma_claim_unused_channel(true);
         spi_p->rx_dma = dma_claim_unused_channel(true);
+        spi_p->rx_tail_dma = dma_claim_unused_channel(true);
 
         spi_p->tx_dma_cfg = dma_channel_get_default_config(spi_p->tx_dma);
         spi_p->rx_dma_cfg = dma_channel_get_default_config(spi_p->rx_dma);
+        spi_p->rx_tail_dma_cfg = dma_channel_get_default_config(spi_p->rx_tail_dma);
         channel_config_set_transfer_data_size(&spi_p->tx_dma_cfg, DMA_SIZE_8);
         channel_config_set_transfer_data_size(&spi_p->rx_dma_cfg, DMA_SIZE_8);
+        channel_config_set_transfer_data_size(&spi_p->rx_tail_dma_cfg, DMA_SIZE_8);
 
         // We set the outbound DMA to transfer from a memory buffer to the SPI
         // transmit FIFO paced by the SPI TX FIFO DREQ The default is for the
@@ -200,6 +282,7 @@ bool my_spi_init(spi_t *spi_p) {
                                                        ? DREQ_SPI1_TX
                                                        : DREQ_SPI0_TX);
         channel_config_set_write_increment(&spi_p->tx_dma_cfg, false);
+        channel_config_set_read_increment(&spi_p->tx_dma_cfg, true);
 
         // We set the inbound DMA to transfer from the SPI receive FIFO to a
         // memory buffer paced by the SPI RX FIFO DREQ We coinfigure the read
@@ -209,6 +292,25 @@ bool my_spi_init(spi_t *spi_p) {
                                                        ? DREQ_SPI1_RX
                                                        : DREQ_SPI0_RX);
         channel_config_set_read_increment(&spi_p->rx_dma_cfg, false);
+        channel_config_set_write_increment(&spi_p->rx_dma_cfg, true);
+
+        // The tail channel continues the receive side where rx_dma stops
+        channel_config_set_dreq(&spi_p->rx_tail_dma_cfg, spi_get_index(spi_p->hw_inst)
+                                                            ? DREQ_SPI1_RX
+                                                            : DREQ_SPI0_RX);
+        channel_config_set_read_increment(&spi_p->rx_tail_dma_cfg, false);
+        channel_config_set_write_increment(&spi_p->rx_tail_dma_cfg, true);
+
+        // The other shapes are variations of the two above
+        spi_p->tx_fill_dma_cfg = spi_p->tx_dma_cfg;
+        channel_config_set_read_increment(&spi_p->tx_fill_dma_cfg, false);
+        spi_p->rx_discard_dma_cfg = spi_p->rx_dma_cfg;
+        channel_config_set_write_increment(&spi_p->rx_discard_dma_cfg, false);
+        spi_p->rx_chain_dma_cfg = spi_p->rx_dma_cfg;
+        channel_config_set_chain_to(&spi_p->rx_chain_dma_cfg, spi_p->rx_tail_dma);
+        channel_config_set_irq_quiet(&spi_p->rx_chain_dma_cfg, true);
+
+        spi_p->polled_max = SPI_POLLED_MAX;
 
         /* Theory: we only need an interrupt on rx complete,
         since if rx is complete, tx must also be complete. */
@@ -223,22 +325,30 @@ bool my_spi_init(spi_t *spi_p) {
         case DMA_IRQ_0:
             spi_irq_handler_p = spi_irq_handler_0;
             dma_channel_set_irq0_enabled(spi_p->rx_dma, true);
+            dma_channel_set_irq0_enabled(spi_p->rx_tail_dma, true);
             dma_channel_set_irq0_enabled(spi_p->tx_dma, false);
         break;
         case DMA_IRQ_1:
             spi_irq_handler_p = spi_irq_handler_1;
             dma_channel_set_irq1_enabled(spi_p->rx_dma, true);
+            dma_channel_set_irq1_enabled(spi_p->rx_tail_dma, true);
             dma_channel_set_irq1_enabled(spi_p->tx_dma, false);
         break;
         default:
             assert(false);
         }
-        if (irqShared) {
-            irq_add_shared_handler(
-                spi_p->DMA_IRQ_num, *spi_irq_handler_p,
-                PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
-        } else {
-            irq_set_exclusive_handler(spi_p->DMA_IRQ_num, *spi_irq_handler_p);
+        // The handler serves every SPI on its IRQ line, so it is installed
+        // only once per line; a second copy would see the same status bits.
+        static bool handler_installed[2];
+        if (!handler_installed[spi_p->DMA_IRQ_num - DMA_IRQ_0]) {
+            if (irqShared) {
+                irq_add_shared_handler(
+                    spi_p->DMA_IRQ_num, *spi_irq_handler_p,
+                    PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+            } else {
+                irq_set_exclusive_handler(spi_p->DMA_IRQ_num, *spi_irq_handler_p);
+            }
+            handler_installed[spi_p->DMA_IRQ_num - DMA_IRQ_0] = true;
         }
         irq_set_enabled(spi_p->DMA_IRQ_num, true);
         LED_INIT();
@@ -27,6 +27,15 @@ specific language governing permissions and limitations under the License.
 
 #define SPI_FILL_CHAR (0xFF)
 
+// Transfers of up to this many bytes are done with programmed I/O instead
+// of DMA: for tokens, CRCs and R1 polling, setting up two channels and
+// waiting for the completion interrupt costs more than the transfer itself.
+// The limit is copied to spi_t.polled_max by my_spi_init() and can be
+// changed at run time (0 = always use DMA).
+#ifndef SPI_POLLED_MAX
+#define SPI_POLLED_MAX 16
+#endif
+
 // "Class" representing SPIs
 typedef struct {
     // SPI HW
@@ -44,25 +53,64 @@ typedef struct {
     enum gpio_drive_strength mosi_gpio_drive_strength;
     enum gpio_drive_strength sck_gpio_drive_strength;
 
+    // Compute data block CRC16s with the DMA sniffer while they stream,
+    // instead of with the CPU. There is one sniffer: enable it on one SPI only.
+    bool dma_crc;
+
     // State variables:
     uint tx_dma;
     uint rx_dma;
-    dma_channel_config tx_dma_cfg;
-    dma_channel_config rx_dma_cfg;
+    uint rx_tail_dma; // Chained after rx_dma to split off a trailer (e.g. CRC)
+    // DMA channel configurations are built once in my_spi_init(), one per
+    // transfer shape; starting a transfer only selects one of them.
+    dma_channel_config tx_dma_cfg;      // From a buffer
+    dma_channel_config tx_fill_dma_cfg; // Repeats SPI_FILL_CHAR
+    dma_channel_config rx_dma_cfg;      // Into a buffer
+    dma_channel_config rx_discard_dma_cfg; // Into a dummy byte
+    dma_channel_config rx_chain_dma_cfg;   // Into a buffer, then rx_tail_dma
+    dma_channel_config rx_tail_dma_cfg;
+    size_t polled_max; // See SPI_POLLED_MAX
     irq_handler_t dma_isr; // Ignored: no longer used
     bool initialized;  
     semaphore_t sem;
     mutex_t mutex;    
 } spi_t;
 
+// Transfer descriptor: the DMA configurations and addresses for one
+// transfer, resolved by spi_xfer_prepare(). Buffers are used in place (no
+// copies); a descriptor can be started any number of times while its
+// buffers stay valid.
+typedef struct {
+    const dma_channel_config *tx_cfg;
+    const dma_channel_config *rx_cfg;
+    const uint8_t *tx;  // Buffer or the fill character
+    uint8_t *rx;        // Buffer or a dummy byte
+    size_t length;
+    uint8_t *tail;      // Optional trailer buffer (receive only)
+    size_t tail_length;
+    bool sniff_crc16;   // CRC16-CCITT of the length data bytes by the DMA sniffer
+} spi_xfer_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
   
 bool __not_in_flash_func(spi_transfer)(spi_t *pSPI, const uint8_t *tx, uint8_t *rx, size_t length);  
+bool __not_in_flash_func(spi_transfer_start)(spi_t *pSPI, const uint8_t *tx, uint8_t *rx, size_t length,
+                                             uint8_t *tail, size_t tail_length);
+bool __not_in_flash_func(spi_transfer_wait_complete)(spi_t *pSPI, uint32_t timeout_ms);
+void __not_in_flash_func(spi_xfer_prepare)(spi_t *pSPI, spi_xfer_t *xfer, const uint8_t *tx, uint8_t *rx,
+                                           size_t length, uint8_t *tail, size_t tail_length);
+bool __not_in_flash_func(spi_xfer_start)(spi_t *pSPI, const spi_xfer_t *xfer);
+bool __not_in_flash_func(spi_transfer_crc16)(spi_t *pSPI, const uint8_t *tx, uint8_t *rx, size_t length,
+                                             uint16_t *crc);
+uint16_t spi_sniffed_crc16(void);
 void spi_lock(spi_t *pSPI);
 void spi_unlock(spi_t *pSPI);
 bool my_spi_init(spi_t *pSPI);
+// With shared false the handler is installed as the exclusive one for the
+// line. Other drivers (SSD1306, WS2812 matrix) add shared handlers on
+// DMA_IRQ_1, so keep shared true when using channel 1.
 void set_spi_dma_irq_channel(bool useChannel1, bool shared);
 
 #ifdef __cplusplus
@@ -28,6 +28,7 @@ specific language governing permissions and limitations under the License.
 #include "hw_config.h"
 #include "my_debug.h"
 #include "sd_card.h"
+#include "sector_cache.h"
 
 #define TRACE_PRINTF(fmt, args...)
 //#define TRACE_PRINTF printf  // task_printf
@@ -59,6 +60,8 @@ DSTATUS disk_initialize(
 
     sd_card_t *p_sd = sd_get_by_num(pdrv);
     if (!p_sd) return RES_PARERR;
+    // Whatever is cached belongs to the card that was there before
+    if (p_sd->m_Status & STA_NOINIT) sector_cache_invalidate(pdrv);
     // See http://elm-chan.org/fsw/ff/doc/dstat.html
     return p_sd->init(p_sd);  
 }
@@ -98,7 +101,7 @@ DRESULT disk_read(BYTE pdrv,  /* Physical drive nmuber to identify the drive */
     TRACE_PRINTF(">>> %s\n", __FUNCTION__);
     sd_card_t *p_sd = sd_get_by_num(pdrv);
     if (!p_sd) return RES_PARERR;
-    int rc = p_sd->read_blocks(p_sd, buff, sector, count);
+    int rc = sector_cache_read(pdrv, buff, sector, count);
     return sdrc2dresult(rc);
 }
 
@@ -116,7 +119,7 @@ DRESULT disk_write(BYTE pdrv, /* Physical drive nmuber to identify the drive */
     TRACE_PRINTF(">>> %s\n", __FUNCTION__);
     sd_card_t *p_sd = sd_get_by_num(pdrv);
     if (!p_sd) return RES_PARERR;
-    int rc = p_sd->write_blocks(p_sd, buff, sector, count);
+    int rc = sector_cache_write(pdrv, buff, sector, count);
     return sdrc2dresult(rc);
 }
 
@@ -142,7 +145,8 @@ DRESULT disk_ioctl(BYTE pdrv, /* Physical drive nmuber (0..) */
                                   // volume/partition to be created. It is
                                   // required when FF_USE_MKFS == 1.
             static LBA_t n;
-            n = sd_sectors(p_sd);
+            // Only SPI cards can be asked (CSD); others know their size
+            n = p_sd->spi ? sd_sectors(p_sd) : p_sd->sectors;
             *(LBA_t *)buff = n;
             if (!n) return RES_ERROR;
             return RES_OK;
@@ -156,12 +160,20 @@ DRESULT disk_ioctl(BYTE pdrv, /* Physical drive nmuber (0..) */
                                 // f_mkfs function and it attempts to align data
                                 // area on the erase block boundary. It is
                                 // required when FF_USE_MKFS == 1.
-            static DWORD bs = 1;
-            *(DWORD *)buff = bs;
+            *(DWORD *)buff = p_sd->au_sectors ? p_sd->au_sectors : 1;
             return RES_OK;
         }
-        case CTRL_SYNC:
-            return RES_OK;
+        case CTRL_TRIM: {  // Informs the device that the data on the block of
+                           // sectors specified by the LBA_t array {start,
+                           // end} pointed by buff is no longer needed.
+                           // Required when FF_USE_TRIM == 1.
+            LBA_t *range = buff;
+            sector_cache_discard(pdrv, range[0], range[1]);
+            if (!p_sd->trim) return RES_OK;
+            return sdrc2dresult(p_sd->trim(p_sd, range[0], range[1]));
+        }
+        case CTRL_SYNC:  // Write back everything the sector cache is holding
+            return sdrc2dresult(sector_cache_flush(pdrv));
         default:
             return RES_PARERR;
     }
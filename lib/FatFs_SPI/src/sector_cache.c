@@ -0,0 +1,272 @@
+/* sector_cache.c
+Write-back sector cache between the FatFs glue and the SD card driver.
+See sector_cache.h.
+*/
+#include <string.h>
+//
+#include "pico/mutex.h"
+#include "pico/time.h"
+//
+#include "hw_config.h"
+#include "my_debug.h"
+#include "sd_card.h"
+#include "sector_cache.h"
+
+#if SECTOR_CACHE_SETS & (SECTOR_CACHE_SETS - 1)
+#error "SECTOR_CACHE_SETS must be a power of 2"
+#endif
+
+#define SECTOR_SIZE 512
+
+typedef struct {
+    uint64_t sector;
+    uint32_t last_use;  // For LRU replacement
+    bool valid;
+    bool dirty;
+} cache_line_t;
+
+typedef struct {
+    // Indexed [way][set]: a run of consecutive sectors cached in the same way
+    // is contiguous in data[], so it can be written back without copying.
+    cache_line_t lines[SECTOR_CACHE_WAYS][SECTOR_CACHE_SETS];
+    uint8_t data[SECTOR_CACHE_WAYS][SECTOR_CACHE_SETS][SECTOR_SIZE];
+    uint32_t clock;
+    uint32_t num_dirty;
+    absolute_time_t dirty_since;  // When the oldest dirty sector was written
+    mutex_t mutex;
+    sector_cache_stats_t stats;
+} sector_cache_t;
+
+static sector_cache_t caches[SECTOR_CACHE_DRIVES];
+
+static sector_cache_t *cache_lock(BYTE pdrv) {
+    auto_init_mutex(cache_init_mutex);
+    if (!SECTOR_CACHE_ENABLED || pdrv >= SECTOR_CACHE_DRIVES) return NULL;
+    sector_cache_t *c = &caches[pdrv];
+    if (!mutex_is_initialized(&c->mutex)) {
+        mutex_enter_blocking(&cache_init_mutex);
+        if (!mutex_is_initialized(&c->mutex)) mutex_init(&c->mutex);
+        mutex_exit(&cache_init_mutex);
+    }
+    mutex_enter_blocking(&c->mutex);
+    return c;
+}
+static void cache_unlock(sector_cache_t *c) {
+    mutex_exit(&c->mutex);
+}
+
+static inline uint set_of(uint64_t sector) {
+    return sector & (SECTOR_CACHE_SETS - 1);
+}
+
+static cache_line_t *lookup(sector_cache_t *c, uint64_t sector, uint *way) {
+    uint set = set_of(sector);
+    for (uint w = 0; w < SECTOR_CACHE_WAYS; ++w) {
+        cache_line_t *l = &c->lines[w][set];
+        if (l->valid && l->sector == sector) {
+            l->last_use = ++c->clock;
+            if (way) *way = w;
+            return l;
+        }
+    }
+    return NULL;
+}
+
+static void mark_dirty(sector_cache_t *c, cache_line_t *l) {
+    if (l->dirty) return;
+    if (!c->num_dirty) c->dirty_since = get_absolute_time();
+    l->dirty = true;
+    ++c->num_dirty;
+}
+
+static void mark_clean(sector_cache_t *c, cache_line_t *l) {
+    if (!l->dirty) return;
+    l->dirty = false;
+    --c->num_dirty;
+}
+
+// Write back every dirty sector, one card write per run of consecutive
+// sectors held in consecutive sets of the same way.
+static int flush_nolock(BYTE pdrv, sector_cache_t *c) {
+    sd_card_t *sd_card_p = sd_get_by_num(pdrv);
+    int status = SD_BLOCK_DEVICE_ERROR_NONE;
+    for (uint w = 0; w < SECTOR_CACHE_WAYS && c->num_dirty; ++w) {
+        cache_line_t *row = c->lines[w];
+        uint s = 0;
+        while (s < SECTOR_CACHE_SETS) {
+            if (!row[s].dirty) {
+                ++s;
+                continue;
+            }
+            uint n = 1;
+            while (s + n < SECTOR_CACHE_SETS && row[s + n].dirty &&
+                   row[s + n].sector == row[s].sector + n)
+                ++n;
+            int rc = sd_card_p->write_blocks(sd_card_p, c->data[w][s], row[s].sector, n);
+            ++c->stats.write_commands;
+            if (SD_BLOCK_DEVICE_ERROR_NONE == rc) {
+                for (uint i = 0; i < n; ++i) mark_clean(c, &row[s + i]);
+                c->stats.writebacks += n;
+            } else {
+                DBG_PRINTF("%s: write-back of %u sectors at %llu failed: %d\r\n",
+                           __FUNCTION__, n, (unsigned long long)row[s].sector, rc);
+                status = rc;  // Leave them dirty
+            }
+            s += n;
+        }
+    }
+    return status;
+}
+
+// Choose a line in the set of sector for a new entry, writing back if the
+// victim is dirty. Prefers the way holding sector - 1 so that runs stay
+// contiguous, then an empty line, then the least recently used.
+static cache_line_t *allocate(BYTE pdrv, sector_cache_t *c, uint64_t sector, uint *way) {
+    uint set = set_of(sector);
+    uint victim = SECTOR_CACHE_WAYS;
+    uint prev_way;
+    if (set && lookup(c, sector - 1, &prev_way) && !c->lines[prev_way][set].dirty)
+        victim = prev_way;
+    for (uint w = 0; w < SECTOR_CACHE_WAYS && SECTOR_CACHE_WAYS == victim; ++w)
+        if (!c->lines[w][set].valid) victim = w;
+    if (SECTOR_CACHE_WAYS == victim) {
+        victim = 0;
+        for (uint w = 1; w < SECTOR_CACHE_WAYS; ++w)
+            if (c->lines[w][set].last_use < c->lines[victim][set].last_use) victim = w;
+    }
+    cache_line_t *l = &c->lines[victim][set];
+    if (l->dirty) {
+        // Write everything back while at it: neighbours go out in the same run
+        int rc = flush_nolock(pdrv, c);
+        if (SD_BLOCK_DEVICE_ERROR_NONE != rc) return NULL;
+    }
+    l->valid = true;
+    l->sector = sector;
+    l->last_use = ++c->clock;
+    *way = victim;
+    return l;
+}
+
+static int flush_expired_nolock(BYTE pdrv, sector_cache_t *c) {
+    if (SECTOR_CACHE_FLUSH_MS && c->num_dirty &&
+        absolute_time_diff_us(c->dirty_since, get_absolute_time()) >=
+            (int64_t)SECTOR_CACHE_FLUSH_MS * 1000)
+        return flush_nolock(pdrv, c);
+    return SD_BLOCK_DEVICE_ERROR_NONE;
+}
+
+int sector_cache_read(BYTE pdrv, uint8_t *buffer, uint64_t sector, uint32_t count) {
+    sd_card_t *sd_card_p = sd_get_by_num(pdrv);
+    sector_cache_t *c = cache_lock(pdrv);
+    if (!c) return sd_card_p->read_blocks(sd_card_p, buffer, sector, count);
+
+    int rc = SD_BLOCK_DEVICE_ERROR_NONE;
+    uint way;
+    cache_line_t *l;
+    if (1 == count) {
+        if ((l = lookup(c, sector, &way))) {
+            ++c->stats.read_hits;
+            memcpy(buffer, c->data[way][set_of(sector)], SECTOR_SIZE);
+        } else {
+            ++c->stats.read_misses;
+            rc = sd_card_p->read_blocks(sd_card_p, buffer, sector, 1);
+            if (SD_BLOCK_DEVICE_ERROR_NONE == rc && (l = allocate(pdrv, c, sector, &way)))
+                memcpy(c->data[way][set_of(sector)], buffer, SECTOR_SIZE);
+        }
+    } else {
+        // Bulk read straight from the card, then overlay newer cached data
+        rc = sd_card_p->read_blocks(sd_card_p, buffer, sector, count);
+        for (uint w = 0; w < SECTOR_CACHE_WAYS && c->num_dirty; ++w)
+            for (uint s = 0; s < SECTOR_CACHE_SETS; ++s) {
+                l = &c->lines[w][s];
+                if (l->dirty && l->sector >= sector && l->sector < sector + count)
+                    memcpy(buffer + (l->sector - sector) * SECTOR_SIZE, c->data[w][s], SECTOR_SIZE);
+            }
+    }
+    if (SD_BLOCK_DEVICE_ERROR_NONE == rc) rc = flush_expired_nolock(pdrv, c);
+    cache_unlock(c);
+    return rc;
+}
+
+int sector_cache_write(BYTE pdrv, const uint8_t *buffer, uint64_t sector, uint32_t count) {
+    sd_card_t *sd_card_p = sd_get_by_num(pdrv);
+    sector_cache_t *c = cache_lock(pdrv);
+    if (!c) return sd_card_p->write_blocks(sd_card_p, buffer, sector, count);
+
+    int rc = SD_BLOCK_DEVICE_ERROR_NONE;
+    uint way;
+    cache_line_t *l;
+    if (1 == count) {
+        if ((l = lookup(c, sector, &way))) {
+            ++c->stats.write_hits;
+        } else {
+            ++c->stats.write_misses;
+            l = allocate(pdrv, c, sector, &way);
+        }
+        if (l) {
+            memcpy(c->data[way][set_of(sector)], buffer, SECTOR_SIZE);
+            mark_dirty(c, l);
+        } else {
+            rc = SD_BLOCK_DEVICE_ERROR_WRITE;
+        }
+    } else {
+        // Bulk write goes through; cached copies in the range are refreshed
+        rc = sd_card_p->write_blocks(sd_card_p, buffer, sector, count);
+        if (SD_BLOCK_DEVICE_ERROR_NONE == rc) {
+            for (uint w = 0; w < SECTOR_CACHE_WAYS; ++w)
+                for (uint s = 0; s < SECTOR_CACHE_SETS; ++s) {
+                    l = &c->lines[w][s];
+                    if (l->valid && l->sector >= sector && l->sector < sector + count) {
+                        memcpy(c->data[w][s], buffer + (l->sector - sector) * SECTOR_SIZE, SECTOR_SIZE);
+                        mark_clean(c, l);
+                    }
+                }
+        }
+    }
+    if (SD_BLOCK_DEVICE_ERROR_NONE == rc) rc = flush_expired_nolock(pdrv, c);
+    cache_unlock(c);
+    return rc;
+}
+
+int sector_cache_flush(BYTE pdrv) {
+    sector_cache_t *c = cache_lock(pdrv);
+    if (!c) return SD_BLOCK_DEVICE_ERROR_NONE;
+    int rc = flush_nolock(pdrv, c);
+    cache_unlock(c);
+    return rc;
+}
+
+int sector_cache_flush_expired(BYTE pdrv) {
+    sector_cache_t *c = cache_lock(pdrv);
+    if (!c) return SD_BLOCK_DEVICE_ERROR_NONE;
+    int rc = flush_expired_nolock(pdrv, c);
+    cache_unlock(c);
+    return rc;
+}
+
+void sector_cache_invalidate(BYTE pdrv) {
+    sector_cache_t *c = cache_lock(pdrv);
+    if (!c) return;
+    memset(c->lines, 0, sizeof c->lines);
+    c->num_dirty = 0;
+    cache_unlock(c);
+}
+
+void sector_cache_discard(BYTE pdrv, uint64_t start, uint64_t end) {
+    sector_cache_t *c = cache_lock(pdrv);
+    if (!c) return;
+    for (uint w = 0; w < SECTOR_CACHE_WAYS; ++w)
+        for (uint s = 0; s < SECTOR_CACHE_SETS; ++s) {
+            cache_line_t *l = &c->lines[w][s];
+            if (l->valid && l->sector >= start && l->sector <= end) {
+                mark_clean(c, l);
+                l->valid = false;
+            }
+        }
+    cache_unlock(c);
+}
+
+const sector_cache_stats_t *sector_cache_stats(BYTE pdrv) {
+    if (pdrv >= SECTOR_CACHE_DRIVES) return NULL;
+    return &caches[pdrv].stats;
+}
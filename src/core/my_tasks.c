@@ -1,4 +1,6 @@
 #include "core/my_tasks.h"
+#include "drivers/sdcard.h"
+#include "sector_cache.h"
 
 /**
  * @brief Inicializa as filas de comunicação entre as tarefas
@@ -30,3 +32,298 @@ void init_tasks(void) {
 }
 
 
+
+// Bloco entregue pela tarefa coletora à tarefa de gravação
+typedef struct
+{
+    uint8_t index; // Buffer ping-pong
+    UINT len;      // Bytes válidos
+    bool sync;     // Sincronizar após gravar
+    bool stop;     // Último bloco: fechar o arquivo
+} sd_writer_block_t;
+
+static struct
+{
+    StreamBufferHandle_t stream;  // Registros dos produtores
+    QueueHandle_t free_q;         // Índices de buffers livres
+    QueueHandle_t full_q;         // Blocos prontos para o cartão
+    SemaphoreHandle_t submit_mutex; // Um escritor por vez no stream buffer; criado uma vez e nunca liberado
+    SemaphoreHandle_t done;
+    volatile bool stopping;
+    sd_log_t log;
+    sd_writer_stats_t stats;
+} sd_writer;
+
+static uint8_t sd_writer_buf[2][SD_WRITER_BUFFER_SECTORS * FF_MAX_SS] __attribute__((aligned(4)));
+
+/**
+ * @brief Esvazia o stream buffer no buffer ping-pong livre
+ *
+ * Um buffer cheio vai para a tarefa de gravação enquanto o outro continua
+ * recebendo registros. Após SD_WRITER_IDLE_MS sem dados, o buffer parcial
+ * é entregue com pedido de sincronização.
+ * @param params Não utilizado
+ */
+static void sd_collect_task(void *params) {
+    uint8_t index;
+    UINT used = 0;
+    bool unsynced = false;
+    xQueueReceive(sd_writer.free_q, &index, portMAX_DELAY);
+    for (;;)
+    {
+        size_t n = xStreamBufferReceive(sd_writer.stream, sd_writer_buf[index] + used,
+                                        sizeof sd_writer_buf[0] - used, pdMS_TO_TICKS(SD_WRITER_IDLE_MS));
+        used += n;
+        bool stop = sd_writer.stopping && 0 == xStreamBufferBytesAvailable(sd_writer.stream);
+        bool idle = 0 == n && (used || unsynced);
+        if (used < sizeof sd_writer_buf[0] && !idle && !stop)
+            continue;
+        sd_writer_block_t block = {index, used, idle, stop};
+        xQueueSend(sd_writer.full_q, &block, portMAX_DELAY);
+        if (stop)
+            vTaskDelete(NULL);
+        unsynced = !idle;
+        used = 0;
+        xQueueReceive(sd_writer.free_q, &index, portMAX_DELAY);
+    }
+}
+
+/**
+ * @brief Dona do cartão: grava cada bloco como uma escrita multibloco no sd_log
+ * @param params Não utilizado
+ */
+static void sd_writer_task(void *params) {
+    sd_writer_block_t block;
+    for (;;)
+    {
+        xQueueReceive(sd_writer.full_q, &block, portMAX_DELAY);
+        if (block.len)
+        {
+            uint64_t start = time_us_64();
+            if (FR_OK != sd_log_append(&sd_writer.log, sd_writer_buf[block.index], block.len))
+                ++sd_writer.stats.errors;
+            uint32_t elapsed = (uint32_t)(time_us_64() - start);
+            if (elapsed > sd_writer.stats.max_write_us)
+                sd_writer.stats.max_write_us = elapsed;
+            ++sd_writer.stats.buffers_written;
+        }
+        if (block.sync || block.stop)
+        {
+            if (FR_OK != sd_log_sync(&sd_writer.log))
+                ++sd_writer.stats.errors;
+            ++sd_writer.stats.syncs;
+        }
+        xQueueSend(sd_writer.free_q, &block.index, portMAX_DELAY);
+        if (block.stop)
+        {
+            if (FR_OK != sd_log_close(&sd_writer.log))
+                ++sd_writer.stats.errors;
+            xSemaphoreGive(sd_writer.done);
+            vTaskDelete(NULL);
+        }
+    }
+}
+
+/**
+ * @brief Libera filas, semáforos e o stream buffer do gravador
+ *
+ * O submit_mutex fica: um produtor pode estar esperando por ele e, ao
+ * obtê-lo, encontra o stream buffer já liberado.
+ */
+static void sd_writer_free(void) {
+    if (sd_writer.stream)
+        vStreamBufferDelete(sd_writer.stream);
+    if (sd_writer.free_q)
+        vQueueDelete(sd_writer.free_q);
+    if (sd_writer.full_q)
+        vQueueDelete(sd_writer.full_q);
+    if (sd_writer.done)
+        vSemaphoreDelete(sd_writer.done);
+    sd_writer.stream = NULL;
+    sd_writer.free_q = sd_writer.full_q = NULL;
+    sd_writer.done = NULL;
+}
+
+/**
+ * @brief Inicia o gravador assíncrono do cartão SD
+ *
+ * A partir daqui somente as tarefas do gravador acessam o volume. Os
+ * registros são gravados em arquivos pré-alocados base.000, base.001, ...
+ * @param base Caminho dos arquivos sem extensão, por exemplo "0:/adc"
+ * @param file_size Bytes reservados por arquivo
+ * @return true se o arquivo foi aberto e as tarefas criadas
+ */
+bool sd_writer_start(const char *base, FSIZE_t file_size) {
+    myASSERT(!sd_writer.stream);
+    if (!sd_writer.submit_mutex)
+        sd_writer.submit_mutex = xSemaphoreCreateMutex();
+    if (!sd_writer.submit_mutex)
+        return false;
+    memset(&sd_writer.stats, 0, sizeof sd_writer.stats);
+    sd_writer.stopping = false;
+    sd_writer.stream = xStreamBufferCreate(SD_WRITER_STREAM_SIZE, sizeof sd_writer_buf[0]);
+    sd_writer.free_q = xQueueCreate(2, sizeof(uint8_t));
+    sd_writer.full_q = xQueueCreate(2, sizeof(sd_writer_block_t));
+    sd_writer.done = xSemaphoreCreateBinary();
+    if (!sd_writer.stream || !sd_writer.free_q || !sd_writer.full_q || !sd_writer.done)
+    {
+        sd_writer_free();
+        return false;
+    }
+    for (uint8_t i = 0; i < 2; ++i)
+        xQueueSend(sd_writer.free_q, &i, 0);
+    FRESULT fr = sd_log_open(&sd_writer.log, base, file_size);
+    if (FR_OK != fr)
+    {
+        printf("sd_log_open error: %s (%d)\n", FRESULT_str(fr), fr);
+        sd_writer_free();
+        return false;
+    }
+    if (pdPASS != xTaskCreate(sd_writer_task, "SD Writer", 1024, NULL, SD_WRITER_PRIORITY, NULL))
+    {
+        sd_log_close(&sd_writer.log);
+        sd_writer_free();
+        return false;
+    }
+    if (pdPASS != xTaskCreate(sd_collect_task, "SD Collect", 512, NULL, SD_WRITER_PRIORITY, NULL))
+    {
+        // Sem a coletora, o bloco final vem daqui: a tarefa de gravação fecha o arquivo e termina
+        sd_writer_block_t block = {0, 0, false, true};
+        xQueueReceive(sd_writer.free_q, &block.index, portMAX_DELAY);
+        xQueueSend(sd_writer.full_q, &block, portMAX_DELAY);
+        xSemaphoreTake(sd_writer.done, portMAX_DELAY);
+        sd_writer_free();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Enfileira um registro para gravação
+ *
+ * O registro entra inteiro ou é recusado: um envio parcial deixaria um
+ * registro cortado no arquivo. Tarefas de amostragem devem usar timeout 0
+ * para recusar em vez de bloquear quando o stream buffer está cheio.
+ * @param data Registro
+ * @param len Tamanho em bytes
+ * @param timeout Espera máxima pelo mutex e por espaço, em ticks
+ * @return len se o registro foi aceito, 0 caso contrário
+ */
+size_t sd_writer_submit(const void *data, size_t len, TickType_t timeout) {
+    if (!sd_writer.submit_mutex || !sd_writer.stream || sd_writer.stopping)
+        return 0;
+    TickType_t start = xTaskGetTickCount();
+    if (pdTRUE != xSemaphoreTake(sd_writer.submit_mutex, timeout))
+        return 0;
+    // sd_writer_stop pode ter começado (ou terminado) enquanto este produtor esperava
+    if (!sd_writer.stream || sd_writer.stopping)
+    {
+        xSemaphoreGive(sd_writer.submit_mutex);
+        return 0;
+    }
+    // Único escritor: o espaço só aumenta enquanto o mutex estiver com esta tarefa
+    bool fits = len <= SD_WRITER_STREAM_SIZE;
+    while (fits && xStreamBufferSpacesAvailable(sd_writer.stream) < len)
+    {
+        if (xTaskGetTickCount() - start >= timeout)
+            fits = false;
+        else
+            vTaskDelay(1);
+    }
+    size_t sent = fits ? xStreamBufferSend(sd_writer.stream, data, len, 0) : 0;
+    size_t used = SD_WRITER_STREAM_SIZE - xStreamBufferSpacesAvailable(sd_writer.stream);
+    sd_writer.stats.bytes_submitted += sent;
+    sd_writer.stats.bytes_dropped += len - sent;
+    if (used > sd_writer.stats.max_stream_used)
+        sd_writer.stats.max_stream_used = used;
+    xSemaphoreGive(sd_writer.submit_mutex);
+    return sent;
+}
+
+/**
+ * @brief Grava o que resta no stream buffer, fecha o arquivo e encerra as tarefas
+ *
+ * Se o tempo se esgotar, o encerramento continua: os registros seguem
+ * recusados e sd_writer_stop pode ser chamada de novo para aguardar o fim
+ * (o gravador só pode ser reiniciado depois disso).
+ * @param timeout Espera máxima, em ticks
+ * @return true se o gravador terminou sem erros
+ */
+bool sd_writer_stop(TickType_t timeout) {
+    if (!sd_writer.stream)
+        return false;
+    // Com o mutex, nenhum produtor está no meio de um envio
+    if (pdTRUE != xSemaphoreTake(sd_writer.submit_mutex, timeout))
+        return false;
+    sd_writer.stopping = true;
+    xSemaphoreGive(sd_writer.submit_mutex);
+    if (pdTRUE != xSemaphoreTake(sd_writer.done, timeout))
+        return false;
+    xSemaphoreTake(sd_writer.submit_mutex, portMAX_DELAY);
+    sd_writer_free();
+    xSemaphoreGive(sd_writer.submit_mutex);
+    return 0 == sd_writer.stats.errors;
+}
+
+/**
+ * @brief Contadores do gravador
+ * @return Ponteiro para os contadores
+ */
+const sd_writer_stats_t *sd_writer_stats(void) {
+    return &sd_writer.stats;
+}
+
+static struct
+{
+    SemaphoreHandle_t done;
+    volatile bool stopping;
+} sd_flusher;
+
+/**
+ * @brief Grava os setores sujos que passaram de SECTOR_CACHE_FLUSH_MS
+ *
+ * Sem esta tarefa, um setor sujo só sai do cache no próximo acesso ao
+ * volume, num CTRL_SYNC ou ao ser substituído.
+ * @param params Não utilizado
+ */
+static void sd_flusher_task(void *params) {
+    while (!sd_flusher.stopping)
+    {
+        vTaskDelay(pdMS_TO_TICKS(SD_FLUSHER_PERIOD_MS));
+        for (BYTE pdrv = 0; pdrv < SECTOR_CACHE_DRIVES; ++pdrv)
+            sector_cache_flush_expired(pdrv);
+    }
+    xSemaphoreGive(sd_flusher.done);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Inicia a tarefa que grava periodicamente os setores sujos antigos do cache
+ * @return true se a tarefa foi criada
+ */
+bool sd_flusher_start(void) {
+    myASSERT(!sd_flusher.done);
+    sd_flusher.stopping = false;
+    sd_flusher.done = xSemaphoreCreateBinary();
+    if (!sd_flusher.done)
+        return false;
+    if (pdPASS != xTaskCreate(sd_flusher_task, "SD Flusher", 512, NULL, SD_WRITER_PRIORITY, NULL))
+    {
+        vSemaphoreDelete(sd_flusher.done);
+        sd_flusher.done = NULL;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Encerra a tarefa de gravação periódica (espera o fim da verificação em andamento)
+ */
+void sd_flusher_stop(void) {
+    if (!sd_flusher.done)
+        return;
+    sd_flusher.stopping = true;
+    xSemaphoreTake(sd_flusher.done, portMAX_DELAY);
+    vSemaphoreDelete(sd_flusher.done);
+    sd_flusher.done = NULL;
+}
@@ -1,6 +1,156 @@
+#include <string.h>
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
 #include "display/ssd1306.h"
 #include "display/font.h"
 
+// Bytes I2C que abrem uma janela de envio: a transação de comandos (controle + 6 bytes),
+// o byte de controle dos dados e os dois endereços
+#define SSD1306_WINDOW_OVERHEAD 10
+#define SSD1306_WINDOW_WORDS 8 // Palavras de IC_DATA_CMD além dos dados, por janela
+#define SSD1306_BUS_RETRY_US 50 // Nova tentativa de trocar o TAR enquanto a FIFO esvazia
+
+// Display dono de cada canal de DMA. As interrupções chegam pela linha
+// DMA_IRQ_1 como tratador compartilhado, junto com o da matriz de LEDs; o
+// driver SD não pode registrar tratador exclusivo nessa linha
+// (set_spi_dma_irq_channel(true, false)), senão o pico-sdk entra em pânico
+static ssd1306_t *dma_displays[NUM_DMA_CHANNELS];
+
+// Um DMA por barramento I2C: o display dono da FIFO de transmissão, o canal
+// do último dono (a vez passa adiante a partir dele) e o alarme de nova tentativa
+static ssd1306_t *volatile bus_owner[2];
+static uint bus_last[2];
+static alarm_id_t bus_retry[2];
+
+/**
+ * @brief O controlador I2C terminou de transmitir: FIFO vazia e fora de transação
+ */
+static bool ssd1306_bus_idle(const ssd1306_t *ssd) {
+  uint32_t status = i2c_get_hw(ssd->i2c_port)->status;
+  return (status & I2C_IC_STATUS_TFE_BITS) && !(status & I2C_IC_STATUS_MST_ACTIVITY_BITS);
+}
+
+/**
+ * @brief Toma o barramento livre e dispara o buffer ativo do display
+ *
+ * TAR só pode ser alterado com o controlador desabilitado, o que descarta a
+ * FIFO: se outro endereço usou o barramento e ele ainda transmite, não
+ * espera e retorna false.
+ */
+static bool ssd1306_dma_start(ssd1306_t *ssd) {
+  uint bus = i2c_hw_index(ssd->i2c_port);
+  i2c_hw_t *hw = i2c_get_hw(ssd->i2c_port);
+  if (bus_owner[bus])
+    return false;
+  if ((hw->tar & I2C_IC_TAR_IC_TAR_BITS) != ssd->address) {
+    if (!ssd1306_bus_idle(ssd))
+      return false;
+    hw->enable = 0;
+    hw->tar = ssd->address;
+    hw->enable = 1;
+  }
+  bus_owner[bus] = ssd;
+  bus_last[bus] = ssd->dma_channel;
+  uint8_t slot = ssd->dma_active;
+  dma_channel_transfer_from_buffer_now(ssd->dma_channel, ssd->dma_buffer[slot], ssd->dma_len[slot]);
+  return true;
+}
+
+static int64_t ssd1306_bus_retry(alarm_id_t id, void *user_data);
+
+/**
+ * @brief Com o barramento livre, dispara o próximo display que aguarda por ele
+ *
+ * A vez segue a ordem dos canais a partir do último dono. Se o próximo não
+ * puder começar porque a FIFO ainda esvazia, um alarme tenta de novo; sem
+ * alarme livre, a tentativa fica para ssd1306_busy e ssd1306_send_data_async.
+ */
+static void ssd1306_bus_kick(uint bus) {
+  uint32_t irq = save_and_disable_interrupts();
+  for (uint k = 1; !bus_owner[bus] && k <= NUM_DMA_CHANNELS; ++k) {
+    ssd1306_t *next = dma_displays[(bus_last[bus] + k) % NUM_DMA_CHANNELS];
+    if (!next || SSD1306_DMA_IDLE == next->dma_active || i2c_hw_index(next->i2c_port) != bus)
+      continue;
+    if (!ssd1306_dma_start(next) && !bus_retry[bus]) {
+      alarm_id_t id = add_alarm_in_us(SSD1306_BUS_RETRY_US, ssd1306_bus_retry, (void *)(uintptr_t)bus, true);
+      bus_retry[bus] = id > 0 ? id : 0;
+    }
+    break;
+  }
+  restore_interrupts(irq);
+}
+
+/**
+ * @brief Alarme de nova tentativa: a FIFO do barramento pode ter esvaziado
+ */
+static int64_t ssd1306_bus_retry(alarm_id_t id, void *user_data) {
+  (void)id;
+  uint bus = (uint)(uintptr_t)user_data;
+  bus_retry[bus] = 0;
+  ssd1306_bus_kick(bus);
+  return 0;
+}
+
+/**
+ * @brief Término de um envio: libera o barramento, passa a vez e notifica
+ *
+ * O buffer enfileirado passa a ativo e espera a vez como os demais.
+ */
+static void __not_in_flash_func(ssd1306_dma_irq_handler)(void) {
+  for (uint8_t i = 0; i < count_of(dma_displays); ++i) {
+    ssd1306_t *ssd = dma_displays[i];
+    if (!ssd || !dma_channel_get_irq1_status(ssd->dma_channel))
+      continue;
+    dma_channel_acknowledge_irq1(ssd->dma_channel);
+    uint bus = i2c_hw_index(ssd->i2c_port);
+    bus_owner[bus] = NULL;
+    if (ssd->dma_queued) {
+      ssd->dma_queued = false;
+      ssd->dma_active ^= 1;
+    } else {
+      ssd->dma_active = SSD1306_DMA_IDLE;
+    }
+    ssd1306_bus_kick(bus);
+    if (ssd->on_flush)
+      ssd->on_flush(ssd, ssd->on_flush_ctx);
+  }
+}
+
+/**
+ * @brief Algum display do barramento tem envio pendente, ou a FIFO ainda transmite
+ */
+static bool ssd1306_bus_busy(const ssd1306_t *ssd) {
+  uint bus = i2c_hw_index(ssd->i2c_port);
+  ssd1306_bus_kick(bus);
+  for (uint i = 0; i < count_of(dma_displays); ++i) {
+    const ssd1306_t *d = dma_displays[i];
+    if (d && SSD1306_DMA_IDLE != d->dma_active && i2c_hw_index(d->i2c_port) == bus)
+      return true;
+  }
+  return !ssd1306_bus_idle(ssd);
+}
+
+/**
+ * @brief Configura o canal de DMA (16 bits por palavra, cadenciado pelo DREQ de transmissão I2C)
+ */
+static void ssd1306_dma_attach(ssd1306_t *ssd) {
+  static bool handler_installed;
+  dma_channel_config cfg = dma_channel_get_default_config(ssd->dma_channel);
+  channel_config_set_transfer_data_size(&cfg, DMA_SIZE_16);
+  channel_config_set_read_increment(&cfg, true);
+  channel_config_set_write_increment(&cfg, false);
+  channel_config_set_dreq(&cfg, i2c_get_dreq(ssd->i2c_port, true));
+  dma_channel_configure(ssd->dma_channel, &cfg, &i2c_get_hw(ssd->i2c_port)->data_cmd, NULL, 0, false);
+  dma_displays[ssd->dma_channel] = ssd;
+  dma_channel_set_irq1_enabled(ssd->dma_channel, true);
+  if (!handler_installed) {
+    irq_add_shared_handler(DMA_IRQ_1, ssd1306_dma_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_1, true);
+    handler_installed = true;
+  }
+}
+
 /**
  * @brief Inicializa o display OLED SSD1306
  * @param ssd Ponteiro para a estrutura do display
@@ -20,6 +170,34 @@ void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_v
   ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
   ssd->ram_buffer[0] = 0x40;
   ssd->port_buffer[0] = 0x80;
+  ssd->sent_buffer = calloc(ssd->bufsize - 1, sizeof(uint8_t));
+  // Pior caso: uma janela por página, cada uma com seus comandos
+  for (uint8_t i = 0; i < 2; ++i) {
+    ssd->dma_buffer[i] = calloc(ssd->bufsize - 1 + ssd->pages * SSD1306_WINDOW_WORDS, sizeof(uint16_t));
+    ssd->dma_len[i] = 0;
+  }
+  ssd->dma_active = SSD1306_DMA_IDLE;
+  ssd->dma_queued = false;
+  ssd->on_flush = NULL;
+  ssd->on_flush_ctx = NULL;
+  ssd->dma_channel = dma_claim_unused_channel(true);
+  ssd1306_dma_attach(ssd);
+  ssd1306_invalidate(ssd);
+}
+
+/**
+ * @brief Libera os buffers e o canal de DMA do display
+ * @param ssd Ponteiro para a estrutura do display
+ */
+void ssd1306_deinit(ssd1306_t *ssd) {
+  ssd1306_wait(ssd);
+  dma_channel_set_irq1_enabled(ssd->dma_channel, false);
+  dma_channel_unclaim(ssd->dma_channel);
+  dma_displays[ssd->dma_channel] = NULL;
+  free(ssd->ram_buffer);
+  free(ssd->sent_buffer);
+  free(ssd->dma_buffer[0]);
+  free(ssd->dma_buffer[1]);
 }
 
 /**
@@ -52,6 +230,7 @@ void ssd1306_config(ssd1306_t *ssd) {
   ssd1306_command(ssd, SET_CHARGE_PUMP);
   ssd1306_command(ssd, 0x14);
   ssd1306_command(ssd, SET_DISP | 0x01);
+  ssd1306_invalidate(ssd); // A RAM do painel tem conteúdo indefinido
 }
 
 /**
@@ -60,6 +239,9 @@ void ssd1306_config(ssd1306_t *ssd) {
  * @param command Comando a ser enviado
  */
 void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
+  // i2c_write_blocking reescreve o TAR: espera os envios de todos os displays do barramento
+  while (ssd1306_bus_busy(ssd))
+    tight_loop_contents();
   ssd->port_buffer[1] = command;
   i2c_write_blocking(
     ssd->i2c_port,
@@ -71,23 +253,196 @@ void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
 }
 
 /**
- * @brief Envia dados para o display OLED SSD1306
+ * @brief Marca uma região do buffer como alterada, para o próximo envio
+ * @param ssd Ponteiro para a estrutura do display
+ * @param x0 Primeira coluna
+ * @param y0 Primeira linha
+ * @param x1 Última coluna (inclusive)
+ * @param y1 Última linha (inclusive)
+ */
+void ssd1306_mark_dirty(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1) {
+  if (x1 >= ssd->width)
+    x1 = ssd->width - 1;
+  if (y1 >= ssd->height)
+    y1 = ssd->height - 1;
+  for (uint8_t page = y0 >> 3; page <= (y1 >> 3) && x0 <= x1; ++page) {
+    if (x0 < ssd->dirty_x0[page])
+      ssd->dirty_x0[page] = x0;
+    if (x1 > ssd->dirty_x1[page])
+      ssd->dirty_x1[page] = x1;
+  }
+}
+
+/**
+ * @brief Força o reenvio do quadro inteiro no próximo ssd1306_send_data
+ * @param ssd Ponteiro para a estrutura do display
+ */
+void ssd1306_invalidate(ssd1306_t *ssd) {
+  ssd->panel_synced = false;
+  for (uint8_t page = 0; page < ssd->pages; ++page) {
+    ssd->dirty_x0[page] = 0;
+    ssd->dirty_x1[page] = ssd->width - 1;
+  }
+}
+
+/**
+ * @brief Acrescenta ao buffer de envio uma janela de colunas x páginas (endereçamento vertical: coluna a coluna)
+ *
+ * Os seis bytes de endereçamento vão numa única transação de comandos, seguida
+ * da transação de dados; o bit STOP da última palavra de cada uma as separa.
+ * @param ssd Ponteiro para a estrutura do display
+ * @param out Buffer de palavras IC_DATA_CMD
+ * @param x0 Primeira coluna
+ * @param x1 Última coluna
+ * @param p0 Primeira página
+ * @param p1 Última página
+ * @return Palavras acrescentadas
+ */
+static size_t ssd1306_append_window(ssd1306_t *ssd, uint16_t *out, uint8_t x0, uint8_t x1, uint8_t p0, uint8_t p1) {
+  const uint8_t commands[] = {0x00, SET_COL_ADDR, x0, x1, SET_PAGE_ADDR, p0, p1};
+  size_t len = 0;
+  for (uint8_t i = 0; i < sizeof commands; ++i)
+    out[len++] = commands[i];
+  out[len - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+  out[len++] = 0x40;
+  for (uint16_t x = x0; x <= x1; ++x) {
+    const uint8_t *column = ssd->ram_buffer + 1 + x * ssd->pages;
+    for (uint8_t page = p0; page <= p1; ++page)
+      out[len++] = column[page];
+    memcpy(ssd->sent_buffer + x * ssd->pages + p0, column + p0, p1 - p0 + 1u);
+  }
+  out[len - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+  return len;
+}
+
+/**
+ * @brief Monta no buffer de envio apenas as regiões alteradas desde o último envio
+ *
+ * Em cada página, as colunas marcadas são comparadas com o que o painel já
+ * exibe (ou exibirá, ao fim dos envios pendentes); páginas vizinhas com
+ * alterações são enviadas numa só janela quando isso custa menos bytes I2C
+ * que uma janela a mais.
+ * @param ssd Ponteiro para a estrutura do display
+ * @param out Buffer de palavras IC_DATA_CMD
+ * @return Palavras a enviar (0: nada mudou)
+ */
+static size_t ssd1306_build_update(ssd1306_t *ssd, uint16_t *out) {
+  uint8_t x0[SSD1306_MAX_PAGES], x1[SSD1306_MAX_PAGES]; // Colunas a enviar por página
+  for (uint8_t page = 0; page < ssd->pages; ++page) {
+    int first = ssd->dirty_x0[page], last = ssd->dirty_x1[page];
+    if (ssd->panel_synced) {
+      while (first <= last && ssd->ram_buffer[1 + first * ssd->pages + page] ==
+                                  ssd->sent_buffer[first * ssd->pages + page])
+        first++;
+      while (last >= first && ssd->ram_buffer[1 + last * ssd->pages + page] ==
+                                  ssd->sent_buffer[last * ssd->pages + page])
+        last--;
+    }
+    x0[page] = first <= last ? first : 1;
+    x1[page] = first <= last ? last : 0;
+    ssd->dirty_x0[page] = UINT8_MAX;
+    ssd->dirty_x1[page] = 0;
+  }
+  size_t len = 0;
+  for (uint8_t p0 = 0; p0 < ssd->pages;) {
+    if (x0[p0] > x1[p0]) {
+      p0++;
+      continue;
+    }
+    uint8_t left = x0[p0], right = x1[p0], p1 = p0;
+    unsigned area = right - left + 1u;
+    while (p1 + 1 < ssd->pages && x0[p1 + 1] <= x1[p1 + 1]) {
+      uint8_t l = x0[p1 + 1] < left ? x0[p1 + 1] : left;
+      uint8_t r = x1[p1 + 1] > right ? x1[p1 + 1] : right;
+      unsigned merged = (r - l + 1u) * (p1 + 2u - p0);
+      if (merged > area + (x1[p1 + 1] - x0[p1 + 1] + 1u) + SSD1306_WINDOW_OVERHEAD)
+        break;
+      left = l;
+      right = r;
+      area = merged;
+      p1++;
+    }
+    len += ssd1306_append_window(ssd, out + len, left, right, p0, p1);
+    p0 = p1 + 1;
+  }
+  ssd->panel_synced = true;
+  return len;
+}
+
+/**
+ * @brief Inicia por DMA o envio das regiões alteradas, sem esperar a transmissão
+ *
+ * As alterações são copiadas para um dos dois buffers de envio, então o
+ * framebuffer pode ser redesenhado logo em seguida. Se um envio estiver em
+ * curso, este fica enfileirado e parte na interrupção de término do atual.
+ * Displays no mesmo barramento se revezam: um só DMA por vez alimenta a FIFO.
+ * @param ssd Ponteiro para a estrutura do display
+ * @return false se os dois buffers estiverem ocupados (as alterações ficam para a próxima chamada)
+ */
+bool ssd1306_send_data_async(ssd1306_t *ssd) {
+  if (ssd->dma_queued)
+    return false;
+  uint8_t active = ssd->dma_active;
+  uint8_t slot = SSD1306_DMA_IDLE == active ? 0 : active ^ 1;
+  size_t len = ssd1306_build_update(ssd, ssd->dma_buffer[slot]);
+  if (!len) {
+    if (SSD1306_DMA_IDLE == active && ssd->on_flush)
+      ssd->on_flush(ssd, ssd->on_flush_ctx);
+    return true;
+  }
+  ssd->dma_len[slot] = len;
+  uint32_t irq = save_and_disable_interrupts();
+  if (SSD1306_DMA_IDLE == ssd->dma_active)
+    ssd->dma_active = slot;
+  else
+    ssd->dma_queued = true;
+  restore_interrupts(irq);
+  ssd1306_bus_kick(i2c_hw_index(ssd->i2c_port));
+  return true;
+}
+
+/**
+ * @brief Há envio por DMA em curso ou enfileirado, ou bytes ainda na FIFO do I2C
+ *
+ * O fim do DMA só significa que a última palavra entrou na FIFO: até 16
+ * bytes e o STOP ainda estão por sair, e desabilitar o controlador (como
+ * i2c_write_blocking faz para escrever o TAR) os descartaria. Também passa
+ * a vez no barramento, se um display aguarda a FIFO esvaziar.
+ * @param ssd Ponteiro para a estrutura do display
+ */
+bool ssd1306_busy(const ssd1306_t *ssd) {
+  ssd1306_bus_kick(i2c_hw_index(ssd->i2c_port));
+  return SSD1306_DMA_IDLE != ssd->dma_active || !ssd1306_bus_idle(ssd);
+}
+
+/**
+ * @brief Aguarda o término dos envios por DMA e a transmissão da FIFO do I2C
+ * @param ssd Ponteiro para a estrutura do display
+ */
+void ssd1306_wait(const ssd1306_t *ssd) {
+  while (ssd1306_busy(ssd))
+    tight_loop_contents();
+}
+
+/**
+ * @brief Define a notificação de término do envio (chamada no contexto da interrupção do DMA)
+ * @param ssd Ponteiro para a estrutura do display
+ * @param cb Função chamada; NULL desativa
+ * @param ctx Contexto repassado a cb
+ */
+void ssd1306_set_flush_callback(ssd1306_t *ssd, ssd1306_flush_cb_t cb, void *ctx) {
+  ssd->on_flush = cb;
+  ssd->on_flush_ctx = ctx;
+}
+
+/**
+ * @brief Envia ao display apenas as regiões alteradas desde o último envio, aguardando a transmissão
  * @param ssd Ponteiro para a estrutura do display
  */
 void ssd1306_send_data(ssd1306_t *ssd) {
-  ssd1306_command(ssd, SET_COL_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->width - 1);
-  ssd1306_command(ssd, SET_PAGE_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->pages - 1);
-  i2c_write_blocking(
-    ssd->i2c_port,
-    ssd->address,
-    ssd->ram_buffer,
-    ssd->bufsize,
-    false
-  );
+  while (!ssd1306_send_data_async(ssd))
+    tight_loop_contents();
+  ssd1306_wait(ssd);
 }
 
 /**
@@ -98,26 +453,87 @@ void ssd1306_send_data(ssd1306_t *ssd) {
  * @param value Valor do pixel
  */
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
+  if (x >= ssd->width || y >= ssd->height)
+    return;
   uint16_t index = (y >> 3) + (x << 3) + 1;
   uint8_t pixel = (y & 0b111);
+  uint8_t page = y >> 3;
+  if (x < ssd->dirty_x0[page])
+    ssd->dirty_x0[page] = x;
+  if (x > ssd->dirty_x1[page])
+    ssd->dirty_x1[page] = x;
   if (value)
     ssd->ram_buffer[index] |= (1 << pixel);
   else
     ssd->ram_buffer[index] &= ~(1 << pixel);
 }
 
+/**
+ * @brief Endereço da coluna x no framebuffer: uma página (8 linhas) por byte
+ */
+static inline uint8_t *ssd1306_column(ssd1306_t *ssd, uint8_t x) {
+  return ssd->ram_buffer + 1 + x * ssd->pages;
+}
+
+/**
+ * @brief Lê uma coluna como palavra de 64 bits: o bit y é o pixel da linha y
+ *
+ * Vale para CPUs little-endian (RP2040 e o alvo nativo); no Cortex-M0+ cada
+ * operação vira duas sobre palavras de 32 bits.
+ */
+static inline uint64_t ssd1306_column_load(const ssd1306_t *ssd, const uint8_t *column) {
+  uint64_t bits = 0;
+  if (SSD1306_MAX_PAGES == ssd->pages)
+    memcpy(&bits, column, SSD1306_MAX_PAGES);
+  else
+    memcpy(&bits, column, ssd->pages);
+  return bits;
+}
+
+static inline void ssd1306_column_store(const ssd1306_t *ssd, uint8_t *column, uint64_t bits) {
+  if (SSD1306_MAX_PAGES == ssd->pages)
+    memcpy(column, &bits, SSD1306_MAX_PAGES);
+  else
+    memcpy(column, &bits, ssd->pages);
+}
+
+/**
+ * @brief Liga ou desliga as linhas y0..y1 das colunas x0..x1 (inclusive), já recortadas ao painel
+ *
+ * Dentro de uma página basta um byte mascarado por coluna; senão a coluna
+ * inteira é tratada como uma palavra.
+ */
+static void ssd1306_span(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y0, uint8_t y1, bool value) {
+  if (x1 >= ssd->width)
+    x1 = ssd->width - 1;
+  if (y1 >= ssd->height)
+    y1 = ssd->height - 1;
+  if (x0 > x1 || y0 > y1)
+    return;
+  ssd1306_mark_dirty(ssd, x0, y0, x1, y1);
+  uint8_t *column = ssd1306_column(ssd, x0);
+  if (y0 >> 3 == y1 >> 3) {
+    uint8_t mask = (uint8_t)((0xFFu >> (7 - (y1 & 7))) & (0xFFu << (y0 & 7)));
+    column += y0 >> 3;
+    for (uint8_t x = x0; x <= x1 && x >= x0; ++x, column += ssd->pages)
+      *column = value ? *column | mask : *column & ~mask;
+    return;
+  }
+  uint64_t mask = (~0ull >> (63 - y1)) & (~0ull << y0);
+  for (uint8_t x = x0; x <= x1 && x >= x0; ++x, column += ssd->pages) {
+    uint64_t bits = ssd1306_column_load(ssd, column);
+    ssd1306_column_store(ssd, column, value ? bits | mask : bits & ~mask);
+  }
+}
+
 /**
  * @brief Preenche o display OLED SSD1306
  * @param ssd Ponteiro para a estrutura do display
  * @param value Valor do pixel
  */
 void ssd1306_fill(ssd1306_t *ssd, bool value) {
-    // Itera por todas as posições do display
-    for (uint8_t y = 0; y < ssd->height; ++y) {
-        for (uint8_t x = 0; x < ssd->width; ++x) {
-            ssd1306_pixel(ssd, x, y, value);
-        }
-    }
+  memset(ssd->ram_buffer + 1, value ? 0xFF : 0x00, ssd->bufsize - 1);
+  ssd1306_mark_dirty(ssd, 0, 0, ssd->width - 1, ssd->height - 1);
 }
 
 /**
@@ -131,22 +547,20 @@ void ssd1306_fill(ssd1306_t *ssd, bool value) {
  * @param fill Preenche o retângulo
  */
 void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
-  for (uint8_t x = left; x < left + width; ++x) {
-    ssd1306_pixel(ssd, x, top, value);
-    ssd1306_pixel(ssd, x, top + height - 1, value);
-  }
-  for (uint8_t y = top; y < top + height; ++y) {
-    ssd1306_pixel(ssd, left, y, value);
-    ssd1306_pixel(ssd, left + width - 1, y, value);
-  }
-
+  if (!width || !height || left >= ssd->width || top >= ssd->height)
+    return;
+  uint8_t right = left + width - 1 < ssd->width ? left + width - 1 : ssd->width - 1;
+  uint8_t bottom = top + height - 1 < ssd->height ? top + height - 1 : ssd->height - 1;
   if (fill) {
-    for (uint8_t x = left + 1; x < left + width - 1; ++x) {
-      for (uint8_t y = top + 1; y < top + height - 1; ++y) {
-        ssd1306_pixel(ssd, x, y, value);
-      }
-    }
+    ssd1306_span(ssd, left, right, top, bottom, value);
+    return;
   }
+  ssd1306_span(ssd, left, right, top, top, value);
+  if (top + height - 1 < ssd->height)
+    ssd1306_span(ssd, left, right, bottom, bottom, value);
+  ssd1306_span(ssd, left, left, top, bottom, value);
+  if (left + width - 1 < ssd->width)
+    ssd1306_span(ssd, right, right, top, bottom, value);
 }
 
 /**
@@ -195,8 +609,7 @@ void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1
  * @param value Valor do pixel
  */
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value) {
-  for (uint8_t x = x0; x <= x1; ++x)
-    ssd1306_pixel(ssd, x, y, value);
+  ssd1306_span(ssd, x0, x1, y, y, value);
 }
 
 /**
@@ -208,28 +621,43 @@ void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value
  * @param value Valor do pixel
  */
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value) {
-  for (uint8_t y = y0; y <= y1; ++y)
-    ssd1306_pixel(ssd, x, y, value);
+  ssd1306_span(ssd, x, x, y0, y1, value);
+}
+
+/**
+ * @brief Glifo do caractere; fora da tabela, o de FONT_FALLBACK
+ */
+static inline uint8_t ssd1306_glyph_index(char c) {
+  unsigned char code = (unsigned char)c;
+  return (code < FONT_FIRST || code > FONT_LAST ? FONT_FALLBACK : code) - FONT_FIRST;
 }
 
 /**
  * @brief Desenha um caractere no display OLED SSD1306
+ *
+ * Os glifos já estão em colunas de 8 pixels, como o framebuffer: cada coluna
+ * é copiada inteira, num byte se y cai no início de uma página.
  * @param ssd Ponteiro para a estrutura do display
  * @param c Caractere a ser desenhado
  * @param x Posição x do caractere
  * @param y Posição y do caractere
  */
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y){
-  uint16_t index = (c - ' ') * 8;
-  char ver=c;
-  
-  for (uint8_t i = 0; i < 8; ++i)
-  {
-    uint8_t line = font[index + i];
-    for (uint8_t j = 0; j < 8; ++j)
-    {
-      ssd1306_pixel(ssd, x + i, y + j, line & (1 << j));
-    }
+  if (x >= ssd->width || y >= ssd->height)
+    return;
+  const uint8_t *glyph = &font[ssd1306_glyph_index(c) * 8];
+  uint8_t columns = ssd->width - x < 8 ? ssd->width - x : 8;
+  uint8_t *column = ssd1306_column(ssd, x);
+  ssd1306_mark_dirty(ssd, x, y, x + columns - 1, y + 7);
+  if (!(y & 7) && y + 8 <= ssd->height) {
+    for (uint8_t i = 0; i < columns; ++i, column += ssd->pages)
+      column[y >> 3] = glyph[i];
+    return;
+  }
+  uint64_t mask = 0xFFull << y;
+  for (uint8_t i = 0; i < columns; ++i, column += ssd->pages) {
+    uint64_t bits = ssd1306_column_load(ssd, column);
+    ssd1306_column_store(ssd, column, (bits & ~mask) | ((uint64_t)glyph[i] << y));
   }
 }
 
@@ -258,6 +686,163 @@ void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y)
   }
 }
 
+// Espalha 4 bits em 8, duplicando cada um (escala 2x na vertical)
+static const uint8_t ssd1306_nibble_double[16] = {
+  0x00, 0x03, 0x0C, 0x0F, 0x30, 0x33, 0x3C, 0x3F,
+  0xC0, 0xC3, 0xCC, 0xCF, 0xF0, 0xF3, 0xFC, 0xFF,
+};
+
+/**
+ * @brief Colunas de um caractere no formato de texto pedido
+ * @param c Caractere
+ * @param flags SSD1306_TEXT_*
+ * @param out Colunas (até 16 + 2 de espaço)
+ * @return Número de colunas
+ */
+static uint8_t ssd1306_glyph_columns(char c, uint8_t flags, uint16_t *out) {
+  uint8_t index = ssd1306_glyph_index(c);
+  const uint8_t *glyph = &font[index * 8];
+  uint8_t first = 0, width = 8, n = 0;
+  if (flags & SSD1306_TEXT_PROPORTIONAL) {
+    first = font_extent[index] >> 4;
+    width = font_extent[index] & 0x0F;
+  }
+  for (uint8_t i = first; i < first + width; ++i) {
+    uint8_t bits = i < 8 ? glyph[i] : 0;
+    if (flags & SSD1306_TEXT_SCALE2) {
+      uint16_t tall = ssd1306_nibble_double[bits & 0x0F] | ssd1306_nibble_double[bits >> 4] << 8;
+      out[n++] = tall;
+      out[n++] = tall;
+    } else {
+      out[n++] = bits;
+    }
+  }
+  if (flags & SSD1306_TEXT_PROPORTIONAL) {
+    out[n++] = 0;
+    if (flags & SSD1306_TEXT_SCALE2)
+      out[n++] = 0;
+  }
+  return n;
+}
+
+/**
+ * @brief Copia colunas de texto para o buffer, sobrescrevendo a faixa de linhas y..y + height - 1
+ */
+static void ssd1306_blit_columns(ssd1306_t *ssd, const uint16_t *columns, uint8_t n, uint8_t x, uint8_t y,
+                                 uint8_t height) {
+  if (x >= ssd->width || y >= ssd->height || !n)
+    return;
+  if (n > ssd->width - x)
+    n = ssd->width - x;
+  ssd1306_mark_dirty(ssd, x, y, x + n - 1, y + height - 1);
+  uint8_t *column = ssd1306_column(ssd, x);
+  if (!(y & 7) && y + height <= ssd->height) {
+    uint8_t page = y >> 3;
+    if (8 == height) {
+      for (uint8_t i = 0; i < n; ++i, column += ssd->pages)
+        column[page] = (uint8_t)columns[i];
+      return;
+    }
+    for (uint8_t i = 0; i < n; ++i, column += ssd->pages) {
+      column[page] = (uint8_t)columns[i];
+      column[page + 1] = (uint8_t)(columns[i] >> 8);
+    }
+    return;
+  }
+  uint64_t mask = ((1ull << height) - 1) << y;
+  for (uint8_t i = 0; i < n; ++i, column += ssd->pages) {
+    uint64_t bits = ssd1306_column_load(ssd, column);
+    ssd1306_column_store(ssd, column, (bits & ~mask) | ((uint64_t)columns[i] << y));
+  }
+}
+
+/**
+ * @brief Desenha um bitmap de 8 linhas em colunas (bit j = linha j), como os glifos da fonte
+ * @param ssd Ponteiro para a estrutura do display
+ * @param columns Colunas do bitmap
+ * @param n Número de colunas
+ * @param x Posição x do bitmap
+ * @param y Posição y do bitmap
+ */
+void ssd1306_draw_bitmap(ssd1306_t *ssd, const uint8_t *columns, uint8_t n, uint8_t x, uint8_t y) {
+  uint16_t chunk[16];
+  while (n && x < ssd->width) {
+    uint8_t count = n < count_of(chunk) ? n : count_of(chunk);
+    for (uint8_t i = 0; i < count; ++i)
+      chunk[i] = columns[i];
+    ssd1306_blit_columns(ssd, chunk, count, x, y, 8);
+    columns += count;
+    n -= count;
+    x = x + count < ssd->width ? x + count : ssd->width;
+  }
+}
+
+/**
+ * @brief Desenha um texto numa única linha, recortado na borda direita
+ * @param ssd Ponteiro para a estrutura do display
+ * @param str Texto
+ * @param x Posição x do texto
+ * @param y Posição y do texto
+ * @param flags SSD1306_TEXT_PROPORTIONAL e/ou SSD1306_TEXT_SCALE2 (0: grade fixa de 8 colunas)
+ * @return Coluna seguinte ao texto
+ */
+uint8_t ssd1306_draw_text(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y, uint8_t flags) {
+  uint16_t columns[18];
+  uint8_t height = flags & SSD1306_TEXT_SCALE2 ? 16 : 8;
+  for (; *str && x < ssd->width; ++str) {
+    uint8_t n = ssd1306_glyph_columns(*str, flags, columns);
+    ssd1306_blit_columns(ssd, columns, n, x, y, height);
+    x = x + n < ssd->width ? x + n : ssd->width;
+  }
+  return x;
+}
+
+/**
+ * @brief Largura de um texto em colunas
+ * @param str Texto
+ * @param flags SSD1306_TEXT_*
+ */
+uint8_t ssd1306_text_width(const char *str, uint8_t flags) {
+  unsigned width = 0;
+  for (; *str; ++str) {
+    unsigned glyph = flags & SSD1306_TEXT_PROPORTIONAL ? (font_extent[ssd1306_glyph_index(*str)] & 0x0F) + 1u : 8u;
+    width += flags & SSD1306_TEXT_SCALE2 ? 2u * glyph : glyph;
+  }
+  return width < UINT8_MAX ? width : UINT8_MAX;
+}
+
+/**
+ * @brief Pré-renderiza um texto em colunas, para copiar ao buffer sem consultar a fonte
+ * @param text Texto renderizado
+ * @param str Texto
+ * @param flags SSD1306_TEXT_*
+ * @return Largura em colunas (recortada em SSD1306_TEXT_MAX_COLUMNS)
+ */
+uint8_t ssd1306_text_render(ssd1306_text_t *text, const char *str, uint8_t flags) {
+  uint16_t columns[18];
+  text->width = 0;
+  text->height = flags & SSD1306_TEXT_SCALE2 ? 16 : 8;
+  for (; *str && text->width < SSD1306_TEXT_MAX_COLUMNS; ++str) {
+    uint8_t n = ssd1306_glyph_columns(*str, flags, columns);
+    if (n > SSD1306_TEXT_MAX_COLUMNS - text->width)
+      n = SSD1306_TEXT_MAX_COLUMNS - text->width;
+    memcpy(text->columns + text->width, columns, n * sizeof columns[0]);
+    text->width += n;
+  }
+  return text->width;
+}
+
+/**
+ * @brief Copia um texto pré-renderizado para o buffer
+ * @param ssd Ponteiro para a estrutura do display
+ * @param text Texto renderizado por ssd1306_text_render
+ * @param x Posição x do texto
+ * @param y Posição y do texto
+ */
+void ssd1306_draw_text_cached(ssd1306_t *ssd, const ssd1306_text_t *text, uint8_t x, uint8_t y) {
+  ssd1306_blit_columns(ssd, text->columns, text->width, x, y, text->height);
+}
+
 /**
  * @brief Inicializa o display OLED SSD1306
  * @param ssd Ponteiro para a estrutura do display
@@ -283,13 +868,23 @@ void ssd1306_clear(ssd1306_t *ssd) {
   ssd1306_send_data(ssd);   // Envia o buffer para o display
 }
 
+/**
+ * @brief Desenha o cabeçalho das telas a partir do texto pré-renderizado na primeira chamada
+ */
+static void ssd1306_draw_header(ssd1306_t *ssd) {
+  static ssd1306_text_t header;
+  if (!header.width)
+    ssd1306_text_render(&header, "CEPEDI   TIC37", 0);
+  ssd1306_draw_text_cached(ssd, &header, 8, 10);
+}
+
 /**
  * @brief Inicia a exibição da tela de início
  * @param ssd Ponteiro para a estrutura do display
  */
 void start_display(ssd1306_t *ssd){
   ssd1306_fill(ssd, false); // Limpa o display
-  ssd1306_draw_string(ssd, "CEPEDI   TIC37", 8, 10); // Desenha uma string
+  ssd1306_draw_header(ssd); // Desenha o cabeçalho
   ssd1306_draw_string(ssd, "Estabelecendo", 12, 30); // Desenha uma string
   ssd1306_draw_string(ssd, "Conexao", 33, 48); // Desenha uma string      
   ssd1306_send_data(ssd); // Atualiza o display
@@ -303,7 +898,7 @@ void start_display(ssd1306_t *ssd){
  */
 void status_display(ssd1306_t *ssd, const char *string1, const char *string2){
   ssd1306_fill(ssd, false); // Limpa o display
-  ssd1306_draw_string(ssd, "CEPEDI   TIC37", 8, 10); // Desenha uma string
+  ssd1306_draw_header(ssd); // Desenha o cabeçalho
   ssd1306_draw_string(ssd, string1, 12, 30); // Desenha uma string
   if(string2 != NULL)
     ssd1306_draw_string(ssd, string2, 17, 48); // Desenha uma string      
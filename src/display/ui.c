@@ -0,0 +1,315 @@
+#include <string.h>
+#include "display/ui.h"
+
+/**
+ * @brief Largura fixa, definida na criação do widget
+ */
+static uint8_t ui_fixed_width(ui_widget_t *w) {
+  return w->width;
+}
+
+/**
+ * @brief Copia o texto associado; muda se for diferente do último exibido
+ */
+static bool ui_label_update(ui_widget_t *w) {
+  ui_label_t *label = (ui_label_t *)w;
+  const char *text = label->text ? label->text : "";
+  if (0 == strncmp(text, label->shown, UI_LABEL_MAX))
+    return false;
+  strncpy(label->shown, text, UI_LABEL_MAX);
+  label->shown[UI_LABEL_MAX] = '\0';
+  return true;
+}
+
+static uint8_t ui_label_measure(ui_widget_t *w) {
+  ui_label_t *label = (ui_label_t *)w;
+  return ssd1306_text_width(label->shown, label->flags);
+}
+
+static void ui_label_draw(ui_widget_t *w, ssd1306_t *ssd) {
+  ui_label_t *label = (ui_label_t *)w;
+  ssd1306_draw_text(ssd, label->shown, w->x, w->y, label->flags);
+}
+
+static const ui_widget_class_t ui_label_class = {ui_label_measure, ui_label_update, ui_label_draw};
+
+/**
+ * @brief Colunas preenchidas da barra para o valor atual
+ */
+static bool ui_bar_update(ui_widget_t *w) {
+  ui_bar_t *bar = (ui_bar_t *)w;
+  int32_t value = *bar->value < bar->min ? bar->min : *bar->value > bar->max ? bar->max : *bar->value;
+  int32_t inner = w->width > 2 ? w->width - 2 : 0;
+  uint8_t fill = bar->max > bar->min ? (uint8_t)((int64_t)(value - bar->min) * inner / (bar->max - bar->min)) : 0;
+  if (fill == bar->shown)
+    return false;
+  bar->shown = fill;
+  return true;
+}
+
+static void ui_bar_draw(ui_widget_t *w, ssd1306_t *ssd) {
+  ui_bar_t *bar = (ui_bar_t *)w;
+  ssd1306_rect(ssd, w->y, w->x, w->width, w->height, true, false);
+  if (bar->shown && w->height > 2)
+    ssd1306_rect(ssd, w->y + 1, w->x + 1, bar->shown, w->height - 2, true, true);
+}
+
+static const ui_widget_class_t ui_bar_class = {ui_fixed_width, ui_bar_update, ui_bar_draw};
+
+static bool ui_sparkline_update(ui_widget_t *w) {
+  ui_sparkline_t *spark = (ui_sparkline_t *)w;
+  bool changed = spark->changed;
+  spark->changed = false;
+  return changed;
+}
+
+/**
+ * @brief Linha da amostra no gráfico (topo = max)
+ */
+static uint8_t ui_sparkline_row(const ui_sparkline_t *spark, int16_t sample) {
+  const ui_widget_t *w = &spark->base;
+  int32_t value = sample < spark->min ? spark->min : sample > spark->max ? spark->max : sample;
+  int32_t span = spark->max > spark->min ? spark->max - spark->min : 1;
+  return w->y + w->height - 1 - (uint8_t)((value - spark->min) * (w->height - 1) / span);
+}
+
+static void ui_sparkline_draw(ui_widget_t *w, ssd1306_t *ssd) {
+  ui_sparkline_t *spark = (ui_sparkline_t *)w;
+  uint8_t n = spark->count < w->width ? spark->count : w->width;
+  uint8_t x = w->x + w->width - n;
+  uint8_t prev = 0;
+  for (uint8_t i = 0; i < n; ++i, ++x) {
+    // Mais antiga primeiro: as n últimas amostras do anel
+    uint8_t slot = (spark->head + UI_SPARKLINE_MAX - n + i) % UI_SPARKLINE_MAX;
+    uint8_t row = ui_sparkline_row(spark, spark->samples[slot]);
+    if (!i)
+      prev = row;
+    ssd1306_vline(ssd, x, row < prev ? row : prev, row < prev ? prev : row, true);
+    prev = row;
+  }
+}
+
+static const ui_widget_class_t ui_sparkline_class = {ui_fixed_width, ui_sparkline_update, ui_sparkline_draw};
+
+static bool ui_icon_update(ui_widget_t *w) {
+  ui_icon_t *icon = (ui_icon_t *)w;
+  uint8_t index = *icon->index < icon->count ? *icon->index : 0;
+  if (index == icon->shown)
+    return false;
+  icon->shown = index;
+  return true;
+}
+
+static void ui_icon_draw(ui_widget_t *w, ssd1306_t *ssd) {
+  ui_icon_t *icon = (ui_icon_t *)w;
+  ssd1306_draw_bitmap(ssd, icon->bitmaps[icon->shown], 8, w->x, w->y);
+}
+
+static const ui_widget_class_t ui_icon_class = {ui_fixed_width, ui_icon_update, ui_icon_draw};
+
+/**
+ * @brief Inicializa a base de um widget, ainda não desenhado
+ */
+static void ui_widget_init(ui_widget_t *w, const ui_widget_class_t *cls, uint8_t width, uint8_t height) {
+  memset(w, 0, sizeof *w);
+  w->cls = cls;
+  w->width = width;
+  w->height = height;
+  w->redraw = true;
+}
+
+/**
+ * @brief Rótulo associado a um texto da aplicação, relido a cada renderização
+ * @param label Rótulo
+ * @param text Texto (até UI_LABEL_MAX caracteres são exibidos)
+ * @param flags SSD1306_TEXT_*
+ */
+void ui_label_init(ui_label_t *label, const char *text, uint8_t flags) {
+  ui_widget_init(&label->base, &ui_label_class, 0, flags & SSD1306_TEXT_SCALE2 ? 16 : 8);
+  label->text = text;
+  label->flags = flags;
+  label->shown[0] = '\0';
+  ui_label_update(&label->base);
+  label->base.width = ui_label_measure(&label->base);
+}
+
+/**
+ * @brief Barra associada a um valor da aplicação
+ * @param bar Barra
+ * @param value Valor exibido
+ * @param min Valor da barra vazia
+ * @param max Valor da barra cheia
+ * @param width Largura, com a moldura
+ * @param height Altura, com a moldura
+ */
+void ui_bar_init(ui_bar_t *bar, const int32_t *value, int32_t min, int32_t max, uint8_t width, uint8_t height) {
+  ui_widget_init(&bar->base, &ui_bar_class, width, height);
+  bar->value = value;
+  bar->min = min;
+  bar->max = max;
+  bar->shown = 0;
+  ui_bar_update(&bar->base);
+}
+
+/**
+ * @brief Gráfico de linha vazio
+ * @param spark Gráfico
+ * @param min Valor na base
+ * @param max Valor no topo
+ * @param width Largura (uma amostra por coluna, até UI_SPARKLINE_MAX)
+ * @param height Altura
+ */
+void ui_sparkline_init(ui_sparkline_t *spark, int16_t min, int16_t max, uint8_t width, uint8_t height) {
+  ui_widget_init(&spark->base, &ui_sparkline_class, width < UI_SPARKLINE_MAX ? width : UI_SPARKLINE_MAX, height);
+  spark->head = spark->count = 0;
+  spark->min = min;
+  spark->max = max;
+  spark->changed = false;
+}
+
+/**
+ * @brief Acrescenta uma amostra ao gráfico, descartando a mais antiga se cheio
+ * @param spark Gráfico
+ * @param sample Amostra
+ */
+void ui_sparkline_push(ui_sparkline_t *spark, int16_t sample) {
+  spark->samples[spark->head] = sample;
+  spark->head = (spark->head + 1) % UI_SPARKLINE_MAX;
+  if (spark->count < UI_SPARKLINE_MAX)
+    spark->count++;
+  spark->changed = true;
+}
+
+/**
+ * @brief Ícone 8x8 associado a um índice da aplicação
+ * @param icon Ícone
+ * @param bitmaps Ícones em colunas
+ * @param count Número de ícones
+ * @param index Ícone exibido (fora da faixa: o primeiro)
+ */
+void ui_icon_init(ui_icon_t *icon, const uint8_t (*bitmaps)[8], uint8_t count, const uint8_t *index) {
+  ui_widget_init(&icon->base, &ui_icon_class, 8, 8);
+  icon->bitmaps = bitmaps;
+  icon->count = count;
+  icon->index = index;
+  icon->shown = 0;
+  ui_icon_update(&icon->base);
+}
+
+/**
+ * @brief Inicializa uma tela vazia
+ * @param screen Tela
+ * @param x Coluna do canto superior esquerdo
+ * @param y Linha do canto superior esquerdo
+ */
+void ui_screen_init(ui_screen_t *screen, uint8_t x, uint8_t y) {
+  screen->first = screen->last = NULL;
+  screen->x = x;
+  screen->y = y;
+  screen->layout_dirty = true;
+}
+
+/**
+ * @brief Acrescenta um widget ao fim da tela
+ * @param screen Tela
+ * @param w Widget (a tela guarda o ponteiro)
+ * @param row_break Começa uma nova linha
+ */
+void ui_screen_add(ui_screen_t *screen, ui_widget_t *w, bool row_break) {
+  w->next = NULL;
+  w->row_break = row_break;
+  if (screen->last)
+    screen->last->next = w;
+  else
+    screen->first = w;
+  screen->last = w;
+  screen->layout_dirty = true;
+}
+
+/**
+ * @brief Força o redesenho de todos os widgets (por exemplo, após limpar o display)
+ * @param screen Tela
+ */
+void ui_invalidate(ui_screen_t *screen) {
+  for (ui_widget_t *w = screen->first; w; w = w->next) {
+    w->redraw = true;
+    w->drawn_width = 0;
+  }
+}
+
+/**
+ * @brief Posiciona os widgets em linhas; os que mudam de lugar ou tamanho são redesenhados
+ */
+static void ui_layout(ui_screen_t *screen) {
+  uint8_t x = screen->x, y = screen->y, row_height = 0;
+  for (ui_widget_t *w = screen->first; w; w = w->next) {
+    if (w->row_break && w != screen->first) {
+      x = screen->x;
+      y += row_height + UI_SPACING;
+      row_height = 0;
+    }
+    w->x = x;
+    w->y = y;
+    w->width = w->cls->measure(w);
+    if (w->x != w->drawn_x || w->y != w->drawn_y || w->width != w->drawn_width || w->height != w->drawn_height)
+      w->redraw = true;
+    x += w->width + UI_SPACING;
+    if (w->height > row_height)
+      row_height = w->height;
+  }
+  screen->layout_dirty = false;
+}
+
+/**
+ * @brief Os retângulos se sobrepõem
+ */
+static bool ui_overlap(uint8_t ax, uint8_t ay, uint8_t aw, uint8_t ah, uint8_t bx, uint8_t by, uint8_t bw, uint8_t bh) {
+  return aw && ah && bw && bh && ax < bx + bw && bx < ax + aw && ay < by + bh && by < ay + ah;
+}
+
+/**
+ * @brief Redesenha no framebuffer só os widgets cujo valor, posição ou tamanho mudou
+ *
+ * Os widgets apagam e desenham apenas os próprios retângulos, e as primitivas
+ * marcam essas regiões para o próximo ssd1306_send_data(_async).
+ * @param screen Tela
+ * @param ssd Ponteiro para a estrutura do display
+ * @return Widgets redesenhados
+ */
+uint8_t ui_render(ui_screen_t *screen, ssd1306_t *ssd) {
+  for (ui_widget_t *w = screen->first; w; w = w->next) {
+    if (!w->cls->update(w))
+      continue;
+    w->redraw = true;
+    if (w->cls->measure(w) != w->width)
+      screen->layout_dirty = true;
+  }
+  if (screen->layout_dirty)
+    ui_layout(screen);
+
+  // Apaga onde os widgets alterados estavam; quem estiver por baixo também é redesenhado
+  for (ui_widget_t *w = screen->first; w; w = w->next) {
+    if (!w->redraw || !w->drawn_width)
+      continue;
+    ssd1306_rect(ssd, w->drawn_y, w->drawn_x, w->drawn_width, w->drawn_height, false, true);
+    for (ui_widget_t *o = screen->first; o; o = o->next)
+      if (!o->redraw && ui_overlap(w->drawn_x, w->drawn_y, w->drawn_width, w->drawn_height, o->x, o->y, o->width,
+                                   o->height))
+        o->redraw = true;
+  }
+
+  uint8_t drawn = 0;
+  for (ui_widget_t *w = screen->first; w; w = w->next) {
+    if (!w->redraw)
+      continue;
+    ssd1306_rect(ssd, w->y, w->x, w->width, w->height, false, true);
+    w->cls->draw(w, ssd);
+    w->drawn_x = w->x;
+    w->drawn_y = w->y;
+    w->drawn_width = w->width;
+    w->drawn_height = w->height;
+    w->redraw = false;
+    drawn++;
+  }
+  return drawn;
+}
@@ -1,20 +1,144 @@
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
 #include "drivers/matrix.h"
 
+#define MATRIX_WORD_US 30 // 24 bits a 800 kHz
+#define MATRIX_FIFO_WORDS 8 // FIFO de transmissão unida (PIO_FIFO_JOIN_TX)
+// Tempo para esvaziar a FIFO e o registrador de deslocamento depois do fim do DMA
+#define MATRIX_FIFO_DRAIN_US ((MATRIX_FIFO_WORDS + 1) * MATRIX_WORD_US)
+
 //Cores 
-const RGB RED = {0.1, 0, 0};
-const RGB GREEN = {0, 0.1, 0};
-const RGB BLUE = {0, 0, 0.1};
-const RGB YELLOW = {0.1, 0.1, 0};
-const RGB CYAN = {0, 0.1, 0.1};
-const RGB MAGENTA = {0.1, 0, 0.1};
-const RGB WHITE = {0.1, 0.1, 0.1};
-const RGB BLACK = {0, 0, 0};
+const GRB RED = {0, 255, 0};
+const GRB GREEN = {255, 0, 0};
+const GRB BLUE = {0, 0, 255};
+const GRB YELLOW = {255, 255, 0};
+const GRB CYAN = {255, 0, 255};
+const GRB MAGENTA = {0, 255, 255};
+const GRB WHITE = {255, 255, 255};
+const GRB BLACK = {0, 0, 0};
 
 PIO pio; //Variável para armazenar a configuração da PIO
 uint sm; //Variável para armazenar o estado da máquina
 
+// Correção de gama 2.2: round((i / 255)^2.2 * 255)
+static const uint8_t matrix_gamma[256] = {
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,
+      3,   3,   3,   3,   3,   4,   4,   4,   4,   5,   5,   5,   5,   6,   6,   6,
+      6,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,  10,  11,  11,  11,  12,
+     12,  13,  13,  13,  14,  14,  15,  15,  16,  16,  17,  17,  18,  18,  19,  19,
+     20,  20,  21,  22,  22,  23,  23,  24,  25,  25,  26,  26,  27,  28,  28,  29,
+     30,  30,  31,  32,  33,  33,  34,  35,  35,  36,  37,  38,  39,  39,  40,  41,
+     42,  43,  43,  44,  45,  46,  47,  48,  49,  49,  50,  51,  52,  53,  54,  55,
+     56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,  67,  68,  69,  70,  71,
+     73,  74,  75,  76,  77,  78,  79,  81,  82,  83,  84,  85,  87,  88,  89,  90,
+     91,  93,  94,  95,  97,  98,  99, 100, 102, 103, 105, 106, 107, 109, 110, 111,
+    113, 114, 116, 117, 119, 120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135,
+    137, 138, 140, 141, 143, 145, 146, 148, 149, 151, 153, 154, 156, 158, 159, 161,
+    163, 165, 166, 168, 170, 172, 173, 175, 177, 179, 181, 182, 184, 186, 188, 190,
+    192, 194, 196, 197, 199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221,
+    223, 225, 227, 229, 231, 234, 236, 238, 240, 242, 244, 246, 248, 251, 253, 255,
+};
+
+static uint8_t matrix_brightness = MATRIX_BRIGHTNESS; // Brilho global
+static uint8_t matrix_lut[256]; // Gama e brilho combinados: intensidade da cor -> byte enviado
+static bool matrix_lut_ready; // Tabela calculada para o brilho atual
+
+// Envio por DMA: um buffer em envio e outro livre ou enfileirado. As
+// interrupções chegam pela linha DMA_IRQ_1 (compartilhada com o display),
+// e o fim do latch é um alarme de MATRIX_RESET_US.
+#define MATRIX_DMA_IDLE 0xFF
+
+static uint32_t matrix_dma_buffer[2][NUM_PIXELS]; // Palavras do PIO de cada buffer
+static int matrix_dma_channel = -1; // Canal reservado (-1: envio bloqueante)
+static volatile uint8_t matrix_dma_active = MATRIX_DMA_IDLE; // Buffer em envio ou aguardando o latch
+static volatile bool matrix_dma_queued; // O outro buffer aguarda o fim do atual
+static volatile uint64_t matrix_ready_us; // Sem alarme livre, fim do latch do buffer ativo (0: não há)
+static matrix_done_cb_t matrix_on_done; // Notificação de quadro exibido
+static void *matrix_on_done_ctx;
+
+/**
+ * @brief A máquina de estados é a da matriz e o envio dela é feito por DMA
+ */
+static bool matrix_dma_owns(PIO p, uint s) {
+    return matrix_dma_channel >= 0 && p == pio && s == sm;
+}
+
+/**
+ * @brief Dispara o envio de um buffer para a FIFO da máquina de estados
+ */
+static void matrix_dma_start(uint8_t slot) {
+    matrix_dma_active = slot;
+    dma_channel_transfer_from_buffer_now(matrix_dma_channel, matrix_dma_buffer[slot], NUM_PIXELS);
+}
+
+/**
+ * @brief Fim do latch: o quadro está exibido; dispara o enfileirado e notifica
+ */
+static int64_t matrix_latch_done(alarm_id_t id, void *user_data) {
+    (void)id;
+    (void)user_data;
+    if (matrix_dma_queued) {
+        matrix_dma_queued = false;
+        matrix_dma_start(matrix_dma_active ^ 1);
+    } else {
+        matrix_dma_active = MATRIX_DMA_IDLE;
+    }
+    if (matrix_on_done)
+        matrix_on_done(matrix_on_done_ctx);
+    return 0;
+}
+
+/**
+ * @brief Término do DMA: as últimas palavras ainda estão na FIFO e no registrador
+ * de deslocamento, então o latch conta a partir daqui com folga
+ *
+ * Sem alarme livre, o prazo fica em matrix_ready_us e o latch termina na
+ * próxima chamada de matrix_submit ou matrix_busy depois dele.
+ */
+static void __not_in_flash_func(matrix_dma_irq_handler)(void) {
+    if (matrix_dma_channel < 0 || !dma_channel_get_irq1_status(matrix_dma_channel))
+        return;
+    dma_channel_acknowledge_irq1(matrix_dma_channel);
+    if (add_alarm_in_us(MATRIX_FIFO_DRAIN_US + MATRIX_RESET_US, matrix_latch_done, NULL, true) < 0)
+        matrix_ready_us = time_us_64() + MATRIX_FIFO_DRAIN_US + MATRIX_RESET_US;
+}
+
+/**
+ * @brief Encerra o latch registrado sem alarme, se o prazo já passou
+ */
+static void matrix_latch_poll(void) {
+    uint32_t irq = save_and_disable_interrupts();
+    if (matrix_ready_us && time_us_64() >= matrix_ready_us) {
+        matrix_ready_us = 0;
+        matrix_latch_done(0, NULL);
+    }
+    restore_interrupts(irq);
+}
+
+/**
+ * @brief Configura o canal de DMA (32 bits por palavra, cadenciado pelo DREQ de transmissão da máquina de estados)
+ */
+static void matrix_dma_attach(void) {
+    static bool handler_installed;
+    dma_channel_config cfg = dma_channel_get_default_config(matrix_dma_channel);
+    channel_config_set_transfer_data_size(&cfg, DMA_SIZE_32);
+    channel_config_set_read_increment(&cfg, true);
+    channel_config_set_write_increment(&cfg, false);
+    channel_config_set_dreq(&cfg, pio_get_dreq(pio, sm, true));
+    dma_channel_configure(matrix_dma_channel, &cfg, &pio->txf[sm], NULL, 0, false);
+    dma_channel_set_irq1_enabled(matrix_dma_channel, true);
+    if (!handler_installed) {
+        irq_add_shared_handler(DMA_IRQ_1, matrix_dma_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(DMA_IRQ_1, true);
+        handler_installed = true;
+    }
+}
+
 /**
  * @brief Inicializa a matriz de LEDs RGB
+ * @return Máquina de estados usada
  */
 uint matrix_init(void) {
    //Configurações da PIO
@@ -22,21 +146,155 @@ uint matrix_init(void) {
    uint offset = pio_add_program(pio, &pio_matrix_program);
    sm = pio_claim_unused_sm(pio, true);
    pio_matrix_program_init(pio, sm, offset, WS2812_PIN);
+   matrix_set_brightness(matrix_brightness);
+   matrix_wait();
+   if (matrix_dma_channel < 0)
+       matrix_dma_channel = dma_claim_unused_channel(true);
+   matrix_dma_attach();
+   return sm;
+}
+
+/**
+ * @brief Define o brilho global e recalcula a tabela de conversão
+ *
+ * A tabela é calculada uma vez por mudança de brilho; a conversão de cada
+ * quadro fica só em consultas a ela.
+ * @param level Brilho (0 apaga, 255 intensidade máxima)
+ */
+void matrix_set_brightness(uint8_t level) {
+    matrix_brightness = level;
+    for (uint i = 0; i < 256; ++i) {
+#if MATRIX_GAMMA
+        uint v = matrix_gamma[i];
+#else
+        uint v = i;
+#endif
+        matrix_lut[i] = (uint8_t)((v * level + 127) / 255);
+    }
+    matrix_lut_ready = true;
+}
+
+/**
+ * @brief Retorna o brilho global
+ */
+uint8_t matrix_get_brightness(void) {
+    return matrix_brightness;
+}
+
+/**
+ * @brief Converte uma cor para a palavra do PIO (gama e brilho aplicados)
+ * @param color Cor
+ * @return Palavra com G, R e B nos 24 bits mais significativos
+ */
+uint32_t matrix_word(GRB color) {
+    if (!matrix_lut_ready)
+        matrix_set_brightness(matrix_brightness);
+    return ((uint32_t)matrix_lut[color.G] << 24) | ((uint32_t)matrix_lut[color.R] << 16) | ((uint32_t)matrix_lut[color.B] << 8);
 }
 
 /**
- * @brief Converte as intensidades de cor para um valor RGB
+ * @brief Converte as intensidades de cor para a palavra do PIO
  * @param r Intensidade da cor vermelha
  * @param g Intensidade da cor verde
  * @param b Intensidade da cor azul
- * @return Valor RGB
+ * @return Palavra com G, R e B nos 24 bits mais significativos
+ */
+uint32_t matrix_rgb(uint8_t r, uint8_t g, uint8_t b){
+  return matrix_word(grb(r, g, b));
+}
+
+/**
+ * @brief Mistura duas cores em ponto fixo
+ * @param a Cor com peso (256 - t)
+ * @param b Cor com peso t
+ * @param t Peso da segunda cor em 1/256 (0 retorna a, 256 retorna b)
+ * @return Cor misturada
+ */
+GRB grb_blend(GRB a, GRB b, uint16_t t) {
+    if (t > 256)
+        t = 256;
+    uint16_t s = 256 - t;
+    return (GRB){
+        (uint8_t)((a.G * s + b.G * t + 128) >> 8),
+        (uint8_t)((a.R * s + b.R * t + 128) >> 8),
+        (uint8_t)((a.B * s + b.B * t + 128) >> 8),
+    };
+}
+
+/**
+ * @brief Escala uma cor em ponto fixo
+ * @param color Cor
+ * @param scale Fator em 1/256; 255 mantém a cor
+ * @return Cor escalada
+ */
+GRB grb_scale(GRB color, uint8_t scale) {
+    uint16_t s = (uint16_t)scale + 1;
+    return (GRB){
+        (uint8_t)((color.G * s) >> 8),
+        (uint8_t)((color.R * s) >> 8),
+        (uint8_t)((color.B * s) >> 8),
+    };
+}
+
+/**
+ * @brief Enfileira um quadro para envio por DMA, sem esperar
+ *
+ * O quadro é convertido para um buffer livre na chamada; o envio, o latch e
+ * o quadro seguinte correm por interrupção. Com um quadro em envio e outro
+ * enfileirado, retorna false sem alterar nada.
+ * @param pixels Array com as cores dos LEDs
+ * @return true se o quadro foi aceito
+ */
+bool matrix_submit(const GRB pixels[NUM_PIXELS]) {
+    matrix_latch_poll();
+    uint32_t irq = save_and_disable_interrupts();
+    uint8_t active = matrix_dma_active;
+    bool full = matrix_dma_queued;
+    restore_interrupts(irq);
+    if (full)
+        return false;
+    if (MATRIX_DMA_IDLE == active) {
+        matrix_encode(pixels, matrix_dma_buffer[0]);
+        matrix_dma_start(0);
+        return true;
+    }
+    // O buffer livre só volta a ser lido depois que matrix_dma_queued for marcado
+    matrix_encode(pixels, matrix_dma_buffer[active ^ 1]);
+    irq = save_and_disable_interrupts();
+    if (MATRIX_DMA_IDLE == matrix_dma_active) {
+        restore_interrupts(irq);
+        matrix_dma_start(active ^ 1);
+        return true;
+    }
+    matrix_dma_queued = true;
+    restore_interrupts(irq);
+    return true;
+}
+
+/**
+ * @brief Há quadro em envio, enfileirado ou aguardando o latch
  */
-uint32_t matrix_rgb(double r, double g, double b){
-  unsigned char R, G, B;
-  R = r * 100;
-  G = g * 100;
-  B = b * 100;
-  return (G << 24) | (R << 16) | (B << 8);
+bool matrix_busy(void) {
+    matrix_latch_poll();
+    return MATRIX_DMA_IDLE != matrix_dma_active;
+}
+
+/**
+ * @brief Aguarda o envio e o latch de todos os quadros
+ */
+void matrix_wait(void) {
+    while (matrix_busy())
+        tight_loop_contents();
+}
+
+/**
+ * @brief Define a notificação de quadro exibido
+ * @param cb Função chamada ao fim do latch de cada quadro (NULL desliga)
+ * @param ctx Contexto repassado à função
+ */
+void matrix_set_done_callback(matrix_done_cb_t cb, void *ctx) {
+    matrix_on_done = cb;
+    matrix_on_done_ctx = ctx;
 }
 
 /**
@@ -47,49 +305,73 @@ uint32_t matrix_rgb(double r, double g, double b){
  * @param g Intensidade da cor verde
  * @param b Intensidade da cor azul
  */
-void set_leds(PIO pio, uint sm, double r, double g, double b) {
-    uint32_t valor_led;
+void set_leds(PIO pio, uint sm, uint8_t r, uint8_t g, uint8_t b) {
+    GRB pixels[NUM_PIXELS];
     for (int16_t i = 0; i < NUM_PIXELS; i++) {
-        valor_led = matrix_rgb(r, g, b);
-        pio_sm_put_blocking(pio, sm, valor_led);
+        pixels[i] = grb(r, g, b);
     }
+    draw_matrix(pixels, pio, sm);
 }
 
+// Posição na cadeia de cada pixel, montada pelo compilador; as posições além
+// de NUM_PIXELS completam o bloco de repetição e não são usadas
+#define MATRIX_MAP_ENTRY(i) \
+    (uint16_t)((i) < NUM_PIXELS ? MATRIX_LAYOUT_INDEX((i) % MATRIX_WIDTH, (i) / MATRIX_WIDTH, MATRIX_PANEL_WIDTH, \
+                                                     MATRIX_PANEL_HEIGHT, MATRIX_TILES_X, MATRIX_LAYOUT) : UINT16_MAX)
+
+#if NUM_PIXELS <= 64
+const uint16_t matrix_map[64] = {MATRIX_REPEAT_64(MATRIX_MAP_ENTRY, 0)};
+#elif NUM_PIXELS <= 256
+const uint16_t matrix_map[256] = {MATRIX_REPEAT_256(MATRIX_MAP_ENTRY, 0)};
+#elif NUM_PIXELS <= 1024
+const uint16_t matrix_map[1024] = {MATRIX_REPEAT_1024(MATRIX_MAP_ENTRY, 0)};
+#else
+#error "matrix_map: até 1024 LEDs"
+#endif
+
 /**
- * @brief Obtém o índice do LED RGB
- * @param x Coordenada x
- * @param y Coordenada y
- * @return Índice do LED RGB
+ * @brief Obtém a posição do LED RGB na cadeia
+ * @param x Coluna (0 à esquerda)
+ * @param y Linha (0 em cima)
+ * @return Posição na cadeia
  */
 int getIndex(int x, int y) {
-    // Se a linha for par (0, 2, 4), percorremos da esquerda para a direita.
-    // Se a linha for ímpar (1, 3), percorremos da direita para a esquerda.
-    if (y % 2 == 0) {
-        return 24-(y * 5 + x); // Linha par (esquerda para direita).
-    } else {
-        return 24-(y * 5 + (4 - x)); // Linha ímpar (direita para esquerda).
-    }
+    return matrix_map[y * MATRIX_WIDTH + x];
 }
 
 /**
- * @brief Obtém as coordenadas do LED RGB
- * @param index Índice do LED RGB
- * @param x Ponteiro para armazenar a coordenada x
- * @param y Ponteiro para armazenar a coordenada y
+ * @brief Obtém as coordenadas de um pixel do quadro
+ * @param index Índice do pixel no quadro
+ * @param x Ponteiro para armazenar a coluna
+ * @param y Ponteiro para armazenar a linha
  */
 void getCoordinates(int index, int *x, int *y) {
-    *x = (index % 5);
-    *y = (index / 5);
+    *x = index % MATRIX_WIDTH;
+    *y = index / MATRIX_WIDTH;
 }
 
 /**
- * @brief Converte as coordenadas para o índice do LED RGB
- * @param x Coordenada x
- * @param y Coordenada y
- * @return Índice do LED RGB
+ * @brief Converte as coordenadas para o índice do pixel no quadro (inverso de getCoordinates)
+ * @param x Coluna
+ * @param y Linha
+ * @return Índice do pixel no quadro
  */
 uint coordenates_to_index(int x, int y) {
-    return x * 5 + y;
+    return y * MATRIX_WIDTH + x;
+}
+
+/**
+ * @brief Converte um quadro para as palavras do PIO, na ordem da cadeia
+ * @param pixels Array com as cores dos LEDs
+ * @param words Palavras na ordem de envio
+ */
+void matrix_encode(const GRB pixels[NUM_PIXELS], uint32_t words[NUM_PIXELS]) {
+    if (!matrix_lut_ready)
+        matrix_set_brightness(matrix_brightness);
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        const GRB *c = &pixels[i];
+        words[matrix_map[i]] = ((uint32_t)matrix_lut[c->G] << 24) | ((uint32_t)matrix_lut[c->R] << 16) | ((uint32_t)matrix_lut[c->B] << 8);
+    }
 }
 
 /**
@@ -98,12 +380,17 @@ uint coordenates_to_index(int x, int y) {
  * @param pio Configuração da PIO
  * @param sm Estado da máquina
  */
-void draw_matrix(RGB pixels[NUM_PIXELS], PIO pio, uint sm) {
+void draw_matrix(const GRB pixels[NUM_PIXELS], PIO pio, uint sm) {
+    // Na máquina de estados da matriz, o envio é do DMA: só espera se já houver um quadro enfileirado
+    if (matrix_dma_owns(pio, sm)) {
+        while (!matrix_submit(pixels))
+            tight_loop_contents();
+        return;
+    }
+    uint32_t words[NUM_PIXELS];
+    matrix_encode(pixels, words);
     for (int i = 0; i < NUM_PIXELS; i++) {
-        int x = i % 5;
-        int y = i / 5;
-        int index = getIndex(x, y);
-        pio_sm_put_blocking(pio, sm, matrix_rgb(pixels[index].R, pixels[index].G, pixels[index].B));
+        pio_sm_put_blocking(pio, sm, words[i]);
     }
 }
 
@@ -111,10 +398,9 @@ void draw_matrix(RGB pixels[NUM_PIXELS], PIO pio, uint sm) {
  * @brief Apaga a matriz de LEDs RGB
  */
 void clear_matrix(void){
-    RGB pixels[NUM_PIXELS];
+    GRB pixels[NUM_PIXELS];
     for (int i = 0; i < NUM_PIXELS; i++) {
         pixels[i] = BLACK;
     }
-    draw_matrix(pixels, pio0, 0);
+    draw_matrix(pixels, pio, sm);
 }
-
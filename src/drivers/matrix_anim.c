@@ -0,0 +1,204 @@
+#include <string.h>
+#include "drivers/matrix_anim.h"
+
+/**
+ * @brief Monta o quadro de uma keyframe a partir do quadro da anterior
+ * @param anim Sequência
+ * @param k Keyframe
+ * @param prev Quadro da keyframe k - 1 (ignorado para k = 0, que parte do quadro base)
+ * @param out Quadro montado (pode ser o próprio prev)
+ */
+static void matrix_anim_key_frame(const matrix_anim_t *anim, uint16_t k, const GRB *prev, GRB *out) {
+    if (!k) {
+        if (anim->base)
+            memcpy(out, anim->base, sizeof(GRB) * NUM_PIXELS);
+        else
+            memset(out, 0, sizeof(GRB) * NUM_PIXELS);
+    } else if (out != prev) {
+        memcpy(out, prev, sizeof(GRB) * NUM_PIXELS);
+    }
+    const matrix_anim_key_t *key = &anim->keys[k];
+    for (uint16_t i = 0; i < key->count; ++i)
+        if (key->deltas[i].pixel < NUM_PIXELS)
+            out[key->deltas[i].pixel] = key->deltas[i].color;
+}
+
+/**
+ * @brief Duração da transição de uma keyframe (no mínimo 1 ms, para o relógio sempre avançar)
+ */
+static uint32_t matrix_anim_key_ms(const matrix_anim_t *anim, uint16_t k) {
+    return anim->keys[k].duration_ms ? anim->keys[k].duration_ms : 1;
+}
+
+/**
+ * @brief Monta o destino da transição que parte da keyframe atual e lista os pixels que mudam
+ */
+static void matrix_anim_target(matrix_anim_player_t *player) {
+    const matrix_anim_t *anim = player->anim;
+    uint16_t next = player->key + 1;
+    if (next == anim->num_keys && !anim->loop) {
+        player->finished = true;
+        player->num_changing = 0;
+        return;
+    }
+    if (next == anim->num_keys)
+        matrix_anim_key_frame(anim, 0, NULL, player->to);
+    else
+        matrix_anim_key_frame(anim, next, player->from, player->to);
+    player->num_changing = 0;
+    for (uint16_t i = 0; i < NUM_PIXELS; ++i)
+        if (memcmp(&player->from[i], &player->to[i], sizeof(GRB)))
+            player->changing[player->num_changing++] = i;
+}
+
+/**
+ * @brief Posiciona o reprodutor na primeira keyframe, com o quadro pendente de envio
+ * @param player Reprodutor
+ * @param anim Sequência
+ */
+void matrix_anim_start(matrix_anim_player_t *player, const matrix_anim_t *anim) {
+    player->anim = anim;
+    player->key = 0;
+    player->key_start_ms = 0;
+    player->elapsed_ms = 0;
+    player->finished = false;
+    player->frames_sent = 0;
+    matrix_anim_key_frame(anim, 0, NULL, player->from);
+    memcpy(player->frame, player->from, sizeof player->frame);
+    player->dirty = true;
+    matrix_anim_target(player);
+}
+
+/**
+ * @brief Passa para a keyframe de destino: o quadro atual fica exato nela
+ * @return O quadro atual mudou
+ */
+static bool matrix_anim_advance(matrix_anim_player_t *player) {
+    const matrix_anim_t *anim = player->anim;
+    bool changed = false;
+    player->key_start_ms += matrix_anim_key_ms(anim, player->key);
+    player->key = (player->key + 1) % anim->num_keys;
+    for (uint16_t i = 0; i < player->num_changing; ++i) {
+        uint16_t p = player->changing[i];
+        if (memcmp(&player->frame[p], &player->to[p], sizeof(GRB))) {
+            player->frame[p] = player->to[p];
+            changed = true;
+        }
+    }
+    memcpy(player->from, player->to, sizeof player->from);
+    matrix_anim_target(player);
+    return changed;
+}
+
+/**
+ * @brief Calcula o quadro no instante dado do relógio da animação
+ *
+ * Só os pixels que diferem entre as keyframes da transição são
+ * interpolados (mistura em ponto fixo de 1/256).
+ * @param player Reprodutor
+ * @param elapsed_ms Relógio da animação (não decrescente)
+ * @return true se o quadro atual mudou
+ */
+bool matrix_anim_step(matrix_anim_player_t *player, uint32_t elapsed_ms) {
+    const matrix_anim_t *anim = player->anim;
+    bool changed = false;
+    player->elapsed_ms = elapsed_ms;
+    while (!player->finished && elapsed_ms - player->key_start_ms >= matrix_anim_key_ms(anim, player->key))
+        changed |= matrix_anim_advance(player);
+    if (!player->finished && !(anim->keys[player->key].flags & MATRIX_ANIM_HOLD)) {
+        uint32_t t = (elapsed_ms - player->key_start_ms) * 256 / matrix_anim_key_ms(anim, player->key);
+        for (uint16_t i = 0; i < player->num_changing; ++i) {
+            uint16_t p = player->changing[i];
+            GRB c = grb_blend(player->from[p], player->to[p], (uint16_t)t);
+            if (memcmp(&player->frame[p], &c, sizeof c)) {
+                player->frame[p] = c;
+                changed = true;
+            }
+        }
+    }
+    player->dirty |= changed;
+    return changed;
+}
+
+/**
+ * @brief Envia o quadro atual, se alterado; com a matriz ocupada, tenta no próximo período
+ */
+static void matrix_anim_flush(matrix_anim_player_t *player) {
+    if (player->dirty && matrix_submit(player->frame)) {
+        player->dirty = false;
+        player->frames_sent++;
+    }
+}
+
+/**
+ * @brief Período do timer: avança o relógio e envia o quadro se ele mudou
+ */
+static bool matrix_anim_tick(repeating_timer_t *rt) {
+    matrix_anim_player_t *player = rt->user_data;
+    matrix_anim_step(player, player->elapsed_ms + MATRIX_ANIM_TICK_MS);
+    matrix_anim_flush(player);
+    return matrix_anim_playing(player);
+}
+
+/**
+ * @brief Reproduz a sequência pela matriz: o timer interpola e o DMA envia
+ *
+ * O reprodutor deve começar zerado (variável estática, por exemplo); uma
+ * reprodução em andamento no mesmo reprodutor é substituída.
+ * @param player Reprodutor (permanece em uso até o fim ou matrix_anim_stop)
+ * @param anim Sequência
+ * @return true se o timer foi iniciado
+ */
+bool matrix_anim_play(matrix_anim_player_t *player, const matrix_anim_t *anim) {
+    matrix_anim_stop(player);
+    matrix_anim_start(player, anim);
+    matrix_anim_flush(player);
+    return add_repeating_timer_ms(-MATRIX_ANIM_TICK_MS, matrix_anim_tick, player, &player->timer);
+}
+
+/**
+ * @brief Interrompe a reprodução; o último quadro enviado permanece na matriz
+ *
+ * Um quadro ainda não enviado é descartado e a reprodução passa a constar
+ * como terminada.
+ * @param player Reprodutor
+ */
+void matrix_anim_stop(matrix_anim_player_t *player) {
+    cancel_repeating_timer(&player->timer);
+    player->finished = true;
+    player->dirty = false;
+}
+
+/**
+ * @brief A reprodução não terminou (ou o último quadro ainda não foi enviado)
+ * @param player Reprodutor
+ */
+bool matrix_anim_playing(const matrix_anim_player_t *player) {
+    return !player->finished || player->dirty;
+}
+
+/**
+ * @brief Duração de uma passagem pela sequência
+ * @param anim Sequência
+ * @return Milissegundos da primeira keyframe até a última (ou de volta à primeira, com repetição)
+ */
+uint32_t matrix_anim_duration_ms(const matrix_anim_t *anim) {
+    uint32_t total = 0;
+    uint16_t n = anim->loop ? anim->num_keys : anim->num_keys - 1;
+    for (uint16_t k = 0; k < n; ++k)
+        total += matrix_anim_key_ms(anim, k);
+    return total;
+}
+
+/**
+ * @brief Bytes da sequência em flash: descritor, keyframes, deltas e quadro base
+ * @param anim Sequência
+ */
+size_t matrix_anim_flash_size(const matrix_anim_t *anim) {
+    size_t size = sizeof *anim + anim->num_keys * sizeof(matrix_anim_key_t);
+    for (uint16_t k = 0; k < anim->num_keys; ++k)
+        size += anim->keys[k].count * sizeof(matrix_anim_delta_t);
+    if (anim->base)
+        size += sizeof(GRB) * NUM_PIXELS;
+    return size;
+}
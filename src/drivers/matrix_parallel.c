@@ -0,0 +1,149 @@
+#include <stdlib.h>
+#include <string.h>
+#include "hardware/dma.h"
+#include "hardware/gpio.h"
+#include "drivers/matrix_parallel.h"
+
+#define MATRIX_BIT_US 1.25 // Um bit a 800 kHz
+#define MATRIX_FIFO_DRAIN_US 45 // 8 palavras na FIFO unida + 1 em deslocamento, 4 planos de 1,25 us cada
+
+/**
+ * @brief Configura as fitas, a máquina de estados e o canal de DMA
+ * @param par Fitas
+ * @param pio Bloco PIO
+ * @param pin_base Pino da fita 0
+ * @param num_strips Número de fitas (1 a MATRIX_PARALLEL_MAX_STRIPS)
+ * @param leds_per_strip LEDs da fita mais longa
+ * @return false se os parâmetros forem inválidos ou faltar memória
+ */
+bool matrix_parallel_init(matrix_parallel_t *par, PIO pio, uint pin_base, uint8_t num_strips, uint16_t leds_per_strip) {
+    if (!num_strips || num_strips > MATRIX_PARALLEL_MAX_STRIPS || !leds_per_strip)
+        return false;
+    par->planes = calloc((size_t)leds_per_strip * MATRIX_PARALLEL_WORDS_PER_LED, sizeof(uint32_t));
+    if (!par->planes)
+        return false;
+    par->pio = pio;
+    par->pin_base = pin_base;
+    par->num_strips = num_strips;
+    par->leds_per_strip = leds_per_strip;
+    par->ready_us = 0;
+    par->offset = pio_add_program(pio, &pio_matrix_parallel_program);
+    par->sm = pio_claim_unused_sm(pio, true);
+    pio_matrix_parallel_program_init(pio, par->sm, par->offset, pin_base, num_strips);
+
+    par->dma_channel = dma_claim_unused_channel(true);
+    dma_channel_config cfg = dma_channel_get_default_config(par->dma_channel);
+    channel_config_set_transfer_data_size(&cfg, DMA_SIZE_32);
+    channel_config_set_read_increment(&cfg, true);
+    channel_config_set_write_increment(&cfg, false);
+    channel_config_set_dreq(&cfg, pio_get_dreq(pio, par->sm, true));
+    dma_channel_configure(par->dma_channel, &cfg, &pio->txf[par->sm], NULL, 0, false);
+    return true;
+}
+
+/**
+ * @brief Libera o buffer, o canal de DMA, a máquina de estados e o programa
+ *
+ * Os pinos voltam ao SIO como saídas em nível baixo, para que as fitas não
+ * fiquem presas ao PIO nem flutuando.
+ * @param par Fitas
+ */
+void matrix_parallel_deinit(matrix_parallel_t *par) {
+    matrix_parallel_wait(par);
+    pio_sm_set_enabled(par->pio, par->sm, false);
+    for (uint8_t i = 0; i < par->num_strips; ++i) {
+        gpio_init(par->pin_base + i); // Saída do SIO em nível baixo
+        gpio_set_dir(par->pin_base + i, GPIO_OUT);
+    }
+    pio_sm_unclaim(par->pio, par->sm);
+    pio_remove_program(par->pio, &pio_matrix_parallel_program, par->offset);
+    dma_channel_unclaim(par->dma_channel);
+    free(par->planes);
+    par->planes = NULL;
+}
+
+/**
+ * @brief Transpõe 8x8 bits: o bit c do byte r passa a ser o bit r do byte c
+ */
+static inline uint64_t matrix_transpose8(uint64_t x) {
+    uint64_t t;
+    t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAull;
+    x ^= t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCull;
+    x ^= t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ull;
+    x ^= t ^ (t << 28);
+    return x;
+}
+
+/**
+ * @brief Transpõe um LED de cada fita em planos de bits
+ *
+ * O plano p (0 = bit mais significativo do verde) é um byte em que o bit i
+ * é o bit correspondente da fita i. A palavra j do resultado leva os planos
+ * 4j a 4j + 3, do byte menos para o mais significativo, que é a ordem em
+ * que o programa pio_matrix_parallel os consome.
+ * @param words Palavras de cada fita, como as de matrix_word (G, R, B nos bits 31..8)
+ * @param planes Seis palavras de planos de bits
+ */
+void matrix_parallel_transpose(const uint32_t words[MATRIX_PARALLEL_MAX_STRIPS], uint32_t planes[MATRIX_PARALLEL_WORDS_PER_LED]) {
+    for (uint c = 0; c < 3; ++c) {
+        // Byte i = canal c da fita i; após a transposição, byte k = bit k de todas as fitas
+        uint64_t x = 0;
+        for (uint i = 0; i < MATRIX_PARALLEL_MAX_STRIPS; ++i)
+            x |= (uint64_t)((words[i] >> (24 - 8 * c)) & 0xFF) << (8 * i);
+        x = matrix_transpose8(x);
+        // Planos do bit 7 ao bit 0: bytes 7..4 e depois 3..0
+        planes[2 * c] = __builtin_bswap32((uint32_t)(x >> 32));
+        planes[2 * c + 1] = __builtin_bswap32((uint32_t)x);
+    }
+}
+
+/**
+ * @brief Aguarda o envio e o latch do último quadro
+ * @param par Fitas
+ */
+void matrix_parallel_wait(const matrix_parallel_t *par) {
+    dma_channel_wait_for_finish_blocking(par->dma_channel);
+    while (time_us_64() < par->ready_us)
+        tight_loop_contents();
+}
+
+/**
+ * @brief Tempo de um quadro na linha, com o latch: não depende do número de fitas
+ * @param par Fitas
+ */
+uint32_t matrix_parallel_frame_us(const matrix_parallel_t *par) {
+    return (uint32_t)(par->leds_per_strip * 24 * MATRIX_BIT_US) + MATRIX_FIFO_DRAIN_US + MATRIX_RESET_US;
+}
+
+/**
+ * @brief Envia um quadro de cada fita, em paralelo, por DMA
+ *
+ * Espera o fim do quadro anterior (o buffer de planos é único), transpõe o
+ * novo e retorna assim que o DMA começa. Fitas NULL ficam apagadas; depois
+ * do fim de uma fita mais curta, a linha recebe zeros até leds_per_strip.
+ * @param par Fitas
+ * @param strips Cores de cada fita, na ordem da cadeia
+ * @param lengths LEDs de cada fita (limitados a leds_per_strip); NULL se todas têm leds_per_strip
+ */
+void matrix_parallel_show(matrix_parallel_t *par, const GRB *const strips[], const uint16_t lengths[]) {
+    matrix_parallel_wait(par);
+    uint16_t count[MATRIX_PARALLEL_MAX_STRIPS];
+    for (uint8_t i = 0; i < par->num_strips; ++i) {
+        count[i] = lengths && lengths[i] < par->leds_per_strip ? lengths[i] : par->leds_per_strip;
+        if (!strips[i])
+            count[i] = 0;
+    }
+    uint32_t words[MATRIX_PARALLEL_MAX_STRIPS] = {0};
+    uint32_t *planes = par->planes;
+    for (uint16_t led = 0; led < par->leds_per_strip; ++led) {
+        for (uint8_t i = 0; i < par->num_strips; ++i)
+            words[i] = led < count[i] ? matrix_word(strips[i][led]) : 0;
+        matrix_parallel_transpose(words, planes);
+        planes += MATRIX_PARALLEL_WORDS_PER_LED;
+    }
+    par->ready_us = time_us_64() + matrix_parallel_frame_us(par);
+    dma_channel_transfer_from_buffer_now(par->dma_channel, par->planes,
+                                         (uint32_t)par->leds_per_strip * MATRIX_PARALLEL_WORDS_PER_LED);
+}
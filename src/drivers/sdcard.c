@@ -291,3 +291,622 @@ void read_file(const char *filename){
     printf("\nLeitura do arquivo %s concluída.\n\n", filename);
 }
 
+
+/**
+ * @brief Primeiro setor de um arquivo contíguo (reservado com f_expand)
+ * @param fil Arquivo aberto
+ * @return LBA do primeiro setor de dados
+ */
+static LBA_t sd_file_lba(const FIL *fil){
+    FATFS *fs = fil->obj.fs;
+    return fs->database + (LBA_t)fs->csize * (fil->obj.sclust - 2);
+}
+
+/**
+ * @brief Grava setores do registrador direto na faixa reservada
+ * @param log Registrador
+ * @param data Dados a gravar
+ * @param count Número de setores
+ * @return FR_OK ou FR_DISK_ERR
+ */
+static FRESULT sd_log_write(sd_log_t *log, const uint8_t *data, UINT count){
+    myASSERT(log->written + count <= log->sectors);
+    DRESULT dr = disk_write(log->fil.obj.fs->pdrv, data, log->lba + log->written, count);
+    return RES_OK == dr ? FR_OK : FR_DISK_ERR;
+}
+
+#define SD_LOG_PATH_SIZE (sizeof ((sd_log_t *)0)->base + 4) // base + ".NNN"
+
+/**
+ * @brief Monta o caminho base.NNN do arquivo log->index
+ * @param log Registrador
+ * @param path Caminho montado
+ * @return false se o índice passou de SD_LOG_MAX_INDEX
+ */
+static bool sd_log_path(const sd_log_t *log, char path[SD_LOG_PATH_SIZE]){
+    if (log->index > SD_LOG_MAX_INDEX)
+        return false;
+    snprintf(path, SD_LOG_PATH_SIZE, "%s.%03u", log->base, (unsigned)log->index);
+    return true;
+}
+
+/**
+ * @brief Cria e reserva o arquivo de número log->index
+ * @param log Registrador
+ * @return Resultado do FatFs
+ */
+static FRESULT sd_log_create(sd_log_t *log){
+    char path[SD_LOG_PATH_SIZE];
+    if (!sd_log_path(log, path))
+        return FR_DENIED;
+    FRESULT fr = f_open(&log->fil, path, FA_CREATE_ALWAYS | FA_WRITE);
+    if (FR_OK != fr)
+        return fr;
+    // Cadeia contígua: o setor de qualquer posição do arquivo é conhecido de antemão
+    fr = f_expand(&log->fil, log->size, 1);
+    // Grava FAT e entrada de diretório já com a reserva, antes de qualquer dado
+    if (FR_OK == fr)
+        fr = f_sync(&log->fil);
+    if (FR_OK != fr)
+    {
+        f_close(&log->fil);
+        f_unlink(path);
+        return fr;
+    }
+    log->lba = sd_file_lba(&log->fil);
+    log->sectors = log->size / FF_MAX_SS;
+    log->written = 0;
+    log->fill = 0;
+    log->open = true;
+    return FR_OK;
+}
+
+/**
+ * @brief Abre o registrador no primeiro arquivo base.NNN inexistente
+ * @param log Registrador
+ * @param base Caminho sem extensão, por exemplo "0:/adc"
+ * @param size Bytes reservados por arquivo (arredondado para múltiplo do buffer)
+ * @return Resultado do FatFs
+ */
+FRESULT sd_log_open(sd_log_t *log, const char *base, FSIZE_t size){
+    if (strlen(base) >= sizeof log->base || 0 == size)
+        return FR_INVALID_PARAMETER;
+    memset(log, 0, sizeof *log);
+    strcpy(log->base, base);
+    log->size = (size + sizeof log->buf - 1) / sizeof log->buf * sizeof log->buf;
+    char path[SD_LOG_PATH_SIZE];
+    FILINFO fno;
+    for (;; ++log->index)
+    {
+        if (!sd_log_path(log, path))
+            return FR_DENIED;
+        FRESULT fr = f_stat(path, &fno);
+        if (FR_NO_FILE == fr)
+            break;
+        if (FR_OK != fr)
+            return fr;
+    }
+    return sd_log_create(log);
+}
+
+/**
+ * @brief Acrescenta dados ao registro, trocando de arquivo quando o atual enche
+ * @param log Registrador
+ * @param data Dados
+ * @param len Tamanho em bytes
+ * @return Resultado do FatFs
+ */
+FRESULT sd_log_append(sd_log_t *log, const void *data, UINT len){
+    if (!log->open)
+        return FR_INVALID_OBJECT;
+    const uint8_t *p = data;
+    while (len)
+    {
+        FRESULT fr;
+        if (0 == log->fill && len >= sizeof log->buf)
+        {
+            // Blocos inteiros vão direto do chamador para o cartão
+            LBA_t count = len / sizeof log->buf * SD_LOG_BUFFER_SECTORS;
+            if (count > log->sectors - log->written)
+                count = log->sectors - log->written;
+            fr = sd_log_write(log, p, (UINT)count);
+            if (FR_OK != fr)
+                return fr;
+            log->written += count;
+            p += count * FF_MAX_SS;
+            len -= (UINT)(count * FF_MAX_SS);
+        }
+        else
+        {
+            UINT n = sizeof log->buf - log->fill;
+            if (n > len)
+                n = len;
+            memcpy(log->buf + log->fill, p, n);
+            log->fill += n;
+            p += n;
+            len -= n;
+            if (log->fill < sizeof log->buf)
+                continue;
+            fr = sd_log_write(log, log->buf, SD_LOG_BUFFER_SECTORS);
+            if (FR_OK != fr)
+                return fr;
+            log->written += SD_LOG_BUFFER_SECTORS;
+            log->fill = 0;
+        }
+        if (log->written == log->sectors)
+        {
+            fr = sd_log_rotate(log);
+            if (FR_OK != fr)
+                return fr;
+        }
+    }
+    return FR_OK;
+}
+
+/**
+ * @brief Grava no cartão os dados ainda no buffer, sem avançar a posição
+ *
+ * O último setor parcial é completado com zeros e regravado na próxima
+ * sincronização ou quando o buffer encher.
+ * @param log Registrador
+ * @return Resultado do FatFs
+ */
+FRESULT sd_log_sync(sd_log_t *log){
+    if (!log->open)
+        return FR_INVALID_OBJECT;
+    if (log->fill)
+    {
+        UINT count = (log->fill + FF_MAX_SS - 1) / FF_MAX_SS;
+        memset(log->buf + log->fill, 0, count * FF_MAX_SS - log->fill);
+        FRESULT fr = sd_log_write(log, log->buf, count);
+        if (FR_OK != fr)
+            return fr;
+    }
+    return RES_OK == disk_ioctl(log->fil.obj.fs->pdrv, CTRL_SYNC, NULL) ? FR_OK : FR_DISK_ERR;
+}
+
+/**
+ * @brief Fecha o registrador, ajustando o tamanho do arquivo aos bytes gravados
+ *
+ * Os clusters reservados e não usados são devolvidos ao sistema de arquivos.
+ * @param log Registrador
+ * @return Resultado do FatFs
+ */
+FRESULT sd_log_close(sd_log_t *log){
+    if (!log->open)
+        return FR_INVALID_OBJECT;
+    FRESULT fr = sd_log_sync(log);
+    FSIZE_t used = (FSIZE_t)log->written * FF_MAX_SS + log->fill;
+    if (FR_OK == fr && used < log->size)
+    {
+        fr = f_lseek(&log->fil, used);
+        if (FR_OK == fr)
+            fr = f_truncate(&log->fil);
+    }
+    FRESULT fr_close = f_close(&log->fil);
+    log->open = false;
+    return FR_OK != fr ? fr : fr_close;
+}
+
+/**
+ * @brief Fecha o arquivo atual e continua o registro no próximo número
+ * @param log Registrador
+ * @return Resultado do FatFs
+ */
+FRESULT sd_log_rotate(sd_log_t *log){
+    FRESULT fr = sd_log_close(log);
+    if (FR_OK != fr)
+        return fr;
+    ++log->index;
+    return sd_log_create(log);
+}
+
+/**
+ * @brief Tabela de clusters (CLMT) de um arquivo, compartilhada pelos FIL abertos nele
+ */
+typedef struct
+{
+    char path[FF_LFN_BUF + 1];
+    FATFS *fs;
+    WORD fs_id;       // Montagem em que a tabela foi criada
+    DWORD sclust;     // Primeiro cluster, tamanho e data de modificação do
+    FSIZE_t size;     // arquivo nessa hora: se algum mudar, a tabela é recriada
+    WORD fdate;
+    WORD ftime;
+    uint32_t users;   // FIL abertos usando a tabela (não pode ser despejada)
+    uint32_t last_use;
+    bool valid;
+    DWORD clmt[SD_FASTSEEK_CLMT_WORDS];
+} sd_fastseek_entry_t;
+
+static sd_fastseek_entry_t sd_fastseek_entries[SD_FASTSEEK_ENTRIES];
+static sd_fastseek_stats_t sd_fastseek_counters;
+static uint32_t sd_fastseek_clock;
+auto_init_mutex(sd_fastseek_mutex);
+
+/**
+ * @brief Entrada cuja tabela é a usada por um FIL
+ */
+static sd_fastseek_entry_t *sd_fastseek_owner(const FIL *fil){
+    for (size_t i = 0; i < SD_FASTSEEK_ENTRIES; ++i)
+        if (fil->cltbl == sd_fastseek_entries[i].clmt)
+            return &sd_fastseek_entries[i];
+    return NULL;
+}
+
+/**
+ * @brief Escolhe onde criar uma tabela: entrada livre ou a menos usada sem usuários
+ */
+static sd_fastseek_entry_t *sd_fastseek_victim(void){
+    sd_fastseek_entry_t *victim = NULL;
+    for (size_t i = 0; i < SD_FASTSEEK_ENTRIES; ++i)
+    {
+        sd_fastseek_entry_t *e = &sd_fastseek_entries[i];
+        if (!e->valid)
+            return e;
+        if (!e->users && (!victim || e->last_use < victim->last_use))
+            victim = e;
+    }
+    if (victim)
+        sd_fastseek_counters.evictions++;
+    return victim;
+}
+
+/**
+ * @brief Abre um arquivo para leitura com busca rápida
+ *
+ * A tabela de clusters do arquivo é criada na primeira abertura e mantida
+ * em cache pelo caminho, de modo que f_lseek vai direto ao cluster de
+ * qualquer posição sem percorrer a FAT. Aberturas seguintes, inclusive
+ * simultâneas, compartilham a tabela enquanto o arquivo não mudar: um
+ * arquivo regravado com o mesmo primeiro cluster e o mesmo tamanho ainda
+ * tem a data de modificação da entrada de diretório alterada. Sem
+ * tabela disponível (arquivo fragmentado demais ou todas em uso), o
+ * arquivo é aberto normalmente.
+ * @param fil Arquivo a abrir
+ * @param path Caminho
+ * @return Resultado do FatFs
+ */
+FRESULT sd_fastseek_open(FIL *fil, const char *path){
+    FILINFO fno;
+    FRESULT fr = f_stat(path, &fno);
+    fr = fr ? fr : f_open(fil, path, FA_READ);
+    if (FR_OK != fr || strlen(path) > FF_LFN_BUF)
+        return fr;
+    mutex_enter_blocking(&sd_fastseek_mutex);
+    sd_fastseek_entry_t *e = NULL;
+    for (size_t i = 0; i < SD_FASTSEEK_ENTRIES && !e; ++i)
+        if (sd_fastseek_entries[i].valid && 0 == strcmp(sd_fastseek_entries[i].path, path))
+            e = &sd_fastseek_entries[i];
+    FATFS *fs = fil->obj.fs;
+    bool current = e && e->fs == fs && e->fs_id == fs->id && e->sclust == fil->obj.sclust &&
+                   e->size == fil->obj.objsize && e->fdate == fno.fdate && e->ftime == fno.ftime;
+    if (current)
+    {
+        sd_fastseek_counters.hits++;
+    }
+    else
+    {
+        if (e && e->users)
+            e = NULL; // Ainda em uso com o conteúdo antigo: abre sem busca rápida
+        else if (!e)
+            e = sd_fastseek_victim();
+        if (!e)
+        {
+            sd_fastseek_counters.full++;
+            mutex_exit(&sd_fastseek_mutex);
+            return FR_OK;
+        }
+        e->valid = false;
+        e->clmt[0] = SD_FASTSEEK_CLMT_WORDS;
+        fil->cltbl = e->clmt;
+        fr = f_lseek(fil, CREATE_LINKMAP);
+        if (FR_OK != fr)
+        {
+            fil->cltbl = NULL;
+            if (FR_NOT_ENOUGH_CORE == fr)
+                sd_fastseek_counters.too_fragmented++;
+            mutex_exit(&sd_fastseek_mutex);
+            if (FR_NOT_ENOUGH_CORE == fr)
+                return FR_OK;
+            f_close(fil);
+            return fr;
+        }
+        strcpy(e->path, path);
+        e->fs = fs;
+        e->fs_id = fs->id;
+        e->sclust = fil->obj.sclust;
+        e->size = fil->obj.objsize;
+        e->fdate = fno.fdate;
+        e->ftime = fno.ftime;
+        e->valid = true;
+        sd_fastseek_counters.builds++;
+    }
+    fil->cltbl = e->clmt;
+    e->users++;
+    e->last_use = ++sd_fastseek_clock;
+    mutex_exit(&sd_fastseek_mutex);
+    return FR_OK;
+}
+
+/**
+ * @brief Fecha um arquivo aberto com sd_fastseek_open, liberando a tabela
+ * @param fil Arquivo
+ * @return Resultado do FatFs
+ */
+FRESULT sd_fastseek_close(FIL *fil){
+    mutex_enter_blocking(&sd_fastseek_mutex);
+    sd_fastseek_entry_t *e = sd_fastseek_owner(fil);
+    if (e && e->users)
+        e->users--;
+    fil->cltbl = NULL;
+    mutex_exit(&sd_fastseek_mutex);
+    return f_close(fil);
+}
+
+/**
+ * @brief Descarta tabelas sem usuários, por exemplo depois de desmontar a unidade
+ *
+ * Arquivos alterados já são detectados na abertura; isto só libera as
+ * entradas mais cedo.
+ * @param path Caminho do arquivo, ou NULL para todos
+ */
+void sd_fastseek_invalidate(const char *path){
+    mutex_enter_blocking(&sd_fastseek_mutex);
+    for (size_t i = 0; i < SD_FASTSEEK_ENTRIES; ++i)
+    {
+        sd_fastseek_entry_t *e = &sd_fastseek_entries[i];
+        if (e->valid && !e->users && (!path || 0 == strcmp(e->path, path)))
+            e->valid = false;
+    }
+    mutex_exit(&sd_fastseek_mutex);
+}
+
+/**
+ * @brief Contadores do cache de tabelas de clusters
+ */
+const sd_fastseek_stats_t *sd_fastseek_stats(void){
+    return &sd_fastseek_counters;
+}
+
+static uint8_t sd_bench_buf[SD_BENCH_MAX_SECTORS * FF_MAX_SS];
+
+/**
+ * @brief Estado de uma execução do benchmark
+ */
+typedef struct
+{
+    const char *drive;
+    sd_card_t *pSD;
+    BYTE pdrv;
+    LBA_t lba;     // Início da área reservada
+    LBA_t sectors; // Tamanho da área reservada
+    uint32_t seed;
+} sd_bench_t;
+
+/**
+ * @brief Imprime uma linha CSV do benchmark
+ * @param b Execução
+ * @param test Nome do teste
+ * @param param Setores por operação, ou limite superior do balde do histograma
+ * @param ops Operações realizadas
+ * @param bytes Bytes transferidos
+ * @param us Tempo total em microssegundos
+ * @param max_us Maior tempo de uma operação
+ */
+static void sd_bench_row(const sd_bench_t *b, const char *test, uint32_t param, uint32_t ops, uint64_t bytes,
+                         uint64_t us, uint64_t max_us){
+    double s = us / 1e6; // Linhas do histograma não têm tempo: taxas em zero
+    printf("sdbench,%s,%s,%lu,%lu,%llu,%llu,%.1f,%.1f,%llu\n", b->drive, test, (unsigned long)param,
+           (unsigned long)ops, (unsigned long long)bytes, (unsigned long long)us, us ? bytes / 1024.0 / s : 0.0,
+           us ? ops / s : 0.0, (unsigned long long)max_us);
+}
+
+/**
+ * @brief Leitura ou escrita sequencial de toda a área, count setores por operação
+ * @return Código SD_BLOCK_DEVICE_ERROR_*
+ */
+static int sd_bench_seq(sd_bench_t *b, bool write, uint32_t count){
+    uint32_t ops = 0;
+    uint64_t max_us = 0;
+    uint64_t start = time_us_64();
+    for (LBA_t s = 0; s + count <= b->sectors; s += count, ++ops)
+    {
+        uint64_t t = time_us_64();
+        int rc = write ? b->pSD->write_blocks(b->pSD, sd_bench_buf, b->lba + s, count)
+                       : b->pSD->read_blocks(b->pSD, sd_bench_buf, b->lba + s, count);
+        if (rc)
+            return rc;
+        t = time_us_64() - t;
+        if (t > max_us)
+            max_us = t;
+    }
+    sd_bench_row(b, write ? "seq_write" : "seq_read", count, ops, (uint64_t)ops * count * FF_MAX_SS,
+                 time_us_64() - start, max_us);
+    return SD_BLOCK_DEVICE_ERROR_NONE;
+}
+
+/**
+ * @brief Leituras ou escritas de 4 KiB em posições alinhadas aleatórias
+ * @return Código SD_BLOCK_DEVICE_ERROR_*
+ */
+static int sd_bench_rand(sd_bench_t *b, bool write, uint32_t ops){
+    const uint32_t count = 4096 / FF_MAX_SS;
+    const uint32_t slots = b->sectors / count;
+    uint64_t max_us = 0;
+    uint64_t start = time_us_64();
+    for (uint32_t i = 0; i < ops; ++i)
+    {
+        b->seed = b->seed * 1103515245u + 12345u;
+        LBA_t lba = b->lba + (LBA_t)((b->seed >> 8) % slots) * count;
+        uint64_t t = time_us_64();
+        int rc = write ? b->pSD->write_blocks(b->pSD, sd_bench_buf, lba, count)
+                       : b->pSD->read_blocks(b->pSD, sd_bench_buf, lba, count);
+        if (rc)
+            return rc;
+        t = time_us_64() - t;
+        if (t > max_us)
+            max_us = t;
+    }
+    sd_bench_row(b, write ? "rand_write_4k" : "rand_read_4k", count, ops, (uint64_t)ops * 4096,
+                 time_us_64() - start, max_us);
+    return SD_BLOCK_DEVICE_ERROR_NONE;
+}
+
+/**
+ * @brief Latência de f_write com registros de 512 bytes, com histograma
+ *
+ * O balde k conta as chamadas que levaram menos de 2^k us; o último
+ * acumula as demais.
+ * @return Resultado do FatFs
+ */
+static FRESULT sd_bench_fwrite(sd_bench_t *b, FIL *fil, uint32_t ops){
+    uint32_t hist[SD_BENCH_HIST_BUCKETS] = {0};
+    uint64_t max_us = 0;
+    uint64_t start = time_us_64();
+    for (uint32_t i = 0; i < ops; ++i)
+    {
+        UINT bw;
+        uint64_t t = time_us_64();
+        FRESULT fr = f_write(fil, sd_bench_buf, FF_MAX_SS, &bw);
+        if (FR_OK != fr)
+            return fr;
+        if (bw < FF_MAX_SS)
+            return FR_DENIED;
+        t = time_us_64() - t;
+        if (t > max_us)
+            max_us = t;
+        uint32_t k = 0;
+        while (k < SD_BENCH_HIST_BUCKETS - 1 && t >= (1ull << k))
+            ++k;
+        hist[k]++;
+    }
+    sd_bench_row(b, "fwrite_512", 1, ops, (uint64_t)ops * FF_MAX_SS, time_us_64() - start, max_us);
+    for (uint32_t k = 0; k < SD_BENCH_HIST_BUCKETS; ++k)
+        if (hist[k])
+            sd_bench_row(b, "fwrite_512_hist", k < SD_BENCH_HIST_BUCKETS - 1 ? 1u << k : 0, hist[k], 0, 0, 0);
+    return FR_OK;
+}
+
+/**
+ * @brief Custo de f_sync depois de cada registro curto
+ * @return Resultado do FatFs
+ */
+static FRESULT sd_bench_fsync(sd_bench_t *b, FIL *fil, uint32_t ops){
+    uint64_t max_us = 0;
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < ops; ++i)
+    {
+        UINT bw;
+        FRESULT fr = f_write(fil, sd_bench_buf, 64, &bw);
+        if (FR_OK != fr)
+            return fr;
+        uint64_t t = time_us_64();
+        fr = f_sync(fil);
+        if (FR_OK != fr)
+            return fr;
+        t = time_us_64() - t;
+        total += t;
+        if (t > max_us)
+            max_us = t;
+    }
+    sd_bench_row(b, "fsync_64", 1, ops, (uint64_t)ops * 64, total, max_us);
+    return FR_OK;
+}
+
+/**
+ * @brief Executa os testes de desempenho do cartão, com saída em CSV
+ *
+ * Os testes de E/S crua (seq, rand) usam a faixa de setores de um arquivo
+ * temporário reservado com f_expand, lida e gravada direto pelo driver,
+ * sem passar pelo FatFs nem pelo cache de setores. Os testes de arquivo
+ * (lat, sync) medem o caminho completo do f_write e do f_sync. O arquivo é
+ * removido ao final. A unidade precisa estar montada.
+ * @param drive Unidade, por exemplo "0:"
+ * @param test "seq", "rand", "lat", "sync" ou "all"
+ * @param kib Tamanho da área de teste em KiB
+ * @return Resultado do FatFs
+ */
+FRESULT sd_bench(const char *drive, const char *test, UINT kib){
+    bool all = 0 == strcmp(test, "all");
+    if (!all && strcmp(test, "seq") && strcmp(test, "rand") && strcmp(test, "lat") && strcmp(test, "sync"))
+        return FR_INVALID_PARAMETER;
+    if (kib < SD_BENCH_MAX_SECTORS * FF_MAX_SS / 1024)
+        kib = SD_BENCH_MAX_SECTORS * FF_MAX_SS / 1024;
+    char path[16];
+    snprintf(path, sizeof path, "%s/bench.tmp", drive);
+    FIL fil;
+    FRESULT fr = f_open(&fil, path, FA_CREATE_ALWAYS | FA_WRITE);
+    if (FR_OK != fr)
+        return fr;
+    fr = f_expand(&fil, (FSIZE_t)kib * 1024, 1);
+    if (FR_OK == fr)
+        fr = f_sync(&fil);
+    sd_bench_t b = {.drive = drive, .seed = 1};
+    if (FR_OK == fr)
+    {
+        b.pdrv = fil.obj.fs->pdrv;
+        b.pSD = sd_get_by_num(b.pdrv);
+        b.lba = sd_file_lba(&fil);
+        b.sectors = (LBA_t)kib * 1024 / FF_MAX_SS;
+        // A área passa a ser gravada por fora do cache
+        sector_cache_discard(b.pdrv, b.lba, b.lba + b.sectors - 1);
+        for (size_t i = 0; i < sizeof sd_bench_buf; ++i)
+            sd_bench_buf[i] = (uint8_t)(i * 7 + 1);
+    }
+    static const uint32_t counts[] = {1, 8, SD_BENCH_MAX_SECTORS};
+    int rc = SD_BLOCK_DEVICE_ERROR_NONE;
+    if (FR_OK == fr && (all || 0 == strcmp(test, "seq")))
+        for (size_t i = 0; !rc && i < count_of(counts); ++i)
+        {
+            rc = sd_bench_seq(&b, true, counts[i]);
+            rc = rc ? rc : sd_bench_seq(&b, false, counts[i]);
+        }
+    if (FR_OK == fr && !rc && (all || 0 == strcmp(test, "rand")))
+    {
+        rc = sd_bench_rand(&b, false, SD_BENCH_RANDOM_OPS);
+        rc = rc ? rc : sd_bench_rand(&b, true, SD_BENCH_RANDOM_OPS);
+    }
+    if (rc)
+    {
+        printf("sd_bench: driver error %d\n", rc);
+        fr = FR_DISK_ERR;
+    }
+    // Os testes de arquivo regravam o mesmo arquivo desde o início
+    if (FR_OK == fr && (all || 0 == strcmp(test, "lat") || 0 == strcmp(test, "sync")))
+        fr = f_lseek(&fil, 0);
+    if (FR_OK == fr && (all || 0 == strcmp(test, "lat")))
+        fr = sd_bench_fwrite(&b, &fil, b.sectors);
+    if (FR_OK == fr && (all || 0 == strcmp(test, "sync")))
+    {
+        fr = f_lseek(&fil, 0);
+        if (FR_OK == fr)
+            fr = sd_bench_fsync(&b, &fil, SD_BENCH_SYNC_OPS);
+    }
+    FRESULT fr_close = f_close(&fil);
+    f_unlink(path);
+    return FR_OK != fr ? fr : fr_close;
+}
+
+/**
+ * @brief Comando "bench [teste] [unidade] [KiB]": desempenho do cartão em CSV
+ */
+void run_bench(void){
+    const char *test = strtok(NULL, " ");
+    if (!test)
+        test = "all";
+    const char *drive = strtok(NULL, " ");
+    if (!drive)
+        drive = sd_get_by_num(0)->pcName;
+    const char *kibStr = strtok(NULL, " ");
+    UINT kib = kibStr ? (UINT)atoi(kibStr) : SD_BENCH_DEFAULT_KIB;
+    if (!sd_get_fs_by_name(drive))
+    {
+        printf("Unknown logical drive number: \"%s\"\n", drive);
+        return;
+    }
+    printf("sdbench,drive,test,param,ops,bytes,total_us,kib_per_s,ops_per_s,max_us\n");
+    FRESULT fr = sd_bench(drive, test, kib);
+    if (FR_OK != fr)
+        printf("sd_bench error: %s (%d)\n", FRESULT_str(fr), fr);
+}